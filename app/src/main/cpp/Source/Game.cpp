@@ -6,6 +6,7 @@
 #include <Urho3D/Urho3D.h>
 
 #include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/ProcessUtils.h>
 #include <Urho3D/Core/Timer.h>
 
 #include <Urho3D/Engine/Console.h>
@@ -48,8 +49,13 @@
 #include "GameAttributes.h"
 #include "GameLibrary.h"
 #include "GameEvents.h"
+#include "EventChannel.h"
 #include "GameStatics.h"
 #include "GameHelpers.h"
+#include "GameLog.h"
+#include "GameProfiler.h"
+#include "GameAllocTracker.h"
+#include "GameBenchmark.h"
 #include "GameCommands.h"
 #include "GameUI.h"
 #include "GameTest.h"
@@ -60,6 +66,8 @@
 #include "DelayAction.h"
 
 #include "MAN_Matches.h"
+#include "BoardSimulator.h"
+#include "MatchReplay.h"
 #ifdef ACTIVE_SPLASHUI
 #include "SplashScreen.h"
 #endif
@@ -77,6 +85,10 @@ URHO3D_DEFINE_APPLICATION_MAIN(Game);
 
 extern int UISIZE[NUMUIELEMENTSIZE];
 static bool engineConfigApplied_;
+static bool boardSimulatorMode_;
+static bool particleBenchmarkMode_;
+static bool batchBenchmarkMode_;
+static bool animationBenchmarkMode_;
 
 WeakPtr<UIMenu> accessMenu_;
 WeakPtr<UIElement> headerHolder_;
@@ -197,6 +209,46 @@ void Game::Setup()
     }
 
     SDL_SetHint(SDL_HINT_ACCELEROMETER_AS_JOYSTICK, "0");
+
+    // Headless Board Simulator (see BoardSimulator::RunCommandLine), Particle, Batch and Animation Benchmarks (see GameBenchmark::RunParticles/RunBatches/RunAnimations)
+    boardSimulatorMode_ = GetArguments().Contains("-simulate");
+    particleBenchmarkMode_ = GetArguments().Contains("-benchparticles");
+    batchBenchmarkMode_ = GetArguments().Contains("-benchbatches");
+    animationBenchmarkMode_ = GetArguments().Contains("-benchanimations");
+    if (boardSimulatorMode_ || particleBenchmarkMode_ || batchBenchmarkMode_ || animationBenchmarkMode_)
+    {
+        engineParameters_["Headless"] = true;
+        engineParameters_["WorkerThreads"] = true;
+        engineParameters_["LogLevel"] = LOG_WARNING;
+        engineParameters_["LogName"] = String::EMPTY;
+    }
+
+    // Match Session Record/Replay (see MatchReplay)
+    const Vector<String>& arguments = GetArguments();
+    for (unsigned i = 0; i+1 < arguments.Size(); i++)
+    {
+        if (arguments[i] == "-recordsession")
+            MatchReplay::SetRecordFile(arguments[i+1]);
+        else if (arguments[i] == "-replaysession")
+            MatchReplay::SetReplayFile(arguments[i+1]);
+        else if (arguments[i] == "-benchmark")
+            GameBenchmark::SetScenarioFile(arguments[i+1]);
+        else if (arguments[i] == "-benchmarkbaseline")
+            GameBenchmark::SetBaselineFile(arguments[i+1]);
+        else if (arguments[i] == "-benchmarkoutput")
+            GameBenchmark::SetOutputFile(arguments[i+1]);
+    }
+
+    // Performance Benchmark (see GameBenchmark) : uncapped frame rate, profiler and allocation tracker on
+    if (GameBenchmark::IsRequested())
+    {
+        GameBenchmark::SetUpdateBaseline(arguments.Contains("-benchmarkupdatebaseline"));
+        engineParameters_["FrameLimiter"] = false;
+        engineParameters_["VSync"] = false;
+        config.initState_ = "MainMenu";
+        config.profilerEnabled_ = true;
+        config.allocTrackerEnabled_ = true;
+    }
 }
 
 
@@ -315,6 +367,11 @@ bool Game::LoadGameConfig(const char* fileName, GameConfig* config)
             else if (name == "debugLights_") config->debugLights_ = value;
             else if (name == "debugUI_") config->debugUI_ = value;
             else if (name == "debugAnimatedSprite2D") config->debugAnimatedSprite2D = value;
+            else if (name == "profilerEnabled_") config->profilerEnabled_ = value;
+            else if (name == "allocTrackerEnabled_") config->allocTrackerEnabled_ = value;
+            else if (name == "allocBudgetAssert_") config->allocBudgetAssert_ = value;
+            else if (name == "spriterBakingEnabled_") config->spriterBakingEnabled_ = value;
+            else if (name == "parallelAnimationEnabled_") config->parallelAnimationEnabled_ = value;
 
             config->logString += ToString("  (bool) %s = %s \n", name.CString(), value ? "true":"false");
             std::cout << config->logString.CString();
@@ -335,6 +392,34 @@ void Game::Start()
 
 	URHO3D_LOGINFOF("Game() - engineConfigApplied_ = %s", engineConfigApplied_ ? "true" : "false");
 
+    if (boardSimulatorMode_)
+    {
+        exitCode_ = BoardSimulator::RunCommandLine(context_, GetArguments());
+        engine_->Exit();
+        return;
+    }
+
+    if (particleBenchmarkMode_)
+    {
+        exitCode_ = GameBenchmark::RunParticles(context_, GetArguments());
+        engine_->Exit();
+        return;
+    }
+
+    if (batchBenchmarkMode_)
+    {
+        exitCode_ = GameBenchmark::RunBatches(context_, GetArguments());
+        engine_->Exit();
+        return;
+    }
+
+    if (animationBenchmarkMode_)
+    {
+        exitCode_ = GameBenchmark::RunAnimations(context_, GetArguments());
+        engine_->Exit();
+        return;
+    }
+
 	//engine_->RegisterApplication(this);
 
     if (engineConfigApplied_)
@@ -351,6 +436,11 @@ void Game::Start()
 
     SetupDirectories();
 
+#ifdef ACTIVE_GAMELOGSINK
+    if (!engineParameters_["LogName"].GetString().Empty())
+        GameLog::Start(context_, GameStatics::gameConfig_.saveDir_ + "gamelog.txt");
+#endif
+
 	RegisterGameLibrary(context_);
 
 	// Create All Statics : Camera, Scene
@@ -397,6 +487,9 @@ void Game::Start()
     splashScreen_ = SharedPtr<SplashScreen>(new SplashScreen(context_, GAME_LEVELTOLOAD, GAME_LEVELREADY, "UI/splash02.webp", 0.f));
 #endif
 
+    if (GameBenchmark::IsRequested())
+        GameBenchmark::Start(context_);
+
 	URHO3D_LOGINFO("Game() - ----------------------------------------");
 	URHO3D_LOGINFO("Game() - Start .... OK !                        -");
 	URHO3D_LOGINFO("Game() - ----------------------------------------");
@@ -412,11 +505,33 @@ void Game::Stop()
 
     UnsubscribeFromAllEvents();
 
+    if (boardSimulatorMode_ || particleBenchmarkMode_ || batchBenchmarkMode_ || animationBenchmarkMode_)
+    {
+        GameLog::Stop();
+        return;
+    }
+
     if (GameStatics::gameConfig_.touchEnabled_)
         GameStatics::input_->RemoveScreenJoystick(GameStatics::gameConfig_.screenJoystickID_);
 
+    if (GameBenchmark::IsRequested())
+    {
+        GameBenchmark::Stop();
+        exitCode_ = GameBenchmark::GetExitCode();
+    }
+
     GameStatics::Stop();
 
+    // budget assert mode : a zero-alloc region violation fails the run
+    if (GameAllocTracker::GetExitCode() != EXIT_SUCCESS)
+        exitCode_ = GameAllocTracker::GetExitCode();
+
+    // replay mode : a desync or unplayed events fail the run
+    if (MatchReplay::GetExitCode() != EXIT_SUCCESS)
+        exitCode_ = MatchReplay::GetExitCode();
+
+    GameLog::Stop();
+
 	UnRegisterGameLibrary(context_);
 
     dialogInfo_.Reset();
@@ -1186,6 +1301,15 @@ void Game::HandleKeyDown(StringHash eventType, VariantMap& eventData)
     {
         GameStatics::AddEarnStars(1);
     }
+#endif
+#ifdef ACTIVE_GAMEPROFILER
+    // Toggle GameProfiler overlay with F8
+    else if (scancode == SCANCODE_F8)
+    {
+        if (!GameProfiler::IsEnabled())
+            GameProfiler::SetEnabled(true);
+        GameProfiler::ToggleOverlay();
+    }
 #endif
     else if (scancode == SCANCODE_F7)
     {
@@ -1271,7 +1395,7 @@ void Game::HandleKeyDown(StringHash eventType, VariantMap& eventData)
         else if (keycode == KEY_M)
         {
             URHO3D_LOGINFOF("Game() - HandleKeyDown : Key M pressed => Add a move");
-            SendEvent(GAME_MOVEADDED);
+            EventChannel<MoveAddedEvent>::Send(this, MoveAddedEvent());
         }
         else if (scancode == SCANCODE_S)
         {
@@ -0,0 +1,391 @@
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GNUC__) && !defined(_WIN32)
+#include <dlfcn.h>
+#include <cxxabi.h>
+#define GAMEALLOC_SYMBOLS
+#endif
+
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/IO/Log.h>
+
+#include "GameStatics.h"
+#include "GameProfiler.h"
+#include "GameHelpers.h"
+
+#include "GameAllocTracker.h"
+
+
+#define GAMEALLOC_HEADERSIZE 16
+#define GAMEALLOC_MAGIC 0x6A110C
+#define GAMEALLOC_NUMCALLSITES 4096
+#define GAMEALLOC_CALLSITEPROBES 16
+
+static const char* GameAllocTagNames_[] =
+{
+    "Other",
+    "Matches",
+    "ObjectPool",
+    "UI",
+    "Network",
+    "Animation",
+};
+
+/// Header before each allocation : keeps the 16 bytes alignment of malloc
+struct GameAllocHeader
+{
+    size_t size_;
+    unsigned tag_ : 8;
+    unsigned tracked_ : 1;
+    unsigned magic_ : 23;
+};
+
+struct GameAllocTagCounters
+{
+    std::atomic<long long> liveBytes_;
+    std::atomic<long long> liveCount_;
+    std::atomic<unsigned long long> totalBytes_;
+    std::atomic<unsigned long long> totalCount_;
+};
+
+struct GameAllocCallSite
+{
+    std::atomic<uintptr_t> address_;
+    std::atomic<unsigned> count_;
+    std::atomic<unsigned long long> bytes_;
+    std::atomic<int> tag_;
+};
+
+/// no constructor : zero-initialized before any allocation
+static std::atomic<bool> GameAllocEnabled_;
+static GameAllocTagCounters GameAllocCounters_[MAX_GAMEALLOCTAGS];
+static GameAllocCallSite GameAllocCallSites_[GAMEALLOC_NUMCALLSITES];
+static std::atomic<unsigned> GameAllocLostCallSites_;
+
+static thread_local int GameAllocTag_ = GAMEALLOC_OTHER;
+static thread_local int GameNoAllocDepth_ = 0;
+static thread_local const char* GameNoAllocName_ = 0;
+static thread_local unsigned GameNoAllocCount_ = 0;
+static thread_local const void* GameNoAllocCallSite_ = 0;
+static thread_local unsigned GameAllocThreadCount_ = 0;
+
+static String GetCallSiteName(const void* address)
+{
+#ifdef GAMEALLOC_SYMBOLS
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_sname)
+    {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, 0, 0, &status);
+        String name(status == 0 && demangled ? demangled : info.dli_sname);
+        free(demangled);
+        return ToString("%s+0x%x", name.CString(), (unsigned)((const char*)address - (const char*)info.dli_saddr));
+    }
+#endif
+    return ToString("%p", address);
+}
+
+#ifdef ACTIVE_GAMEALLOCTRACKER
+
+static void RecordCallSite(const void* caller, size_t size, int tag)
+{
+    const uintptr_t address = (uintptr_t)caller;
+    unsigned index = (unsigned)((address >> 4) * 2654435761U) % GAMEALLOC_NUMCALLSITES;
+
+    for (unsigned i = 0; i < GAMEALLOC_CALLSITEPROBES; i++, index = (index + 1) % GAMEALLOC_NUMCALLSITES)
+    {
+        GameAllocCallSite& site = GameAllocCallSites_[index];
+        uintptr_t current = site.address_.load(std::memory_order_relaxed);
+        if (current != address)
+        {
+            if (current != 0)
+                continue;
+            if (!site.address_.compare_exchange_strong(current, address, std::memory_order_relaxed) && current != address)
+                continue;
+            site.tag_.store(tag, std::memory_order_relaxed);
+        }
+
+        site.count_.fetch_add(1, std::memory_order_relaxed);
+        site.bytes_.fetch_add(size, std::memory_order_relaxed);
+        return;
+    }
+
+    GameAllocLostCallSites_.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* GameAllocate(size_t size, const void* caller)
+{
+    GameAllocHeader* header = (GameAllocHeader*)malloc(size + GAMEALLOC_HEADERSIZE);
+    if (!header)
+        return 0;
+
+    GameAllocThreadCount_++;
+
+    header->size_ = size;
+    header->tag_ = GameAllocTag_;
+    header->magic_ = GAMEALLOC_MAGIC;
+    header->tracked_ = GameAllocEnabled_.load(std::memory_order_relaxed);
+
+    if (header->tracked_)
+    {
+        GameAllocTagCounters& counters = GameAllocCounters_[header->tag_];
+        counters.liveBytes_.fetch_add(size, std::memory_order_relaxed);
+        counters.liveCount_.fetch_add(1, std::memory_order_relaxed);
+        counters.totalBytes_.fetch_add(size, std::memory_order_relaxed);
+        counters.totalCount_.fetch_add(1, std::memory_order_relaxed);
+
+        RecordCallSite(caller, size, header->tag_);
+
+        // no log here (it allocates) : reported at the end of the region
+        if (GameNoAllocDepth_ && !GameNoAllocCount_++)
+            GameNoAllocCallSite_ = caller;
+    }
+
+    return (char*)header + GAMEALLOC_HEADERSIZE;
+}
+
+static void GameFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    GameAllocHeader* header = (GameAllocHeader*)((char*)ptr - GAMEALLOC_HEADERSIZE);
+    assert(header->magic_ == GAMEALLOC_MAGIC);
+
+    if (header->tracked_)
+    {
+        GameAllocTagCounters& counters = GameAllocCounters_[header->tag_];
+        counters.liveBytes_.fetch_sub(header->size_, std::memory_order_relaxed);
+        counters.liveCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    free(header);
+}
+
+void* operator new(size_t size)
+{
+    void* ptr = GameAllocate(size, __builtin_return_address(0));
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    void* ptr = GameAllocate(size, __builtin_return_address(0));
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return GameAllocate(size, __builtin_return_address(0));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return GameAllocate(size, __builtin_return_address(0));
+}
+
+void operator delete(void* ptr) noexcept { GameFree(ptr); }
+void operator delete[](void* ptr) noexcept { GameFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { GameFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { GameFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { GameFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { GameFree(ptr); }
+
+#endif
+
+
+GameAllocTracker* GameAllocTracker::tracker_ = 0;
+bool GameAllocTracker::budgetAssert_ = false;
+std::atomic<unsigned> GameAllocTracker::numViolations_(0);
+
+GameAllocTracker::GameAllocTracker(Context* context) :
+    Object(context),
+    lastCount_(0),
+    lastBytes_(0)
+{
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(GameAllocTracker, HandleEndFrame));
+}
+
+GameAllocTracker::~GameAllocTracker()
+{
+    if (IsEnabled())
+        URHO3D_LOGINFOF("GameAllocTracker() - ~GameAllocTracker :\n%s", GetReport().CString());
+}
+
+void GameAllocTracker::Reset(Context* context)
+{
+    if (tracker_)
+    {
+        delete tracker_;
+        tracker_ = 0;
+        SetEnabled(false);
+    }
+
+#ifdef ACTIVE_GAMEALLOCTRACKER
+    if (context)
+    {
+        tracker_ = new GameAllocTracker(context);
+        SetBudgetAssert(GameStatics::gameConfig_.allocBudgetAssert_);
+        SetEnabled(GameStatics::gameConfig_.allocTrackerEnabled_);
+    }
+#endif
+}
+
+void GameAllocTracker::SetEnabled(bool enable)
+{
+    GameAllocEnabled_.store(enable, std::memory_order_relaxed);
+
+    if (tracker_)
+    {
+        GameAllocStats stats;
+        GetTotalStats(stats);
+        tracker_->lastCount_ = stats.totalCount_;
+        tracker_->lastBytes_ = stats.totalBytes_;
+    }
+
+    URHO3D_LOGINFOF("GameAllocTracker() - SetEnabled : %s budgetAssert=%s", enable ? "true" : "false", budgetAssert_ ? "true" : "false");
+}
+
+bool GameAllocTracker::IsEnabled()
+{
+    return GameAllocEnabled_.load(std::memory_order_relaxed);
+}
+
+void GameAllocTracker::GetStats(GameAllocTag tag, GameAllocStats& stats)
+{
+    const GameAllocTagCounters& counters = GameAllocCounters_[tag];
+    stats.liveBytes_ = counters.liveBytes_.load(std::memory_order_relaxed);
+    stats.liveCount_ = counters.liveCount_.load(std::memory_order_relaxed);
+    stats.totalBytes_ = counters.totalBytes_.load(std::memory_order_relaxed);
+    stats.totalCount_ = counters.totalCount_.load(std::memory_order_relaxed);
+}
+
+void GameAllocTracker::GetTotalStats(GameAllocStats& stats)
+{
+    memset(&stats, 0, sizeof(GameAllocStats));
+
+    for (int i = 0; i < MAX_GAMEALLOCTAGS; i++)
+    {
+        GameAllocStats tagstats;
+        GetStats((GameAllocTag)i, tagstats);
+        stats.liveBytes_ += tagstats.liveBytes_;
+        stats.liveCount_ += tagstats.liveCount_;
+        stats.totalBytes_ += tagstats.totalBytes_;
+        stats.totalCount_ += tagstats.totalCount_;
+    }
+}
+
+String GameAllocTracker::GetReport(unsigned numcallsites)
+{
+    String report;
+    // String::AppendWithFormat has no field width and no long long : use vsprintf
+    GameHelpers::AppendBufferToString(report, "%-12s %12s %10s %14s %12s\n", "tag", "livebytes", "livecount", "totalbytes", "totalcount");
+    for (int i = 0; i < MAX_GAMEALLOCTAGS; i++)
+    {
+        GameAllocStats stats;
+        GetStats((GameAllocTag)i, stats);
+        GameHelpers::AppendBufferToString(report, "%-12s %12lld %10lld %14llu %12llu\n", GameAllocTagNames_[i], stats.liveBytes_, stats.liveCount_, stats.totalBytes_, stats.totalCount_);
+    }
+
+    // top call sites by count
+    PODVector<unsigned> top;
+    for (unsigned i = 0; i < GAMEALLOC_NUMCALLSITES; i++)
+    {
+        if (!GameAllocCallSites_[i].address_.load(std::memory_order_relaxed))
+            continue;
+
+        const unsigned count = GameAllocCallSites_[i].count_.load(std::memory_order_relaxed);
+        unsigned j = top.Size();
+        while (j > 0 && GameAllocCallSites_[top[j-1]].count_.load(std::memory_order_relaxed) < count)
+            j--;
+        if (j < numcallsites)
+        {
+            top.Insert(j, i);
+            if (top.Size() > numcallsites)
+                top.Pop();
+        }
+    }
+
+    report.AppendWithFormat("top call sites (lost=%u) :\n", GameAllocLostCallSites_.load(std::memory_order_relaxed));
+    for (unsigned i = 0; i < top.Size(); i++)
+    {
+        const GameAllocCallSite& site = GameAllocCallSites_[top[i]];
+        GameHelpers::AppendBufferToString(report, "  %10u allocs %12llu bytes %-10s ", site.count_.load(std::memory_order_relaxed), site.bytes_.load(std::memory_order_relaxed),
+                                          GameAllocTagNames_[site.tag_.load(std::memory_order_relaxed)]);
+        // the name of the call site can be longer than the buffer of AppendBufferToString
+        report.Append(GetCallSiteName((const void*)site.address_.load(std::memory_order_relaxed)));
+        report.Append('\n');
+    }
+
+    report.AppendWithFormat("zero-alloc regions violations=%u", GetNumNoAllocViolations());
+
+    return report;
+}
+
+unsigned GameAllocTracker::GetThreadAllocations()
+{
+    return GameAllocThreadCount_;
+}
+
+int GameAllocTracker::SetTag(int tag)
+{
+    const int previous = GameAllocTag_;
+    GameAllocTag_ = tag;
+    return previous;
+}
+
+void GameAllocTracker::BeginNoAlloc(const char* name)
+{
+    if (!GameNoAllocDepth_++)
+    {
+        GameNoAllocName_ = name;
+        GameNoAllocCount_ = 0;
+        GameNoAllocCallSite_ = 0;
+    }
+}
+
+void GameAllocTracker::EndNoAlloc()
+{
+    if (--GameNoAllocDepth_ || !GameNoAllocCount_)
+        return;
+
+    // the regions run on the worker threads too
+    numViolations_.fetch_add(1, std::memory_order_relaxed);
+
+    // budget assert mode : the run fails at exit (GetExitCode), in release builds too
+    URHO3D_LOGERRORF("GameAllocTracker() - EndNoAlloc : %u allocation(s) in the zero-alloc region %s (first at %s)%s !",
+                     GameNoAllocCount_, GameNoAllocName_, GetCallSiteName(GameNoAllocCallSite_).CString(), budgetAssert_ ? " => budget failure" : "");
+
+    GameNoAllocCount_ = 0;
+}
+
+const char* GameAllocTracker::GetTagName(int tag)
+{
+    return tag >= 0 && tag < MAX_GAMEALLOCTAGS ? GameAllocTagNames_[tag] : "";
+}
+
+void GameAllocTracker::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (!IsEnabled())
+        return;
+
+    GameAllocStats stats;
+    GetTotalStats(stats);
+
+    GAMEPROFILE_COUNT(Allocations, (unsigned)(stats.totalCount_ - lastCount_));
+    GAMEPROFILE_COUNT(AllocatedBytes, (unsigned)(stats.totalBytes_ - lastBytes_));
+
+    lastCount_ = stats.totalCount_;
+    lastBytes_ = stats.totalBytes_;
+}
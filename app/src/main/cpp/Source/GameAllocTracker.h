@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+
+#include <Urho3D/Core/Object.h>
+
+#include "GameOptions.h"
+
+using namespace Urho3D;
+
+
+/// Game Allocation Tracker (ACTIVE_GAMEALLOCTRACKER)
+/// Replaces the global operator new/delete : each allocation has a small header (size, tag) and,
+/// when the tracker is enabled (GameConfig::allocTrackerEnabled_), is counted by tag and by call site.
+/// GAMEALLOC_SCOPE(tag) : the allocations of the scope are tagged (the inner scope wins).
+/// GAMEALLOC_NOALLOC(name) : a zero-alloc region, any allocation inside is logged as an error (and fails the run in budget assert mode).
+/// The tag and the regions are by thread : a work item sets its own scope.
+/// Each frame, the numbers of allocations and allocated bytes go to the GameProfiler counters "Allocations" and "AllocatedBytes".
+#ifdef ACTIVE_GAMEALLOCTRACKER
+#define GAMEALLOC_SCOPE(tag) GameAllocScope gameAllocScope_(tag)
+#define GAMEALLOC_NOALLOC(name) GameNoAllocRegion gameNoAllocRegion_(name)
+#else
+#define GAMEALLOC_SCOPE(tag)
+#define GAMEALLOC_NOALLOC(name)
+#endif
+
+enum GameAllocTag
+{
+    GAMEALLOC_OTHER = 0,
+    GAMEALLOC_MATCHES,
+    GAMEALLOC_OBJECTPOOL,
+    GAMEALLOC_UI,
+    GAMEALLOC_NETWORK,
+    GAMEALLOC_ANIMATION,
+    MAX_GAMEALLOCTAGS
+};
+
+struct GameAllocStats
+{
+    long long liveBytes_;
+    long long liveCount_;
+    unsigned long long totalBytes_;
+    unsigned long long totalCount_;
+};
+
+class GameAllocTracker : public Object
+{
+    URHO3D_OBJECT(GameAllocTracker, Object);
+
+public:
+    GameAllocTracker(Context* context);
+    virtual ~GameAllocTracker();
+
+    static void Reset(Context* context=0);
+
+    static void SetEnabled(bool enable);
+    static bool IsEnabled();
+    /// frame budget assert mode : an allocation inside a zero-alloc region sets the exit code to EXIT_FAILURE
+    static void SetBudgetAssert(bool enable) { budgetAssert_ = enable; }
+    static int GetExitCode() { return budgetAssert_ && GetNumNoAllocViolations() ? EXIT_FAILURE : EXIT_SUCCESS; }
+
+    static void GetStats(GameAllocTag tag, GameAllocStats& stats);
+    static void GetTotalStats(GameAllocStats& stats);
+    static unsigned GetNumNoAllocViolations() { return numViolations_.load(std::memory_order_relaxed); }
+    /// number of allocations of the calling thread, counted even if the tracker is disabled (0 without ACTIVE_GAMEALLOCTRACKER)
+    static unsigned GetThreadAllocations();
+    static String GetReport(unsigned numcallsites=10);
+
+    /// used by GameAllocScope, GameNoAllocRegion
+    static int SetTag(int tag);
+    static void BeginNoAlloc(const char* name);
+    static void EndNoAlloc();
+
+    static const char* GetTagName(int tag);
+
+private:
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+
+    unsigned long long lastCount_, lastBytes_;
+
+    static GameAllocTracker* tracker_;
+    static bool budgetAssert_;
+    static std::atomic<unsigned> numViolations_;
+};
+
+class GameAllocScope
+{
+public:
+    GameAllocScope(int tag) : previous_(GameAllocTracker::SetTag(tag)) { }
+    ~GameAllocScope() { GameAllocTracker::SetTag(previous_); }
+
+private:
+    int previous_;
+};
+
+class GameNoAllocRegion
+{
+public:
+    GameNoAllocRegion(const char* name) { GameAllocTracker::BeginNoAlloc(name); }
+    ~GameNoAllocRegion() { GameAllocTracker::EndNoAlloc(); }
+};
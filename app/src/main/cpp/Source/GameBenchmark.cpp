@@ -0,0 +1,884 @@
+#include <cstdio>
+
+#include <Urho3D/ThirdParty/PugiXml/pugixml.hpp>
+
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/UI/BorderImage.h>
+#include <Urho3D/Graphics/Material.h>
+#include <Urho3D/Urho2D/AnimationSet2D.h>
+#include <Urho3D/Urho2D/BatchBuilder2D.h>
+#include <Urho3D/Urho2D/ParticleEffect2D.h>
+#include <Urho3D/Urho2D/ParticleEmitter2D.h>
+#include <Urho3D/Urho2D/SpriterInstance2D.h>
+
+#include "GameEvents.h"
+#include "GameStatics.h"
+#include "GameStateManager.h"
+#include "GameProfiler.h"
+#include "GameTest.h"
+
+#include "sCinematic.h"
+
+#include "GameBenchmark.h"
+
+
+#define BENCHMARK_SWITCHDELAY (SWITCHSCREENTIME + 1.5f)
+#define BENCHMARK_DEFAULTTIMEOUT 120.f
+#define BENCHMARK_DEFAULTTOLERANCE_TIME 0.2f
+#define BENCHMARK_DEFAULTTOLERANCE_ALLOC 0.2f
+#define BENCHMARK_DEFAULTTOLERANCE_MEMORY 0.1f
+#define BENCHMARK_PARTICLEFRAMES 600
+#define BENCHMARK_PARTICLEWARMUP 60
+#define BENCHMARK_BATCHFRAMES 600
+#define BENCHMARK_BATCHMATERIALS 8
+#define BENCHMARK_BATCHLAYERS 4
+#define BENCHMARK_ANIMATIONFRAMES 600
+
+const String BENCHMARK_BASELINE("Data/Tests/benchmark_baseline.xml");
+const String BENCHMARK_OUTPUT("benchmark.json");
+const String BENCHMARK_PARTICLEEFFECT("Particules/fire.pex");
+const String BENCHMARK_ANIMATIONSETS("2D/boss01/boss01.scml;2D/boss07/boss07.scml;2D/eleceffect.scml;Cinematic/Constellation01/play01.scml");
+
+
+GameBenchmark* GameBenchmark::benchmark_ = 0;
+String GameBenchmark::scenarioFile_;
+String GameBenchmark::baselineFile_;
+String GameBenchmark::outputFile_;
+bool GameBenchmark::updateBaseline_ = false;
+int GameBenchmark::exitCode_ = EXIT_SUCCESS;
+
+GameBenchmark::GameBenchmark(Context* context) :
+    Object(context),
+    iscenario_(0),
+    state_(BENCH_SWITCHSTATE)
+{ }
+
+GameBenchmark::~GameBenchmark()
+{ }
+
+bool GameBenchmark::Start(Context* context)
+{
+    if (benchmark_)
+        return false;
+
+    if (baselineFile_.Empty())
+        baselineFile_ = GameStatics::gameConfig_.appDir_ + BENCHMARK_BASELINE;
+    if (outputFile_.Empty())
+        outputFile_ = GameStatics::gameConfig_.saveDir_ + BENCHMARK_OUTPUT;
+
+    benchmark_ = new GameBenchmark(context);
+    if (!benchmark_->LoadScenarios(scenarioFile_))
+    {
+        URHO3D_LOGERRORF("GameBenchmark() - Start : can't load the scenarios %s !", scenarioFile_.CString());
+        exitCode_ = EXIT_FAILURE;
+        GameStatics::Exit();
+        return false;
+    }
+
+    URHO3D_LOGINFOF("GameBenchmark() - Start : scenarios=%s(%u) baseline=%s output=%s",
+                    scenarioFile_.CString(), benchmark_->scenarios_.Size(), baselineFile_.CString(), outputFile_.CString());
+
+    GameProfiler::SetEnabled(true);
+
+    // subscribe first : a scenario can end in StartScenario
+    benchmark_->SubscribeToEvent(E_UPDATE, new EventHandlerImpl<GameBenchmark>(benchmark_, &GameBenchmark::HandleUpdate));
+    benchmark_->StartScenario();
+
+    return true;
+}
+
+void GameBenchmark::Stop()
+{
+    if (benchmark_)
+    {
+        delete benchmark_;
+        benchmark_ = 0;
+    }
+}
+
+bool GameBenchmark::LoadScenarios(const String& filename)
+{
+    pugi::xml_document doc;
+    if (doc.load_file(filename.CString()).status != pugi::status_ok)
+        return false;
+
+    for (pugi::xml_node node = doc.first_child().child("scenario"); node; node = node.next_sibling("scenario"))
+    {
+        scenarios_.Resize(scenarios_.Size()+1);
+        BenchmarkScenario& scenario = scenarios_.Back();
+        scenario.name_ = node.attribute("name").value();
+        scenario.record_ = node.attribute("record").value();
+        scenario.state_ = node.attribute("state").empty() ? "MainMenu" : node.attribute("state").value();
+        scenario.level_ = node.attribute("level").as_int(0);
+        scenario.warmup_ = node.attribute("warmup").as_float(0.f);
+        scenario.timeout_ = node.attribute("timeout").as_float(BENCHMARK_DEFAULTTIMEOUT);
+    }
+
+    return scenarios_.Size() > 0;
+}
+
+void GameBenchmark::StartScenario()
+{
+    const BenchmarkScenario& scenario = scenarios_[iscenario_];
+
+    URHO3D_LOGINFOF("GameBenchmark() - StartScenario : %s record=%s state=%s level=%d ...", scenario.name_.CString(), scenario.record_.CString(), scenario.state_.CString(), scenario.level_);
+
+    state_ = BENCH_SWITCHSTATE;
+    timer_.Reset();
+
+    GameStateManager* stateManager = GameStateManager::Get();
+    if (scenario.state_ == "Cinematic")
+    {
+        // the intro of the zone of the level, back to the MainMenu at the end
+        GameStatics::SetLevel(scenario.level_ > 0 ? scenario.level_ : 1);
+        stateManager->ClearStack();
+        if (!CinematicState::SetCinematic(CINEMATICSELECTIONMODE_REPLAY, GameStatics::currentLevel_, GameStatics::currentLevel_, "MainMenu"))
+        {
+            URHO3D_LOGERRORF("GameBenchmark() - StartScenario : %s no cinematic for the level %d !", scenario.name_.CString(), GameStatics::currentLevel_);
+            EndScenario(false);
+        }
+    }
+    else if (scenario.level_ > 0 || stateManager->GetActiveState()->GetStateId() != scenario.state_)
+    {
+        // same as MenuState::GoLevel
+        if (scenario.level_ > 0)
+        {
+            GameStatics::ResetGameStates();
+            GameStatics::currentLevelDatas_ = 0;
+            GameStatics::SetLevel(scenario.level_);
+        }
+
+        stateManager->ClearStack();
+        stateManager->PushToStack(scenario.state_);
+        SendEvent(SPLASHSCREEN_STOP);
+    }
+}
+
+void GameBenchmark::EndScenario(bool completed)
+{
+    const BenchmarkScenario& scenario = scenarios_[iscenario_];
+
+    results_.Resize(results_.Size()+1);
+    BenchmarkResult& result = results_.Back();
+    result.name_ = scenario.name_;
+    result.completed_ = completed;
+    result.frames_ = GameProfiler::GetNumFrames();
+
+    const int framescope = GameProfiler::GetFrameScope();
+    const GameProfileScope& frame = GameProfiler::GetScopeData(framescope);
+    result.mean_ = result.frames_ ? (float)((double)frame.total_ / result.frames_) : 0.f;
+    result.p50_ = GameProfiler::GetRunPercentile(framescope, 50.f);
+    result.p95_ = GameProfiler::GetRunPercentile(framescope, 95.f);
+    result.p99_ = GameProfiler::GetRunPercentile(framescope, 99.f);
+    result.max_ = frame.max_;
+
+    const int allocscope = GameProfiler::GetScope("Allocations");
+    result.allocations_ = allocscope != -1 && result.frames_ ? (float)((double)GameProfiler::GetScopeData(allocscope).total_ / result.frames_) : 0.f;
+    result.peakMemory_ = GetPeakMemory();
+
+    URHO3D_LOGINFOF("GameBenchmark() - EndScenario : %s %s frames=%u mean=%fus p50=%uus p95=%uus p99=%uus max=%uus allocations/frame=%f peakmemory=%ukB",
+                    result.name_.CString(), completed ? "completed" : "NOT COMPLETED", result.frames_, result.mean_,
+                    result.p50_, result.p95_, result.p99_, result.max_, result.allocations_, result.peakMemory_);
+
+    iscenario_++;
+    if (iscenario_ < scenarios_.Size())
+        StartScenario();
+    else
+        Finish();
+}
+
+void GameBenchmark::Finish()
+{
+    UnsubscribeFromAllEvents();
+
+    WriteResults(outputFile_);
+
+    bool success = true;
+    for (unsigned i = 0; i < results_.Size(); i++)
+        if (!results_[i].completed_)
+            success = false;
+
+    if (updateBaseline_)
+    {
+        success = WriteBaseline(baselineFile_) && success;
+    }
+    else if (GetSubsystem<FileSystem>()->FileExists(baselineFile_))
+    {
+        success = Compare(baselineFile_) && success;
+    }
+    else
+    {
+        URHO3D_LOGERRORF("GameBenchmark() - Finish : no baseline %s (use -benchmarkupdatebaseline to write it) !", baselineFile_.CString());
+        success = false;
+    }
+
+    exitCode_ = success ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    URHO3D_LOGINFOF("GameBenchmark() - Finish : %s", success ? "OK !" : "REGRESSION !");
+
+    GameStatics::Exit();
+}
+
+bool GameBenchmark::Compare(const String& filename)
+{
+    pugi::xml_document doc;
+    if (doc.load_file(filename.CString()).status != pugi::status_ok)
+    {
+        URHO3D_LOGERRORF("GameBenchmark() - Compare : can't load the baseline %s !", filename.CString());
+        return false;
+    }
+
+    pugi::xml_node root = doc.first_child();
+    const float timetolerance = root.attribute("time").as_float(BENCHMARK_DEFAULTTOLERANCE_TIME);
+    const float alloctolerance = root.attribute("allocations").as_float(BENCHMARK_DEFAULTTOLERANCE_ALLOC);
+    const float memorytolerance = root.attribute("memory").as_float(BENCHMARK_DEFAULTTOLERANCE_MEMORY);
+
+    unsigned numregressions = 0;
+    for (unsigned i = 0; i < results_.Size(); i++)
+    {
+        const BenchmarkResult& result = results_[i];
+        pugi::xml_node node = root.find_child_by_attribute("scenario", "name", result.name_.CString());
+        if (!node)
+        {
+            URHO3D_LOGWARNINGF("GameBenchmark() - Compare : %s not in the baseline !", result.name_.CString());
+            continue;
+        }
+
+        const char* names[] = { "p50", "p95", "p99", "allocations", "peakmemory" };
+        const float values[] = { (float)result.p50_, (float)result.p95_, (float)result.p99_, result.allocations_, (float)result.peakMemory_ };
+        const float tolerances[] = { timetolerance, timetolerance, timetolerance, alloctolerance, memorytolerance };
+
+        for (unsigned j = 0; j < 5; j++)
+        {
+            const float reference = node.attribute(names[j]).as_float(0.f);
+            // no reference or no measure (allocations, peak memory not available)
+            if (reference <= 0.f || values[j] <= 0.f)
+                continue;
+
+            if (values[j] > reference * (1.f + tolerances[j]))
+            {
+                URHO3D_LOGERRORF("GameBenchmark() - Compare : %s %s=%f baseline=%f (+%f%% > %f%%) REGRESSION !",
+                                 result.name_.CString(), names[j], values[j], reference, (values[j] / reference - 1.f) * 100.f, tolerances[j] * 100.f);
+                numregressions++;
+            }
+        }
+    }
+
+    return numregressions == 0;
+}
+
+static void SetBaselineValue(pugi::xml_node node, const char* name, float value)
+{
+    pugi::xml_attribute attribute = node.attribute(name);
+    if (!attribute)
+        attribute = node.append_attribute(name);
+    attribute = value;
+}
+
+bool GameBenchmark::WriteBaseline(const String& filename) const
+{
+    // update the measured scenarios in the existing baseline : keep its comments, tolerances and the other scenarios
+    pugi::xml_document doc;
+    if (doc.load_file(filename.CString(), pugi::parse_default | pugi::parse_comments).status != pugi::status_ok)
+        doc.reset();
+
+    pugi::xml_node root = doc.child("baseline");
+    if (!root)
+    {
+        root = doc.append_child("baseline");
+        root.append_attribute("time") = BENCHMARK_DEFAULTTOLERANCE_TIME;
+        root.append_attribute("allocations") = BENCHMARK_DEFAULTTOLERANCE_ALLOC;
+        root.append_attribute("memory") = BENCHMARK_DEFAULTTOLERANCE_MEMORY;
+    }
+
+    for (unsigned i = 0; i < results_.Size(); i++)
+    {
+        const BenchmarkResult& result = results_[i];
+        if (!result.completed_)
+            continue;
+
+        pugi::xml_node node = root.find_child_by_attribute("scenario", "name", result.name_.CString());
+        if (!node)
+        {
+            node = root.append_child("scenario");
+            node.append_attribute("name") = result.name_.CString();
+        }
+        SetBaselineValue(node, "p50", (float)result.p50_);
+        SetBaselineValue(node, "p95", (float)result.p95_);
+        SetBaselineValue(node, "p99", (float)result.p99_);
+        SetBaselineValue(node, "allocations", result.allocations_);
+        SetBaselineValue(node, "peakmemory", (float)result.peakMemory_);
+    }
+
+    if (!doc.save_file(filename.CString()))
+    {
+        URHO3D_LOGERRORF("GameBenchmark() - WriteBaseline : can't write %s !", filename.CString());
+        return false;
+    }
+
+    URHO3D_LOGINFOF("GameBenchmark() - WriteBaseline : %s", filename.CString());
+    return true;
+}
+
+bool GameBenchmark::WriteResults(const String& filename) const
+{
+    File file(context_, filename, FILE_WRITE);
+    if (!file.IsOpen())
+    {
+        URHO3D_LOGERRORF("GameBenchmark() - WriteResults : can't open %s !", filename.CString());
+        return false;
+    }
+
+    file.WriteLine("{\n  \"scenarios\": [");
+    for (unsigned i = 0; i < results_.Size(); i++)
+    {
+        const BenchmarkResult& result = results_[i];
+        file.WriteLine(ToString("    { \"name\": \"%s\", \"completed\": %s, \"frames\": %u, \"mean\": %f, \"p50\": %u, \"p95\": %u, \"p99\": %u, \"max\": %u,"
+                                " \"allocationsPerFrame\": %f, \"peakMemoryKB\": %u }%s",
+                                result.name_.CString(), result.completed_ ? "true" : "false", result.frames_, result.mean_,
+                                result.p50_, result.p95_, result.p99_, result.max_, result.allocations_, result.peakMemory_,
+                                i+1 < results_.Size() ? "," : ""));
+    }
+    file.WriteLine("  ]\n}");
+
+    URHO3D_LOGINFOF("GameBenchmark() - WriteResults : %s", filename.CString());
+    return true;
+}
+
+void GameBenchmark::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    const BenchmarkScenario& scenario = scenarios_[iscenario_];
+    InputPlayer* player = InputPlayer::Get();
+
+    if (state_ == BENCH_SWITCHSTATE)
+    {
+        if (timer_.GetMSec(false) < BENCHMARK_SWITCHDELAY * 1000.f)
+            return;
+
+        player->StartFile(scenario.record_);
+        if (!player->IsPlaying())
+        {
+            URHO3D_LOGERRORF("GameBenchmark() - HandleUpdate : %s can't play the record %s !", scenario.name_.CString(), scenario.record_.CString());
+            EndScenario(false);
+            return;
+        }
+
+        state_ = BENCH_WARMUP;
+        timer_.Reset();
+        GameProfiler::ResetStats();
+        ResetPeakMemory();
+        return;
+    }
+
+    if (state_ == BENCH_WARMUP && timer_.GetMSec(false) >= scenario.warmup_ * 1000.f)
+    {
+        state_ = BENCH_PLAYING;
+        GameProfiler::ResetStats();
+        ResetPeakMemory();
+    }
+
+    if (!player->IsPlaying())
+    {
+        EndScenario(true);
+    }
+    else if (timer_.GetMSec(false) >= scenario.timeout_ * 1000.f)
+    {
+        URHO3D_LOGERRORF("GameBenchmark() - HandleUpdate : %s timeout !", scenario.name_.CString());
+        player->Stop();
+        EndScenario(false);
+    }
+}
+
+/// Peak resident memory (kB) since the last reset : linux only
+unsigned GameBenchmark::GetPeakMemory()
+{
+    unsigned peak = 0;
+#if defined(__linux__)
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file)
+    {
+        char line[128];
+        while (fgets(line, sizeof(line), file))
+        {
+            if (sscanf(line, "VmHWM: %u kB", &peak) == 1)
+                break;
+        }
+        fclose(file);
+    }
+#endif
+    return peak;
+}
+
+void GameBenchmark::ResetPeakMemory()
+{
+#if defined(__linux__)
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file)
+    {
+        fputs("5", file);
+        fclose(file);
+    }
+#endif
+}
+
+
+int GameBenchmark::RunParticles(Context* context, const Vector<String>& arguments)
+{
+    unsigned numemitters = 100;
+    unsigned numframes = BENCHMARK_PARTICLEFRAMES;
+    String effectname = BENCHMARK_PARTICLEEFFECT;
+
+    for (unsigned i=0; i+1 < arguments.Size(); i++)
+    {
+        if (arguments[i] == "-benchparticles")
+            numemitters = Max(1U, ToUInt(arguments[i+1]));
+        else if (arguments[i] == "-benchparticleframes")
+            numframes = Max(1U, ToUInt(arguments[i+1]));
+        else if (arguments[i] == "-benchparticleeffect")
+            effectname = arguments[i+1];
+    }
+
+    ParticleEffect2D* effect = context->GetSubsystem<ResourceCache>()->GetResource<ParticleEffect2D>(effectname);
+    if (!effect)
+    {
+        PrintLine(ToString("ParticleBenchmark : no effect %s !", effectname.CString()), true);
+        return EXIT_FAILURE;
+    }
+
+    SharedPtr<Scene> scene(new Scene(context));
+    PODVector<ParticleEmitter2D*> emitters(numemitters);
+    for (unsigned i=0; i < numemitters; i++)
+    {
+        Node* node = scene->CreateChild("Emitter", LOCAL);
+        node->SetPosition2D(Vector2(Random(-10.f, 10.f), Random(-10.f, 10.f)));
+        emitters[i] = node->CreateComponent<ParticleEmitter2D>(LOCAL);
+        emitters[i]->SetEffect(effect);
+    }
+
+    const float timestep = 1.f / 60.f;
+
+    // fill the emitters
+    for (unsigned frame=0; frame < BENCHMARK_PARTICLEWARMUP; frame++)
+        scene->Update(timestep);
+
+    unsigned long long numparticles = 0;
+    long long updatetime = 0;
+    long long batchtime = 0;
+    HiresTimer timer;
+
+    for (unsigned frame=0; frame < numframes; frame++)
+    {
+        timer.Reset();
+        scene->Update(timestep);
+        updatetime += timer.GetUSec(true);
+
+        for (unsigned i=0; i < numemitters; i++)
+            emitters[i]->GetSourceBatchesToRender();
+        batchtime += timer.GetUSec(false);
+
+        for (unsigned i=0; i < numemitters; i++)
+            numparticles += emitters[i]->GetNumParticles();
+    }
+
+    PrintLine(ToString("ParticleBenchmark : effect=%s emitters=%u frames=%u particles/frame=%f",
+                       effectname.CString(), numemitters, numframes, (double)numparticles / numframes));
+    PrintLine(ToString("ParticleBenchmark : update=%f particles/ms vertices=%f particles/ms",
+                       updatetime ? numparticles * 1000.0 / updatetime : 0.0, batchtime ? numparticles * 1000.0 / batchtime : 0.0));
+
+    return EXIT_SUCCESS;
+}
+
+
+static void SetBenchBatch(SourceBatch2D& batch, Material* material, unsigned tag)
+{
+    batch.material_ = material;
+    batch.drawOrder_ = Random(BENCHMARK_BATCHLAYERS) << 20;
+    batch.quadvertices_ = Random(4) != 0;
+    batch.vertices_.Resize(batch.quadvertices_ ? 4 * (1 + Random(4)) : 3 * (1 + Random(4)));
+    for (unsigned i=0; i < batch.vertices_.Size(); i++)
+    {
+        Vertex2D& vertex = batch.vertices_[i];
+        vertex.position_ = Vector3(Random(-10.f, 10.f), Random(-10.f, 10.f), 0.f);
+        vertex.color_ = tag + i;
+        vertex.uv_ = Vector2(Random(1.f), Random(1.f));
+    }
+}
+
+static bool CheckBenchBatches(const BatchBuilder2D& builder, unsigned frame)
+{
+    const PODVector<const SourceBatch2D*>& batches = builder.GetSourceBatches();
+
+    // the sorted batches follow the sort keys and the packed storages hold their current vertices
+    unsigned vertexStart[2] = { 0, 0 };
+    for (unsigned b=0; b < batches.Size(); b++)
+    {
+        const SourceBatch2D* batch = batches[b];
+        if (b && BatchBuilder2D::GetSortKey(batches[b-1]) > BatchBuilder2D::GetSortKey(batch))
+        {
+            PrintLine(ToString("BatchBenchmark : frame=%u batch %u not sorted !", frame, b), true);
+            return false;
+        }
+
+        const int primitiveType = batch->quadvertices_;
+        const unsigned count = batch->vertices_.Size();
+        if (memcmp(builder.GetVertices(primitiveType) + vertexStart[primitiveType], batch->vertices_.Buffer(), count * sizeof(Vertex2D)) != 0)
+        {
+            PrintLine(ToString("BatchBenchmark : frame=%u batch %u stale vertices in the storage !", frame, b), true);
+            return false;
+        }
+        vertexStart[primitiveType] += count;
+    }
+
+    // the draw ranges are contiguous in each storage, one range per material change, and cover all the vertices/indices
+    unsigned indexStart[2] = { 0, 0 };
+    unsigned vertexEnd[2] = { 0, 0 };
+    unsigned b = 0;
+    const PODVector<DrawRange2D>& ranges = builder.GetDrawRanges();
+    for (unsigned r=0; r < ranges.Size(); r++)
+    {
+        const DrawRange2D& range = ranges[r];
+        const int primitiveType = range.primitiveType_;
+        if (range.indexStart_ != indexStart[primitiveType] || range.vertexStart_ != vertexEnd[primitiveType] ||
+            (r && ranges[r-1].material_ == range.material_ && ranges[r-1].primitiveType_ == primitiveType))
+        {
+            PrintLine(ToString("BatchBenchmark : frame=%u range %u not contiguous !", frame, r), true);
+            return false;
+        }
+
+        unsigned numVertices = 0;
+        while (b < batches.Size() && numVertices < range.vertexCount_)
+        {
+            if (batches[b]->material_ != range.material_ || batches[b]->quadvertices_ != primitiveType)
+            {
+                PrintLine(ToString("BatchBenchmark : frame=%u batch %u outside its range %u !", frame, b, r), true);
+                return false;
+            }
+            numVertices += batches[b++]->vertices_.Size();
+        }
+        if (numVertices != range.vertexCount_ || range.indexCount_ != (primitiveType == QUAD2D ? numVertices * 6 / 4 : numVertices))
+        {
+            PrintLine(ToString("BatchBenchmark : frame=%u range %u counts mismatch !", frame, r), true);
+            return false;
+        }
+
+        indexStart[primitiveType] += range.indexCount_;
+        vertexEnd[primitiveType] += range.vertexCount_;
+    }
+
+    for (int primitiveType=0; primitiveType < 2; primitiveType++)
+    {
+        if (indexStart[primitiveType] != builder.GetIndexCount(primitiveType) || vertexEnd[primitiveType] != builder.GetVertexCount(primitiveType) ||
+            vertexEnd[primitiveType] != vertexStart[primitiveType])
+        {
+            PrintLine(ToString("BatchBenchmark : frame=%u primitive=%d total counts mismatch !", frame, primitiveType), true);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int GameBenchmark::RunBatches(Context* context, const Vector<String>& arguments)
+{
+    unsigned numbatches = 1000;
+    unsigned numframes = BENCHMARK_BATCHFRAMES;
+    float changeratio = 0.05f;
+
+    for (unsigned i=0; i+1 < arguments.Size(); i++)
+    {
+        if (arguments[i] == "-benchbatches")
+            numbatches = Max(1U, ToUInt(arguments[i+1]));
+        else if (arguments[i] == "-benchbatchframes")
+            numframes = Max(1U, ToUInt(arguments[i+1]));
+        else if (arguments[i] == "-benchbatchchanges")
+            changeratio = Clamp(ToFloat(arguments[i+1]), 0.f, 1.f);
+    }
+
+    SetRandomSeed(1);
+
+    Vector<SharedPtr<Material> > materials(BENCHMARK_BATCHMATERIALS);
+    for (unsigned i=0; i < materials.Size(); i++)
+    {
+        materials[i] = new Material(context);
+        materials[i]->SetName(ToString("BatchBenchmark%u", i));
+    }
+
+    // the source batches are never reallocated : a replaced batch reuses the address of the previous one
+    Vector<SourceBatch2D> batches(numbatches);
+    unsigned tag = 0;
+    for (unsigned i=0; i < numbatches; i++, tag += 16)
+        SetBenchBatch(batches[i], materials[Random((int)materials.Size())], tag);
+
+    BatchBuilder2D builder;
+    const unsigned numchanges = (unsigned)(numbatches * changeratio);
+
+    unsigned long long numvertices = 0;
+    unsigned long long numcopied = 0;
+    unsigned long long numsortmoves = 0;
+    unsigned numidlecopied = 0;
+    unsigned numidlesortmoves = 0;
+    long long buildtime = 0;
+    bool ok = true;
+    HiresTimer timer;
+
+    unsigned frame = 0;
+    for (; frame < numframes && ok; frame++)
+    {
+        // every 4th frame is unchanged and must not copy any vertex
+        const bool idle = frame && (frame % 4) == 0;
+        if (!idle)
+        {
+            for (unsigned i=0; i < numchanges; i++, tag += 16)
+            {
+                SourceBatch2D& batch = batches[Random((int)numbatches)];
+                switch (Random(3))
+                {
+                // moved vertices
+                case 0:
+                    for (unsigned v=0; v < batch.vertices_.Size(); v++)
+                        batch.vertices_[v].color_ = tag + v;
+                    batch.version_ = SourceBatch2D::NextVersion();
+                    break;
+                // new sort key
+                case 1:
+                    batch.drawOrder_ = Random(BENCHMARK_BATCHLAYERS) << 20;
+                    batch.material_ = materials[Random((int)materials.Size())];
+                    break;
+                // replaced batch at the same address
+                default:
+                    batch = SourceBatch2D();
+                    SetBenchBatch(batch, materials[Random((int)materials.Size())], tag);
+                    break;
+                }
+            }
+        }
+
+        timer.Reset();
+        builder.Clear();
+        for (unsigned i=0; i < numbatches; i++)
+            builder.AddSourceBatch(&batches[i]);
+        builder.Build();
+        unsigned copied = builder.PackVertices(QUAD2D) + builder.PackVertices(TRIANGLE2D);
+        buildtime += timer.GetUSec(false);
+
+        numvertices += builder.GetVertexCount(QUAD2D) + builder.GetVertexCount(TRIANGLE2D);
+        numcopied += copied;
+        numsortmoves += builder.GetNumSortMoves();
+        if (idle)
+        {
+            numidlecopied += copied;
+            numidlesortmoves += builder.GetNumSortMoves();
+        }
+
+        ok = CheckBenchBatches(builder, frame);
+    }
+
+    if (ok && numidlecopied)
+    {
+        PrintLine(ToString("BatchBenchmark : %u vertices copied in the unchanged frames !", numidlecopied), true);
+        ok = false;
+    }
+
+    if (ok && numidlesortmoves)
+    {
+        PrintLine(ToString("BatchBenchmark : %u sort moves in the unchanged frames !", numidlesortmoves), true);
+        ok = false;
+    }
+
+    PrintLine(ToString("BatchBenchmark : batches=%u frames=%u changes/frame=%u vertices/frame=%f",
+                       numbatches, frame, numchanges, (double)numvertices / frame));
+    PrintLine(ToString("BatchBenchmark : build=%f us/frame sortmoves=%f/frame reused=%f%% %s",
+                       (double)buildtime / frame, (double)numsortmoves / frame,
+                       numvertices ? 100.0 * (numvertices - numcopied) / numvertices : 0.0, ok ? "ok" : "FAILED"));
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+struct BenchAnimation
+{
+    Spriter::SpriterInstance* instance_;
+    float speed_;
+    bool updated_;
+};
+
+static void UpdateBenchAnimationsWork(const WorkItem* item, unsigned threadIndex)
+{
+    BenchAnimation* start = reinterpret_cast<BenchAnimation*>(item->start_);
+    BenchAnimation* end = reinterpret_cast<BenchAnimation*>(item->end_);
+    const float timestep = *reinterpret_cast<const float*>(item->aux_);
+
+    while (start != end)
+    {
+        start->updated_ = start->instance_->Update(timestep * start->speed_);
+        start++;
+    }
+}
+
+// bitwise comparison of the results of two instances
+static bool IsSameBenchAnimation(const BenchAnimation& a, const BenchAnimation& b)
+{
+    if (a.updated_ != b.updated_ || a.instance_->GetCurrentTime() != b.instance_->GetCurrentTime())
+        return false;
+
+    const PODVector<Spriter::SpriteTimelineKey*>& spritekeysA = a.instance_->GetSpriteKeys();
+    const PODVector<Spriter::SpriteTimelineKey*>& spritekeysB = b.instance_->GetSpriteKeys();
+    if (spritekeysA.Size() != spritekeysB.Size())
+        return false;
+    for (unsigned i=0; i < spritekeysA.Size(); i++)
+    {
+        const Spriter::SpriteTimelineKey& keyA = *spritekeysA[i];
+        const Spriter::SpriteTimelineKey& keyB = *spritekeysB[i];
+        if (keyA.timeline_ != keyB.timeline_ || keyA.folderId_ != keyB.folderId_ || keyA.fileId_ != keyB.fileId_ || keyA.zIndex_ != keyB.zIndex_ ||
+            keyA.useDefaultPivot_ != keyB.useDefaultPivot_ || memcmp(&keyA.pivotX_, &keyB.pivotX_, sizeof(float)) || memcmp(&keyA.pivotY_, &keyB.pivotY_, sizeof(float)) ||
+            memcmp(&keyA.info_, &keyB.info_, sizeof(Spriter::SpatialInfo)))
+            return false;
+    }
+
+    const PODVector<Spriter::BoneTimelineKey*>& bonekeysA = a.instance_->GetBoneKeys();
+    const PODVector<Spriter::BoneTimelineKey*>& bonekeysB = b.instance_->GetBoneKeys();
+    if (bonekeysA.Size() != bonekeysB.Size())
+        return false;
+    for (unsigned i=0; i < bonekeysA.Size(); i++)
+    {
+        if (bonekeysA[i]->timeline_ != bonekeysB[i]->timeline_ || memcmp(&bonekeysA[i]->info_, &bonekeysB[i]->info_, sizeof(Spriter::SpatialInfo)))
+            return false;
+    }
+
+    return a.instance_->GetEventTriggers().Size() == b.instance_->GetEventTriggers().Size() &&
+           a.instance_->GetNodeTriggers().Size() == b.instance_->GetNodeTriggers().Size() &&
+           a.instance_->GetPhysicTriggers().Size() == b.instance_->GetPhysicTriggers().Size();
+}
+
+int GameBenchmark::RunAnimations(Context* context, const Vector<String>& arguments)
+{
+    unsigned numinstances = 1000;
+    unsigned numframes = BENCHMARK_ANIMATIONFRAMES;
+    String setnames = BENCHMARK_ANIMATIONSETS;
+
+    for (unsigned i=0; i+1 < arguments.Size(); i++)
+    {
+        if (arguments[i] == "-benchanimations")
+            numinstances = Max(1U, ToUInt(arguments[i+1]));
+        else if (arguments[i] == "-benchanimationframes")
+            numframes = Max(1U, ToUInt(arguments[i+1]));
+        else if (arguments[i] == "-benchanimationsets")
+            setnames = arguments[i+1];
+    }
+
+    ResourceCache* cache = context->GetSubsystem<ResourceCache>();
+    Vector<SharedPtr<AnimationSet2D> > animationsets;
+    Vector<String> names = setnames.Split(';');
+    for (unsigned i=0; i < names.Size(); i++)
+    {
+        AnimationSet2D* animationset = cache->GetResource<AnimationSet2D>(names[i]);
+        if (!animationset || !animationset->GetSpriterData())
+        {
+            PrintLine(ToString("AnimationBenchmark : no spriter animation set %s !", names[i].CString()), true);
+            return EXIT_FAILURE;
+        }
+        animationsets.Push(SharedPtr<AnimationSet2D>(animationset));
+    }
+
+    WorkQueue* queue = context->GetSubsystem<WorkQueue>();
+    if (!queue->GetNumThreads())
+        PrintLine("AnimationBenchmark : no worker thread, the parallel updates run on the main thread !", true);
+
+    const bool bakingenabled = Spriter::SpriterInstance::IsBakingEnabled();
+    const float timestep = 1.f / 60.f;
+    bool ok = true;
+
+    // the same instances updated serially on the main thread and in parallel on the WorkQueue (as Renderer2D does), live then baked
+    for (int baked=0; baked < 2 && ok; baked++)
+    {
+        Spriter::SpriterInstance::SetBakingEnabled(baked != 0);
+
+        PODVector<BenchAnimation> serial;
+        PODVector<BenchAnimation> parallel;
+        for (unsigned i=0; i < numinstances; i++)
+        {
+            Spriter::SpriterData* data = animationsets[i % animationsets.Size()]->GetSpriterData();
+            const unsigned variant = i / animationsets.Size();
+            const int entity = variant % data->entities_.Size();
+            const int animation = (variant / data->entities_.Size()) % data->entities_[entity]->animations_.Size();
+            const float speed = 0.5f + 0.25f * (i % 5);
+
+            for (int j=0; j < 2; j++)
+            {
+                BenchAnimation bench = { new Spriter::SpriterInstance(0, data), speed, false };
+                bench.instance_->SetEntity(entity);
+                bench.instance_->SetAnimation(animation);
+                (j ? parallel : serial).Push(bench);
+            }
+        }
+
+        long long serialtime = 0;
+        long long paralleltime = 0;
+        unsigned long long numupdated = 0;
+        HiresTimer timer;
+        float step = timestep;
+
+        unsigned frame = 0;
+        for (; frame < numframes && ok; frame++)
+        {
+            timer.Reset();
+            for (unsigned i=0; i < numinstances; i++)
+                serial[i].updated_ = serial[i].instance_->Update(step * serial[i].speed_);
+            serialtime += timer.GetUSec(true);
+
+            const unsigned numitems = Max(1U, queue->GetNumThreads());
+            const unsigned numperitem = (numinstances + numitems - 1) / numitems;
+            for (unsigned start=0; start < numinstances; start += numperitem)
+            {
+                SharedPtr<WorkItem> item = queue->GetFreeItem();
+                item->priority_ = M_MAX_UNSIGNED;
+                item->workFunction_ = UpdateBenchAnimationsWork;
+                item->start_ = &parallel[start];
+                item->end_ = &parallel[0] + Min(start + numperitem, numinstances);
+                item->aux_ = &step;
+                queue->AddWorkItem(item);
+            }
+            queue->Complete(M_MAX_UNSIGNED);
+            paralleltime += timer.GetUSec(false);
+
+            for (unsigned i=0; i < numinstances; i++)
+            {
+                numupdated += serial[i].updated_;
+                if (!IsSameBenchAnimation(serial[i], parallel[i]))
+                {
+                    PrintLine(ToString("AnimationBenchmark : %s frame=%u instance=%u (%s) serial and parallel results differ !",
+                                       baked ? "baked" : "live", frame, i, names[i % names.Size()].CString()), true);
+                    ok = false;
+                    break;
+                }
+            }
+
+            // a zero time step every 100 frames (as the visibility changes)
+            step = (frame % 100) == 99 ? 0.f : timestep;
+        }
+
+        PrintLine(ToString("AnimationBenchmark : %s instances=%u frames=%u threads=%u updated=%f/frame serial=%fus/frame parallel=%fus/frame %s",
+                           baked ? "baked" : "live", numinstances, frame, queue->GetNumThreads(), (double)numupdated / frame,
+                           (double)serialtime / frame, (double)paralleltime / frame, ok ? "ok" : "FAILED"));
+
+        for (unsigned i=0; i < numinstances; i++)
+        {
+            delete serial[i].instance_;
+            delete parallel[i].instance_;
+        }
+    }
+
+    Spriter::SpriterInstance::SetBakingEnabled(bakingenabled);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/Timer.h>
+
+using namespace Urho3D;
+
+
+/// Game Benchmark
+/// command line : -benchmark scenarios.xml [-benchmarkbaseline baseline.xml] [-benchmarkoutput results.json] [-benchmarkupdatebaseline]
+/// Replays the InputPlayer records of the scenarios at an uncapped frame rate, one after the other, from the initial state of each scenario.
+/// With a level, the scenario starts the level in the state (Play) or the intro cinematic of the zone of the level (Cinematic).
+/// For each scenario : frame time distribution (GameProfiler), allocations per frame ("Allocations" counter) and peak memory.
+/// The results are compared to the baseline with its tolerances : the exit code is EXIT_FAILURE on a regression
+/// or without a baseline (except with -benchmarkupdatebaseline which writes it).
+/// scenarios.xml :
+///     <benchmark>
+///         <scenario name="levelmap" record="bench_levelmap" state="LevelMap" warmup="2" timeout="120"/>
+///         <scenario name="classicplay" record="bench_classicplay" state="Play" level="1" warmup="2" timeout="120"/>
+///     </benchmark>
+/// baseline.xml :
+///     <baseline time="0.2" allocations="0.1" memory="0.1">
+///         <scenario name="levelmap" p50="16000" p95="18000" p99="20000" allocations="12.5" peakmemory="180000"/>
+///     </baseline>
+/// Headless particle benchmark :
+/// command line : -benchparticles numemitters [-benchparticleframes numframes] [-benchparticleeffect Particules/fire.pex]
+/// Spawns the emitters in a scene and reports the particles updated and converted to vertices per millisecond.
+/// Headless batch benchmark :
+/// command line : -benchbatches numbatches [-benchbatchframes numframes] [-benchbatchchanges ratio]
+/// Feeds a BatchBuilder2D with synthetic source batches (a ratio of them changed, resorted or replaced each frame, every 4th frame unchanged),
+/// checks the sort, the draw ranges and the packed vertices, checks that the unchanged frames copy and move nothing,
+/// and reports the build time, the sort moves (BatchBuilder2D::GetNumSortMoves) and the reused vertices.
+/// The exit code is EXIT_FAILURE if a check fails.
+/// Headless animation check (AnimatedSprite2D::SetParallelUpdate) :
+/// command line : -benchanimations numinstances [-benchanimationframes numframes] [-benchanimationsets 2D/boss01/boss01.scml;2D/eleceffect.scml]
+/// Updates pairs of identical Spriter instances, one serially on the main thread and one on the WorkQueue as Renderer2D does,
+/// with the live then the baked keys, and fails (EXIT_FAILURE) at the first frame where the keys or the Update results are not bitwise identical.
+/// Reports the serial and parallel update times.
+
+struct BenchmarkScenario
+{
+    String name_;
+    String record_;
+    String state_;
+    int level_;
+    float warmup_;
+    float timeout_;
+};
+
+struct BenchmarkResult
+{
+    String name_;
+    bool completed_;
+    unsigned frames_;
+    float mean_;
+    unsigned p50_, p95_, p99_, max_;
+    float allocations_;
+    unsigned peakMemory_;
+};
+
+class GameBenchmark : public Object
+{
+    URHO3D_OBJECT(GameBenchmark, Object);
+
+public:
+    GameBenchmark(Context* context);
+    virtual ~GameBenchmark();
+
+    static void SetScenarioFile(const String& filename) { scenarioFile_ = filename; }
+    static void SetBaselineFile(const String& filename) { baselineFile_ = filename; }
+    static void SetOutputFile(const String& filename) { outputFile_ = filename; }
+    static void SetUpdateBaseline(bool enable) { updateBaseline_ = enable; }
+    static bool IsRequested() { return !scenarioFile_.Empty(); }
+
+    static bool Start(Context* context);
+    static void Stop();
+    static int GetExitCode() { return exitCode_; }
+
+    static int RunParticles(Context* context, const Vector<String>& arguments);
+    static int RunBatches(Context* context, const Vector<String>& arguments);
+    static int RunAnimations(Context* context, const Vector<String>& arguments);
+
+private:
+    enum BenchmarkState
+    {
+        BENCH_SWITCHSTATE = 0,
+        BENCH_WARMUP,
+        BENCH_PLAYING,
+    };
+
+    bool LoadScenarios(const String& filename);
+    void StartScenario();
+    void EndScenario(bool completed);
+    void Finish();
+
+    bool Compare(const String& filename);
+    bool WriteBaseline(const String& filename) const;
+    bool WriteResults(const String& filename) const;
+
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+
+    static unsigned GetPeakMemory();
+    static void ResetPeakMemory();
+
+    Vector<BenchmarkScenario> scenarios_;
+    Vector<BenchmarkResult> results_;
+    unsigned iscenario_;
+    BenchmarkState state_;
+    Timer timer_;
+
+    static GameBenchmark* benchmark_;
+    static String scenarioFile_, baselineFile_, outputFile_;
+    static bool updateBaseline_;
+    static int exitCode_;
+};
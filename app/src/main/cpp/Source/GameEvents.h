@@ -48,6 +48,7 @@ namespace Urho3D
     URHO3D_EVENT(GAME_MOVEREMOVED, Game_MoveRemoved) { }
     URHO3D_EVENT(GAME_MOVEADDED, Game_MoveAdded) { }
     URHO3D_EVENT(GAME_MOVERESTORED, Game_MoveRestored) { }
+    URHO3D_EVENT(GAME_MOVEBONUS, Game_MoveBonus) { }
     URHO3D_EVENT(GAME_TRYREMOVED, Game_TryRemoved) { }
     URHO3D_EVENT(GAME_TRYADDED, Game_TryAdded) { }
     URHO3D_EVENT(GAME_TRYRESTORED, Game_TryRestored) { }
@@ -427,6 +428,49 @@ namespace Urho3D
 
 using namespace Urho3D;
 
+/// Typed match and turn events for EventChannel<E> (no parameters)
+struct MatchStateChangeEvent
+{
+    static StringHash GetEventType() { return GAME_MATCHSTATECHANGE; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
+struct NoMatchStateEvent
+{
+    static StringHash GetEventType() { return GAME_NOMATCHSTATE; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
+struct ScoreChangeEvent
+{
+    static StringHash GetEventType() { return GAME_SCORECHANGE; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
+struct ObjectiveChangeEvent
+{
+    static StringHash GetEventType() { return GAME_OBJECTIVECHANGE; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
+struct MoveRemovedEvent
+{
+    static StringHash GetEventType() { return GAME_MOVEREMOVED; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
+struct MoveAddedEvent
+{
+    static StringHash GetEventType() { return GAME_MOVEADDED; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
+struct MoveRestoredEvent
+{
+    static StringHash GetEventType() { return GAME_MOVERESTORED; }
+    void FillEventData(VariantMap& eventData) const { }
+};
+
 /// GO Events
 struct GOE
 {
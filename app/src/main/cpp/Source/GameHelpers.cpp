@@ -64,6 +64,8 @@
 #include "GameAttributes.h"
 #include "GameEvents.h"
 #include "GameStatics.h"
+#include "GameLog.h"
+#include "GameAllocTracker.h"
 
 #include "AnimatedSprite.h"
 #include "InteractiveFrame.h"
@@ -99,6 +101,7 @@ void GameHelpers::ResetGameLog(Context* context)
 {
     GameLogLock_ = 0;
     context->GetSubsystem<Log>()->SetLevel(GAMELOGLEVEL_DEFAULT);
+    GameLog::SetLevel(GAMELOGLEVEL_DEFAULT);
 }
 
 void GameHelpers::SetGameLogEnable(Context* context, unsigned filterbits, bool state)
@@ -109,13 +112,17 @@ void GameHelpers::SetGameLogEnable(Context* context, unsigned filterbits, bool s
         if (!state)
         {
             context->GetSubsystem<Log>()->SetLevel(GAMELOGLEVEL_MINIMAL);
+            GameLog::SetLevel(GAMELOGLEVEL_MINIMAL);
             GameLogLock_++;
         }
         else
         {
             GameLogLock_--;
             if (GameLogLock_ <= 0)
+            {
                 context->GetSubsystem<Log>()->SetLevel(GAMELOGLEVEL_DEFAULT);
+                GameLog::SetLevel(GAMELOGLEVEL_DEFAULT);
+            }
         }
     }
 #endif
@@ -1220,6 +1227,8 @@ void GameHelpers::AddTextFadeAnim(UIElement* uiroot, const String& msg, Text* or
 
 TextMessage* GameHelpers::AddUIMessage(const String& text, bool localize, const String& font, int fontsize, const Color& color, const IntVector2& position, float duration, float delaystart)
 {
+    GAMEALLOC_SCOPE(GAMEALLOC_UI);
+
     TextMessage* message = TextMessage::Get();
     message->Set(localize ? GameStatics::context_->GetSubsystem<Localization>()->Get(text)+" !" : text, font.CString(), fontsize, duration, position, true, delaystart);
     if (&color != &Color::WHITE)
@@ -32,6 +32,11 @@ enum
     GAMELOG_WORLDUPDATE = 1 << 4,
     GAMELOG_WORLDVISIBLE = 1 << 5,
     GAMELOG_PLAYER = 1 << 6,
+    GAMELOG_MATCHES = 1 << 7,
+    GAMELOG_HINTS = 1 << 8,
+    GAMELOG_POOL = 1 << 9,
+    GAMELOG_NETWORK = 1 << 10,
+    GAMELOG_ALL = 0xFFFFFFFF
 };
 
 
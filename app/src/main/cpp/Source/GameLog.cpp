@@ -0,0 +1,213 @@
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Thread.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+
+#if defined(__ANDROID__)
+#include <android/log.h>
+#endif
+
+#include "GameLog.h"
+
+
+#define GAMELOG_RINGSIZE 1024
+#define GAMELOG_RINGMASK (GAMELOG_RINGSIZE-1)
+#define GAMELOG_MESSAGESIZE 256
+#define GAMELOG_WRITERSLEEP 4
+
+static const char* GameLogLevelPrefixes_[] =
+{
+    "DEBUG",
+    "INFO",
+    "WARNING",
+    "ERROR",
+};
+
+/// bounded multi producers ring (each slot has a sequence number), one consumer : the writer thread
+struct GameLogSlot
+{
+    std::atomic<unsigned> sequence_;
+    int level_;
+    char text_[GAMELOG_MESSAGESIZE];
+};
+
+static GameLogSlot GameLogRing_[GAMELOG_RINGSIZE];
+static std::atomic<unsigned> GameLogEnqueuePos_;
+static unsigned GameLogDequeuePos_;
+static std::atomic<unsigned> GameLogDropped_;
+
+class GameLogWriter : public Thread
+{
+public:
+    GameLogWriter(Context* context, const String& filename)
+    {
+        if (!filename.Empty())
+        {
+            file_ = new File(context, filename, FILE_WRITE);
+            if (!file_->IsOpen())
+                file_.Reset();
+        }
+    }
+
+    virtual void ThreadFunction()
+    {
+        while (shouldRun_)
+        {
+            if (!Drain())
+                Time::Sleep(GAMELOG_WRITERSLEEP);
+        }
+
+        Drain();
+    }
+
+private:
+    bool Drain()
+    {
+        bool written = false;
+
+        for (;;)
+        {
+            GameLogSlot& slot = GameLogRing_[GameLogDequeuePos_ & GAMELOG_RINGMASK];
+            if ((int)(slot.sequence_.load(std::memory_order_acquire) - (GameLogDequeuePos_ + 1)) < 0)
+                break;
+
+            Write(slot.level_, slot.text_);
+
+            slot.sequence_.store(GameLogDequeuePos_ + GAMELOG_RINGSIZE, std::memory_order_release);
+            GameLogDequeuePos_++;
+            written = true;
+        }
+
+        if (written && file_)
+            file_->Flush();
+
+        return written;
+    }
+
+    void Write(int level, const char* text)
+    {
+#if defined(__ANDROID__)
+        __android_log_print(ANDROID_LOG_DEBUG + level, "Urho3D", "%s", text);
+#endif
+        line_ = GameLogLevelPrefixes_[level];
+        line_ += ": ";
+        line_ += text;
+#if !defined(__ANDROID__)
+        PrintUnicodeLine(line_, level == LOG_ERROR);
+#endif
+        if (file_)
+            file_->WriteLine(line_);
+    }
+
+    SharedPtr<File> file_;
+    String line_;
+};
+
+/// published with release by Start, read with acquire by the producers (any thread)
+static std::atomic<GameLogWriter*> GameLogWriter_(0);
+
+int GameLog::level_ = GAMELOGLEVEL_DEFAULT;
+unsigned GameLog::categories_ = GAMELOG_ALL;
+
+void GameLog::Start(Context* context, const String& filename)
+{
+#ifdef ACTIVE_GAMELOGSINK
+    if (GameLogWriter_.load(std::memory_order_acquire))
+        return;
+
+    for (unsigned i = 0; i < GAMELOG_RINGSIZE; i++)
+        GameLogRing_[i].sequence_.store(i, std::memory_order_relaxed);
+    GameLogEnqueuePos_.store(0, std::memory_order_relaxed);
+    GameLogDequeuePos_ = 0;
+    GameLogDropped_.store(0, std::memory_order_relaxed);
+
+    GameLogWriter* writer = new GameLogWriter(context, filename);
+    if (!writer->Run())
+    {
+        delete writer;
+        URHO3D_LOGERROR("GameLog() - Start : can't start the writer thread !");
+        return;
+    }
+
+    // the ring is reset before the producers see the writer
+    GameLogWriter_.store(writer, std::memory_order_release);
+
+    URHO3D_LOGINFOF("GameLog() - Start : file=%s categories=%u", filename.CString(), categories_);
+#endif
+}
+
+void GameLog::Stop()
+{
+    GameLogWriter* writer = GameLogWriter_.exchange(0, std::memory_order_acq_rel);
+    if (!writer)
+        return;
+
+    writer->Stop();
+    delete writer;
+
+    URHO3D_LOGINFOF("GameLog() - Stop : dropped=%u", GetNumDropped());
+}
+
+bool GameLog::IsStarted()
+{
+    return GameLogWriter_.load(std::memory_order_acquire) != 0;
+}
+
+unsigned GameLog::GetNumDropped()
+{
+    return GameLogDropped_.load(std::memory_order_relaxed);
+}
+
+void GameLog::Writef(int level, const char* format, ...)
+{
+    if (level < LOG_DEBUG || level > LOG_ERROR)
+        return;
+
+    va_list args;
+    va_start(args, format);
+
+    if (!GameLogWriter_.load(std::memory_order_acquire))
+    {
+        char text[GAMELOG_MESSAGESIZE];
+        vsnprintf(text, GAMELOG_MESSAGESIZE, format, args);
+        va_end(args);
+        Log::Write(level, String(text));
+        return;
+    }
+
+    // claim a slot, never wait for the writer
+    unsigned pos = GameLogEnqueuePos_.load(std::memory_order_relaxed);
+    GameLogSlot* slot;
+    for (;;)
+    {
+        slot = &GameLogRing_[pos & GAMELOG_RINGMASK];
+        const int diff = (int)(slot->sequence_.load(std::memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+            if (GameLogEnqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            va_end(args);
+            GameLogDropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+            pos = GameLogEnqueuePos_.load(std::memory_order_relaxed);
+    }
+
+    slot->level_ = level;
+    vsnprintf(slot->text_, GAMELOG_MESSAGESIZE, format, args);
+    va_end(args);
+
+    slot->sequence_.store(pos + 1, std::memory_order_release);
+}
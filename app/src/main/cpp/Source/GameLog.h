@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Urho3D/IO/Log.h>
+
+#include "GameOptions.h"
+#include "GameHelpers.h"
+
+using namespace Urho3D;
+
+
+/// Game Log
+/// GAMELOG_*F(category, format, ...) : a log message of a category (GAMELOG_* bits).
+/// The categories out of GAMELOG_COMPILEDCATEGORIES and the levels under GAMELOG_COMPILEDLEVEL are removed at compile time,
+/// the others are filtered at runtime before any formatting (no String, no Log::logMutex_).
+/// With the sink started, the messages are formatted in a lock-free ring buffer (any thread) and written by a writer thread,
+/// a message is dropped when the ring is full. Without the sink, the messages go to the Urho3D Log.
+#define GAMELOG_COMPILED(category, level) ((GAMELOG_COMPILEDCATEGORIES & (category)) != 0 && (level) >= GAMELOG_COMPILEDLEVEL)
+
+#define GAMELOG_WRITEF(category, level, format, ...) \
+    do { if (GAMELOG_COMPILED(category, level) && GameLog::IsEnabled(category, level)) GameLog::Writef(level, format, ##__VA_ARGS__); } while (0)
+
+#define GAMELOG_DEBUGF(category, format, ...) GAMELOG_WRITEF(category, Urho3D::LOG_DEBUG, format, ##__VA_ARGS__)
+#define GAMELOG_INFOF(category, format, ...) GAMELOG_WRITEF(category, Urho3D::LOG_INFO, format, ##__VA_ARGS__)
+#define GAMELOG_WARNINGF(category, format, ...) GAMELOG_WRITEF(category, Urho3D::LOG_WARNING, format, ##__VA_ARGS__)
+#define GAMELOG_ERRORF(category, format, ...) GAMELOG_WRITEF(category, Urho3D::LOG_ERROR, format, ##__VA_ARGS__)
+
+class GameLog
+{
+public:
+    /// Sink : the writer thread writes to the console and to filename (if not empty)
+    static void Start(Context* context, const String& filename=String::EMPTY);
+    static void Stop();
+    static bool IsStarted();
+
+    /// Runtime filters : the level follows the Urho3D Log level (GameHelpers::SetGameLogEnable)
+    static void SetLevel(int level) { level_ = level; }
+    static void SetCategories(unsigned categories) { categories_ = categories; }
+    static bool IsEnabled(unsigned category, int level) { return (categories_ & category) != 0 && level >= level_; }
+
+    static void Writef(int level, const char* format, ...);
+
+    static unsigned GetNumDropped();
+
+private:
+    static int level_;
+    static unsigned categories_;
+};
@@ -16,6 +16,15 @@
 //#define GAMELOGLEVEL_MINIMAL LOG_NONE
 #define GAMELOGLEVEL_MINIMAL LOG_ERROR
 #define GAMELOGLEVEL_DEFAULT LOG_INFO
+// GameLog.h : the GAMELOG_* categories and the minimal level compiled in the GAMELOG_*F macros
+#define GAMELOG_COMPILEDCATEGORIES (GAMELOG_ALL & ~(GAMELOG_MATCHES|GAMELOG_HINTS))
+#define GAMELOG_COMPILEDLEVEL LOG_INFO
+#define ACTIVE_GAMELOGSINK
+// GameProfiler.h : GAMEPROFILE scopes and counters (switched on at runtime with GameConfig::profilerEnabled_)
+#define ACTIVE_GAMEPROFILER
+// GameAllocTracker.h : replaces the global operator new/delete, tracking switched on at runtime with GameConfig::allocTrackerEnabled_
+// (also defined by the cmake option SPACEMATCH_WITH_ALLOCTRACKER and in the Debug builds)
+//#define ACTIVE_GAMEALLOCTRACKER
 
 //#define DUMP_COMPONENTTEMPLATES
 //#define DUMP_ATTRIBUTES
@@ -47,6 +56,10 @@
         #ifndef ACTIVE_TIPS
             #define ACTIVE_TIPS
         #endif
+        // count the heap allocations of the board logic (MatchGridInfo::CheckTurnAllocations)
+        #ifndef ACTIVE_GAMEALLOCTRACKER
+            #define ACTIVE_GAMEALLOCTRACKER
+        #endif
 
 //        #ifdef ACTIVE_SERIALIZEGAMESTATE
 //            #undef ACTIVE_SERIALIZEGAMESTATE
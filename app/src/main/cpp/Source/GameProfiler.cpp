@@ -0,0 +1,397 @@
+#include <cstring>
+
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Core/Profiler.h>
+#include <Urho3D/Container/Sort.h>
+#include <Urho3D/Graphics/Graphics.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Resource/ResourceCache.h>
+#include <Urho3D/UI/UI.h>
+#include <Urho3D/UI/Font.h>
+#include <Urho3D/UI/Text.h>
+
+#include "GameStatics.h"
+#include "GameHelpers.h"
+
+#include "GameProfiler.h"
+
+
+#define GAMEPROFILER_OVERLAYFRAMES 30
+
+static const char* GameProfileTypeNames_[] =
+{
+    "time",
+    "counter",
+    "engine",
+};
+
+/// Engine blocks sampled from the Urho3D Profiler
+static const char* GameProfileEngineBlocks_[] =
+{
+    "UpdateRenderer2D",
+    "AnimatedSprite2D_Update",
+    0
+};
+
+/// Histogram buckets : exact under 32, then 16 buckets by power of 2 (steps of 6.25% at most, under the GameBenchmark tolerances)
+static unsigned GetBucket(unsigned value)
+{
+    if (value < 32)
+        return value;
+
+    unsigned e = 31;
+    while (!(value & (1U << e)))
+        e--;
+
+    return 32 + (e - 5) * 16 + ((value >> (e - 4)) & 15);
+}
+
+static unsigned GetBucketValue(unsigned bucket)
+{
+    if (bucket < 32)
+        return bucket;
+
+    const unsigned e = (bucket - 32) / 16 + 5;
+    return (16 + (bucket - 32) % 16) << (e - 4);
+}
+
+static const ProfilerBlock* FindProfilerBlock(const ProfilerBlock* block, const char* name)
+{
+    if (block->name_ && !String::Compare(block->name_, name, true))
+        return block;
+
+    for (PODVector<ProfilerBlock*>::ConstIterator it = block->children_.Begin(); it != block->children_.End(); ++it)
+    {
+        const ProfilerBlock* found = FindProfilerBlock(*it, name);
+        if (found)
+            return found;
+    }
+
+    return 0;
+}
+
+
+GameProfiler* GameProfiler::profiler_ = 0;
+bool GameProfiler::enabled_ = false;
+Vector<GameProfileScope> GameProfiler::scopes_;
+unsigned GameProfiler::numFrames_ = 0;
+HiresTimer GameProfiler::clock_;
+
+GameProfiler::GameProfiler(Context* context) :
+    Object(context),
+    frameScope_(RegisterScope("Frame", GAMEPROFILE_TIME)),
+    overlayFrames_(0)
+{
+    for (unsigned i = 0; GameProfileEngineBlocks_[i]; i++)
+        RegisterScope(GameProfileEngineBlocks_[i], GAMEPROFILE_ENGINEBLOCK);
+
+    URHO3D_LOGINFOF("GameProfiler() - GameProfiler : numscopes=%u", scopes_.Size());
+}
+
+GameProfiler::~GameProfiler()
+{
+    if (numFrames_)
+    {
+        URHO3D_LOGINFOF("GameProfiler() - ~GameProfiler : frames=%u\n%s", numFrames_, GetReport().CString());
+
+        DumpCSV(GameStatics::gameConfig_.saveDir_ + "profile.csv");
+        DumpJSON(GameStatics::gameConfig_.saveDir_ + "profile.json");
+    }
+
+    if (overlay_)
+        overlay_->Remove();
+}
+
+void GameProfiler::Reset(Context* context)
+{
+    if (profiler_)
+    {
+        SetEnabled(false);
+        delete profiler_;
+        profiler_ = 0;
+    }
+
+    if (context)
+    {
+        profiler_ = new GameProfiler(context);
+        SetEnabled(GameStatics::gameConfig_.profilerEnabled_);
+    }
+}
+
+void GameProfiler::SetEnabled(bool enable)
+{
+    if (!profiler_)
+        enable = false;
+
+    if (enabled_ == enable)
+        return;
+
+    enabled_ = enable;
+
+    if (enabled_)
+    {
+        for (unsigned i = 0; i < scopes_.Size(); i++)
+        {
+            scopes_[i].value_ = 0;
+            scopes_[i].calls_ = 0;
+        }
+        profiler_->frameTimer_.Reset();
+        profiler_->SubscribeToEvent(E_BEGINFRAME, new EventHandlerImpl<GameProfiler>(profiler_, &GameProfiler::HandleBeginFrame));
+    }
+    else
+    {
+        profiler_->UnsubscribeFromEvent(E_BEGINFRAME);
+        SetOverlay(false);
+    }
+
+    URHO3D_LOGINFOF("GameProfiler() - SetEnabled : %s", enabled_ ? "true" : "false");
+
+    // URHO3D_PROFILE compiles out when the engine is built without URHO3D_PROFILING : no engine blocks in the reports
+    if (enabled_ && !profiler_->GetSubsystem<Profiler>())
+        URHO3D_LOGWARNINGF("GameProfiler() - SetEnabled : no Urho3D Profiler (build with URHO3D_PROFILING) => the engine blocks are not sampled !");
+}
+
+void GameProfiler::SetOverlay(bool enable)
+{
+    if (!profiler_)
+        return;
+
+    Context* context = profiler_->GetContext();
+    if (enable && enabled_ && !profiler_->overlay_ && context->GetSubsystem<Graphics>())
+    {
+        Text* text = context->GetSubsystem<UI>()->GetRoot()->CreateChild<Text>();
+        text->SetFont(context->GetSubsystem<ResourceCache>()->GetResource<Font>("Fonts/Anonymous Pro.ttf"), 9);
+        text->SetColor(Color::WHITE);
+        text->SetPriority(100);
+        text->SetPosition(4, 4);
+        profiler_->overlay_ = text;
+        profiler_->UpdateOverlay();
+    }
+    else if (!enable && profiler_->overlay_)
+    {
+        profiler_->overlay_->Remove();
+        profiler_->overlay_.Reset();
+    }
+}
+
+void GameProfiler::ToggleOverlay()
+{
+    SetOverlay(!(profiler_ && profiler_->overlay_));
+}
+
+int GameProfiler::RegisterScope(const char* name, GameProfileType type)
+{
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+        if (scopes_[i].name_ == name)
+            return i;
+
+    scopes_.Resize(scopes_.Size() + 1);
+    GameProfileScope& scope = scopes_.Back();
+    scope.name_ = name;
+    scope.type_ = type;
+    scope.value_ = scope.calls_ = 0;
+    memset(scope.window_, 0, sizeof(scope.window_));
+    memset(scope.histogram_, 0, sizeof(scope.histogram_));
+    scope.total_ = scope.totalCalls_ = 0;
+    scope.max_ = 0;
+    scope.block_ = 0;
+    // the frames before the registration count as zero
+    scope.histogram_[0] = numFrames_;
+
+    return scopes_.Size() - 1;
+}
+
+int GameProfiler::GetScope(const String& name)
+{
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+        if (scopes_[i].name_ == name)
+            return i;
+
+    return -1;
+}
+
+void GameProfiler::ResetStats()
+{
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+    {
+        GameProfileScope& scope = scopes_[i];
+        scope.value_ = scope.calls_ = 0;
+        memset(scope.window_, 0, sizeof(scope.window_));
+        memset(scope.histogram_, 0, sizeof(scope.histogram_));
+        scope.total_ = scope.totalCalls_ = 0;
+        scope.max_ = 0;
+    }
+
+    numFrames_ = 0;
+
+    if (profiler_)
+        profiler_->frameTimer_.Reset();
+}
+
+unsigned GameProfiler::GetPercentile(int scope, float percent)
+{
+    const unsigned numsamples = Min(numFrames_, GAMEPROFILER_WINDOW);
+    if (!numsamples)
+        return 0;
+
+    static PODVector<unsigned> samples;
+    samples.Resize(numsamples);
+    memcpy(samples.Buffer(), scopes_[scope].window_, numsamples * sizeof(unsigned));
+    Sort(samples.Begin(), samples.End());
+
+    return samples[Min((unsigned)(percent * 0.01f * numsamples), numsamples - 1)];
+}
+
+unsigned GameProfiler::GetRunPercentile(int scope, float percent)
+{
+    if (!numFrames_)
+        return 0;
+
+    const GameProfileScope& entry = scopes_[scope];
+    const unsigned rank = Min((unsigned)(percent * 0.01f * numFrames_), numFrames_ - 1);
+    unsigned count = 0;
+    for (unsigned i = 0; i < GAMEPROFILER_NUMBUCKETS; i++)
+    {
+        count += entry.histogram_[i];
+        if (count > rank)
+            return GetBucketValue(i);
+    }
+
+    return entry.max_;
+}
+
+String GameProfiler::GetReport()
+{
+    String report;
+    // String::AppendWithFormat has no field width : use vsprintf
+    GameHelpers::AppendBufferToString(report, "%-24s %8s %8s %8s %8s\n", "scope (us|count)", "p50", "p95", "p99", "max");
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+    {
+        const GameProfileScope& entry = scopes_[i];
+        if (entry.type_ == GAMEPROFILE_ENGINEBLOCK && !entry.block_)
+            continue;
+        GameHelpers::AppendBufferToString(report, "%-24.24s %8u %8u %8u %8u\n", entry.name_.CString(),
+                                GetPercentile(i, 50.f), GetPercentile(i, 95.f), GetPercentile(i, 99.f), entry.max_);
+    }
+    return report;
+}
+
+bool GameProfiler::DumpCSV(const String& filename)
+{
+    if (!profiler_)
+        return false;
+
+    File file(profiler_->GetContext(), filename, FILE_WRITE);
+    if (!file.IsOpen())
+    {
+        URHO3D_LOGERRORF("GameProfiler() - DumpCSV : can't open %s !", filename.CString());
+        return false;
+    }
+
+    const double numframes = numFrames_ ? (double)numFrames_ : 1.0;
+
+    file.WriteLine("scope,type,frames,mean,p50,p95,p99,max,callsperframe,window_p50,window_p95,window_p99");
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+    {
+        const GameProfileScope& entry = scopes_[i];
+        file.WriteLine(ToString("%s,%s,%u,%f,%u,%u,%u,%u,%f,%u,%u,%u", entry.name_.CString(), GameProfileTypeNames_[entry.type_], numFrames_,
+                                entry.total_ / numframes, GetRunPercentile(i, 50.f), GetRunPercentile(i, 95.f), GetRunPercentile(i, 99.f),
+                                entry.max_, entry.totalCalls_ / numframes, GetPercentile(i, 50.f), GetPercentile(i, 95.f), GetPercentile(i, 99.f)));
+    }
+
+    URHO3D_LOGINFOF("GameProfiler() - DumpCSV : %s", filename.CString());
+    return true;
+}
+
+bool GameProfiler::DumpJSON(const String& filename)
+{
+    if (!profiler_)
+        return false;
+
+    File file(profiler_->GetContext(), filename, FILE_WRITE);
+    if (!file.IsOpen())
+    {
+        URHO3D_LOGERRORF("GameProfiler() - DumpJSON : can't open %s !", filename.CString());
+        return false;
+    }
+
+    const double numframes = numFrames_ ? (double)numFrames_ : 1.0;
+
+    file.WriteLine(ToString("{\n  \"frames\": %u,\n  \"scopes\": [", numFrames_));
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+    {
+        const GameProfileScope& entry = scopes_[i];
+        file.WriteLine(ToString("    { \"name\": \"%s\", \"type\": \"%s\", \"mean\": %f, \"p50\": %u, \"p95\": %u, \"p99\": %u, \"max\": %u, \"callsPerFrame\": %f,"
+                                " \"window\": { \"p50\": %u, \"p95\": %u, \"p99\": %u } }%s",
+                                entry.name_.CString(), GameProfileTypeNames_[entry.type_], entry.total_ / numframes,
+                                GetRunPercentile(i, 50.f), GetRunPercentile(i, 95.f), GetRunPercentile(i, 99.f), entry.max_,
+                                entry.totalCalls_ / numframes, GetPercentile(i, 50.f), GetPercentile(i, 95.f), GetPercentile(i, 99.f),
+                                i+1 < scopes_.Size() ? "," : ""));
+    }
+    file.WriteLine("  ]\n}");
+
+    URHO3D_LOGINFOF("GameProfiler() - DumpJSON : %s", filename.CString());
+    return true;
+}
+
+void GameProfiler::SampleEngineBlocks()
+{
+    Profiler* profiler = GetSubsystem<Profiler>();
+    if (!profiler)
+        return;
+
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+    {
+        GameProfileScope& entry = scopes_[i];
+        if (entry.type_ != GAMEPROFILE_ENGINEBLOCK)
+            continue;
+
+        // the blocks live as long as the profiler : cache them
+        if (!entry.block_)
+            entry.block_ = FindProfilerBlock(profiler->GetRootBlock(), entry.name_.CString());
+
+        if (entry.block_)
+        {
+            entry.value_ = (unsigned)entry.block_->frameTime_;
+            entry.calls_ = entry.block_->frameCount_;
+        }
+    }
+}
+
+void GameProfiler::UpdateOverlay()
+{
+    overlay_->SetText(ToString("GameProfiler frames=%u\n", numFrames_) + GetReport());
+}
+
+void GameProfiler::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+{
+    AddValue(frameScope_, (unsigned)frameTimer_.GetUSec(true));
+
+    SampleEngineBlocks();
+
+    const unsigned windowindex = numFrames_ % GAMEPROFILER_WINDOW;
+    for (unsigned i = 0; i < scopes_.Size(); i++)
+    {
+        GameProfileScope& entry = scopes_[i];
+        entry.window_[windowindex] = entry.value_;
+        entry.histogram_[GetBucket(entry.value_)]++;
+        entry.total_ += entry.value_;
+        entry.totalCalls_ += entry.calls_;
+        if (entry.value_ > entry.max_)
+            entry.max_ = entry.value_;
+        entry.value_ = 0;
+        entry.calls_ = 0;
+    }
+
+    numFrames_++;
+
+    if (overlay_ && ++overlayFrames_ >= GAMEPROFILER_OVERLAYFRAMES)
+    {
+        overlayFrames_ = 0;
+        UpdateOverlay();
+    }
+}
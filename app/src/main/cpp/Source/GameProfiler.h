@@ -0,0 +1,140 @@
+#pragma once
+
+#include <Urho3D/Core/Object.h>
+#include <Urho3D/Core/Timer.h>
+
+#include "GameOptions.h"
+
+namespace Urho3D
+{
+    class ProfilerBlock;
+    class Text;
+}
+
+using namespace Urho3D;
+
+
+/// Game Profiler
+/// GAMEPROFILE(name) : a scoped timer, the time of a scope is accumulated during the frame.
+/// GAMEPROFILE_COUNT(name, value) : a counter, the value is accumulated during the frame.
+/// At each frame, the totals are pushed in a rolling window (p50/p95/p99 on the last frames)
+/// and in a whole-run histogram (log buckets) dumped in CSV and JSON on exit.
+/// The engine blocks (Renderer2D, AnimatedSprite2D) are sampled from the Urho3D Profiler : the builds that produce the reports
+/// need URHO3D_PROFILING (off by default, on in the CI benchmark job).
+/// Switched on at runtime with GameConfig::profilerEnabled_ (or GameProfiler::SetEnabled), no cost beside a test when off.
+#ifdef ACTIVE_GAMEPROFILER
+#define GAMEPROFILE(name) \
+    static const int gameProfileScope_##name = GameProfiler::RegisterScope(#name, GAMEPROFILE_TIME); \
+    GameProfileBlock gameProfileBlock_##name(gameProfileScope_##name)
+#define GAMEPROFILE_COUNT(name, value) \
+    do { static const int gameProfileScope_##name = GameProfiler::RegisterScope(#name, GAMEPROFILE_COUNTER); \
+         if (GameProfiler::IsEnabled()) GameProfiler::AddValue(gameProfileScope_##name, value); } while (0)
+#else
+#define GAMEPROFILE(name)
+#define GAMEPROFILE_COUNT(name, value)
+#endif
+
+const unsigned GAMEPROFILER_WINDOW = 256;
+const unsigned GAMEPROFILER_NUMBUCKETS = 464;
+
+enum GameProfileType
+{
+    GAMEPROFILE_TIME = 0,
+    GAMEPROFILE_COUNTER,
+    GAMEPROFILE_ENGINEBLOCK,
+};
+
+struct GameProfileScope
+{
+    String name_;
+    GameProfileType type_;
+    /// current frame
+    unsigned value_;
+    unsigned calls_;
+    /// rolling window
+    unsigned window_[GAMEPROFILER_WINDOW];
+    /// whole run
+    unsigned histogram_[GAMEPROFILER_NUMBUCKETS];
+    unsigned long long total_;
+    unsigned long long totalCalls_;
+    unsigned max_;
+    /// engine block (GAMEPROFILE_ENGINEBLOCK)
+    const ProfilerBlock* block_;
+};
+
+class GameProfiler : public Object
+{
+    URHO3D_OBJECT(GameProfiler, Object);
+
+public:
+    GameProfiler(Context* context);
+    virtual ~GameProfiler();
+
+    static void Reset(Context* context=0);
+    static GameProfiler* Get() { return profiler_; }
+
+    static void SetEnabled(bool enable);
+    static bool IsEnabled() { return enabled_; }
+    static void SetOverlay(bool enable);
+    static void ToggleOverlay();
+
+    static int RegisterScope(const char* name, GameProfileType type);
+    static int GetScope(const String& name);
+    /// clear the windows and the histograms (a new run, see GameBenchmark)
+    static void ResetStats();
+    static void AddValue(int scope, unsigned value)
+    {
+        GameProfileScope& entry = scopes_[scope];
+        entry.value_ += value;
+        entry.calls_++;
+    }
+
+    /// percentile (0-100) on the rolling window or on the whole run
+    static unsigned GetPercentile(int scope, float percent);
+    static unsigned GetRunPercentile(int scope, float percent);
+    static unsigned GetNumFrames() { return numFrames_; }
+    static int GetFrameScope() { return profiler_ ? profiler_->frameScope_ : -1; }
+    static const GameProfileScope& GetScopeData(int scope) { return scopes_[scope]; }
+    /// monotonic clock of the profiler
+    static long long GetUSec() { return clock_.GetUSec(false); }
+
+    static String GetReport();
+    static bool DumpCSV(const String& filename);
+    static bool DumpJSON(const String& filename);
+
+private:
+    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+
+    void SampleEngineBlocks();
+    void UpdateOverlay();
+
+    static GameProfiler* profiler_;
+    static bool enabled_;
+    static Vector<GameProfileScope> scopes_;
+    static unsigned numFrames_;
+    static HiresTimer clock_;
+
+    HiresTimer frameTimer_;
+    int frameScope_;
+    unsigned overlayFrames_;
+    SharedPtr<Text> overlay_;
+};
+
+class GameProfileBlock
+{
+public:
+    GameProfileBlock(int scope) : scope_(GameProfiler::IsEnabled() ? scope : -1)
+    {
+        if (scope_ != -1)
+            start_ = GameProfiler::GetUSec();
+    }
+    ~GameProfileBlock()
+    {
+        if (scope_ != -1)
+            GameProfiler::AddValue(scope_, (unsigned)(GameProfiler::GetUSec() - start_));
+    }
+
+private:
+    int scope_;
+    long long start_;
+};
@@ -58,12 +58,15 @@
 #include <Urho3D/Urho2D/CollisionCircle2D.h>
 #include <Urho3D/Urho2D/RigidBody2D.h>
 #include <Urho3D/Urho2D/SpriteSheet2D.h>
+#include <Urho3D/Urho2D/SpriterInstance2D.h>
 #include <Urho3D/Urho2D/PhysicsWorld2D.h>
 
 #include "GameOptions.h"
 #include "GameAttributes.h"
 #include "GameRand.h"
 #include "GameHelpers.h"
+#include "GameProfiler.h"
+#include "GameAllocTracker.h"
 #include "GameEvents.h"
 
 #include "GameStateManager.h"
@@ -78,6 +81,8 @@
 #include "DelayAction.h"
 #include "DelayInformer.h"
 #include "TimerRemover.h"
+#include "TimerWheel.h"
+#include "ComponentUpdater.h"
 #include "TextMessage.h"
 #include "InteractiveFrame.h"
 
@@ -173,6 +178,11 @@ GameConfig::GameConfig() :
     debugUI_(false),
     debugAnimatedSprite2D(false),
     debugMatches_(true),
+    profilerEnabled_(false),
+    allocTrackerEnabled_(false),
+    allocBudgetAssert_(false),
+    spriterBakingEnabled_(false),
+    parallelAnimationEnabled_(false),
     initState_(String::EMPTY),
     saveDir_(String::EMPTY),
     screenJoystickID_(-1),
@@ -333,11 +343,20 @@ void GameStatics::Initialize(Context* context)
     GameStatics::input_ = context->GetSubsystem<Input>();
     GameStatics::ui_ = context->GetSubsystem<UI>();
 
+    TimerWheel::Reset(context);
+    ComponentUpdater::Reset(context);
+    GameProfiler::Reset(context);
+    GameAllocTracker::Reset(context);
     TimerRemover::Reset(500);
     DelayInformer::Reset(500);
     DelayAction::Reset(500);
     TextMessage::Reset(20);
 
+    // Spriter animations without triggers are baked and shared by the AnimatedSprite2Ds
+    Spriter::SpriterInstance::SetBakingEnabled(gameConfig_.spriterBakingEnabled_);
+    // AnimatedSprite2Ds are updated by Renderer2D in the worker threads, the triggers stay in the main thread
+    AnimatedSprite2D::SetParallelUpdate(gameConfig_.parallelAnimationEnabled_);
+
     // Set default UI style
     UIElement* uiroot = GameStatics::ui_->GetRoot();
     uiroot->SetDefaultStyle(context->GetSubsystem<ResourceCache>()->GetResource<XMLFile>("UI/DefaultStyle.xml"));
@@ -1300,6 +1319,10 @@ void GameStatics::Stop()
     DelayInformer::Reset();
     DelayAction::Reset();
     TextMessage::Reset();
+    TimerWheel::Reset();
+    ComponentUpdater::Reset();
+    GameAllocTracker::Reset();
+    GameProfiler::Reset();
 
     URHO3D_LOGINFO("GameStatics() - ----------------------------------------");
     URHO3D_LOGINFO("GameStatics() - Stop  .... OK !                        -");
@@ -1504,8 +1527,9 @@ void GameStatics::AddBonus(const Slot& slot, Object* sender, float time)
     {
         URHO3D_LOGINFOF("GameStatics - AddBonus() - category MOVES qty=%d", slot.qty_);
         // Add +3 more than the event which add +1 move
+        // GAME_MOVEBONUS : the delayed string-keyed event is forwarded by PlayState as a MoveAddedEvent
         moves_ += (slot.qty_-1);
-        eventType = GAME_MOVEADDED;
+        eventType = GAME_MOVEBONUS;
     }
     else if (slot.cat_ == COT::STARS.Value())
     {
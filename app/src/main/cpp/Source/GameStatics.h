@@ -158,6 +158,11 @@ struct GameConfig
     bool debugAnimatedSprite2D;
     bool debugGOC_BodyExploder2D;
     bool debugMatches_;
+    bool profilerEnabled_;
+    bool allocTrackerEnabled_;
+    bool allocBudgetAssert_;
+    bool spriterBakingEnabled_;
+    bool parallelAnimationEnabled_;
 
     String initState_;
     String logString;
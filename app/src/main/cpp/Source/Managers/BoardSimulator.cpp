@@ -0,0 +1,762 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/ProcessUtils.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Core/WorkQueue.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+
+#include <Urho3D/Urho2D/Drawable2D.h>
+
+#include "GameStatics.h"
+
+#include "BoardSimulator.h"
+
+
+#define SIM_MAXCASCADES 50
+#define SIM_MAXSTABILIZE 20
+#define SIM_MAXRESHUFFLES 5
+#define SIM_DEFAULTLEVELS 100
+#define SIM_DEFAULTCOLORS 4
+#define SIM_DEFAULTMOVES 30
+#define SIM_NUMPOWERS (SQREXPLOSION-XEXPLOSION+1)
+
+
+/// Policies
+
+bool SimRandomPolicy::ChooseMove(const BoardSimulator& board, const PODVector<SimMove>& moves, GameRand& random, SimMove& move) const
+{
+    if (!moves.Size())
+        return false;
+
+    move = moves[random.Get(moves.Size())];
+    return true;
+}
+
+bool SimGreedyPolicy::ChooseMove(const BoardSimulator& board, const PODVector<SimMove>& moves, GameRand& random, SimMove& move) const
+{
+    if (!moves.Size())
+        return false;
+
+    int bestscore = -1;
+    unsigned numbest = 0;
+
+    for (unsigned i=0; i < moves.Size(); i++)
+    {
+        int score = board.EvaluateMove(moves[i]);
+
+        if (score > bestscore)
+        {
+            bestscore = score;
+            numbest = 1;
+            move = moves[i];
+        }
+        // reservoir sampling between the equal moves
+        else if (score == bestscore && random.Get(++numbest) == 0)
+        {
+            move = moves[i];
+        }
+    }
+
+    return true;
+}
+
+static SimRandomPolicy randomPolicy_;
+static SimGreedyPolicy greedyPolicy_;
+
+
+/// BoardSimulator
+
+HashMap<String, SimMovePolicy*> BoardSimulator::policies_;
+
+BoardSimulator::BoardSimulator() :
+    width_(0),
+    height_(0),
+    numcolors_(SIM_DEFAULTCOLORS),
+    destroyed_(0),
+    level_(0),
+    swapsDirty_(true)
+{ }
+
+void BoardSimulator::RegisterPolicy(const String& name, SimMovePolicy* policy)
+{
+    policies_[name] = policy;
+}
+
+const SimMovePolicy* BoardSimulator::GetPolicy(const String& name)
+{
+    if (!policies_.Size())
+    {
+        RegisterPolicy("random", &randomPolicy_);
+        RegisterPolicy("greedy", &greedyPolicy_);
+    }
+
+    HashMap<String, SimMovePolicy*>::ConstIterator it = policies_.Find(name);
+    return it != policies_.End() ? it->second_ : 0;
+}
+
+void BoardSimulator::SetupLevel(unsigned seed, int level, int numcolors, int maxmoves, int layout, SimLevelParams& params)
+{
+    params.seed_ = seed;
+    params.level_ = level;
+    params.numcolors_ = Clamp(numcolors, 1, ITEMS-BLUE);
+    params.maxmoves_ = maxmoves;
+    params.layoutshape_ = params.layoutsize_ = params.numobjectives_ = -1;
+
+    GameStatics::SetLevelParameters(seed, level, params.numcolors_, params.layoutshape_, params.layoutsize_, params.numobjectives_, params.totalitems_);
+
+    if (layout >= 0 && layout < L_Custom)
+        params.layoutshape_ = layout;
+
+    // the walls are drawn with the seed of the level, without changing the game randomizers
+    GameRand random;
+    random.SetSeed(seed + level);
+
+    MatchGrid layoutgrid;
+    layoutgrid.SetLayout(params.layoutsize_, (GridLayout)params.layoutshape_, HA_CENTER, VA_CENTER, true, &random);
+
+    params.grid_ = layoutgrid.grid_;
+    params.ramptiles_ = layoutgrid.ramptiles_;
+    params.tileentrances_ = layoutgrid.tileentrances_;
+    params.tileexits_ = layoutgrid.tileexits_;
+    params.fixedcolumns_ = layoutgrid.fixedcolumns_;
+}
+
+struct SimJob
+{
+    const SimLevelParams* params_;
+    const SimMovePolicy* policy_;
+    SimLevelReport* report_;
+};
+
+static void SimulateLevelsWork(const WorkItem* item, unsigned threadIndex)
+{
+    BoardSimulator board;
+
+    SimJob* end = reinterpret_cast<SimJob*>(item->end_);
+    for (SimJob* job = reinterpret_cast<SimJob*>(item->start_); job < end; ++job)
+        board.Play(*job->params_, *job->policy_, *job->report_);
+}
+
+void BoardSimulator::RunBatch(Context* context, const Vector<SimLevelParams>& levels, const SimMovePolicy& policy, Vector<SimLevelReport>& reports)
+{
+    reports.Resize(levels.Size());
+    if (!levels.Size())
+        return;
+
+    PODVector<SimJob> jobs(levels.Size());
+    for (unsigned i=0; i < levels.Size(); i++)
+    {
+        jobs[i].params_ = &levels[i];
+        jobs[i].policy_ = &policy;
+        jobs[i].report_ = &reports[i];
+    }
+
+    SimJob* jobsptr = &jobs[0];
+
+    WorkQueue* queue = context ? context->GetSubsystem<WorkQueue>() : 0;
+    if (!queue)
+    {
+        WorkItem item;
+        item.start_ = jobsptr;
+        item.end_ = jobsptr + jobs.Size();
+        SimulateLevelsWork(&item, 0);
+        return;
+    }
+
+    // a few items by thread for the load balancing
+    const unsigned numitems = (queue->GetNumThreads() + 1) * 4;
+    const unsigned jobsbyitem = Max(1U, (jobs.Size() + numitems - 1) / numitems);
+
+    for (unsigned i=0; i < jobs.Size(); i += jobsbyitem)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = SimulateLevelsWork;
+        item->start_ = jobsptr + i;
+        item->end_ = jobsptr + Min(i + jobsbyitem, jobs.Size());
+        queue->AddWorkItem(item);
+    }
+
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
+String BoardSimulator::GetSummary(const Vector<SimLevelReport>& reports, float elapsedtime)
+{
+    unsigned wins = 0;
+    int movesused = 0, winmovesused = 0, maxdepth = 0, cascades = 0, sumdepth = 0, reshuffles = 0;
+
+    for (unsigned i=0; i < reports.Size(); i++)
+    {
+        const SimLevelReport& report = reports[i];
+        if (report.win_)
+        {
+            wins++;
+            winmovesused += report.movesUsed_;
+        }
+        movesused += report.movesUsed_;
+        cascades += report.totalCascades_;
+        sumdepth += report.maxCascadeDepth_;
+        maxdepth = Max(maxdepth, report.maxCascadeDepth_);
+        reshuffles += report.reshuffles_;
+    }
+
+    const float numlevels = (float)Max(1U, reports.Size());
+
+    return ToString("levels=%u wins=%u winrate=%f%% moves=%f movesonwin=%f cascades/move=%f maxdepth=%f(max=%d) reshuffles=%d time=%fs (%f levels/s)",
+                    reports.Size(), wins, 100.f * wins / numlevels, movesused / numlevels, wins ? (float)winmovesused / wins : 0.f,
+                    movesused ? (float)cascades / movesused : 0.f, sumdepth / numlevels, maxdepth, reshuffles,
+                    elapsedtime, elapsedtime > 0.f ? reports.Size() / elapsedtime : 0.f);
+}
+
+bool BoardSimulator::SaveReports(Context* context, const String& filename, const Vector<SimLevelReport>& reports)
+{
+    SharedPtr<File> file(new File(context));
+    if (!file->Open(filename, FILE_WRITE))
+    {
+        URHO3D_LOGERRORF("BoardSimulator() - SaveReports : can't open %s !", filename.CString());
+        return false;
+    }
+
+    file->WriteLine("level;seed;layoutshape;layoutsize;objectives;items;win;movesused;maxcascadedepth;cascades;reshuffles;destroyed");
+
+    for (unsigned i=0; i < reports.Size(); i++)
+    {
+        const SimLevelReport& r = reports[i];
+        file->WriteLine(ToString("%d;%u;%d;%d;%d;%d;%d;%d;%d;%d;%d;%d", r.level_, r.seed_, r.layoutshape_, r.layoutsize_, r.numobjectives_, r.totalitems_,
+                                 r.win_ ? 1 : 0, r.movesUsed_, r.maxCascadeDepth_, r.totalCascades_, r.reshuffles_, r.destroyed_));
+    }
+
+    file->Close();
+
+    URHO3D_LOGINFOF("BoardSimulator() - SaveReports : %u levels saved in %s !", reports.Size(), filename.CString());
+    return true;
+}
+
+static int GetIntArgument(const Vector<String>& arguments, const char* name, int defaultvalue)
+{
+    for (unsigned i=0; i+1 < arguments.Size(); i++)
+        if (arguments[i] == name)
+            return ToInt(arguments[i+1]);
+
+    return defaultvalue;
+}
+
+static String GetStringArgument(const Vector<String>& arguments, const char* name, const String& defaultvalue)
+{
+    for (unsigned i=0; i+1 < arguments.Size(); i++)
+        if (arguments[i] == name)
+            return arguments[i+1];
+
+    return defaultvalue;
+}
+
+int BoardSimulator::RunCommandLine(Context* context, const Vector<String>& arguments)
+{
+    const int numlevels = Max(1, GetIntArgument(arguments, "-simulate", SIM_DEFAULTLEVELS));
+    const int firstlevel = Max(1, GetIntArgument(arguments, "-simlevel", 1));
+    const unsigned seed = (unsigned)GetIntArgument(arguments, "-simseed", 0);
+    const int numcolors = GetIntArgument(arguments, "-simcolors", SIM_DEFAULTCOLORS);
+    const int maxmoves = GetIntArgument(arguments, "-simmoves", SIM_DEFAULTMOVES);
+    const int layout = GetIntArgument(arguments, "-simlayout", -1);
+    const String policyname = GetStringArgument(arguments, "-simpolicy", "greedy");
+    const String filename = GetStringArgument(arguments, "-simout", String::EMPTY);
+
+    GridTile::WALLCHANCE = GetIntArgument(arguments, "-simwalls", GridTile::WALLCHANCE);
+    Match::ROCKCHANCE = GetIntArgument(arguments, "-simrocks", Match::ROCKCHANCE);
+
+    const SimMovePolicy* policy = GetPolicy(policyname);
+    if (!policy)
+    {
+        PrintLine(ToString("BoardSimulator : unknown policy %s !", policyname.CString()), true);
+        return EXIT_FAILURE;
+    }
+
+    PrintLine(ToString("BoardSimulator : levels=%d..%d seed=%u colors=%d moves=%d walls=%d%% rocks=%d%% policy=%s",
+                       firstlevel, firstlevel+numlevels-1, seed, numcolors, maxmoves, GridTile::WALLCHANCE, Match::ROCKCHANCE, policyname.CString()));
+
+    // the simulator runs before RegisterGameLibrary : create the randomizers used by SetLevelParameters
+    GameRand::InitTable();
+
+    HiresTimer timer;
+
+    Vector<SimLevelParams> levels(numlevels);
+    for (int i=0; i < numlevels; i++)
+        SetupLevel(seed, firstlevel+i, numcolors, maxmoves, layout, levels[i]);
+
+    Vector<SimLevelReport> reports;
+    RunBatch(context, levels, *policy, reports);
+
+    const float elapsedtime = timer.GetUSec(false) / 1000000.f;
+
+    if (filename.Empty())
+    {
+        for (unsigned i=0; i < reports.Size(); i++)
+        {
+            const SimLevelReport& r = reports[i];
+            PrintLine(ToString("level=%d shape=%d size=%d objs=%d items=%d => %s moves=%d maxdepth=%d cascades=%d reshuffles=%d",
+                               r.level_, r.layoutshape_, r.layoutsize_, r.numobjectives_, r.totalitems_,
+                               r.win_ ? "WIN " : "LOSE", r.movesUsed_, r.maxCascadeDepth_, r.totalCascades_, r.reshuffles_));
+        }
+    }
+    else
+    {
+        SaveReports(context, filename, reports);
+    }
+
+    PrintLine("BoardSimulator : " + GetSummary(reports, elapsedtime));
+
+    return EXIT_SUCCESS;
+}
+
+void BoardSimulator::Play(const SimLevelParams& params, const SimMovePolicy& policy, SimLevelReport& report)
+{
+    report.seed_ = params.seed_;
+    report.level_ = params.level_;
+    report.layoutshape_ = params.layoutshape_;
+    report.layoutsize_ = params.layoutsize_;
+    report.numobjectives_ = params.numobjectives_;
+    report.totalitems_ = params.totalitems_;
+    report.win_ = false;
+    report.movesUsed_ = report.maxCascadeDepth_ = report.totalCascades_ = report.reshuffles_ = 0;
+
+    Create(params);
+
+    PODVector<SimMove> moves;
+    SimMove move;
+
+    for (int i=0; i < params.maxmoves_; i++)
+    {
+        GetValidMoves(moves);
+
+        while (!moves.Size() && report.reshuffles_ < SIM_MAXRESHUFFLES)
+        {
+            Shuffle();
+            report.reshuffles_++;
+            GetValidMoves(moves);
+        }
+
+        if (!policy.ChooseMove(*this, moves, random_, move))
+            break;
+
+        const int depth = ResolveMove(move, true);
+
+        report.movesUsed_++;
+        report.totalCascades_ += depth;
+        report.maxCascadeDepth_ = Max(report.maxCascadeDepth_, depth);
+
+        bool objectivesreached = true;
+        for (unsigned j=0; j < objectives_.Size(); j++)
+            if (objectives_[j] > 0)
+                objectivesreached = false;
+
+        if (objectivesreached)
+        {
+            report.win_ = true;
+            break;
+        }
+    }
+
+    report.destroyed_ = destroyed_;
+}
+
+bool BoardSimulator::IsObjective(unsigned char ctype) const
+{
+    const int i = (int)ctype - BLUE;
+    return i >= 0 && i < (int)objectives_.Size() && objectives_[i] > 0;
+}
+
+bool BoardSimulator::IsSelectable(int x, int y) const
+{
+    const unsigned char ctype = matches_(x, y).ctype_;
+    return ctype && ctype < ROCKS;
+}
+
+void BoardSimulator::GetValidMoves(PODVector<SimMove>& moves) const
+{
+    moves.Clear();
+
+    MatchBitBoard board;
+
+    for (unsigned i=0; i < swaps_.Size(); i++)
+    {
+        const SimMove& swap = swaps_[i];
+        const int x = swap.m1_.x_, y = swap.m1_.y_;
+        const int x2 = swap.m2_.x_, y2 = swap.m2_.y_;
+
+        if (!IsSelectable(x, y) || !IsSelectable(x2, y2))
+            continue;
+
+        const unsigned char c1 = matches_(x, y).ctype_;
+        const unsigned char c2 = matches_(x2, y2).ctype_;
+
+        bool valid = IsPower(x, y) || IsPower(x2, y2);
+        if (!valid && c1 != c2)
+        {
+            board = bitboard_;
+            board.SetCell(x, y, c2);
+            board.SetCell(x2, y2, c1);
+            valid = board.HasMatches(Match::MINIMALMATCHES, c1, c1+1) || board.HasMatches(Match::MINIMALMATCHES, c2, c2+1);
+        }
+
+        if (valid)
+            moves.Push(swap);
+    }
+}
+
+int BoardSimulator::EvaluateMove(const SimMove& move) const
+{
+    const Match& m1 = matches_(move.m1_.x_, move.m1_.y_);
+    const Match& m2 = matches_(move.m2_.x_, move.m2_.y_);
+
+    MatchBitBoard board = bitboard_;
+    board.SetCell(move.m1_.x_, move.m1_.y_, m2.ctype_);
+    board.SetCell(move.m2_.x_, move.m2_.y_, m1.ctype_);
+
+    MatchBitBoardResult result;
+    int score = board.FindMatches(Match::MINIMALMATCHES, BLUE, ROCKS, result);
+
+    for (unsigned i=0; i < objectives_.Size(); i++)
+        if (objectives_[i] > 0)
+            score += (result.all_ & board.GetColor(BLUE+i)).Count();
+
+    if (m1.effect_ != NOEFFECT || m2.effect_ != NOEFFECT)
+        score += Max(width_, height_);
+
+    return score;
+}
+
+void BoardSimulator::Create(const SimLevelParams& params)
+{
+    level_ = &params;
+    grid_ = params.grid_;
+    width_ = grid_.Width();
+    height_ = grid_.Height();
+    numcolors_ = params.numcolors_;
+    destroyed_ = 0;
+    swapsDirty_ = true;
+
+    random_.SetSeed(params.seed_ + params.level_);
+
+    objectives_.Resize(params.numobjectives_);
+    for (unsigned i=0; i < objectives_.Size(); i++)
+        objectives_[i] = params.totalitems_ / params.numobjectives_;
+
+    matches_.Resize(width_, height_);
+    for (int y=0; y < height_; y++)
+    {
+        for (int x=0; x < width_; x++)
+        {
+            Match& match = matches_(x, y);
+            match.x_ = x;
+            match.y_ = y;
+            match.property_ = 0;
+
+            if (grid_(x, y).ground_)
+                AddObject(match);
+        }
+    }
+
+    Stabilize();
+}
+
+// the draws of MatchGrid::AddObject : the objectives are the first colors
+void BoardSimulator::AddObject(Match& match)
+{
+    unsigned typeindex = 0;
+    const int category = MatchGrid::DrawObject(random_, SIM_NUMPOWERS, 1, numcolors_, typeindex);
+
+    if (category == MOC_POWER)
+    {
+        match.ctype_  = BLUE + random_.Get(numcolors_);
+        match.otype_  = -1;
+        match.effect_ = XEXPLOSION + typeindex;
+    }
+    else if (category == MOC_ROCK)
+    {
+        match.ctype_  = ROCKS;
+        match.otype_  = -1;
+        match.effect_ = NOEFFECT;
+    }
+    else
+    {
+        match.ctype_  = BLUE + typeindex;
+        match.otype_  = typeindex < objectives_.Size() ? (char)typeindex : -1;
+        match.effect_ = NOEFFECT;
+    }
+}
+
+// remove the matches without counting the objectives
+void BoardSimulator::Stabilize()
+{
+    MatchBitBoardResult result;
+
+    UpdateBitBoard();
+
+    for (int i=0; i < SIM_MAXSTABILIZE; i++)
+    {
+        if (!bitboard_.FindMatches(Match::MINIMALMATCHES, BLUE, ROCKS, result))
+            break;
+
+        Destroy(result.all_, BitBoard::EMPTY, false);
+        Collapse();
+        Refill();
+        UpdateBitBoard();
+    }
+}
+
+// like MatchesManager::ShakeMatches : respawn all the matches except the rocks
+void BoardSimulator::Shuffle()
+{
+    for (int y=0; y < height_; y++)
+        for (int x=0; x < width_; x++)
+        {
+            Match& match = matches_(x, y);
+            if (grid_(x, y).ground_ && match.ctype_ != ROCKS)
+                AddObject(match);
+        }
+
+    Stabilize();
+}
+
+void BoardSimulator::UpdateBitBoard()
+{
+    MatchGrid::UpdateBitBoard(bitboard_, grid_, matches_);
+
+    if (swapsDirty_)
+        UpdateSwaps();
+}
+
+// the swaps only depend on the layout and the walls : the moves are generated from this table
+void BoardSimulator::UpdateSwaps()
+{
+    const BitBoard& ground = bitboard_.GetGround();
+    const BitBoard& blockedright = bitboard_.GetBlockedRight();
+    const BitBoard& blockedsouth = bitboard_.GetBlockedSouth();
+
+    swaps_.Clear();
+
+    for (int y=0; y < height_; y++)
+    {
+        for (int x=0; x < width_; x++)
+        {
+            if (!ground.Test(x, y))
+                continue;
+
+            if (x+1 < width_ && ground.Test(x+1, y) && !blockedright.Test(x, y))
+                swaps_.Push(SimMove(x, y, x+1, y));
+            if (y+1 < height_ && ground.Test(x, y+1) && !blockedsouth.Test(x, y))
+                swaps_.Push(SimMove(x, y, x, y+1));
+        }
+    }
+
+    swapsDirty_ = false;
+}
+
+void BoardSimulator::Swap(const SimMove& move)
+{
+    Match& m1 = matches_(move.m1_.x_, move.m1_.y_);
+    Match& m2 = matches_(move.m2_.x_, move.m2_.y_);
+
+    const unsigned property = m1.property_;
+    m1.property_ = m2.property_;
+    m2.property_ = property;
+}
+
+int BoardSimulator::ResolveMove(const SimMove& move, bool countobjectives)
+{
+    Swap(move);
+    UpdateBitBoard();
+
+    // the moved powers are activated
+    BitBoard activated;
+    if (IsPower(move.m1_.x_, move.m1_.y_))
+        activated.Set(move.m1_.x_, move.m1_.y_);
+    if (IsPower(move.m2_.x_, move.m2_.y_))
+        activated.Set(move.m2_.x_, move.m2_.y_);
+
+    MatchBitBoardResult result;
+    BitBoard bonuscells;
+    unsigned char bonuseffects[2];
+
+    int depth = 0;
+    while (depth < SIM_MAXCASCADES)
+    {
+        bitboard_.FindMatches(Match::MINIMALMATCHES, BLUE, ROCKS, result);
+
+        const BitBoard cells = result.all_ | activated;
+        if (cells.IsEmpty())
+            break;
+
+        bonuscells.Clear();
+        if (!depth)
+            GetBonuses(move, bonuscells, bonuseffects);
+
+        Destroy(cells, bonuscells, countobjectives);
+
+        if (!bonuscells.IsEmpty())
+        {
+            if (bonuscells.Test(move.m1_.x_, move.m1_.y_))
+                matches_(move.m1_.x_, move.m1_.y_).effect_ = bonuseffects[0];
+            if (bonuscells.Test(move.m2_.x_, move.m2_.y_))
+                matches_(move.m2_.x_, move.m2_.y_).effect_ = bonuseffects[1];
+        }
+
+        Collapse();
+        Refill();
+        UpdateBitBoard();
+
+        activated.Clear();
+        depth++;
+    }
+
+    if (level_->ramptiles_.Size() || level_->tileexits_.Size())
+        UpdateDirectionalTiles();
+
+    return depth;
+}
+
+// a moved match in a big match becomes a power (BONUSMINIMALMATCHES)
+void BoardSimulator::GetBonuses(const SimMove& move, BitBoard& bonuscells, unsigned char* bonuseffects)
+{
+    for (int i=0; i < 2; i++)
+    {
+        const IntVector2& position = i ? move.m2_ : move.m1_;
+        const Match& match = matches_(position.x_, position.y_);
+
+        bonuseffects[i] = NOEFFECT;
+
+        if (match.effect_ != NOEFFECT || !IsSelectable(position.x_, position.y_))
+            continue;
+
+        const BitBoard hruns = bitboard_.GetHorizontalRuns(match.ctype_, Match::MINIMALMATCHES);
+        const BitBoard vruns = bitboard_.GetVerticalRuns(match.ctype_, Match::MINIMALMATCHES);
+
+        if (bitboard_.GetLShapes(match.ctype_, hruns, vruns).Test(position.x_, position.y_))
+            bonuseffects[i] = XYEXPLOSION;
+        else if (bitboard_.GetHorizontalRuns(match.ctype_, Match::BONUSMINIMALMATCHES).Test(position.x_, position.y_))
+            bonuseffects[i] = XEXPLOSION;
+        else if (bitboard_.GetVerticalRuns(match.ctype_, Match::BONUSMINIMALMATCHES).Test(position.x_, position.y_))
+            bonuseffects[i] = YEXPLOSION;
+        else if (bitboard_.GetSquares(match.ctype_).Test(position.x_, position.y_))
+            bonuseffects[i] = SQREXPLOSION;
+
+        if (bonuseffects[i] != NOEFFECT)
+            bonuscells.Set(position.x_, position.y_);
+    }
+}
+
+// the walls hitted by an activated power (MatchGrid::GetMatches)
+void BoardSimulator::GetHittedWalls(const Match& match)
+{
+    const int effect = match.effect_;
+    int min, max;
+
+    if (effect == XEXPLOSION || effect == XYEXPLOSION)
+        MatchGrid::GetHorizontalLine(grid_, match.x_, match.y_, min, max, &hittedwalls_);
+    if (effect == YEXPLOSION || effect == XYEXPLOSION)
+        MatchGrid::GetVerticalLine(grid_, match.x_, match.y_, min, max, &hittedwalls_);
+    if (effect == WALLBREAKER)
+        MatchGrid::GetWallsAround(grid_, match.x_, match.y_, 1, hittedwalls_);
+}
+
+// destroy the cells and the cells of the activated powers (chain reaction)
+void BoardSimulator::Destroy(const BitBoard& cells, const BitBoard& keepcells, bool countobjectives)
+{
+    // the chain reactions : the bitboard is up to date (UpdateBitBoard)
+    resolver_.Setup(bitboard_);
+    for (int y=0; y < height_; y++)
+        for (int x=0; x < width_; x++)
+        {
+            if (IsPower(x, y))
+                resolver_.AddPower(x, y, matches_(x, y).effect_);
+        }
+
+    BitBoard activated;
+    const BitBoard done = resolver_.Resolve(cells, keepcells, &activated);
+
+    // the walls are broken after the turn (MatchGrid::SetHittedWalls)
+    hittedwalls_.Clear();
+    for (int y=0; y < height_; y++)
+        for (int x=0; x < width_; x++)
+        {
+            if (activated.Test(x, y))
+                GetHittedWalls(matches_(x, y));
+        }
+
+    for (unsigned i=0; i < hittedwalls_.Size(); i++)
+    {
+        if (MatchGrid::BreakWall(grid_, hittedwalls_[i]))
+            swapsDirty_ = true;
+    }
+
+    for (int y=0; y < height_; y++)
+    {
+        for (int x=0; x < width_; x++)
+        {
+            if (!done.Test(x, y) || keepcells.Test(x, y))
+                continue;
+
+            Match& match = matches_(x, y);
+            if (!match.ctype_)
+                continue;
+
+            if (countobjectives)
+            {
+                const int i = (int)match.ctype_ - BLUE;
+                if (i >= 0 && i < (int)objectives_.Size() && objectives_[i] > 0)
+                    objectives_[i]--;
+
+                destroyed_++;
+            }
+
+            match.property_ = 0;
+        }
+    }
+}
+
+// MatchGrid::CollapseColumn on all the columns
+void BoardSimulator::Collapse()
+{
+    for (int x=0; x < width_; x++)
+        MatchGrid::Collapse(grid_, matches_, x, transfers_);
+}
+
+// MatchGrid::AddColumn on all the columns
+void BoardSimulator::Refill()
+{
+    for (int x=0; x < width_; x++)
+    {
+        MatchGrid::GetRefillCells(grid_, matches_, x, transfers_);
+
+        for (unsigned i=0; i < transfers_.Size(); i++)
+            AddObject(matches_(x, transfers_[i].y_));
+    }
+}
+
+// MatchGridInfo::UpdateItems : a step of the directional tiles after each move, then the collapse of the fixed columns
+void BoardSimulator::UpdateDirectionalTiles()
+{
+    for (unsigned i=0; i < level_->tileexits_.Size(); i++)
+    {
+        const IntVector2& exit = level_->tileexits_[i];
+        matches_(exit.x_, exit.y_).property_ = 0;
+    }
+
+    if (level_->ramptiles_.Size())
+        MatchGrid::MoveOnRamps(grid_, matches_, level_->ramptiles_, gridupdates_, transfers_);
+
+    for (unsigned i=0; i < level_->tileentrances_.Size(); i++)
+    {
+        const IntVector2& entrance = level_->tileentrances_[i].position_;
+        Match& match = matches_(entrance.x_, entrance.y_);
+        if (!match.ctype_)
+            AddObject(match);
+    }
+
+    for (unsigned i=0; i < level_->fixedcolumns_.Size(); i++)
+        MatchGrid::Collapse(grid_, matches_, level_->fixedcolumns_[i], transfers_);
+
+    UpdateBitBoard();
+}
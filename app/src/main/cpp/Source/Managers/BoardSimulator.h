@@ -0,0 +1,163 @@
+#pragma once
+
+#include <Urho3D/Container/Str.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Container/HashMap.h>
+
+#include "GameRand.h"
+#include "MemoryObjects.h"
+#include "Matches.h"
+#include "MatchPowerResolver.h"
+
+namespace Urho3D
+{
+    class Context;
+}
+
+using namespace Urho3D;
+
+
+struct SimMove
+{
+    SimMove() { }
+    SimMove(int x1, int y1, int x2, int y2) : m1_(x1, y1), m2_(x2, y2) { }
+
+    IntVector2 m1_, m2_;
+};
+
+/// Level parameters : prepared in the main thread (GameStatics::SetLevelParameters, MatchGrid::SetLayout)
+struct SimLevelParams
+{
+    unsigned seed_;
+    int level_;
+    int layoutshape_, layoutsize_;
+    int numcolors_, numobjectives_, totalitems_;
+    int maxmoves_;
+
+    Matrix2D<GridTile> grid_;
+    /// the directional tiles of the layout (MatchGrid::AddDirectionalTileRamp)
+    Vector<Vector<IntVector2> > ramptiles_;
+    Vector<TileEntrance> tileentrances_;
+    Vector<IntVector2> tileexits_;
+    Vector<unsigned char> fixedcolumns_;
+};
+
+struct SimLevelReport
+{
+    unsigned seed_;
+    int level_;
+    int layoutshape_, layoutsize_;
+    int numobjectives_, totalitems_;
+
+    bool win_;
+    int movesUsed_;
+    int maxCascadeDepth_;
+    int totalCascades_;
+    int reshuffles_;
+    int destroyed_;
+};
+
+class BoardSimulator;
+
+/// Move Policy : must be stateless, the same policy is used by all the simulation threads
+class SimMovePolicy
+{
+public:
+    virtual ~SimMovePolicy() { }
+
+    virtual bool ChooseMove(const BoardSimulator& board, const PODVector<SimMove>& moves, GameRand& random, SimMove& move) const = 0;
+};
+
+/// pick a random valid move
+class SimRandomPolicy : public SimMovePolicy
+{
+public:
+    virtual bool ChooseMove(const BoardSimulator& board, const PODVector<SimMove>& moves, GameRand& random, SimMove& move) const;
+};
+
+/// pick the valid move that destroys the most matches (objectives first)
+class SimGreedyPolicy : public SimMovePolicy
+{
+public:
+    virtual bool ChooseMove(const BoardSimulator& board, const PODVector<SimMove>& moves, GameRand& random, SimMove& move) const;
+};
+
+
+/// Headless Board Simulator
+/// plays a level with the MatchGrid rules core (layouts, draws, collapses, walls, directional tiles) without any Node or Scene.
+/// the objects are drawn from simulated types : the directional and square powers, the rocks, an enemy by color.
+class BoardSimulator
+{
+public:
+    BoardSimulator();
+
+    /// Policies
+    static void RegisterPolicy(const String& name, SimMovePolicy* policy);
+    static const SimMovePolicy* GetPolicy(const String& name);
+
+    /// Batch : levels setup in the main thread, simulations in the WorkQueue
+    /// layout : the layout of the level if -1
+    static void SetupLevel(unsigned seed, int level, int numcolors, int maxmoves, int layout, SimLevelParams& params);
+    static void RunBatch(Context* context, const Vector<SimLevelParams>& levels, const SimMovePolicy& policy, Vector<SimLevelReport>& reports);
+    static String GetSummary(const Vector<SimLevelReport>& reports, float elapsedtime);
+    static bool SaveReports(Context* context, const String& filename, const Vector<SimLevelReport>& reports);
+    /// Command line : -simulate numlevels [-simlevel first] [-simseed seed] [-simcolors n] [-simmoves n] [-simlayout shape] [-simwalls chance] [-simrocks chance] [-simpolicy name] [-simout file.csv]
+    static int RunCommandLine(Context* context, const Vector<String>& arguments);
+
+    /// Simulation
+    void Play(const SimLevelParams& params, const SimMovePolicy& policy, SimLevelReport& report);
+
+    /// Getters
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+    const Match& GetMatch(int x, int y) const { return matches_(x, y); }
+    bool IsObjective(unsigned char ctype) const;
+
+    void GetValidMoves(PODVector<SimMove>& moves) const;
+    /// number of matches destroyed by the first turn of the move (weighted for the objectives)
+    int EvaluateMove(const SimMove& move) const;
+
+private:
+    void Create(const SimLevelParams& params);
+    void AddObject(Match& match);
+    void Stabilize();
+    void Shuffle();
+
+    bool IsSelectable(int x, int y) const;
+    bool IsPower(int x, int y) const { return matches_(x, y).effect_ != NOEFFECT; }
+
+    void UpdateBitBoard();
+    void UpdateSwaps();
+    void Swap(const SimMove& move);
+    int ResolveMove(const SimMove& move, bool countobjectives);
+    void GetBonuses(const SimMove& move, BitBoard& bonuscells, unsigned char* bonuseffects);
+    void GetHittedWalls(const Match& match);
+    void Destroy(const BitBoard& cells, const BitBoard& keepcells, bool countobjectives);
+    void Collapse();
+    void Refill();
+    void UpdateDirectionalTiles();
+
+    int width_, height_;
+    int numcolors_;
+    int destroyed_;
+
+    const SimLevelParams* level_;
+    Matrix2D<GridTile> grid_;
+    Matrix2D<Match> matches_;
+    MatchBitBoard bitboard_;
+    MatchPowerResolver resolver_;
+    /// the swaps of adjacent ground cells without walls between them, rebuilt when walls are broken
+    PODVector<SimMove> swaps_;
+    bool swapsDirty_;
+    GameRand random_;
+
+    /// the buffers of the rules core
+    Vector<WallInfo> hittedwalls_;
+    PODVector<IntVector2> transfers_;
+    Matrix2D<int> gridupdates_;
+
+    /// remaining items by objective color
+    PODVector<int> objectives_;
+
+    static HashMap<String, SimMovePolicy*> policies_;
+};
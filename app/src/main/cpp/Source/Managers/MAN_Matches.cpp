@@ -1,6 +1,7 @@
 #include <Urho3D/Urho3D.h>
 
 #include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/WorkQueue.h>
 
 #include <Urho3D/IO/Log.h>
 
@@ -31,7 +32,11 @@
 #include "GameOptions.h"
 #include "GameAttributes.h"
 #include "GameHelpers.h"
+#include "GameLog.h"
+#include "GameProfiler.h"
+#include "GameAllocTracker.h"
 #include "GameEvents.h"
+#include "EventChannel.h"
 #include "TimerRemover.h"
 #include "sPlay.h"
 #include "Network.h"
@@ -43,6 +48,7 @@
 #include "InteractiveFrame.h"
 
 #include "MAN_Matches.h"
+#include "MatchReplay.h"
 
 const Color gridcolors_[2] =
 {
@@ -67,6 +73,7 @@ bool MatchesManager::testMode_ = false;
 bool MatchesManager::allowSelectionAlongHV_ = false;
 bool MatchesManager::allowHints_ = true;
 bool MatchesManager::checkallpowersonturn_ = true;
+bool MatchesManager::fastForward_ = false;
 float MatchesManager::sceneScale_ = 1.f;
 
 SharedPtr<MatchesManager> MatchesManager::manager_;
@@ -83,6 +90,8 @@ MatchesManager::MatchesManager(Context* context) :
     manager_ = SharedPtr<MatchesManager>(this);
 
     gridinfos_.Clear();
+    // a new grid resets the authorized objects (the MatchGrid layouts of the BoardSimulator keep them)
+    MatchGrid::ClearAuthorizedTypes();
     gridinfos_.Push(SharedPtr<MatchGridInfo>(new MatchGridInfo()));
 
     gridinfos_.Back()->netusage_ = NETLOCAL;
@@ -139,6 +148,7 @@ void MatchesManager::AddGrid(int netusage)
     if (!manager_)
         return;
 
+    MatchGrid::ClearAuthorizedTypes();
     manager_->gridinfos_.Push(SharedPtr<MatchGridInfo>(new MatchGridInfo()));
 
     const int id = manager_->gridinfos_.Size()-1;
@@ -414,6 +424,8 @@ void MatchesManager::Stop()
 
     allowHints_ = false;
 
+    MatchReplay::StopSession();
+
     // allow when levelwin to allow move matches
 //    manager_->UnsubscribeFromEvents();
 }
@@ -428,6 +440,8 @@ void MatchesManager::Clear()
 
     URHO3D_LOGWARNING("MatchesManager() - Clear !");
 
+    MatchReplay::StopSession();
+
     manager_->UnsubscribeFromEvents();
 
     manager_->Init();
@@ -504,6 +518,8 @@ void MatchesManager::ShakeMatches(int gridid)
 {
     URHO3D_LOGINFOF("MatchesManager() - ShakeMatches : Respawn Matches !");
 
+    MatchReplay::RecordShake(gridid);
+
     ResetObjects(gridid);
 }
 
@@ -740,6 +756,8 @@ void MatchesManager::HandleUpdateInitial(StringHash eventType, VariantMap& event
 
     if (numfinishedinitial == manager_->gridinfos_.Size())
     {
+        MatchReplay::StartSession();
+
         for (int i = 0; i < manager_->gridinfos_.Size(); i++)
         {
             GetGridInfo(i)->Init();
@@ -750,19 +768,68 @@ void MatchesManager::HandleUpdateInitial(StringHash eventType, VariantMap& event
     }
 }
 
+static void UpdateBoardWork(const WorkItem* item, unsigned threadIndex)
+{
+    // the tag is by thread : the scope of HandleUpdateClassicMode doesn't cover the worker
+    GAMEALLOC_SCOPE(GAMEALLOC_MATCHES);
+    static_cast<MatchGridInfo*>(item->start_)->UpdateBoard();
+}
+
+void MatchesManager::UpdateBoards()
+{
+    boardupdates_.Clear();
+    for (int i = 0; i < gridinfos_.Size(); i++)
+    {
+        if (gridinfos_[i]->PrepareBoardUpdate())
+            boardupdates_.Push(gridinfos_[i].Get());
+    }
+
+    if (!boardupdates_.Size())
+        return;
+
+    WorkQueue* queue = GetSubsystem<WorkQueue>();
+    if (boardupdates_.Size() == 1 || !queue || !queue->GetNumThreads())
+    {
+        for (unsigned i = 0; i < boardupdates_.Size(); i++)
+            boardupdates_[i]->UpdateBoard();
+        return;
+    }
+
+    // one item by grid : the grids share no data
+    for (unsigned i = 0; i < boardupdates_.Size(); i++)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = UpdateBoardWork;
+        item->start_ = boardupdates_[i];
+        queue->AddWorkItem(item);
+    }
+
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
 void MatchesManager::HandleUpdateClassicMode(StringHash eventType, VariantMap& eventData)
 {
+    GAMEPROFILE(MatchesUpdateClassicMode);
+    GAMEALLOC_SCOPE(GAMEALLOC_MATCHES);
+
     for (int i = 0; i < manager_->gridinfos_.Size(); i++)
     {
         MatchGridInfo* gridinfo = manager_->gridinfos_[i];
 
-        if (gridinfo->netusage_ == NETLOCAL && GameStatics::allowInputs_)
+        if (gridinfo->netusage_ == NETLOCAL && MatchReplay::IsReplaying())
+            gridinfo->Replay_UpdateControl();
+        else if (gridinfo->netusage_ == NETLOCAL && GameStatics::allowInputs_)
             gridinfo->UpdateControl();
         else if (gridinfo->netusage_ == NETREMOTE)
             gridinfo->Net_UpdateControl();
-
-        gridinfo->Update();
     }
+
+    // the board logic in parallel, then the scene mutations in the main thread
+    manager_->UpdateBoards();
+
+    for (int i = 0; i < manager_->gridinfos_.Size(); i++)
+        manager_->gridinfos_[i]->Update();
 }
 
 void MatchesManager::HandleUpdateBossMode(StringHash eventType, VariantMap& eventData)
@@ -866,10 +933,29 @@ void MatchesManager::DrawDebugGeometry(DebugRenderer* debug, bool depth) const
 
 /// MatchGridInfo
 
+/// adds to count the heap allocations of the thread during its scope
+/// (only with ACTIVE_GAMEALLOCTRACKER, MatchGridInfo::Init warns that nothing is counted otherwise)
+struct BoardAllocationsCounter
+{
+    BoardAllocationsCounter(unsigned& count) : count_(count), start_(GameAllocTracker::GetThreadAllocations()) { }
+    ~BoardAllocationsCounter() { count_ += GameAllocTracker::GetThreadAllocations() - start_; }
+
+    unsigned& count_;
+    unsigned start_;
+};
+
 MatchGridInfo::MatchGridInfo() :
     RefCounted(),
-    abilitySelected_(StringHash::ZERO),
-    hintsearchTimer_(0U)
+    turnCapacity_(0),
+    turnBufferGrowths_(0),
+    turnAllocations_(0),
+    boardAllocations_(0),
+    boardSearchMatches_(false),
+    boardIndexHints_(false),
+    matchesSearched_(false),
+    hintsIndexed_(false),
+    matchesFound_(false),
+    abilitySelected_(StringHash::ZERO)
 {
     netTosendCommands_.Reserve(100);
 }
@@ -880,6 +966,13 @@ MatchGridInfo::~MatchGridInfo()
 void MatchGridInfo::Init()
 {
     objectives_.Reserve(MAXOBJECTIVES);
+    turnBufferGrowths_ = 0;
+    turnAllocations_ = 0;
+    boardAllocations_ = 0;
+#ifndef ACTIVE_GAMEALLOCTRACKER
+    URHO3D_LOGWARNINGF("MatchGridInfo() - Init : gridid=%d the heap allocations of the board logic are not counted (no ACTIVE_GAMEALLOCTRACKER, see SPACEMATCH_WITH_ALLOCTRACKER) !", mgrid_.gridid_);
+#endif
+    ReserveTurnBuffers();
     objectiveDirty_ = false;
     moveCount_ = 0;
 
@@ -942,6 +1035,7 @@ void MatchGridInfo::CreateObjects()
     startMatches_.Clear();
 
     mgrid_.Create(startMatches_);
+    ReserveTurnBuffers();
 
     ResetState();
     ResetHints();
@@ -1106,10 +1200,13 @@ void MatchGridInfo::ResetState()
     ChangeState(NoMatchState);
     successTurns_ = turnProcessed_ = 0;
 
+    if (MatchReplay::IsActive())
+        MatchReplay::OnTurn(mgrid_.gridid_, mgrid_.GetHash());
+
     CheckHints(true);
 
     if (!objectiveDirty_)
-        MatchesManager::Get()->SendEvent(GAME_NOMATCHSTATE);
+        EventChannel<NoMatchStateEvent>::Send(MatchesManager::Get(), NoMatchStateEvent());
 }
 
 void MatchGridInfo::ChangeState(int state)
@@ -1117,7 +1214,7 @@ void MatchGridInfo::ChangeState(int state)
     if (state != state_)
     {
         state_ = state;
-        MatchesManager::Get()->SendEvent(GAME_MATCHSTATECHANGE);
+        EventChannel<MatchStateChangeEvent>::Send(MatchesManager::Get(), MatchStateChangeEvent());
     }
 }
 
@@ -1186,9 +1283,9 @@ void MatchGridInfo::ApplyCurrentAbilityOn(Match* match)
 
 	matchesToCheck_.Clear();
 	if (MatchesManager::checkallpowersonturn_)
-        Match::AddDistinctEntries(mgrid_.GetAllPowers(), matchesToCheck_);
+        mgrid_.GetAllPowers(matchesToCheck_);
 
-    matchesToCheck_.Push(match);
+    matchesToCheck_.Insert(match);
 
     allowCheckObjectives_ = true;
 
@@ -1229,10 +1326,13 @@ void MatchGridInfo::ResetHints()
     if (ishowhints_ != -1)
         SetHintsAnimations(false);
 
+    // keep the cell hints buffers : all the cells will be updated
     hints_.Clear();
+    for (unsigned i=0; i < cellhints_.Size(); i++)
+        cellhints_[i].Clear();
+    mgrid_.SetAllTouched();
     hintstate_ = 0;
     ishowhints_ = ilasthint_ = -1;
-    ihintsearchmatch_ = 0;
     hintTimer_.Reset();
 }
 
@@ -1244,11 +1344,11 @@ void MatchGridInfo::SetHintsAnimations(bool state)
         return;
     }
 
-    const Vector<Match*>& hints = hints_[ishowhints_];
+    const MatchHint& hints = hints_[ishowhints_];
 
 //    URHO3D_LOGINFOF("MatchGridInfo() - SetHintsAnimations : %s ; index=%d hints=%u !", state ? "SHOW":"MASK", ishowhints_, hints.Size());
 
-    for (Vector<Match*>::ConstIterator it=hints.Begin();it!=hints.End();++it)
+    for (Match* const* it=hints.Begin();it!=hints.End();++it)
         mgrid_.SetHintAnimation(**it, state);
 }
 
@@ -1308,9 +1408,9 @@ void MatchGridInfo::MoveSelection()
 
 	matchesToCheck_.Clear();
 	if (MatchesManager::checkallpowersonturn_)
-        Match::AddDistinctEntries(mgrid_.GetAllPowers(), matchesToCheck_);
+        mgrid_.GetAllPowers(matchesToCheck_);
 
-    Match::AddDistinctEntries(mgrid_.GetPermuttedMatches(), matchesToCheck_);
+    mgrid_.GetPermuttedMatches(matchesToCheck_);
 
     // assign a first turnTime
 //    animationTimer_ = turnTime_ = MOVETIME;
@@ -1331,7 +1431,7 @@ void MatchGridInfo::ConfirmSelection()
 
         moveCount_++;
         // TODO : for local multiplayer ... send the gridid
-        MatchesManager::Get()->SendEvent(GAME_MOVEREMOVED);
+        EventChannel<MoveRemovedEvent>::Send(MatchesManager::Get(), MoveRemovedEvent());
 
         ChangeState(SuccessMatch);
         successTurns_++;
@@ -1378,7 +1478,7 @@ void MatchGridInfo::ConfirmSelection_Boss()
 
         moveCount_++;
         // TODO : for local multiplayer ... send the gridid
-        MatchesManager::Get()->SendEvent(GAME_MOVEREMOVED);
+        EventChannel<MoveRemovedEvent>::Send(MatchesManager::Get(), MoveRemovedEvent());
     }
     else
     {
@@ -1391,7 +1491,8 @@ void MatchGridInfo::ConfirmSelection_Boss()
     if (state_ != SuccessMatch)
     {
         // Find columns
-        Vector<unsigned char> columns;
+        PODVector<unsigned char>& columns = collapsecolumns_;
+        columns.Clear();
 
         if (!mgrid_.IsDirectionalTile(selected_[0]))
             columns.Push(selected_[0].x_);
@@ -1400,9 +1501,10 @@ void MatchGridInfo::ConfirmSelection_Boss()
             columns.Push(selected_[1].x_);
 
         // Collapse columns
-        Vector<Match*> collapsedMatches;
+        Vector<Match*>& collapsedMatches = collapsematches_;
+        collapsedMatches.Clear();
         int maxdistance = 1;
-        for (Vector<unsigned char>::ConstIterator xt=columns.Begin();xt!=columns.End();++xt)
+        for (PODVector<unsigned char>::ConstIterator xt=columns.Begin();xt!=columns.End();++xt)
         {
             int distance = mgrid_.CollapseColumn(*xt, collapsedMatches);
             if (distance > maxdistance)
@@ -1421,7 +1523,7 @@ void MatchGridInfo::ConfirmSelection_Boss()
 void MatchGridInfo::RemoveMatchAndCollapse(const Match& m)
 {
     Match& match = mgrid_.matches_(m.x_, m.y_);
-    destroymatches_.Push(&match);
+    destroymatches_.Insert(&match);
 
     ChangeState(SuccessMatch);
     successtoProcess_ = true;
@@ -1456,35 +1558,61 @@ void MatchGridInfo::AcquirePower(const Match& m)
 
 bool MatchGridInfo::FindMatches(const Vector<Match*>& tocheck)
 {
+    MatchSet tocheckset;
+    tocheckset.Insert(tocheck);
+    return FindMatches(tocheckset);
+}
+
+bool MatchGridInfo::FindMatches(const MatchSet& tocheck)
+{
+    SearchMatches(tocheck);
+    return ApplyFoundMatches();
+}
+
+void MatchGridInfo::SearchMatches(const MatchSet& tocheck)
+{
+    GAMEALLOC_NOALLOC("MatchGridInfo::SearchMatches");
+    BoardAllocationsCounter allocationsCounter(boardAllocations_);
+
     destroymatches_.Clear();
     successmatches_.Clear();
     activablebonuses_.Clear();
     brokenrocks_.Clear();
     hittedwalls_.Clear();
 
-    Vector<Match*> newfoundmatches;
+    MatchSet newfoundmatches;
+
+    // the walls and the colors don't change during the search
+    mgrid_.UpdatePowerResolver();
 
-    for (int i=0; i < tocheck.Size(); i++)
+    for (unsigned i=0; i < tocheck.Size(); i++)
     {
         newfoundmatches.Clear();
 
         if (mgrid_.GetMatches(tocheck[i], newfoundmatches, successmatches_, activablebonuses_, brokenrocks_, hittedwalls_))
-            Match::AddDistinctEntries(newfoundmatches, destroymatches_);
+            destroymatches_.Insert(newfoundmatches);
     }
 
 	if (brokenrocks_.Size() && GameStatics::IsBossLevel())
 	{
-		Match::AddDistinctEntries(brokenrocks_, destroymatches_);
+		destroymatches_.Insert(brokenrocks_);
 		brokenrocks_.Clear();
 	}
 
+    // successtoProcess_ drives Update() : only set by ApplyFoundMatches in the main thread
+    matchesFound_ = (destroymatches_.Size() > 0);
+}
+
+bool MatchGridInfo::ApplyFoundMatches()
+{
 	if (hittedwalls_.Size())
 	{
 		mgrid_.SetHittedWalls(hittedwalls_);
 	}
 
-    successtoProcess_ = (destroymatches_.Size() > 0);
+    CheckTurnAllocations("FindMatches");
 
+    successtoProcess_ = matchesFound_;
     return successtoProcess_;
 }
 
@@ -1500,14 +1628,14 @@ void MatchGridInfo::ApplySuccessMatches()
 
         hintstate_ = HintNoMove;
         hintTimer_.Reset();
-        ihintsearchmatch_ = 0;
     }
 
     successtoProcess_ = false;
 
     matchesToCheck_.Clear();
 
-    Vector<unsigned char> columns;
+    PODVector<unsigned char>& columns = collapsecolumns_;
+    columns.Clear();
 
     Match turnbonus;
 
@@ -1515,10 +1643,10 @@ void MatchGridInfo::ApplySuccessMatches()
     {
 //        URHO3D_LOGINFOF("MatchesManager() - ApplySuccessMatches : ... matches=%u => SUCCESS=%d", successmatches_.Size(), successTurns_);
         // Activate effects for activablebonuses
-        for (Vector<Match*>::ConstIterator mt=activablebonuses_.Begin();mt!=activablebonuses_.End();++mt)
+        for (MatchSet::ConstIterator mt=activablebonuses_.Begin();mt!=activablebonuses_.End();++mt)
             mgrid_.AddPowerEffects(**mt);
 
-        for (Vector<Match*>::ConstIterator mt=successmatches_.Begin();mt!=successmatches_.End();++mt)
+        for (MatchSet::ConstIterator mt=successmatches_.Begin();mt!=successmatches_.End();++mt)
             mgrid_.AddSuccessEffect(**mt);
 
         // search for a bonus if enough success
@@ -1531,13 +1659,13 @@ void MatchGridInfo::ApplySuccessMatches()
 
         if (successTurns_ >= Match::BONUSGAINMOVE && successTurns_%Match::BONUSGAINMOVE == 0)
             // TODO : for local multiplayer ... send the gridid
-            MatchesManager::Get()->SendEvent(GAME_MOVEADDED);
+            EventChannel<MoveAddedEvent>::Send(MatchesManager::Get(), MoveAddedEvent());
     }
 
     // find columns to collapse and remove objects
     {
 //        URHO3D_LOGINFOF("MatchesManager() - ApplySuccessMatches : find columns to collapse and remove objects ...");
-        for (Vector<Match*>::ConstIterator mt=destroymatches_.Begin();mt!=destroymatches_.End();++mt)
+        for (MatchSet::ConstIterator mt=destroymatches_.Begin();mt!=destroymatches_.End();++mt)
         {
             Match* match = *mt;
 
@@ -1606,7 +1734,7 @@ void MatchGridInfo::ApplySuccessMatches()
         turnScore_ = (turnDestroyScore+turnSuccessScore) * turnMultiplier + turnBonusSuccess;
 
         // TODO : for local multiplayer ... send the gridid
-        MatchesManager::Get()->SendEvent(GAME_SCORECHANGE);
+        EventChannel<ScoreChangeEvent>::Send(MatchesManager::Get(), ScoreChangeEvent());
 
 //        URHO3D_LOGINFOF("MatchGridInfo() - ApplySuccessMatches : SCORE=%u (TurnSuccess=%d Mul=%u Destroy=%u Success=%u Bonus=%u)!",
 //                        turnScore_, successTurns_, turnMultiplier, turnDestroyScore, turnSuccessScore, turnBonusSuccess);
@@ -1617,8 +1745,11 @@ void MatchGridInfo::ApplySuccessMatches()
 
     // collapse columns
 //    URHO3D_LOGINFOF("MatchGridInfo() - ApplySuccessMatches : collapse columns ...");
-    Vector<Match*> collapsedMatches;
-    for (Vector<unsigned char>::ConstIterator xt=columns.Begin();xt!=columns.End();++xt)
+    Vector<Match*>& collapsedMatches = collapsematches_;
+    Vector<Match*>& addedMatches = addedmatches_;
+    collapsedMatches.Clear();
+    addedMatches.Clear();
+    for (PODVector<unsigned char>::ConstIterator xt=columns.Begin();xt!=columns.End();++xt)
     {
         int distance = mgrid_.CollapseColumn(*xt, collapsedMatches);
         if (distance > maxdistance)
@@ -1629,9 +1760,9 @@ void MatchGridInfo::ApplySuccessMatches()
     if (GameStatics::GetLevelInfo().mode_ == CLASSICLEVELMODE)
     {
 //        URHO3D_LOGINFOF("MatchGridInfo() - ApplySuccessMatches : add new objects ...");
-        for (Vector<unsigned char>::ConstIterator xt=columns.Begin();xt!=columns.End();++xt)
+        for (PODVector<unsigned char>::ConstIterator xt=columns.Begin();xt!=columns.End();++xt)
         {
-            int distance = mgrid_.AddColumn(*xt, matchesToCheck_);
+            int distance = mgrid_.AddColumn(*xt, addedMatches);
             if (distance > maxdistance)
                 maxdistance = distance;
         }
@@ -1641,14 +1772,18 @@ void MatchGridInfo::ApplySuccessMatches()
     turnTime_ = Min(Max((float)maxdistance, 1.f) * MOVETIME, MAXMOVETIME)*1000;
     animationTimer_.Reset();
 
+    matchesToCheck_.Insert(addedMatches);
+
     // add matchbonus to find new matches
     if (bonusNode)
-        matchesToCheck_.Push(&mgrid_.matches_(turnbonus.x_, turnbonus.y_));
+        matchesToCheck_.Insert(&mgrid_.matches_(turnbonus.x_, turnbonus.y_));
 
     // update matches to check
 	if (MatchesManager::checkallpowersonturn_)
-        Match::AddDistinctEntries(mgrid_.GetAllPowers(), matchesToCheck_);
-    Match::AddDistinctEntries(collapsedMatches, matchesToCheck_);
+        mgrid_.GetAllPowers(matchesToCheck_);
+    matchesToCheck_.Insert(collapsedMatches);
+
+    CheckTurnAllocations("ApplySuccessMatches");
 
     URHO3D_LOGINFOF("MatchGridInfo() - ApplySuccessMatches : ... Finished ! (objectivedirty=%u allowcheck=%u)", objectiveDirty_, allowCheckObjectives_);
 
@@ -1656,7 +1791,7 @@ void MatchGridInfo::ApplySuccessMatches()
     if (allowCheckObjectives_ && objectiveDirty_)
     {
         // TODO : for local multiplayer ... send the gridid
-        MatchesManager::Get()->SendEvent(GAME_OBJECTIVECHANGE);
+        EventChannel<ObjectiveChangeEvent>::Send(MatchesManager::Get(), ObjectiveChangeEvent());
         objectiveDirty_ = false;
     }
 }
@@ -1789,9 +1924,7 @@ void NetCommandData::WriteToBuffer(VectorBuffer& buffer) const
 
 NetCommandData* MatchGridInfo::Net_PrepareCommand(NetCommand cmd)
 {
-    if (!Network::Get(false))
-        return nullptr;
-    if (!GameStatics::peerConnected_)
+    if (!MatchReplay::IsRecording() && (!Network::Get(false) || !GameStatics::peerConnected_))
         return nullptr;
 
     netTosendCommands_.Resize(netTosendCommands_.Size()+1);
@@ -1802,16 +1935,20 @@ NetCommandData* MatchGridInfo::Net_PrepareCommand(NetCommand cmd)
 
 void MatchGridInfo::Net_SendCommands()
 {
-    if (!Network::Get(false))
-        return;
-    if (!GameStatics::peerConnected_ || !netTosendCommands_.Size())
+    if (!netTosendCommands_.Size())
         return;
 
-    preparedCommands_.Clear();
-    for (Vector<NetCommandData>::ConstIterator it = netTosendCommands_.Begin(); it != netTosendCommands_.End(); ++it)
-        it->WriteToBuffer(preparedCommands_);
+    if (MatchReplay::IsRecording())
+        MatchReplay::RecordCommands(mgrid_.gridid_, netTosendCommands_);
 
-    Network::Get()->SendBuffer(preparedCommands_, "griddata");
+    if (Network::Get(false) && GameStatics::peerConnected_)
+    {
+        preparedCommands_.Clear();
+        for (Vector<NetCommandData>::ConstIterator it = netTosendCommands_.Begin(); it != netTosendCommands_.End(); ++it)
+            it->WriteToBuffer(preparedCommands_);
+
+        Network::Get()->SendBuffer(preparedCommands_, "griddata");
+    }
 
     netTosendCommands_.Clear();
 }
@@ -1919,6 +2056,32 @@ void MatchGridInfo::Net_UpdateControl()
     netReceivedCommands_.PopFront();
 }
 
+void MatchGridInfo::Replay_UpdateControl()
+{
+    // the commands are recorded in the input states only
+    if (state_ != NoMatchState && state_ != StartSelection)
+        return;
+
+    const MatchReplayEvent* event = MatchReplay::GetNextEvent(mgrid_.gridid_);
+    if (!event)
+        return;
+
+    if (event->type_ == REPLAYEVENT_SHAKE)
+    {
+        MatchReplay::PopEvent(mgrid_.gridid_);
+        MatchesManager::ShakeMatches(mgrid_.gridid_);
+        return;
+    }
+
+    netReceivedCommands_.Resize(netReceivedCommands_.Size()+1);
+    NetCommandData& cmddata = netReceivedCommands_.Back();
+    cmddata.cmd_ = (NetCommand)event->cmd_;
+    cmddata.params_.SetData(event->params_.GetData(), event->params_.GetSize());
+    MatchReplay::PopEvent(mgrid_.gridid_);
+
+    Net_UpdateControl();
+}
+
 
 void MatchGridInfo::UpdateControl()
 {
@@ -2160,7 +2323,7 @@ void MatchGridInfo::UpdateControl()
 
 void MatchGridInfo::UpdateControl_Boss()
 {
-    if (state_ == NoMatchState && animationTimer_.GetMSec(false) >= turnTime_)
+    if (state_ == NoMatchState && IsTurnTimeOver())
     {
         if (GameStatics::input_->GetNumTouches() > 0 || GameStatics::input_->GetMouseButtonPress(MOUSEB_LEFT))
         {
@@ -2517,6 +2680,16 @@ void MatchGridInfo::Update_Initial()
     }
 }
 
+bool MatchGridInfo::IsTurnTimeOver()
+{
+    return MatchesManager::fastForward_ || animationTimer_.GetMSec(false) >= turnTime_;
+}
+
+bool MatchGridInfo::IsPauseTimeOver()
+{
+    return MatchesManager::fastForward_ || pauseTimer_.GetMSec(false) >= PAUSETIME*1000;
+}
+
 void MatchGridInfo::Update()
 {
     if (state_ == CancelMove)
@@ -2524,7 +2697,7 @@ void MatchGridInfo::Update()
 //        URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic : state_=CancelMove timer=%u ...", animationTimer_.GetMSec(false) );
 
 //        if (animationTimer_ <= 0.f)
-        if (animationTimer_.GetMSec(false) >= turnTime_)
+        if (IsTurnTimeOver())
         {
             ResetSelection();
             ResetState();
@@ -2535,7 +2708,7 @@ void MatchGridInfo::Update()
 //        URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic : state_=SelectionAnimation timer=%u/%f ...", animationTimer_.GetMSec(false), turnTime_);
 
 //        if (animationTimer_ <= 0.f)
-        if (animationTimer_.GetMSec(false) >= turnTime_)
+        if (IsTurnTimeOver())
         {
 //            URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic : state_=SelectionAnimation timer=%u/%f ... Confirm ...", animationTimer_.GetMSec(false) , turnTime_);
             ConfirmSelection();
@@ -2548,7 +2721,7 @@ void MatchGridInfo::Update()
         if (successtoProcess_)
         {
             // wait pausetimer between turns
-            if (pauseTimer_.GetMSec(false) >= PAUSETIME*1000)
+            if (IsPauseTimeOver())
             {
                 ApplySuccessMatches();
                 pauseTimer_.Reset();
@@ -2556,9 +2729,9 @@ void MatchGridInfo::Update()
             }
         }
 //        else if (animationTimer_ <= 0.f)
-        else if (animationTimer_.GetMSec(false) >= turnTime_)
+        else if (IsTurnTimeOver())
         {
-            if (FindMatches(matchesToCheck_))
+            if (matchesSearched_ ? ApplyFoundMatches() : FindMatches(matchesToCheck_))
             {
                 successTurns_++;
 
@@ -2574,17 +2747,44 @@ void MatchGridInfo::Update()
         }
     }
 
+    matchesSearched_ = false;
+
     if (state_ != SuccessMatch && GameStatics::allowInputs_)
         UpdateHints();
 }
 
+bool MatchGridInfo::PrepareBoardUpdate()
+{
+    // same conditions as in Update()
+    boardSearchMatches_ = state_ == SuccessMatch && !successtoProcess_ && IsTurnTimeOver();
+    boardIndexHints_ = (state_ == NoMatchState || state_ == StartSelection) && GameStatics::allowInputs_ && hintsenabled_ &&
+                       mgrid_.HasTouchedCells() && !mgrid_.permutation_;
+
+    return boardSearchMatches_ || boardIndexHints_;
+}
+
+void MatchGridInfo::UpdateBoard()
+{
+    if (boardSearchMatches_)
+    {
+        SearchMatches(matchesToCheck_);
+        matchesSearched_ = true;
+    }
+
+    if (boardIndexHints_)
+    {
+        IndexHints();
+        hintsIndexed_ = true;
+    }
+}
+
 void MatchGridInfo::Update_Boss()
 {
     if (state_ == CancelMove)
     {
 //        URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic_Boss : state_=CancelMove timer=%f ...", animationTimer_);
 
-        if (animationTimer_.GetMSec(false) >= turnTime_)
+        if (IsTurnTimeOver())
         {
             ResetSelection();
             ResetState();
@@ -2594,7 +2794,7 @@ void MatchGridInfo::Update_Boss()
     {
 //        URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic_Boss : state_=SelectionAnimation timer=%f ...", animationTimer_);
 
-        if (animationTimer_.GetMSec(false) >= turnTime_)
+        if (IsTurnTimeOver())
             ConfirmSelection_Boss();
     }
     else if (state_ == SuccessMatch)
@@ -2610,14 +2810,14 @@ void MatchGridInfo::Update_Boss()
         if (successtoProcess_)
         {
             // wait pausetimer between turns
-            if (pauseTimer_.GetMSec(false) >= PAUSETIME*1000)
+            if (IsPauseTimeOver())
             {
                 ApplySuccessMatches();
                 pauseTimer_.Reset();
                 turnProcessed_++;
             }
         }
-        else if (animationTimer_.GetMSec(false) >= turnTime_)
+        else if (IsTurnTimeOver())
         {
             if (FindMatches(matchesToCheck_))
             {
@@ -2644,7 +2844,7 @@ void MatchGridInfo::Update_Test()
 {
     if (state_ == CancelMove)
     {
-        if (animationTimer_.GetMSec(false) >= turnTime_)
+        if (IsTurnTimeOver())
         {
             URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic_Test : state_=CancelMove timer=%F ...", animationTimer_.GetMSec(false));
             ResetSelection();
@@ -2653,7 +2853,7 @@ void MatchGridInfo::Update_Test()
     }
     else if (state_ == SelectionAnimation)
     {
-        if (animationTimer_.GetMSec(false) >= turnTime_)
+        if (IsTurnTimeOver())
         {
             URHO3D_LOGINFOF("MatchGridInfo() - UpdateLogic_Test : state_=SelectionAnimation timer=%F ...", animationTimer_.GetMSec(false));
             ConfirmSelection();
@@ -2672,7 +2872,7 @@ void MatchGridInfo::Update_Test()
             if (testModeNextMove_)
             {
                 // wait pausetimer between turns
-                if (pauseTimer_.GetMSec(false) >= PAUSETIME*1000)
+                if (IsPauseTimeOver())
                 {
                     testModeNextMove_ = false;
                     turnProcessed_++;
@@ -2683,7 +2883,7 @@ void MatchGridInfo::Update_Test()
                 }
             }
         }
-        else if (animationTimer_.GetMSec(false) >= turnTime_)
+        else if (IsTurnTimeOver())
         {
             if (FindMatches(matchesToCheck_))
             {
@@ -2740,53 +2940,167 @@ void MatchGridInfo::UpdateItems()
 }
 
 
-#define HINTSEARCHDELAY 6U   // milliseconds for search pass
+#define TURNBUFFERS_CELLHINTS 16
 
-void MatchGridInfo::UpdateHints()
+void MatchGridInfo::ReserveTurnBuffers()
 {
-//    if (!MatchesManager::allowHints_ || !hintsenabled_)
-//        return;
+    const int dimension = Max(Max((int)mgrid_.width_, (int)mgrid_.height_), Match::MAXDIMENSION);
+    const unsigned numcells = dimension * dimension;
 
-    if (!hintsenabled_)
+    collapsematches_.Reserve(numcells);
+    addedmatches_.Reserve(numcells);
+    collapsecolumns_.Reserve(dimension);
+    hittedwalls_.Reserve(numcells * 4);
+    hints_.Reserve(numcells * 4);
+    for (unsigned i=0; i < cellhints_.Size(); i++)
+        cellhints_[i].Reserve(TURNBUFFERS_CELLHINTS);
+
+    mgrid_.ReserveTurnBuffers();
+
+    turnCapacity_ = GetTurnBuffersCapacity();
+}
+
+unsigned MatchGridInfo::GetTurnBuffersCapacity() const
+{
+    unsigned capacity = mgrid_.GetTurnBuffersCapacity() + collapsematches_.Capacity() + addedmatches_.Capacity() +
+                        collapsecolumns_.Capacity() + hittedwalls_.Capacity() + hints_.Capacity();
+
+    for (unsigned i=0; i < cellhints_.Size(); i++)
+        capacity += cellhints_[i].Capacity();
+
+    return capacity;
+}
+
+// the heap allocations are counted by GameAllocTracker in the board logic (no scene access),
+// the turn containers never shrink : a capacity change is a heap allocation in the other steps
+void MatchGridInfo::CheckTurnAllocations(const char* step)
+{
+    if (boardAllocations_)
+    {
+        turnAllocations_ += boardAllocations_;
+        URHO3D_LOGWARNINGF("MatchGridInfo() - CheckTurnAllocations : gridid=%d step=%s %u heap allocation(s) in the board logic (allocations=%u) !",
+                           mgrid_.gridid_, step, boardAllocations_, turnAllocations_);
+        boardAllocations_ = 0;
+    }
+
+    const unsigned capacity = GetTurnBuffersCapacity();
+    if (capacity == turnCapacity_)
         return;
 
-    // Update Search
-    if (ihintsearchmatch_ < mgrid_.size_)
+    turnBufferGrowths_++;
+    URHO3D_LOGWARNINGF("MatchGridInfo() - CheckTurnAllocations : gridid=%d step=%s buffers capacity %u => %u (growths=%u) !",
+                       mgrid_.gridid_, step, turnCapacity_, capacity, turnBufferGrowths_);
+
+    turnCapacity_ = capacity;
+}
+
+#define HINTSEARCHRADIUS 3   // Manhattan distance of the cells used by GetHints
+
+void MatchGridInfo::IndexHints()
+{
+    if (cellhints_.Size() != mgrid_.size_)
     {
-        if (!ihintsearchmatch_)
+        cellhints_.Clear();
+        cellhints_.Resize(mgrid_.size_);
+        mgrid_.SetAllTouched();
+        ReserveTurnBuffers();
+    }
+
+    BoardAllocationsCounter allocationsCounter(boardAllocations_);
+
+    // re-evaluate only the touched cells and their neighborhood
+    const BitBoard cells = mgrid_.PopTouchedCells(HINTSEARCHRADIUS);
+
+    // the power tutorials are checked on these cells, even if their hints come from the cache
+    indexedcells_ |= cells;
+
+    // the board has already been evaluated (shake, cancelled move)
+    const unsigned long long hash = mgrid_.GetZobristHash();
+    if (mgrid_.hintscache_.Restore(hash, cellhints_))
+        return;
+
+    for (int y=0; y < mgrid_.height_; y++)
+    {
+        for (int x=0; x < mgrid_.width_; x++)
         {
-            hints_.Clear();
+            if (!cells.Test(x, y))
+                continue;
+
+            unsigned i = y * mgrid_.width_ + x;
+            cellhints_[i].Clear();
+            mgrid_.GetHints(i, cellhints_[i]);
         }
+    }
+
+    mgrid_.hintscache_.Store(hash, cellhints_);
+}
 
-        hintsearchTimer_.SetExpirationTime(HINTSEARCHDELAY);
+void MatchGridInfo::UpdateHintsIndex()
+{
+    // the board is not stable during a permutation
+    if (mgrid_.permutation_)
+        return;
+
+    // index the touched cells if not done in the board update or if touched since
+    if (!hintsIndexed_ || mgrid_.HasTouchedCells())
+        IndexHints();
+    hintsIndexed_ = false;
 
-        int i=0;
-        for (i = ihintsearchmatch_; i < mgrid_.size_; i++)
+    // the power tutorials of the updated cells
+    unsigned numcells = 0;
+    for (int y=0; y < mgrid_.height_; y++)
+    {
+        for (int x=0; x < mgrid_.width_; x++)
         {
-            mgrid_.GetHints(i, hints_);
+            if (!indexedcells_.Test(x, y))
+                continue;
 
-            if (hintsearchTimer_.Expired())
-            {
-                ihintsearchmatch_ = i+1;
-                break;
-            }
+            unsigned i = y * mgrid_.width_ + x;
+            if (cellhints_[i].Size())
+                mgrid_.CheckPowerTutorial(i);
+            numcells++;
         }
+    }
+    indexedcells_.Clear();
 
-        if (i == mgrid_.size_)
-            ihintsearchmatch_ = mgrid_.size_;
-
-        URHO3D_LOGINFOF("MatchGridInfo() - UpdateHints : gridid=%d - find %u hints (%d/%u-%s) !", mgrid_.gridid_,
-                        hints_.Size(), i, mgrid_.size_, ihintsearchmatch_ == mgrid_.size_ ? "finished" : "running");
+    if (ishowhints_ != -1)
+    {
+        SetHintsAnimations(false);
+        ishowhints_ = -1;
     }
 
+    hints_.Clear();
+    for (unsigned i=0; i < cellhints_.Size(); i++)
+        hints_.Push(cellhints_[i]);
+
+    CheckTurnAllocations("UpdateHintsIndex");
+
+    GAMELOG_INFOF(GAMELOG_HINTS, "MatchGridInfo() - UpdateHintsIndex : gridid=%d - find %u hints (%u/%u cells updated, cache hits=%u misses=%u) !", mgrid_.gridid_, hints_.Size(), numcells, mgrid_.size_,
+                    mgrid_.hintscache_.hits_, mgrid_.hintscache_.misses_);
+}
+
+void MatchGridInfo::UpdateHints()
+{
+//    if (!MatchesManager::allowHints_ || !hintsenabled_)
+//        return;
+
+    if (!hintsenabled_)
+        return;
+
+    GAMEPROFILE(MatchesUpdateHints);
+
+    // Update Index
+    if (hintsIndexed_ || mgrid_.HasTouchedCells())
+        UpdateHintsIndex();
+
     // No Results, Shake the world !
-    if (!hints_.Size() && ihintsearchmatch_ >= mgrid_.size_)
+    if (!hints_.Size() && !mgrid_.HasTouchedCells())
     {
         // If has tiles entrances (ex : boss01) we don't have to shake if no hints
         if (mgrid_.HasTileEntrances())
             return;
 
-        URHO3D_LOGINFOF("MatchGridInfo() - UpdateHints : gridid=%d - No More Match !", mgrid_.gridid_);
+        GAMELOG_INFOF(GAMELOG_HINTS, "MatchGridInfo() - UpdateHints : gridid=%d - No More Match !", mgrid_.gridid_);
 
         hintsenabled_ = false;
 
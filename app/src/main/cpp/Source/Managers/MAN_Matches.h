@@ -98,6 +98,12 @@ public:
     void ResetScaleOnSelection();
     void ResetHints();
 
+    /// Turn Allocations : the heap allocations of the board logic (SearchMatches, IndexHints) counted by GameAllocTracker, must stay at 0
+    /// (not counted without ACTIVE_GAMEALLOCTRACKER, Init warns about it)
+    unsigned GetTurnAllocations() const { return turnAllocations_; }
+    /// Turn Buffers : the number of growths of the turn buffers (also checked after ApplySuccessMatches), must stay at 0
+    unsigned GetTurnBufferGrowths() const { return turnBufferGrowths_; }
+
     void SetHintsAnimations(bool state);
     void SelectStartMatch(const Match& m1);
 
@@ -112,6 +118,9 @@ public:
     void ConfirmSelection_Boss();
 
     bool FindMatches(const Vector<Match*>& tocheck);
+    bool FindMatches(const MatchSet& tocheck);
+    void SearchMatches(const MatchSet& tocheck);
+    bool ApplyFoundMatches();
     void ApplySuccessMatches();
 
     void RemoveMatchAndCollapse(const Match& match);
@@ -127,6 +136,10 @@ public:
     void Net_SendCommands();
     void Net_SendGrid();
     void Net_UpdateControl();
+    void Replay_UpdateControl();
+
+    bool IsTurnTimeOver();
+    bool IsPauseTimeOver();
 
     void UpdateControl();
     void UpdateControl_Boss();
@@ -141,7 +154,17 @@ public:
     void Update_Test();
 #endif
 
+    void ReserveTurnBuffers();
+    unsigned GetTurnBuffersCapacity() const;
+    void CheckTurnAllocations(const char* step);
+
+    /// Board Update : the board logic of the frame (match search, hints index) without scene access, can run in the WorkQueue
+    bool PrepareBoardUpdate();
+    void UpdateBoard();
+
     void UpdateItems();
+    void IndexHints();
+    void UpdateHintsIndex();
     void UpdateHints();
 
     MatchGrid mgrid_;
@@ -152,22 +175,40 @@ public:
     VectorBuffer preparedCommands_;
 
     /// the found matches from Selection
-    Vector<Match*> destroymatches_;
-    Vector<Match*> successmatches_;
-    Vector<Match*> brokenrocks_;
+    MatchSet destroymatches_;
+    MatchSet successmatches_;
+    MatchSet brokenrocks_;
     Vector<WallInfo> hittedwalls_;
     /// the bonuses to activate from success matches
-    Vector<Match*> activablebonuses_;
+    MatchSet activablebonuses_;
     /// current collapsed matches
     Vector<Match*> collapsematches_;
+    Vector<Match*> addedmatches_;
+    PODVector<unsigned char> collapsecolumns_;
     /// current matches to check
     Vector<Match*> startMatches_;
-    Vector<Match*> matchesToCheck_;
+    MatchSet matchesToCheck_;
     /// hints
-    Vector<Vector<Match*> > hints_;
+    PODVector<MatchHint> hints_;
+    /// hints index : the hints found by cell
+    Vector<PODVector<MatchHint> > cellhints_;
+    BitBoard indexedcells_;
     /// registered objectives
     Vector<MatchObjective > objectives_;
 
+    /// turn buffers
+    unsigned turnCapacity_;
+    unsigned turnBufferGrowths_;
+    unsigned turnAllocations_;
+    /// allocations of the board logic not yet checked (the board logic can run in a worker thread)
+    unsigned boardAllocations_;
+
+    /// board update : pending works and the results ready for Update()
+    bool boardSearchMatches_, boardIndexHints_;
+    bool matchesSearched_, hintsIndexed_;
+    /// result of SearchMatches, applied by ApplyFoundMatches
+    bool matchesFound_;
+
     /// metrics
     int moveCount_;
     int state_;
@@ -178,9 +219,7 @@ public:
     unsigned turnScore_;
     float turnTime_;
     int ishowhints_;
-    int ihintsearchmatch_;
     int ilasthint_;
-    TimerSimple hintsearchTimer_;
     Timer animationTimer_, pauseTimer_, hintTimer_, updateitemsTimer_;
     float currentTime_, initialTime_;
 
@@ -240,6 +279,9 @@ public :
     static void SubscribeToEvents();
     static void UnsubscribeFromEvents();
 
+    /// no turn delays (session replay)
+    static void SetFastForward(bool enable) { fastForward_ = enable; }
+
     // General Getters
     static MatchesManager* Get()
     {
@@ -300,6 +342,7 @@ private :
 
     void HandleUpdateInitial(StringHash eventType, VariantMap& eventData);
     void HandleUpdateClassicMode(StringHash eventType, VariantMap& eventData);
+    void UpdateBoards();
     void HandleUpdateBossMode(StringHash eventType, VariantMap& eventData);
 #ifdef ACTIVE_TESTMODE
     void HandleUpdateTestMode(StringHash eventType, VariantMap& eventData);
@@ -308,6 +351,8 @@ private :
 
     /// all the Grids local & network
     Vector<SharedPtr<MatchGridInfo > > gridinfos_;
+    /// the grids with a board update in the frame
+    PODVector<MatchGridInfo*> boardupdates_;
 
     int netplaymod_;
     int gridsize_;
@@ -319,5 +364,6 @@ private :
 #endif
     static bool allowSelectionAlongHV_;
     static bool allowHints_, checkallpowersonturn_;
+    static bool fastForward_;
     static SharedPtr<MatchesManager> manager_;
 };
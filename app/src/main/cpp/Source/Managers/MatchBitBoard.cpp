@@ -0,0 +1,251 @@
+#include <Urho3D/Urho3D.h>
+
+#include "MatchBitBoard.h"
+
+
+static inline unsigned long long GetLaneMask(unsigned short lanemask)
+{
+    return (unsigned long long)lanemask * 0x0001000100010001ULL;
+}
+
+
+/// BitBoard
+
+const BitBoard BitBoard::EMPTY;
+
+void BitBoard::Fill(int width, int height)
+{
+    const unsigned short rowmask = (unsigned short)((1U << width) - 1U);
+
+    for (int y=0; y < BITBOARD_DIMENSION; y++)
+        rows_[y] = y < height ? rowmask : 0;
+}
+
+unsigned BitBoard::Count() const
+{
+    unsigned count = 0;
+    for (int i=0; i < BITBOARD_NUMWORDS; i++)
+        count += CountSetBits((unsigned)words_[i]) + CountSetBits((unsigned)(words_[i] >> 32));
+    return count;
+}
+
+BitBoard BitBoard::ShiftLeft(int n) const
+{
+    const unsigned long long mask = GetLaneMask((unsigned short)(0xFFFFU >> n));
+    BitBoard b;
+    for (int i=0; i < BITBOARD_NUMWORDS; i++)
+        b.words_[i] = (words_[i] >> n) & mask;
+    return b;
+}
+
+BitBoard BitBoard::ShiftRight(int n) const
+{
+    const unsigned long long mask = GetLaneMask((unsigned short)(0xFFFFU << n));
+    BitBoard b;
+    for (int i=0; i < BITBOARD_NUMWORDS; i++)
+        b.words_[i] = (words_[i] << n) & mask;
+    return b;
+}
+
+BitBoard BitBoard::ShiftUp(int n) const
+{
+    BitBoard b;
+    for (int y=0; y < BITBOARD_DIMENSION-n; y++)
+        b.rows_[y] = rows_[y+n];
+    return b;
+}
+
+BitBoard BitBoard::ShiftDown(int n) const
+{
+    BitBoard b;
+    for (int y=n; y < BITBOARD_DIMENSION; y++)
+        b.rows_[y] = rows_[y-n];
+    return b;
+}
+
+
+/// MatchBitBoard
+
+MatchBitBoard::MatchBitBoard() :
+    width_(0),
+    height_(0)
+{ }
+
+void MatchBitBoard::Clear()
+{
+    for (int i=0; i < BITBOARD_NUMCOLORS; i++)
+        colors_[i].Clear();
+
+    ground_.Clear();
+    blockedRight_.Clear();
+    blockedSouth_.Clear();
+    wallLeft_.Clear();
+    wallRight_.Clear();
+    wallNorth_.Clear();
+    wallSouth_.Clear();
+}
+
+void MatchBitBoard::Resize(int width, int height)
+{
+    width_ = Min(width, BITBOARD_DIMENSION);
+    height_ = Min(height, BITBOARD_DIMENSION);
+
+    Clear();
+}
+
+void MatchBitBoard::SetCell(int x, int y, unsigned char ctype)
+{
+    for (int i=1; i < BITBOARD_NUMCOLORS; i++)
+        colors_[i].Reset(x, y);
+
+    if (ctype && ctype < BITBOARD_NUMCOLORS)
+        colors_[ctype].Set(x, y);
+}
+
+void MatchBitBoard::SetLinks(int x, int y, bool blockright, bool blocksouth)
+{
+    blockedRight_.Set(x, y, blockright);
+    blockedSouth_.Set(x, y, blocksouth);
+}
+
+void MatchBitBoard::SetCellWalls(int x, int y, bool left, bool right, bool north, bool south)
+{
+    wallLeft_.Set(x, y, left);
+    wallRight_.Set(x, y, right);
+    wallNorth_.Set(x, y, north);
+    wallSouth_.Set(x, y, south);
+}
+
+unsigned char MatchBitBoard::GetCell(int x, int y) const
+{
+    for (int i=1; i < BITBOARD_NUMCOLORS; i++)
+        if (colors_[i].Test(x, y))
+            return i;
+
+    return 0;
+}
+
+BitBoard MatchBitBoard::GetHorizontalLinks(unsigned char ctype) const
+{
+    const BitBoard& color = colors_[ctype];
+    return color & color.ShiftLeft() & ~blockedRight_;
+}
+
+BitBoard MatchBitBoard::GetVerticalLinks(unsigned char ctype) const
+{
+    const BitBoard& color = colors_[ctype];
+    return color & color.ShiftUp() & ~blockedSouth_;
+}
+
+// a run of "minimal" cells starts at x if the (minimal-1) links from x are all set
+BitBoard MatchBitBoard::GetHorizontalRuns(unsigned char ctype, int minimal) const
+{
+    const BitBoard links = GetHorizontalLinks(ctype);
+
+    BitBoard starts = links;
+    for (int i=1; i < minimal-1; i++)
+        starts &= links.ShiftLeft(i);
+
+    BitBoard runs = starts;
+    for (int i=1; i < minimal; i++)
+        runs |= starts.ShiftRight(i);
+
+    return runs;
+}
+
+BitBoard MatchBitBoard::GetVerticalRuns(unsigned char ctype, int minimal) const
+{
+    const BitBoard links = GetVerticalLinks(ctype);
+
+    BitBoard starts = links;
+    for (int i=1; i < minimal-1; i++)
+        starts &= links.ShiftUp(i);
+
+    BitBoard runs = starts;
+    for (int i=1; i < minimal; i++)
+        runs |= starts.ShiftDown(i);
+
+    return runs;
+}
+
+// e X
+// X X
+BitBoard MatchBitBoard::GetSquares(unsigned char ctype) const
+{
+    const BitBoard hlinks = GetHorizontalLinks(ctype);
+    const BitBoard vlinks = GetVerticalLinks(ctype);
+    const BitBoard corners = hlinks & hlinks.ShiftUp() & vlinks & vlinks.ShiftLeft();
+    const BitBoard squares = corners | corners.ShiftRight();
+
+    return squares | squares.ShiftDown();
+}
+
+// the runs (horizontal and vertical) that cross each other
+BitBoard MatchBitBoard::GetLShapes(unsigned char ctype, const BitBoard& horizontalruns, const BitBoard& verticalruns) const
+{
+    BitBoard lshapes = horizontalruns & verticalruns;
+    if (lshapes.IsEmpty())
+        return lshapes;
+
+    const BitBoard hlinks = GetHorizontalLinks(ctype);
+    const BitBoard vlinks = GetVerticalLinks(ctype);
+
+    // propagate the crossing cells along their runs until stable
+    BitBoard grown;
+    for (;;)
+    {
+        grown = lshapes;
+        grown |= horizontalruns & lshapes.ShiftLeft() & hlinks;
+        grown |= horizontalruns & (lshapes & hlinks).ShiftRight();
+        grown |= verticalruns & lshapes.ShiftUp() & vlinks;
+        grown |= verticalruns & (lshapes & vlinks).ShiftDown();
+
+        if (grown == lshapes)
+            break;
+
+        lshapes = grown;
+    }
+
+    return lshapes;
+}
+
+unsigned MatchBitBoard::FindMatches(int minimal, unsigned char firstctype, unsigned char lastctype, MatchBitBoardResult& result) const
+{
+    result.Clear();
+
+    lastctype = Min((int)lastctype, BITBOARD_NUMCOLORS);
+
+    for (unsigned char ctype = Max((int)firstctype, 1); ctype < lastctype; ctype++)
+    {
+        if (colors_[ctype].IsEmpty())
+            continue;
+
+        const BitBoard horizontal = GetHorizontalRuns(ctype, minimal);
+        const BitBoard vertical = GetVerticalRuns(ctype, minimal);
+
+        result.horizontal_ |= horizontal;
+        result.vertical_ |= vertical;
+        result.squares_ |= GetSquares(ctype);
+        result.lshapes_ |= GetLShapes(ctype, horizontal, vertical);
+    }
+
+    result.all_ = result.horizontal_ | result.vertical_ | result.squares_;
+
+    return result.all_.Count();
+}
+
+bool MatchBitBoard::HasMatches(int minimal, unsigned char firstctype, unsigned char lastctype) const
+{
+    lastctype = Min((int)lastctype, BITBOARD_NUMCOLORS);
+
+    for (unsigned char ctype = Max((int)firstctype, 1); ctype < lastctype; ctype++)
+    {
+        if (colors_[ctype].IsEmpty())
+            continue;
+
+        if (!GetHorizontalRuns(ctype, minimal).IsEmpty() || !GetVerticalRuns(ctype, minimal).IsEmpty() || !GetSquares(ctype).IsEmpty())
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <Urho3D/Math/MathDefs.h>
+
+using namespace Urho3D;
+
+
+#define BITBOARD_DIMENSION 16
+#define BITBOARD_NUMWORDS 4
+#define BITBOARD_NUMCOLORS 12
+
+/// 16x16 cells bitboard : one row per 16 bits lane, 4 rows per 64 bits word.
+/// bit x of rows_[y] is the cell (x,y), y=0 is the top row of the grid (like matches_).
+/// The horizontal shifts work on the 64 bits words with lane masks (independent of the endianness).
+struct BitBoard
+{
+    BitBoard() { Clear(); }
+    BitBoard(const BitBoard& rhs) { for (int i=0; i < BITBOARD_NUMWORDS; i++) words_[i] = rhs.words_[i]; }
+
+    BitBoard& operator =(const BitBoard& rhs)
+    {
+        for (int i=0; i < BITBOARD_NUMWORDS; i++)
+            words_[i] = rhs.words_[i];
+        return *this;
+    }
+
+    bool operator ==(const BitBoard& rhs) const
+    {
+        return words_[0] == rhs.words_[0] && words_[1] == rhs.words_[1] && words_[2] == rhs.words_[2] && words_[3] == rhs.words_[3];
+    }
+    bool operator !=(const BitBoard& rhs) const { return !(*this == rhs); }
+
+    BitBoard operator &(const BitBoard& rhs) const { BitBoard b; for (int i=0; i < BITBOARD_NUMWORDS; i++) b.words_[i] = words_[i] & rhs.words_[i]; return b; }
+    BitBoard operator |(const BitBoard& rhs) const { BitBoard b; for (int i=0; i < BITBOARD_NUMWORDS; i++) b.words_[i] = words_[i] | rhs.words_[i]; return b; }
+    BitBoard operator ^(const BitBoard& rhs) const { BitBoard b; for (int i=0; i < BITBOARD_NUMWORDS; i++) b.words_[i] = words_[i] ^ rhs.words_[i]; return b; }
+    BitBoard operator ~() const { BitBoard b; for (int i=0; i < BITBOARD_NUMWORDS; i++) b.words_[i] = ~words_[i]; return b; }
+    BitBoard& operator &=(const BitBoard& rhs) { for (int i=0; i < BITBOARD_NUMWORDS; i++) words_[i] &= rhs.words_[i]; return *this; }
+    BitBoard& operator |=(const BitBoard& rhs) { for (int i=0; i < BITBOARD_NUMWORDS; i++) words_[i] |= rhs.words_[i]; return *this; }
+    BitBoard& operator ^=(const BitBoard& rhs) { for (int i=0; i < BITBOARD_NUMWORDS; i++) words_[i] ^= rhs.words_[i]; return *this; }
+
+    void Clear() { for (int i=0; i < BITBOARD_NUMWORDS; i++) words_[i] = 0ULL; }
+    void Fill(int width, int height);
+
+    bool Test(int x, int y) const { return (rows_[y] >> x) & 1U; }
+    void Set(int x, int y) { rows_[y] |= (unsigned short)(1U << x); }
+    void Reset(int x, int y) { rows_[y] &= (unsigned short)~(1U << x); }
+    void Set(int x, int y, bool state) { if (state) Set(x, y); else Reset(x, y); }
+
+    bool IsEmpty() const { return !(words_[0] | words_[1] | words_[2] | words_[3]); }
+    unsigned Count() const;
+
+    /// cell(x,y) <= cell(x+n,y)
+    BitBoard ShiftLeft(int n=1) const;
+    /// cell(x,y) <= cell(x-n,y)
+    BitBoard ShiftRight(int n=1) const;
+    /// cell(x,y) <= cell(x,y+n)
+    BitBoard ShiftUp(int n=1) const;
+    /// cell(x,y) <= cell(x,y-n)
+    BitBoard ShiftDown(int n=1) const;
+
+    union
+    {
+        unsigned short rows_[BITBOARD_DIMENSION];
+        unsigned long long words_[BITBOARD_NUMWORDS];
+    };
+
+    static const BitBoard EMPTY;
+};
+
+/// Results of a full board evaluation, all masks are the union for all the colors
+struct MatchBitBoardResult
+{
+    void Clear()
+    {
+        horizontal_.Clear();
+        vertical_.Clear();
+        squares_.Clear();
+        lshapes_.Clear();
+        all_.Clear();
+    }
+
+    BitBoard horizontal_;
+    BitBoard vertical_;
+    BitBoard squares_;
+    BitBoard lshapes_;
+    BitBoard all_;
+};
+
+/// Bitboard Match Engine
+/// keeps one bitboard by color type and the blocked links (walls) between the cells.
+/// Runs, Squares and L-shapes are found with shifts and ands for all the board in one pass.
+class MatchBitBoard
+{
+public:
+    MatchBitBoard();
+
+    void Clear();
+    void Resize(int width, int height);
+
+    /// Setters
+    void SetCell(int x, int y, unsigned char ctype);
+    void SetGround(int x, int y, bool ground) { ground_.Set(x, y, ground); }
+    /// blockright : no link between (x,y) and (x+1,y), blocksouth : no link between (x,y) and (x,y+1)
+    void SetLinks(int x, int y, bool blockright, bool blocksouth);
+    /// the walls of the cell itself : the line powers don't expand behind a wall on their own cell (see MatchGrid::GetAllHorizontalMatches)
+    void SetCellWalls(int x, int y, bool left, bool right, bool north, bool south);
+
+    /// Getters
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+    unsigned char GetCell(int x, int y) const;
+    const BitBoard& GetColor(unsigned char ctype) const { return colors_[ctype]; }
+    const BitBoard& GetGround() const { return ground_; }
+    const BitBoard& GetBlockedRight() const { return blockedRight_; }
+    const BitBoard& GetBlockedSouth() const { return blockedSouth_; }
+    const BitBoard& GetWallLeft() const { return wallLeft_; }
+    const BitBoard& GetWallRight() const { return wallRight_; }
+    const BitBoard& GetWallNorth() const { return wallNorth_; }
+    const BitBoard& GetWallSouth() const { return wallSouth_; }
+
+    /// Links between same colors : bit (x,y) if (x,y) and (x+1,y) (horizontal) or (x,y) and (x,y+1) (vertical) are linked
+    BitBoard GetHorizontalLinks(unsigned char ctype) const;
+    BitBoard GetVerticalLinks(unsigned char ctype) const;
+
+    /// Matches Finders for one color
+    BitBoard GetHorizontalRuns(unsigned char ctype, int minimal) const;
+    BitBoard GetVerticalRuns(unsigned char ctype, int minimal) const;
+    BitBoard GetSquares(unsigned char ctype) const;
+    BitBoard GetLShapes(unsigned char ctype, const BitBoard& horizontalruns, const BitBoard& verticalruns) const;
+
+    /// Matches Finders for all the colors in [firstctype, lastctype[
+    unsigned FindMatches(int minimal, unsigned char firstctype, unsigned char lastctype, MatchBitBoardResult& result) const;
+    bool HasMatches(int minimal, unsigned char firstctype, unsigned char lastctype) const;
+
+private:
+    BitBoard colors_[BITBOARD_NUMCOLORS];
+    BitBoard ground_;
+    BitBoard blockedRight_;
+    BitBoard blockedSouth_;
+    BitBoard wallLeft_, wallRight_, wallNorth_, wallSouth_;
+
+    int width_, height_;
+};
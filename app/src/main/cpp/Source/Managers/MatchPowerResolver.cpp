@@ -0,0 +1,219 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Urho2D/Drawable2D.h>
+
+#include "Matches.h"
+
+#include "MatchPowerResolver.h"
+
+
+MatchPowerResolver::MatchPowerResolver() :
+    bitboard_(0)
+{ }
+
+void MatchPowerResolver::Setup(const MatchBitBoard& bitboard)
+{
+    bitboard_ = &bitboard;
+
+    const int width = bitboard.GetWidth();
+    const int height = bitboard.GetHeight();
+
+    occupied_.Clear();
+    for (int i=1; i < BITBOARD_NUMCOLORS; i++)
+        occupied_ |= bitboard.GetColor(i);
+
+    powers_.Clear();
+
+    // row segments : the cells linked by the open links (bit x of blockedright : no link between x and x+1)
+    const BitBoard& blockedright = bitboard.GetBlockedRight();
+    for (int y=0; y < height; y++)
+    {
+        int start = 0;
+        for (int x=0; x < width; x++)
+        {
+            if (x == width-1 || blockedright.Test(x, y))
+            {
+                const unsigned short segment = (unsigned short)(((1U << (x+1)) - 1U) & ~((1U << start) - 1U));
+                for (int i=start; i <= x; i++)
+                    rowsegments_[y * BITBOARD_DIMENSION + i] = segment;
+                start = x+1;
+            }
+        }
+    }
+
+    // column segments
+    const BitBoard& blockedsouth = bitboard.GetBlockedSouth();
+    for (int x=0; x < width; x++)
+    {
+        int start = 0;
+        for (int y=0; y < height; y++)
+        {
+            if (y == height-1 || blockedsouth.Test(x, y))
+            {
+                const unsigned short segment = (unsigned short)(((1U << (y+1)) - 1U) & ~((1U << start) - 1U));
+                for (int i=start; i <= y; i++)
+                    colsegments_[i * BITBOARD_DIMENSION + x] = segment;
+                start = y+1;
+            }
+        }
+    }
+}
+
+void MatchPowerResolver::AddPower(int x, int y, unsigned char effect)
+{
+    if (!bitboard_ || effect == NOEFFECT)
+        return;
+
+    const int width = bitboard_->GetWidth();
+    const int height = bitboard_->GetHeight();
+
+    BitBoard& mask = masks_[y * BITBOARD_DIMENSION + x];
+    mask.Clear();
+
+    if (effect <= XYEXPLOSION)
+    {
+        if (effect & XEXPLOSION)
+            mask |= GetRowSegment(x, y);
+        if (effect & YEXPLOSION)
+            mask |= GetColumnSegment(x, y);
+    }
+    else if (effect <= WALLBREAKER)
+    {
+        mask = GetSquare(x, y, effect == WALLBREAKER ? 1 : effect - SQREXPLOSION + 1, width, height);
+    }
+    else
+    {
+        mask = GetNeighborhood(x, y, effect);
+    }
+
+    mask &= occupied_;
+    mask.Set(x, y);
+
+    powers_.Set(x, y);
+}
+
+BitBoard MatchPowerResolver::Resolve(const BitBoard& cells, const BitBoard& keepcells, BitBoard* activated) const
+{
+    BitBoard todo = cells;
+    BitBoard done;
+
+    for (;;)
+    {
+        const BitBoard pending = todo & ~done;
+        if (pending.IsEmpty())
+            break;
+
+        done |= pending;
+
+        // stamp the masks of the reached powers
+        BitBoard fired = pending & powers_ & ~keepcells;
+        if (activated)
+            *activated |= fired;
+
+        for (int y=0; y < BITBOARD_DIMENSION; y++)
+        {
+            unsigned row = fired.rows_[y];
+            while (row)
+            {
+                const unsigned lowbit = row & (0U - row);
+                const int x = CountSetBits(lowbit - 1U);
+                row ^= lowbit;
+                todo |= masks_[y * BITBOARD_DIMENSION + x];
+            }
+        }
+    }
+
+    return done;
+}
+
+// as MatchGrid::GetAllHorizontalMatches : a wall on the right of (x,y) stops the expansion to the left at (x,y), and a wall on the left stops the expansion to the right
+BitBoard MatchPowerResolver::GetRowSegment(int x, int y) const
+{
+    unsigned short segment = rowsegments_[y * BITBOARD_DIMENSION + x];
+    if (bitboard_->GetWallRight().Test(x, y))
+        segment &= (unsigned short)~((1U << x) - 1U);
+    if (bitboard_->GetWallLeft().Test(x, y))
+        segment &= (unsigned short)((1U << (x+1)) - 1U);
+
+    BitBoard b;
+    b.rows_[y] = segment;
+    return b;
+}
+
+// as MatchGrid::GetAllVerticalMatches : a wall on the south of (x,y) stops the expansion to the top at (x,y), and a wall on the north stops the expansion to the bottom
+BitBoard MatchPowerResolver::GetColumnSegment(int x, int y) const
+{
+    unsigned short segment = colsegments_[y * BITBOARD_DIMENSION + x];
+    if (bitboard_->GetWallSouth().Test(x, y))
+        segment &= (unsigned short)~((1U << y) - 1U);
+    if (bitboard_->GetWallNorth().Test(x, y))
+        segment &= (unsigned short)((1U << (y+1)) - 1U);
+
+    BitBoard b;
+    for (int i=0; i < BITBOARD_DIMENSION; i++)
+    {
+        if ((segment >> i) & 1U)
+            b.rows_[i] = (unsigned short)(1U << x);
+    }
+    return b;
+}
+
+BitBoard MatchPowerResolver::GetNeighborhood(int x, int y, unsigned char effect) const
+{
+    const int width = bitboard_->GetWidth();
+    const int height = bitboard_->GetHeight();
+
+    // the cells of the same color (or the rocks) in the range
+    const bool rocks = effect >= ROCKEXPLOSION;
+    const int range = 2 + effect - (rocks ? ROCKEXPLOSION : ELECEXPLOSION);
+    BitBoard region = GetSquare(x, y, range, width, height) & bitboard_->GetColor(rocks ? ROCKS : bitboard_->GetCell(x, y));
+
+    // the walls around (x,y) stop the flood
+    const BitBoard& blockedright = bitboard_->GetBlockedRight();
+    const BitBoard& blockedsouth = bitboard_->GetBlockedSouth();
+    if (x+1 < width && blockedright.Test(x, y))
+        region.Reset(x+1, y);
+    if (x > 0 && blockedright.Test(x-1, y))
+        region.Reset(x-1, y);
+    if (y+1 < height && blockedsouth.Test(x, y))
+        region.Reset(x, y+1);
+    if (y > 0 && blockedsouth.Test(x, y-1))
+        region.Reset(x, y-1);
+
+    BitBoard seed;
+    seed.Set(x, y);
+    return Flood8(seed, region | seed);
+}
+
+BitBoard MatchPowerResolver::GetSquare(int x, int y, int range, int width, int height)
+{
+    const int xmin = Max(0, x - range);
+    const int xmax = Min(width-1, x + range);
+    const int ymin = Max(0, y - range);
+    const int ymax = Min(height-1, y + range);
+
+    BitBoard b;
+    const unsigned short rowmask = (unsigned short)(((1U << (xmax+1)) - 1U) & ~((1U << xmin) - 1U));
+    for (int i=ymin; i <= ymax; i++)
+        b.rows_[i] = rowmask;
+
+    return b;
+}
+
+BitBoard MatchPowerResolver::Dilate8(const BitBoard& cells)
+{
+    BitBoard b = cells | cells.ShiftLeft() | cells.ShiftRight();
+    return b | b.ShiftUp() | b.ShiftDown();
+}
+
+BitBoard MatchPowerResolver::Flood8(const BitBoard& seed, const BitBoard& region)
+{
+    BitBoard fill = seed;
+    for (;;)
+    {
+        const BitBoard next = Dilate8(fill) & region;
+        if (next == fill)
+            return fill;
+        fill = next;
+    }
+}
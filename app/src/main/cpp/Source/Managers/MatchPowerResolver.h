@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MatchBitBoard.h"
+
+
+/// Power Resolver
+/// each power is stamped into a precomputed cell mask (wall bounded row/column segments, squares, color masks)
+/// and the chain reactions are resolved to a fixed point with bitboard ors.
+/// The result doesn't depend on the activation order.
+/// Used by the BoardSimulator : MatchGrid::GetMatches only takes the masks (GetNeighborhood) and keeps its own recursive chain expansion,
+/// which depends on the activation order (the bonus matches, the spread of the effects, the hitted walls) and so stays the game rule.
+class MatchPowerResolver
+{
+public:
+    MatchPowerResolver();
+
+    /// Setup : the segments from the links of the bitboard, removes the powers
+    void Setup(const MatchBitBoard& bitboard);
+    /// precompute the mask of the power at (x,y), the color of the power is the color of the cell in the bitboard
+    void AddPower(int x, int y, unsigned char effect);
+
+    /// the destroyed cells from "cells" with the chain reactions, the powers in keepcells are not activated
+    BitBoard Resolve(const BitBoard& cells, const BitBoard& keepcells, BitBoard* activated=0) const;
+
+    const BitBoard& GetPowers() const { return powers_; }
+    const BitBoard& GetPowerMask(int x, int y) const { return masks_[y * BITBOARD_DIMENSION + x]; }
+    /// the cells reached by a line power at (x,y), bounded by the walls like MatchGrid::GetAllHorizontalMatches/GetAllVerticalMatches
+    BitBoard GetRowSegment(int x, int y) const;
+    BitBoard GetColumnSegment(int x, int y) const;
+    /// ELECEXPLOSION, ROCKEXPLOSION : the 8-connected cells of the color of (x,y) (or the rocks) in the range,
+    /// the orthogonal neighbors walled from (x,y) are excluded (as MatchGrid::HaveSameTypeAndNoWalls)
+    BitBoard GetNeighborhood(int x, int y, unsigned char effect) const;
+
+    /// Helpers
+    static BitBoard GetSquare(int x, int y, int range, int width, int height);
+    static BitBoard Dilate8(const BitBoard& cells);
+    /// the 8-connected cells of region reachable from seed (seed included)
+    static BitBoard Flood8(const BitBoard& seed, const BitBoard& region);
+
+private:
+    const MatchBitBoard* bitboard_;
+    BitBoard occupied_;
+    BitBoard powers_;
+    BitBoard masks_[BITBOARD_DIMENSION * BITBOARD_DIMENSION];
+    /// by cell : the linked cells in the row (bit x) and in the column (bit y)
+    unsigned short rowsegments_[BITBOARD_DIMENSION * BITBOARD_DIMENSION];
+    unsigned short colsegments_[BITBOARD_DIMENSION * BITBOARD_DIMENSION];
+};
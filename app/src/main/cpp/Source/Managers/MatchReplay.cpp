@@ -0,0 +1,394 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/Engine/Engine.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/Log.h>
+
+#include <Urho3D/Urho2D/Drawable2D.h>
+
+#include "GameStatics.h"
+
+#include "MAN_Matches.h"
+
+#include "MatchReplay.h"
+
+
+#define REPLAY_FILEID "GMRP"
+#define REPLAY_VERSION 1
+
+String MatchReplay::recordFile_;
+String MatchReplay::replayFile_;
+MatchReplay::ReplayState MatchReplay::state_ = MatchReplay::REPLAY_NONE;
+int MatchReplay::level_ = 0;
+unsigned MatchReplay::seeds_[NUM_GAMERANDRNG];
+unsigned MatchReplay::startframe_ = 0;
+unsigned MatchReplay::numframes_ = 0;
+Vector<VectorBuffer> MatchReplay::grids_;
+Vector<MatchReplayEvent> MatchReplay::events_;
+PODVector<unsigned> MatchReplay::turns_;
+PODVector<unsigned> MatchReplay::cursors_;
+unsigned MatchReplay::numturns_ = 0;
+unsigned MatchReplay::numdesyncs_ = 0;
+int MatchReplay::exitCode_ = EXIT_SUCCESS;
+int MatchReplay::maxfps_ = 0;
+Timer MatchReplay::timer_;
+
+
+unsigned MatchReplay::GetFrame()
+{
+    return GameStatics::context_->GetSubsystem<Time>()->GetFrameNumber() - startframe_;
+}
+
+void MatchReplay::StartSession()
+{
+    if (state_ != REPLAY_NONE || !MatchesManager::Get())
+        return;
+
+    const unsigned numgrids = MatchesManager::GetNumGrids();
+
+    if (!replayFile_.Empty())
+    {
+        if (!LoadFile(replayFile_))
+        {
+            replayFile_.Clear();
+            exitCode_ = EXIT_FAILURE;
+            return;
+        }
+
+        if (level_ != GameStatics::currentLevel_ || grids_.Size() != numgrids)
+        {
+            URHO3D_LOGERRORF("MatchReplay() - StartSession : %s is a session of the level %d with %u grids (current level %d with %u grids) !",
+                             replayFile_.CString(), level_, grids_.Size(), GameStatics::currentLevel_, numgrids);
+            replayFile_.Clear();
+            exitCode_ = EXIT_FAILURE;
+            return;
+        }
+
+        // restore the session seeds and the starting grids
+        for (int r=MAPRAND; r < NUM_GAMERANDRNG; r++)
+            GameRand::SetSeedRand((GameRandRng)r, seeds_[r]);
+
+        for (unsigned i=0; i < numgrids; i++)
+        {
+            grids_[i].Seek(0);
+            MatchesManager::GetGrid(i).Load(grids_[i]);
+        }
+
+        // maximum speed
+        Engine* engine = GameStatics::context_->GetSubsystem<Engine>();
+        maxfps_ = engine->GetMaxFps();
+        engine->SetMaxFps(0);
+        MatchesManager::SetFastForward(true);
+
+        state_ = REPLAY_PLAYING;
+    }
+    else if (!recordFile_.Empty())
+    {
+        level_ = GameStatics::currentLevel_;
+
+        // new seeds for the session : the refills only depend on the recorded commands
+        for (int r=MAPRAND; r < NUM_GAMERANDRNG; r++)
+        {
+            seeds_[r] = GameRand::GetTimeSeed() + r;
+            GameRand::SetSeedRand((GameRandRng)r, seeds_[r]);
+        }
+
+        grids_.Resize(numgrids);
+        for (unsigned i=0; i < numgrids; i++)
+        {
+            grids_[i].Clear();
+            MatchesManager::GetGrid(i).Save(grids_[i]);
+        }
+
+        events_.Clear();
+
+        state_ = REPLAY_RECORDING;
+    }
+    else
+        return;
+
+    turns_.Resize(numgrids);
+    cursors_.Resize(numgrids);
+    for (unsigned i=0; i < numgrids; i++)
+        turns_[i] = cursors_[i] = 0;
+
+    numturns_ = numdesyncs_ = 0;
+    startframe_ = GameStatics::context_->GetSubsystem<Time>()->GetFrameNumber();
+    timer_.Reset();
+
+    URHO3D_LOGINFOF("MatchReplay() - StartSession : %s level=%d grids=%u events=%u",
+                    state_ == REPLAY_PLAYING ? "replay" : "record", level_, numgrids, events_.Size());
+}
+
+void MatchReplay::StopSession()
+{
+    if (state_ == REPLAY_RECORDING)
+    {
+        numframes_ = GetFrame();
+        SaveFile(recordFile_);
+        recordFile_.Clear();
+    }
+    else if (state_ == REPLAY_PLAYING)
+    {
+        unsigned remaining = 0;
+        for (unsigned i=0; i < turns_.Size(); i++)
+            while (FindNextEvent(i) != -1)
+            {
+                remaining++;
+                PopEvent(i);
+            }
+
+        URHO3D_LOGINFOF("MatchReplay() - StopSession : %s replayed in %u ms (%u frames, recorded %u frames) turns=%u desyncs=%u unplayed=%u => %s !",
+                        replayFile_.CString(), timer_.GetMSec(false), GetFrame(), numframes_, numturns_, numdesyncs_, remaining,
+                        numdesyncs_ || remaining ? "DESYNC" : "OK");
+
+        if (numdesyncs_ || remaining)
+            exitCode_ = EXIT_FAILURE;
+
+        GameStatics::context_->GetSubsystem<Engine>()->SetMaxFps(maxfps_);
+        MatchesManager::SetFastForward(false);
+        replayFile_.Clear();
+    }
+    else
+        return;
+
+    state_ = REPLAY_NONE;
+    grids_.Clear();
+    events_.Clear();
+}
+
+void MatchReplay::AddEvent(unsigned char type, int gridid)
+{
+    events_.Resize(events_.Size()+1);
+    MatchReplayEvent& event = events_.Back();
+    event.type_ = type;
+    event.gridid_ = gridid;
+    event.frame_ = GetFrame();
+    event.turn_ = turns_[gridid];
+    event.hash_ = 0;
+    event.cmd_ = 0;
+}
+
+void MatchReplay::RecordCommands(int gridid, const Vector<NetCommandData>& commands)
+{
+    if (state_ != REPLAY_RECORDING || gridid >= turns_.Size())
+        return;
+
+    for (Vector<NetCommandData>::ConstIterator it = commands.Begin(); it != commands.End(); ++it)
+    {
+        AddEvent(REPLAYEVENT_COMMAND, gridid);
+        MatchReplayEvent& event = events_.Back();
+        event.cmd_ = it->cmd_;
+        event.params_.SetData(it->params_.GetData(), it->params_.GetSize());
+    }
+}
+
+void MatchReplay::RecordShake(int gridid)
+{
+    if (state_ != REPLAY_RECORDING || gridid >= turns_.Size())
+        return;
+
+    AddEvent(REPLAYEVENT_SHAKE, gridid);
+}
+
+int MatchReplay::FindNextEvent(int gridid)
+{
+    for (unsigned i=cursors_[gridid]; i < events_.Size(); i++)
+    {
+        if (events_[i].gridid_ == gridid)
+        {
+            cursors_[gridid] = i;
+            return i;
+        }
+    }
+
+    cursors_[gridid] = events_.Size();
+    return -1;
+}
+
+const MatchReplayEvent* MatchReplay::GetNextEvent(int gridid)
+{
+    if (state_ != REPLAY_PLAYING || gridid >= cursors_.Size())
+        return 0;
+
+    int ievent = FindNextEvent(gridid);
+
+    // the grid is waiting for a command : a recorded turn has not been played
+    while (ievent != -1 && events_[ievent].type_ == REPLAYEVENT_TURN)
+    {
+        numdesyncs_++;
+        URHO3D_LOGERRORF("MatchReplay() - GetNextEvent : gridid=%d turn=%u (frame=%u) not replayed !", gridid, events_[ievent].turn_, events_[ievent].frame_);
+        PopEvent(gridid);
+        ievent = FindNextEvent(gridid);
+    }
+
+    return ievent != -1 ? &events_[ievent] : 0;
+}
+
+void MatchReplay::PopEvent(int gridid)
+{
+    if (cursors_[gridid] < events_.Size())
+        cursors_[gridid]++;
+}
+
+void MatchReplay::OnTurn(int gridid, unsigned hash)
+{
+    if (gridid >= turns_.Size())
+        return;
+
+    if (state_ == REPLAY_RECORDING)
+    {
+        AddEvent(REPLAYEVENT_TURN, gridid);
+        events_.Back().hash_ = hash;
+    }
+    else if (state_ == REPLAY_PLAYING)
+    {
+        numturns_++;
+
+        int ievent = FindNextEvent(gridid);
+        if (ievent != -1 && events_[ievent].type_ == REPLAYEVENT_TURN)
+        {
+            const MatchReplayEvent& event = events_[ievent];
+            if (event.hash_ != hash)
+            {
+                numdesyncs_++;
+                URHO3D_LOGERRORF("MatchReplay() - OnTurn : gridid=%d turn=%u (frame=%u) hash=%u expected=%u => DESYNC !",
+                                 gridid, turns_[gridid], event.frame_, hash, event.hash_);
+            }
+            PopEvent(gridid);
+        }
+        else
+        {
+            numdesyncs_++;
+            URHO3D_LOGERRORF("MatchReplay() - OnTurn : gridid=%d turn=%u hash=%u not recorded => DESYNC !", gridid, turns_[gridid], hash);
+        }
+    }
+
+    turns_[gridid]++;
+}
+
+bool MatchReplay::SaveFile(const String& filename)
+{
+    File file(GameStatics::context_, filename, FILE_WRITE);
+    if (!file.IsOpen())
+    {
+        URHO3D_LOGERRORF("MatchReplay() - SaveFile : can't open %s !", filename.CString());
+        return false;
+    }
+
+    file.WriteFileID(REPLAY_FILEID);
+    file.WriteUInt(REPLAY_VERSION);
+    file.WriteInt(level_);
+    for (int r=0; r < NUM_GAMERANDRNG; r++)
+        file.WriteUInt(seeds_[r]);
+    file.WriteUInt(numframes_);
+
+    file.WriteVLE(grids_.Size());
+    for (unsigned i=0; i < grids_.Size(); i++)
+    {
+        file.WriteVLE(grids_[i].GetSize());
+        file.Write(grids_[i].GetData(), grids_[i].GetSize());
+    }
+
+    file.WriteVLE(events_.Size());
+    for (Vector<MatchReplayEvent>::ConstIterator it = events_.Begin(); it != events_.End(); ++it)
+    {
+        file.WriteUByte(it->type_);
+        file.WriteUByte(it->gridid_);
+        file.WriteVLE(it->frame_);
+        file.WriteVLE(it->turn_);
+
+        if (it->type_ == REPLAYEVENT_TURN)
+        {
+            file.WriteUInt(it->hash_);
+        }
+        else if (it->type_ == REPLAYEVENT_COMMAND)
+        {
+            file.WriteUByte(it->cmd_);
+            file.WriteVLE(it->params_.GetSize());
+            file.Write(it->params_.GetData(), it->params_.GetSize());
+        }
+    }
+
+    URHO3D_LOGINFOF("MatchReplay() - SaveFile : %s level=%d frames=%u events=%u size=%u bytes",
+                    filename.CString(), level_, numframes_, events_.Size(), file.GetSize());
+
+    return true;
+}
+
+/// a count read in a session file : each element takes at least minbytes in the rest of the file
+static bool ReadCount(File& file, unsigned minbytes, unsigned& count)
+{
+    count = file.ReadVLE();
+    return count <= (file.GetSize() - file.GetPosition()) / minbytes;
+}
+
+bool MatchReplay::LoadFile(const String& filename)
+{
+    File file(GameStatics::context_, filename, FILE_READ);
+    if (!file.IsOpen() || file.ReadFileID() != REPLAY_FILEID || file.ReadUInt() != REPLAY_VERSION)
+    {
+        URHO3D_LOGERRORF("MatchReplay() - LoadFile : %s is not a session file !", filename.CString());
+        return false;
+    }
+
+    level_ = file.ReadInt();
+    for (int r=0; r < NUM_GAMERANDRNG; r++)
+        seeds_[r] = file.ReadUInt();
+    numframes_ = file.ReadUInt();
+
+    unsigned count;
+
+    if (!ReadCount(file, 1, count))
+        return LoadError(filename);
+    grids_.Resize(count);
+    for (unsigned i=0; i < grids_.Size(); i++)
+    {
+        if (!ReadCount(file, 1, count))
+            return LoadError(filename);
+        grids_[i].SetData(file, count);
+    }
+
+    // an event takes at least 4 bytes (type, gridid, frame, turn)
+    if (!ReadCount(file, 4, count))
+        return LoadError(filename);
+    events_.Resize(count);
+    for (Vector<MatchReplayEvent>::Iterator it = events_.Begin(); it != events_.End(); ++it)
+    {
+        if (file.IsEof())
+            return LoadError(filename);
+
+        it->type_ = file.ReadUByte();
+        it->gridid_ = file.ReadUByte();
+        it->frame_ = file.ReadVLE();
+        it->turn_ = file.ReadVLE();
+        it->hash_ = 0;
+        it->cmd_ = 0;
+
+        if (it->type_ == REPLAYEVENT_TURN)
+        {
+            it->hash_ = file.ReadUInt();
+        }
+        else if (it->type_ == REPLAYEVENT_COMMAND)
+        {
+            it->cmd_ = file.ReadUByte();
+            if (!ReadCount(file, 1, count))
+                return LoadError(filename);
+            it->params_.SetData(file, count);
+        }
+    }
+
+    URHO3D_LOGINFOF("MatchReplay() - LoadFile : %s level=%d frames=%u events=%u", filename.CString(), level_, numframes_, events_.Size());
+
+    return true;
+}
+
+bool MatchReplay::LoadError(const String& filename)
+{
+    URHO3D_LOGERRORF("MatchReplay() - LoadFile : %s is truncated or corrupted !", filename.CString());
+    grids_.Clear();
+    events_.Clear();
+    return false;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdlib>
+
+#include <Urho3D/Container/Str.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Timer.h>
+#include <Urho3D/IO/VectorBuffer.h>
+
+#include "GameRand.h"
+
+using namespace Urho3D;
+
+struct NetCommandData;
+
+enum MatchReplayEventType : unsigned char
+{
+    REPLAYEVENT_COMMAND = 1,
+    REPLAYEVENT_SHAKE,
+    REPLAYEVENT_TURN,
+};
+
+struct MatchReplayEvent
+{
+    unsigned char type_;
+    unsigned char gridid_;
+    /// frame since the start of the session
+    unsigned frame_;
+    /// number of turns of the grid when the event occurs
+    unsigned turn_;
+    /// REPLAYEVENT_TURN : board hash at the end of the turn
+    unsigned hash_;
+    /// REPLAYEVENT_COMMAND : NetCommand and params
+    unsigned char cmd_;
+    VectorBuffer params_;
+};
+
+/// Match Session Replay
+/// Records the session seeds, the starting grids and the player intents (the NetCommands of the lockstep network grids).
+/// The replayer feeds the recorded commands to the grids like remote commands, without turn delays and frame limit,
+/// and checks the board hash at the end of each turn (MatchGridInfo::ResetState).
+/// Command line : -recordsession file or -replaysession file
+class MatchReplay
+{
+public:
+    static void SetRecordFile(const String& filename) { recordFile_ = filename; }
+    static void SetReplayFile(const String& filename) { replayFile_ = filename; }
+
+    static bool IsActive() { return state_ != REPLAY_NONE; }
+    static bool IsRecording() { return state_ == REPLAY_RECORDING; }
+    static bool IsReplaying() { return state_ == REPLAY_PLAYING; }
+
+    /// Session : starts when the initial cascades are finished, stops with the level
+    static void StartSession();
+    static void StopSession();
+
+    /// Recorder
+    static void RecordCommands(int gridid, const Vector<NetCommandData>& commands);
+    static void RecordShake(int gridid);
+
+    /// Replayer : the next command or shake of the grid (0 if none), PopEvent after use
+    static const MatchReplayEvent* GetNextEvent(int gridid);
+    static void PopEvent(int gridid);
+
+    /// Recorder and Replayer : end of a turn
+    static void OnTurn(int gridid, unsigned hash);
+
+    /// Replayer : a session file not loaded, a desync or unplayed events fail the run (Game::Stop)
+    static int GetExitCode() { return exitCode_; }
+
+private:
+    enum ReplayState
+    {
+        REPLAY_NONE = 0,
+        REPLAY_RECORDING,
+        REPLAY_PLAYING,
+    };
+
+    static unsigned GetFrame();
+    static int FindNextEvent(int gridid);
+    static void AddEvent(unsigned char type, int gridid);
+    static bool SaveFile(const String& filename);
+    static bool LoadFile(const String& filename);
+    static bool LoadError(const String& filename);
+
+    static String recordFile_;
+    static String replayFile_;
+    static ReplayState state_;
+
+    static int level_;
+    static unsigned seeds_[NUM_GAMERANDRNG];
+    static unsigned startframe_, numframes_;
+    static Vector<VectorBuffer> grids_;
+    static Vector<MatchReplayEvent> events_;
+    /// by grid : number of turns, replay cursor in events_
+    static PODVector<unsigned> turns_;
+    static PODVector<unsigned> cursors_;
+
+    /// replay stats
+    static unsigned numturns_, numdesyncs_;
+    static int exitCode_;
+    static int maxfps_;
+    static Timer timer_;
+};
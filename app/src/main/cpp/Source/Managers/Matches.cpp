@@ -31,6 +31,7 @@
 #include "GameAttributes.h"
 #include "GameStatics.h"
 #include "GameHelpers.h"
+#include "GameLog.h"
 #include "GameEvents.h"
 #include "GameUI.h"
 
@@ -121,6 +122,112 @@ void Match::DumpMatches(Vector<Match*>& matches)
 }
 
 
+/// MatchSet
+
+bool MatchSet::Insert(Match* match)
+{
+    if (cells_.Test(match->x_, match->y_))
+        return false;
+
+    cells_.Set(match->x_, match->y_);
+    entries_[size_++] = match;
+    return true;
+}
+
+void MatchSet::Insert(const Vector<Match*>& matches)
+{
+    for (Vector<Match*>::ConstIterator it=matches.Begin(); it!=matches.End(); ++it)
+        Insert(*it);
+}
+
+void MatchSet::Insert(const MatchSet& matches)
+{
+    if (&matches == this)
+        return;
+
+    for (ConstIterator it=matches.Begin(); it!=matches.End(); ++it)
+        Insert(*it);
+}
+
+
+/// MatchTurnBuffers
+
+void MatchTurnBuffers::Reserve(int dimension)
+{
+    const unsigned numcells = dimension * dimension;
+
+    matches_.Reserve(numcells);
+    matchesh_.Reserve(numcells);
+    matchesv_.Reserve(numcells);
+    matchesq_.Reserve(numcells);
+    bonush_.Reserve(numcells);
+    bonusv_.Reserve(numcells);
+    bonus2_.Reserve(numcells);
+    bonuses_.Reserve(numcells);
+    hints_.Reserve(32);
+    transfers_.Reserve(2 * numcells);
+}
+
+unsigned MatchTurnBuffers::GetCapacity() const
+{
+    return matches_.Capacity() + matchesh_.Capacity() + matchesv_.Capacity() + matchesq_.Capacity() +
+           bonush_.Capacity() + bonusv_.Capacity() + bonus2_.Capacity() + bonuses_.Capacity() +
+           hints_.Capacity() + transfers_.Capacity();
+}
+
+
+void MatchHintsCache::Clear()
+{
+    for (unsigned i=0; i < MATCHHINTSCACHE_SIZE; i++)
+    {
+        entries_[i].hash_ = 0;
+        entries_[i].hints_.Clear();
+        entries_[i].offsets_.Clear();
+    }
+}
+
+bool MatchHintsCache::Restore(unsigned long long hash, Vector<PODVector<MatchHint> >& cellhints)
+{
+    for (unsigned i=0; i < MATCHHINTSCACHE_SIZE; i++)
+    {
+        const Entry& entry = entries_[i];
+        if (entry.hash_ != hash || entry.offsets_.Size() != cellhints.Size()+1)
+            continue;
+
+        for (unsigned j=0; j < cellhints.Size(); j++)
+        {
+            PODVector<MatchHint>& hints = cellhints[j];
+            hints.Clear();
+            for (unsigned k=entry.offsets_[j]; k < entry.offsets_[j+1]; k++)
+                hints.Push(entry.hints_[k]);
+        }
+
+        hits_++;
+        return true;
+    }
+
+    misses_++;
+    return false;
+}
+
+void MatchHintsCache::Store(unsigned long long hash, const Vector<PODVector<MatchHint> >& cellhints)
+{
+    // round robin replacement : the buffers of the entries are reused
+    Entry& entry = entries_[next_];
+    next_ = (next_+1) % MATCHHINTSCACHE_SIZE;
+
+    entry.hash_ = hash;
+    entry.hints_.Clear();
+    entry.offsets_.Resize(cellhints.Size()+1);
+    for (unsigned j=0; j < cellhints.Size(); j++)
+    {
+        entry.offsets_[j] = entry.hints_.Size();
+        entry.hints_.Push(cellhints[j]);
+    }
+    entry.offsets_[cellhints.Size()] = entry.hints_.Size();
+}
+
+
 int MatchGrid::optionSameType_     = 0;
 int MatchGrid::optionCheckMatches_ = 0;
 HashMap<StringHash, Vector<StringHash> > MatchGrid::authorizedTypes_;
@@ -131,10 +238,11 @@ MatchGrid::MatchGrid()
 {
     previewLines_ = 1;
 
-    MatchGrid::authorizedTypes_.Clear();
-    MatchGrid::authorizedColors_.Clear();
-
     freeDirectionExplosion_ = true;
+
+    turnbuffers_.Reserve(Match::MAXDIMENSION);
+
+    hash_ = 0;
 }
 
 void MatchGrid::ClearGrid()
@@ -165,6 +273,7 @@ void MatchGrid::ClearObjects(bool clearmatches)
     {
         matches_.Clear();
         previewmatches_.Clear();
+        hintscache_.Clear();
     }
     else
     {
@@ -176,6 +285,7 @@ void MatchGrid::ClearObjects(bool clearmatches)
     }
 
     CleanSavedMatches();
+    SetAllTouched();
 
     URHO3D_LOGINFO("MatchGrid() - ClearObjects : Objects and Rocks have been removed !");
 }
@@ -212,7 +322,7 @@ void MatchGrid::SetPhysicsEnable(bool enable)
 }
 
 
-void MatchGrid::SetLayout(int dimension, GridLayout layout, HorizontalAlignment halign, VerticalAlignment valign, bool randomwalls)
+void MatchGrid::SetLayout(int dimension, GridLayout layout, HorizontalAlignment halign, VerticalAlignment valign, bool randomwalls, GameRand* random)
 {
     width_ = height_ = 0;
 
@@ -446,15 +556,13 @@ void MatchGrid::SetLayout(int dimension, GridLayout layout, HorizontalAlignment
     size_ = width_*height_;
 
     if (randomwalls && GridTile::WALLCHANCE && layout < L_MAXSTANDARDLAYOUT)
-        RandomizeWalls();
+        RandomizeWalls(random ? *random : GameRand::GetRandomizer(OBJRAND));
 }
 
 
-void MatchGrid::RandomizeWalls()
+void MatchGrid::RandomizeWalls(GameRand& random)
 {
     // Randomize Walls for Testing
-    GameRand& random = GameRand::GetRandomizer(OBJRAND);
-
     for (int y = 0; y < height_; y++)
     {
         for (int x = 0; x < width_; x++)
@@ -488,6 +596,12 @@ void MatchGrid::SetAuthorizedTypes(const StringHash& category, const Vector<Stri
     MatchGrid::authorizedTypes_[category] = types;
 }
 
+void MatchGrid::ClearAuthorizedTypes()
+{
+    MatchGrid::authorizedTypes_.Clear();
+    MatchGrid::authorizedColors_.Clear();
+}
+
 
 void MatchGrid::Load(VectorBuffer& buffer)
 {
@@ -534,11 +648,14 @@ void MatchGrid::Load(VectorBuffer& buffer)
     grid_.Resize(width_, height_);
     matches_.Resize(width_, height_);
     previewmatches_.Resize(width_, previewLines_);
+    hintscache_.Clear();
+    ReserveTurnBuffers();
     PODVector<StringHash> gots(width_ * height_);
     PODVector<StringHash> previewgots(width_ * previewLines_);
 
     buffer.Read(grid_.Buffer(), width_ * height_ * sizeof(GridTile));
     URHO3D_LOGINFOF("MatchGrid() - Load : ... load gridtiles ... buffer position = %u", buffer.GetPosition());
+    UpdateMoveTable();
     buffer.Read(matches_.Buffer(), width_ * height_ * sizeof(Match));
     URHO3D_LOGINFOF("MatchGrid() - Load : ... load matches ... buffer position = %u", buffer.GetPosition());
     buffer.Read(previewmatches_.Buffer(), width_ * previewLines_ * sizeof(Match));
@@ -556,6 +673,8 @@ void MatchGrid::Load(VectorBuffer& buffer)
     InitializeTiles();
     InitializeWalls();
     SetObjects(gots, previewgots);
+
+    SetAllTouched();
 }
 
 void MatchGrid::Save(VectorBuffer& buffer)
@@ -586,6 +705,54 @@ void MatchGrid::Save(VectorBuffer& buffer)
     URHO3D_LOGINFOF("MatchGrid() - Save : ... add prevobjects ... buffer size = %u", buffer.GetSize());
 }
 
+// the zobrist keys are generated by a 64 bits mixer (splitmix64) instead of a table : a match property has 2^32 values
+unsigned long long MatchGrid::GetZobristKey(unsigned cell, unsigned value)
+{
+    if (!value)
+        return 0;
+
+    unsigned long long z = (((unsigned long long)cell << 32) | value) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline unsigned GetTileHashValue(const GridTile& tile)
+{
+    return tile.ground_ | (tile.walltype_ << 8) | (tile.wallorientation_ << 16);
+}
+
+#define ZOBRIST_TILECELL 0x10000
+
+void MatchGrid::ResetHash()
+{
+    hash_ = 0;
+
+    hashedmatches_.Resize(matches_.Size());
+    for (unsigned i=0; i < matches_.Size(); i++)
+    {
+        hashedmatches_[i] = matches_[i].property_;
+        hash_ ^= GetZobristKey(i, hashedmatches_[i]);
+    }
+
+    hashedtiles_.Resize(grid_.Size());
+    for (unsigned i=0; i < grid_.Size(); i++)
+    {
+        hashedtiles_[i] = GetTileHashValue(grid_[i]);
+        hash_ ^= GetZobristKey(ZOBRIST_TILECELL + i, hashedtiles_[i]);
+    }
+}
+
+void MatchGrid::UpdateTileHash(int x, int y)
+{
+    const unsigned cell = y * width_ + x;
+    if (cell >= hashedtiles_.Size())
+        return;
+
+    const unsigned value = GetTileHashValue(grid_[cell]);
+    hash_ ^= GetZobristKey(ZOBRIST_TILECELL + cell, hashedtiles_[cell]) ^ GetZobristKey(ZOBRIST_TILECELL + cell, value);
+    hashedtiles_[cell] = value;
+}
 
 void MatchGrid::Create(Vector<Match*>& newmatches)
 {
@@ -595,6 +762,8 @@ void MatchGrid::Create(Vector<Match*>& newmatches)
         activedRules_[i] = true;
 
     matches_.Resize(width_, height_);
+    hintscache_.Clear();
+    UpdateMoveTable();
     for (unsigned y=0; y < height_; y++)
     {
         for (unsigned x=0; x < width_; x++)
@@ -626,6 +795,9 @@ void MatchGrid::Create(Vector<Match*>& newmatches)
     InitializeTypes();
     InitializeObjects(newmatches);
 
+    SetAllTouched();
+    ReserveTurnBuffers();
+
     URHO3D_LOGINFO("MatchGrid() - Create : ... OK !");
 }
 
@@ -877,43 +1049,30 @@ int MatchGrid::CollapseColumn(int x, Vector<Match*>& collapsematches)
 {
     int distance = 0;
 
-    for (int y=height_-1; y >= 0; y--)
-    {
-        if (grid_(x, y).wallorientation_ & WO_WALLNORTH)
-            break;
-
-        if (grid_(x, y).ground_ && !matches_(x, y).ctype_)
-        {
-            Match& m1 = matches_(x, y);
-
-            for (int y2=y-1; y2 >= 0; y2--)
-            {
-                if (matches_(x, y2).ctype_)
-                {
-                    Match& m2 = matches_(x, y2);
-
-                    if (IsDirectionalTile(m2) || (grid_(x, y2).wallorientation_ & WO_WALLNORTH))
-                        break;
+    PODVector<IntVector2>& transfers = turnbuffers_.transfers_;
+    Collapse(grid_, matches_, x, transfers);
 
-                    m1.property_ = m2.property_;
-                    m2.property_ = 0;
+    for (unsigned i=0; i < transfers.Size(); i += 2)
+    {
+        const int y2 = transfers[i].y_;
+        const int y = transfers[i+1].y_;
 
-                    WeakPtr<Node>& object = objects_(x, y);
-                    object = objects_(x, y2);
-                    objects_(x, y2).Reset();
+        Match& m1 = matches_(x, y);
+        Match& m2 = matches_(x, y2);
+        SetTouched(m1);
+        SetTouched(m2);
 
-                    SetDrawOrder(m1, object, OBJECTLAYER);
-                    SetMoveAnimation(m1, object, CalculateMatchPosition(x, y), MOVETIME*float(y-y2));
+        WeakPtr<Node>& object = objects_(x, y);
+        object = objects_(x, y2);
+        objects_(x, y2).Reset();
 
-                    collapsematches.Push(&m1);
+        SetDrawOrder(m1, object, OBJECTLAYER);
+        SetMoveAnimation(m1, object, CalculateMatchPosition(x, y), MOVETIME*float(y-y2));
 
-                    if (y-y2 > distance)
-                        distance = y-y2;
+        collapsematches.Push(&m1);
 
-                    break;
-                }
-            }
-        }
+        if (y-y2 > distance)
+            distance = y-y2;
     }
 
 //    URHO3D_LOGINFOF("MatchGrid() - CollapseColumn : column=%d distance=%d !", x, distance);
@@ -927,47 +1086,33 @@ int MatchGrid::AddColumn(int x, Vector<Match*>& newmatches)
 
     GameRand& random = GameRand::GetRandomizer(OBJRAND);
 
-    const bool wallblocking = false;
+    PODVector<IntVector2>& cells = turnbuffers_.transfers_;
+    GetRefillCells(grid_, matches_, x, cells);
 
-    for (int y=height_-1; y >= 0; y--)
+    for (unsigned i=0; i < cells.Size(); i++)
     {
-        if (!grid_(x, y).ground_)
-        {
-//            wallblocking = false;
-//            URHO3D_LOGINFOF("MatchGrid() - AddColumn : addobject at %d,%d => Blocked by Ground !", x, y);
-            continue;
-        }
+        const int y = cells[i].y_;
+        Match& match = matches_(x, y);
 
-        if (wallblocking && grid_(x,y).wallorientation_ & WO_WALLNORTH && grid_(x,y).wallorientation_ & WO_WALLSOUTH)
-        {
-//            wallblocking = true;
-//            URHO3D_LOGINFOF("MatchGrid() - AddColumn : addobject at %d,%d => Blocked by Wall !", x, y);
-            continue;
-        }
+        Node* node = GetPreviewMatch(match, random);
+        if (!node)
+            node = AddObject(match, random);
 
-        if (!wallblocking && !matches_(x, y).ctype_)
+        if (node)
         {
-            Match& match = matches_(x, y);
-
-            Node* node = GetPreviewMatch(match, random);
-            if (!node)
-                node = AddObject(match, random);
-
-            if (node)
-            {
-                node->SetPosition(GetEntrance(match));
+            node->SetPosition(GetEntrance(match));
 
-//                URHO3D_LOGINFOF("MatchGrid() - AddColumn : addobject at %d,%d !", x, y);
+//            URHO3D_LOGINFOF("MatchGrid() - AddColumn : addobject at %d,%d !", x, y);
 
-                SetMoveAnimation(match, node, CalculateMatchPosition(x, y), MOVETIME*float(y+1));
-                newmatches.Push(&match);
+            SetMoveAnimation(match, node, CalculateMatchPosition(x, y), MOVETIME*float(y+1));
+            newmatches.Push(&match);
+            SetTouched(match);
 
-                if (distance < y+1)
-                    distance = y+1;
-            }
-            else
-                URHO3D_LOGERRORF("MatchGrid() - AddColumn : addobject at %d,%d => No Node !", x, y);
+            if (distance < y+1)
+                distance = y+1;
         }
+        else
+            URHO3D_LOGERRORF("MatchGrid() - AddColumn : addobject at %d,%d => No Node !", x, y);
     }
 
 //    URHO3D_LOGINFOF("MatchGrid() - AddColumn : column=%d distance=%d !", x, distance);
@@ -1033,15 +1178,17 @@ Node* MatchGrid::AddPreviewObject(Match& match, GameRand& random)
     const Vector<StringHash>& bonusesTypes = authorizedTypes_[COT::POWERS];
     const Vector<StringHash>& rocksTypes = authorizedTypes_[COT::ROCKS];
     const Vector<StringHash>& enemiesTypes = authorizedTypes_[COT::ENEMIES];
-    const bool addPower = bonusesTypes.Size() ? random.Get(100) < Match::BONUSCHANCE : false;
-    const bool addRock = rocksTypes.Size() ? random.Get(100) < Match::ROCKCHANCE : false;
+
+    unsigned typeindex = 0;
+    const int category = DrawObject(random, bonusesTypes.Size(), rocksTypes.Size(), enemiesTypes.Size(), typeindex);
+    const bool addPower = category == MOC_POWER;
 
     WeakPtr<Node>& object = previewobjects_(match.x_, match.y_);
     RemoveObject(object);
 
     if (addPower)
     {
-        StringHash bonustype(bonusesTypes[random.Get(bonusesTypes.Size())]);
+        StringHash bonustype(bonusesTypes[typeindex]);
         object = GOT::GetObject(bonustype)->Clone(LOCAL, true, 0, 0, objectsNode_);
         object->SetVar(GOA::GOT, bonustype);
         // set match type
@@ -1051,10 +1198,10 @@ Node* MatchGrid::AddPreviewObject(Match& match, GameRand& random)
 
         URHO3D_LOGINFOF("MatchGrid() - AddPreviewObject : addPower match=%s !", match.ToString().CString());
     }
-    else if (addRock)
+    else if (category == MOC_ROCK)
     {
         // set object
-        StringHash rocktype = rocksTypes[random.Get(rocksTypes.Size())];
+        StringHash rocktype = rocksTypes[typeindex];
         object = GOT::GetObject(rocktype)->Clone(LOCAL, true, 0, 0, objectsNode_);
         object->SetVar(GOA::GOT, rocktype);
         // set match type
@@ -1070,14 +1217,14 @@ Node* MatchGrid::AddPreviewObject(Match& match, GameRand& random)
     }
     else
     {
-        if (!enemiesTypes.Size())
+        if (category == MOC_NONE)
         {
 //            URHO3D_LOGERRORF("MatchGrid() - AddPreviewObject : No ennemies Types registered !");
             return 0;
         }
 
         // set object
-        const StringHash& got = enemiesTypes[random.Get(enemiesTypes.Size())];
+        const StringHash& got = enemiesTypes[typeindex];
         object = GOT::GetObject(got)->Clone(LOCAL, true, 0, 0, objectsNode_);
         object->SetVar(GOA::GOT, got);
         // set match type
@@ -1111,15 +1258,16 @@ Node* MatchGrid::AddObject(Match& match, GameRand& random)
     const Vector<StringHash>& rocksTypes = authorizedTypes_[COT::ROCKS];
     const Vector<StringHash>& enemiesTypes = authorizedTypes_[COT::ENEMIES];
 
-    bool addPower = bonusesTypes.Size() ? random.Get(100) < Match::BONUSCHANCE : false;
-    bool addRock = rocksTypes.Size() ? random.Get(100) < Match::ROCKCHANCE : false;
+    unsigned typeindex = 0;
+    const int category = DrawObject(random, bonusesTypes.Size(), rocksTypes.Size(), enemiesTypes.Size(), typeindex);
+    const bool addPower = category == MOC_POWER;
 
     WeakPtr<Node>& object = objects_(match.x_, match.y_);
     RemoveObject(object);
 
     if (addPower)
     {
-        StringHash bonustype(bonusesTypes[random.Get(bonusesTypes.Size())]);
+        StringHash bonustype(bonusesTypes[typeindex]);
         object = GOT::GetObject(bonustype)->Clone(LOCAL, true, 0, 0, objectsNode_);
         object->SetVar(GOA::GOT, bonustype);
 //        int bonusindex = GameRand::GetRand(OBJRAND, bonusesTypes.Size());
@@ -1132,10 +1280,10 @@ Node* MatchGrid::AddObject(Match& match, GameRand& random)
 
         URHO3D_LOGINFOF("MatchGrid() - AddObject : addPower match=%s !", match.ToString().CString());
     }
-    else if (addRock)
+    else if (category == MOC_ROCK)
     {
         // set object
-        StringHash rocktype = rocksTypes[random.Get(rocksTypes.Size())];
+        StringHash rocktype = rocksTypes[typeindex];
         object = GOT::GetObject(rocktype)->Clone(LOCAL, true, 0, 0, objectsNode_);
         object->SetVar(GOA::GOT, rocktype);
         // set match type
@@ -1151,11 +1299,11 @@ Node* MatchGrid::AddObject(Match& match, GameRand& random)
     }
     else
     {
-        if (!enemiesTypes.Size())
+        if (category == MOC_NONE)
             return 0;
 
         // set object
-        const StringHash& got = enemiesTypes[random.Get(enemiesTypes.Size())];
+        const StringHash& got = enemiesTypes[typeindex];
         object = GOT::GetObject(got)->Clone(LOCAL, true, 0, 0, objectsNode_);
         object->SetVar(GOA::GOT, got);
         // set match type
@@ -1262,6 +1410,7 @@ Node* MatchGrid::AddPowerBonus(Match* m, int bonusindex)
 
     match.otype_  = bonusindex;
     match.effect_ = object->GetVar(GOA::BONUS).GetIntVector2().x_;
+    SetTouched(match);
 
     SetDrawOrder(match, object, OBJECTLAYER, true);
     SetScaleAnimation(object, BONUSFACTOR);
@@ -1313,6 +1462,7 @@ Node* MatchGrid::AddItemBonus(Match& m, const StringHash& category, int bonusind
     match.otype_  = bonusindex;
     match.effect_ = NOEFFECT;
     match.qty_    = object->GetVar(GOA::BONUS).GetInt();
+    SetTouched(match);
 
     SetDrawOrder(match, object, ITEMLAYER, false);
 
@@ -1821,13 +1971,17 @@ bool MatchGrid::SetHintAnimation(const Match& match, bool enable)
 
 void MatchGrid::SetHittedWalls(Vector<WallInfo>& hittedwalls)
 {
+    bool brokenwalls = false;
+
     for (unsigned i=0; i < hittedwalls.Size(); i++)
     {
         WallInfo& wallinfo = hittedwalls[i];
-        if ((grid_(wallinfo.x_, wallinfo.y_).wallorientation_ & wallinfo.wallorientation_) == 0)
+        if (!BreakWall(grid_, wallinfo))
             continue;
 
-        grid_(wallinfo.x_, wallinfo.y_).wallorientation_ = grid_(wallinfo.x_, wallinfo.y_).wallorientation_ & ~wallinfo.wallorientation_;
+        touchedcells_.Set(wallinfo.x_, wallinfo.y_);
+        UpdateTileHash(wallinfo.x_, wallinfo.y_);
+        brokenwalls = true;
 
         Node* rootnode = walls_(wallinfo.x_, wallinfo.y_);
         if (!rootnode)
@@ -1846,11 +2000,16 @@ void MatchGrid::SetHittedWalls(Vector<WallInfo>& hittedwalls)
 			}
 		}
     }
+
+    // the moves depend on the walls : rebuilt here in the main thread, the hints indexing only reads the table
+    if (brokenwalls)
+        UpdateMoveTable();
 }
 
 void MatchGrid::SetMatch(Match& match, unsigned property)
 {
     match.property_ = property;
+    SetTouched(match);
 }
 
 void MatchGrid::SetMatch(Match& match, unsigned char ctype, char otype, unsigned char effect)
@@ -1858,6 +2017,7 @@ void MatchGrid::SetMatch(Match& match, unsigned char ctype, char otype, unsigned
     match.ctype_ = ctype;
     match.otype_ = otype;
     match.effect_ = effect;
+    SetTouched(match);
 }
 
 // reset scale and position
@@ -1913,6 +2073,7 @@ void MatchGrid::Remove(Match& match)
     {
         RemoveObject(objects_(savedM2_.x_, savedM2_.y_));
         matches_(savedM2_.x_, savedM2_.y_).property_ = 0;
+        SetTouched(savedM2_);
         permutation_ = false;
 //        URHO3D_LOGERRORF("MatchGrid() - Remove a permutted Match : m1=%s m2(removed)=%s", savedM1_.ToString().CString(), savedM2_.ToString().CString());
     }
@@ -1920,6 +2081,7 @@ void MatchGrid::Remove(Match& match)
     {
         RemoveObject(objects_(savedM1_.x_, savedM1_.y_));
         matches_(savedM1_.x_, savedM1_.y_).property_ = 0;
+        SetTouched(savedM1_);
         permutation_ = false;
 //        URHO3D_LOGERRORF("MatchGrid() - Remove a permutted Match : m1(removed)=%s m2=%s", savedM1_.ToString().CString(), savedM2_.ToString().CString());
     }
@@ -1927,6 +2089,7 @@ void MatchGrid::Remove(Match& match)
     {
         RemoveObject(objects_(match.x_, match.y_));
         match.property_ = 0;
+        SetTouched(match);
     }
 }
 
@@ -1934,6 +2097,7 @@ void MatchGrid::Remove(const Match& match)
 {
     RemoveObject(objects_(match.x_, match.y_));
     matches_(match.x_, match.y_).property_ = 0;
+    SetTouched(match);
 }
 
 void MatchGrid::RemoveObject(Node* node)
@@ -1963,6 +2127,8 @@ void MatchGrid::PermuteMatchType(const Match& e1, const Match& e2)
 
     m1.property_ = m2.property_;
     m2.property_ = savedM1_.property_;
+    SetTouched(m1);
+    SetTouched(m2);
 
 //    URHO3D_LOGINFOF("MatchGrid() - PermuteMatchType : After m1type=%d m2type=%d !", m1.ctype_, m2.ctype_);
 }
@@ -1971,6 +2137,8 @@ void MatchGrid::UndoPermute()
 {
     matches_(savedM1_.x_, savedM1_.y_) = savedM1_;
     matches_(savedM2_.x_, savedM2_.y_) = savedM2_;
+    SetTouched(savedM1_);
+    SetTouched(savedM2_);
 
     CleanSavedMatches();
 }
@@ -2009,81 +2177,33 @@ void MatchGrid::UpdateDirectionalTiles()
     {
         // gridupdates prevents double moves when a tile changes of direction
         static Matrix2D<int> gridupdates;
-        gridupdates.Resize(width_, height_);
-        gridupdates.SetBufferValue(-1);
-
-        for (int i=ramptiles_.Size()-1; i >= 0; --i)
-        {
-            const Vector<IntVector2>& ramptile = ramptiles_[i];
-            IntVector2 direction = ramptile.At(0);
-
-            for (int j=ramptile.Size()-1; j > 0; --j)
-            {
-                const IntVector2& position = ramptile[j];
-
-                // check in grid
-                if (direction.x_ != 0)
-                {
-                    if (direction.x_ > 0)
-                    {
-                        if (position.x_+direction.x_ >= width_)
-                            continue;
-                    }
-                    else
-                    {
-                        if (position.x_+direction.x_ < 0)
-                            continue;
-                    }
-                }
-                else
-                {
-                    if (direction.y_ > 0)
-                    {
-                        if (position.y_+direction.y_ >= height_)
-                            continue;
-                    }
-                    else
-                    {
-                        if (position.y_+direction.y_ < 0)
-                            continue;
-                    }
-                }
 
-                int& updatedfrom = gridupdates(position.x_, position.y_);
-                int& updatedto = gridupdates(position.x_ + direction.x_, position.y_ + direction.y_);
+        PODVector<IntVector2>& transfers = turnbuffers_.transfers_;
+        MoveOnRamps(grid_, matches_, ramptiles_, gridupdates, transfers);
 
-                // gridupdates is needed to prevent double moves when a tile changes of ramp
-                if (updatedfrom != -1 && updatedfrom != i)
-                    continue;
+        for (unsigned i=0; i < transfers.Size(); i += 2)
+        {
+            Match& mfrom = matches_(transfers[i].x_, transfers[i].y_);
+            Match& mto = matches_(transfers[i+1].x_, transfers[i+1].y_);
 
-                Match& mfrom = matches_(position.x_, position.y_);
-                Match& mto = matches_(position.x_ + direction.x_, position.y_ + direction.y_);
+            SetTouched(mto);
+            SetTouched(mfrom);
 
-    //            URHO3D_LOGINFOF("MatchGrid() - UpdateDirectionalTiles : Move=%s dir=%s", position.ToString().CString(), direction.ToString().CString());
-                if (mfrom.ctype_ && !mto.ctype_ && grid_(position.x_ + direction.x_, position.y_ + direction.y_).ground_ > GT_VOID)
-                {
-                    // Move the match to the direction
-                    if (objects_(mfrom.x_, mfrom.y_))
-                    {
-                        mto.property_ = mfrom.property_;
-                        mfrom.property_ = 0;
-                        WeakPtr<Node>& object = objects_(mto.x_, mto.y_);
-                        object = objects_(mfrom.x_, mfrom.y_);
-                        objects_(mfrom.x_, mfrom.y_).Reset();
-                        object->SetScale(OBJECTSCALE);
-                        SetDrawOrder(mto, object, OBJECTLAYER);
-                        SetMoveAnimation(mto, object, CalculateMatchPosition(mto.x_, mto.y_), MOVETIME);
-
-                        updatedfrom = i;
-                        updatedto = i;
-                    }
-                    else
-                    {
-                        URHO3D_LOGERRORF("MatchGrid() - UpdateDirectionalTiles : Error on Move=%s dir=%s no object => reset match", position.ToString().CString(), direction.ToString().CString());
-                        mfrom.property_ = 0;
-                    }
-                }
+            if (!objects_(mfrom.x_, mfrom.y_))
+            {
+                URHO3D_LOGERRORF("MatchGrid() - UpdateDirectionalTiles : Error on Move=%d,%d to=%d,%d no object => reset match", mfrom.x_, mfrom.y_, mto.x_, mto.y_);
+                mto.property_ = 0;
+                SetTouched(mto);
+                continue;
             }
+
+            // Move the match to the direction
+            WeakPtr<Node>& object = objects_(mto.x_, mto.y_);
+            object = objects_(mfrom.x_, mfrom.y_);
+            objects_(mfrom.x_, mfrom.y_).Reset();
+            object->SetScale(OBJECTSCALE);
+            SetDrawOrder(mto, object, OBJECTLAYER);
+            SetMoveAnimation(mto, object, CalculateMatchPosition(mto.x_, mto.y_), MOVETIME);
         }
     }
 
@@ -2102,6 +2222,7 @@ void MatchGrid::UpdateDirectionalTiles()
                 Node* node = AddObject(match, random);
                 if (node)
                 {
+                    SetTouched(match);
                     node->SetPosition(CalculateMatchPosition(match.x_-entrance.direction_.x_, match.y_-entrance.direction_.y_));
                     SetMoveAnimation(match, node, CalculateMatchPosition(match.x_, match.y_), MOVETIME);
                 }
@@ -2183,6 +2304,17 @@ Vector<Match*> MatchGrid::GetAllPowers()
     return powers;
 }
 
+void MatchGrid::GetAllPowers(MatchSet& powers)
+{
+    for (int y = 0; y < height_; y++)
+    for (int x = 0; x < width_; x++)
+    {
+        Match& match = matches_(x, y);
+        if (IsPower(match))
+            powers.Insert(&match);
+    }
+}
+
 // check if a world position is in the grid (gridRect_ is scene scaled)
 bool MatchGrid::IsInside(const Vector2& position) const
 {
@@ -2286,7 +2418,7 @@ bool MatchGrid::IsSelectableObject(const Match& match) const
     return (match.ctype_ && match.ctype_ < ROCKS);
 }
 
-bool MatchGrid::IsDirectional(unsigned char feature) const
+bool MatchGrid::IsDirectional(unsigned char feature)
 {
     return feature > GT_GRND;
 }
@@ -2330,14 +2462,10 @@ Match* MatchGrid::GetFirstBonusInMatches(const Vector<Match*>& matches, const In
     return 0;
 }
 
-Vector<Match*> MatchGrid::GetPermuttedMatches()
+void MatchGrid::GetPermuttedMatches(MatchSet& matches)
 {
-    Vector<Match*> matches;
-
-    matches.Push(&matches_(savedM1_.x_, savedM1_.y_));
-    matches.Push(&matches_(savedM2_.x_, savedM2_.y_));
-
-    return matches;
+    matches.Insert(&matches_(savedM1_.x_, savedM1_.y_));
+    matches.Insert(&matches_(savedM2_.x_, savedM2_.y_));
 }
 
 Match* MatchGrid::GetMatch(Node* object)
@@ -2364,7 +2492,7 @@ Node* MatchGrid::GetObject(int x, int y) const
 
 /// MATCHES
 
-bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<Match*>& successmatches, Vector<Match*>& activablebonuses, Vector<Match*>& brokenrocks, Vector<WallInfo>& hittedwalls)
+bool MatchGrid::GetMatches(Match* match, MatchSet& destroymatches, MatchSet& successmatches, MatchSet& activablebonuses, MatchSet& brokenrocks, Vector<WallInfo>& hittedwalls)
 {
     if (!grid_(match->x_, match->y_).ground_)
         return false;
@@ -2379,38 +2507,45 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
 	// "Spread Bomb" Matches
 	if (activedRules_[SPREADBOMBMATCH] && IsPower(entry, SPREADBOMB))
 	{
-		Vector<Match*> matches;
+		Vector<Match*>& matches = turnbuffers_.matches_;
+		matches.Clear();
 
 		CheckMatches_NeighborHood(entry, matches);
 
 		if (entry.effect_ < ROCKEXPLOSION)
 		{
-			URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s ... SPREADBOMBMATCH ...success=%u", entry.ToString().CString(), matches.Size());
+			GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s ... SPREADBOMBMATCH ...success=%u", entry.ToString().CString(), matches.Size());
 			if (matches.Size() >= Match::MINIMALMATCHES)
 			{
 			    // add effects on matches
 			    for (Vector<Match*>::ConstIterator mt=matches.Begin(); mt != matches.End(); ++mt)
+			    {
                     (*mt)->effect_ = entry.effect_;
+                    SetTouched(**mt);
+			    }
 
 			    // add entries
-				Match::AddDistinctEntries(matches, successmatches);
-				Match::AddDistinctEntries(successmatches, activablebonuses);
-				Match::AddDistinctEntries(matches, destroymatches);
+				successmatches.Insert(matches);
+				activablebonuses.Insert(successmatches);
+				destroymatches.Insert(matches);
 				return true;
 			}
 		}
 		else
 		{
-			URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s ... SPREADBOMBMATCH ROCKS ...success=%u", entry.ToString().CString(), matches.Size());
+			GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s ... SPREADBOMBMATCH ROCKS ...success=%u", entry.ToString().CString(), matches.Size());
 			if (matches.Size() > 1)
 			{
 			    // add effects on matches
 			    for (Vector<Match*>::ConstIterator mt=matches.Begin(); mt != matches.End(); ++mt)
+			    {
                     (*mt)->effect_ = entry.effect_;
+                    SetTouched(**mt);
+			    }
 
-				Match::AddDistinctEntries(matches, successmatches);
-				Match::AddDistinctEntries(successmatches, activablebonuses);
-				Match::AddDistinctEntries(matches, destroymatches);
+				successmatches.Insert(matches);
+				activablebonuses.Insert(successmatches);
+				destroymatches.Insert(matches);
 				return true;
 			}
 		}
@@ -2421,8 +2556,8 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
 		GetAllWallsAround(entry, 1, hittedwalls);
 		if (hittedwalls.Size())
 		{
-			Match::AddDistinctEntry(&entry, activablebonuses);
-			Match::AddDistinctEntry(&entry, destroymatches);
+			activablebonuses.Insert(&entry);
+			destroymatches.Insert(&entry);
 			return true;
 		}
 	}
@@ -2430,19 +2565,22 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
     // "Bomb" Matches
     if (activedRules_[BOMBMATCH] && IsPower(entry, DIRECTIONALEXPLOSION))
     {
-        Vector<Match*> bonush;
-        Vector<Match*> bonusv;
+        Vector<Match*>& bonush = turnbuffers_.bonush_;
+        bonush.Clear();
+        Vector<Match*>& bonusv = turnbuffers_.bonusv_;
+        bonusv.Clear();
 
         CheckMatches_Horizontal_Bonus(entry, bonush);
         if (bonush.Size() > 0)
         {
             Match::AddDistinctEntry(&entry, bonush);
-            Match::AddDistinctEntries(bonush, successmatches);
-            Match::AddDistinctEntries(successmatches, activablebonuses);
+            successmatches.Insert(bonush);
+            activablebonuses.Insert(successmatches);
 
-            URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s ... BOMBMATCH horiz=%u ...", entry.ToString().CString(), successmatches.Size());
+            GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s ... BOMBMATCH horiz=%u ...", entry.ToString().CString(), successmatches.Size());
 
-            Vector<Match*> bonus2;
+            Vector<Match*>& bonus2 = turnbuffers_.bonus2_;
+            bonus2.Clear();
             for (int i=0; i < bonush.Size(); i++)
             {
                 if (IsPower(*bonush[i], DIRECTIONALEXPLOSION, YEXPLOSION))
@@ -2450,12 +2588,12 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
                 if (IsPower(*bonush[i], DIRECTIONALEXPLOSION, XEXPLOSION))
                     GetAllHorizontalMatches(*bonush[i], bonus2, brokenrocks, &hittedwalls);
             }
-            Match::AddDistinctEntries(bonus2, destroymatches);
+            destroymatches.Insert(bonus2);
 
             if (entry.effect_ & XEXPLOSION)
             {
                 GetAllHorizontalMatches(entry, bonush, brokenrocks, &hittedwalls);
-                Match::AddDistinctEntries(bonush, destroymatches);
+                destroymatches.Insert(bonush);
             }
         }
 
@@ -2463,12 +2601,13 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
         if (bonusv.Size() > 0)
         {
             Match::AddDistinctEntry(&entry, bonusv);
-            Match::AddDistinctEntries(bonusv, successmatches);
-            Match::AddDistinctEntries(successmatches, activablebonuses);
+            successmatches.Insert(bonusv);
+            activablebonuses.Insert(successmatches);
 
-            URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s ... BOMBMATCH verti=%u ...", entry.ToString().CString(), successmatches.Size());
+            GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s ... BOMBMATCH verti=%u ...", entry.ToString().CString(), successmatches.Size());
 
-            Vector<Match*> bonus2;
+            Vector<Match*>& bonus2 = turnbuffers_.bonus2_;
+            bonus2.Clear();
             for (int i=0; i < bonusv.Size(); i++)
             {
                 if (IsPower(*bonusv[i], DIRECTIONALEXPLOSION, YEXPLOSION))
@@ -2476,12 +2615,12 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
                 if (IsPower(*bonusv[i], DIRECTIONALEXPLOSION, XEXPLOSION))
                     GetAllHorizontalMatches(*bonusv[i], bonus2, brokenrocks, &hittedwalls);
             }
-            Match::AddDistinctEntries(bonus2, destroymatches);
+            destroymatches.Insert(bonus2);
 
             if (entry.effect_ & YEXPLOSION)
             {
                 GetAllVerticalMatches(entry, bonusv, brokenrocks, &hittedwalls);
-                Match::AddDistinctEntries(bonusv, destroymatches);
+                destroymatches.Insert(bonusv);
             }
         }
 
@@ -2492,21 +2631,22 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
     // "Square" Matches
     if (activedRules_[SQUAREMATCH])
     {
-        Vector<Match*> matchesq;
+        Vector<Match*>& matchesq = turnbuffers_.matchesq_;
+        matchesq.Clear();
 
         matchesq.Push(&entry);
         CheckMatches_Squares(entry, matchesq);
 
         if (matchesq.Size() > Match::MINIMALMATCHES)
         {
-            Match::AddDistinctEntries(matchesq, successmatches);
+            successmatches.Insert(matchesq);
 
 			// TODO
 //            entry.effect_ = SQREXPLOSION;
-//            Match::AddDistinctEntry(&entry, activablebonuses);
-            Match::AddDistinctEntries(matchesq, destroymatches);
+//            activablebonuses.Insert(&entry);
+            destroymatches.Insert(matchesq);
 
-            URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - SQUAREMATCH NumMatches=%u SUCCESS !", entry.ToString().CString(), matchesq.Size());
+            GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - SQUAREMATCH NumMatches=%u SUCCESS !", entry.ToString().CString(), matchesq.Size());
         }
     }
 
@@ -2517,16 +2657,18 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
         // Horizontal Matches
         if (activedRules_[HORIZONTALMATCH])
         {
-            Vector<Match*> matchesh;
+            Vector<Match*>& matchesh = turnbuffers_.matchesh_;
+            matchesh.Clear();
 
             matchesh.Push(&entry);
             CheckMatches_Horizontal(entry, matchesh);
 
             if (matchesh.Size() >= Match::MINIMALMATCHES)
             {
-                Match::AddDistinctEntries(matchesh, successmatches);
+                successmatches.Insert(matchesh);
 
-                Vector<Match*> bonuses;
+                Vector<Match*>& bonuses = turnbuffers_.bonuses_;
+                bonuses.Clear();
                 if (GetBonusesInMatches(matchesh, bonuses, DIRECTIONALEXPLOSION))
                 {
                     // Check HorizontalBomb in the matches
@@ -2534,7 +2676,7 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
 
                     if (firstpower)
                     {
-                        URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - HORIZONTAL HasPowers=%u !", entry.ToString().CString(), bonuses.Size());
+                        GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - HORIZONTAL HasPowers=%u !", entry.ToString().CString(), bonuses.Size());
 
                         matchesh.Clear();
 
@@ -2563,30 +2705,32 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
                             }
                         }
 
-                        activablebonuses.Push(bonuses);
+                        activablebonuses.Insert(bonuses);
                     }
                 }
 
-                Match::AddDistinctEntries(matchesh, destroymatches);
+                destroymatches.Insert(matchesh);
 
-                URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - HORIZONTAL NumMatches=%u SUCCESS !", entry.ToString().CString(), matchesh.Size());
+                GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - HORIZONTAL NumMatches=%u SUCCESS !", entry.ToString().CString(), matchesh.Size());
             }
         }
 
         // Vertical Matches
         if (activedRules_[VERTICALMATCH])
         {
-            Vector<Match*> matchesv;
+            Vector<Match*>& matchesv = turnbuffers_.matchesv_;
+            matchesv.Clear();
 
             matchesv.Push(&entry);
             CheckMatches_Vertical(entry, matchesv);
 
             if (matchesv.Size() >= Match::MINIMALMATCHES)
             {
-                Match::AddDistinctEntries(matchesv, successmatches);
+                successmatches.Insert(matchesv);
 
                 // Check VerticalBomb in the matches
-                Vector<Match*> bonuses;
+                Vector<Match*>& bonuses = turnbuffers_.bonuses_;
+                bonuses.Clear();
                 if (GetBonusesInMatches(matchesv, bonuses, DIRECTIONALEXPLOSION))
                 {
                     // Check HorizontalBomb in the matches
@@ -2594,7 +2738,7 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
 
                     if (firstpower)
                     {
-                        URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - VERTICAL HasPowers=%u !", entry.ToString().CString(), bonuses.Size());
+                        GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - VERTICAL HasPowers=%u !", entry.ToString().CString(), bonuses.Size());
 
                         matchesv.Clear();
 
@@ -2619,7 +2763,7 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
                             }
                         }
 
-                        activablebonuses.Push(bonuses);
+                        activablebonuses.Insert(bonuses);
                     }
                 }
 
@@ -2629,7 +2773,7 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
     //
     //                GetAllVerticalMatches(entry, matchesv, brokenrocks, &hittedwalls);
     //
-    //                activablebonuses.Push(bonuses);
+    //                activablebonuses.Insert(bonuses);
     //
     //                Match* bonus = *bonuses.Begin();
     //
@@ -2643,16 +2787,18 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
     //                }
     //            }
 
-                Match::AddDistinctEntries(matchesv, destroymatches);
+                destroymatches.Insert(matchesv);
 
-                URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - VERTICAL NumMatches=%u SUCCESS !", entry.ToString().CString(), matchesv.Size());
+                GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - VERTICAL NumMatches=%u SUCCESS !", entry.ToString().CString(), matchesv.Size());
             }
         }
     }
     else
     {
-        Vector<Match*> matchesh;
-        Vector<Match*> matchesv;
+        Vector<Match*>& matchesh = turnbuffers_.matchesh_;
+        matchesh.Clear();
+        Vector<Match*>& matchesv = turnbuffers_.matchesv_;
+        matchesv.Clear();
 
         // Horizontal Matches
         if (activedRules_[HORIZONTALMATCH])
@@ -2664,10 +2810,11 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
             {
                 unsigned nummatches = matchesh.Size();
 
-                Match::AddDistinctEntries(matchesh, successmatches);
-                Match::AddDistinctEntries(matchesh, destroymatches);
+                successmatches.Insert(matchesh);
+                destroymatches.Insert(matchesh);
 
-                Vector<Match*> bonuses;
+                Vector<Match*>& bonuses = turnbuffers_.bonuses_;
+                bonuses.Clear();
                 if (GetBonusesInMatches(matchesh, bonuses, DIRECTIONALEXPLOSION))
                 {
                     for (Vector<Match*>::ConstIterator it=bonuses.Begin(); it!=bonuses.End(); ++it)
@@ -2676,21 +2823,21 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
                         if (IsPower(*power, DIRECTIONALEXPLOSION, XEXPLOSION))
                         {
                             GetAllHorizontalMatches(*power, matchesh, brokenrocks, &hittedwalls);
-                            Match::AddDistinctEntries(matchesh, destroymatches);
+                            destroymatches.Insert(matchesh);
                             nummatches += matchesh.Size();
                         }
                         if (IsPower(*power, DIRECTIONALEXPLOSION, YEXPLOSION))
                         {
                             GetAllVerticalMatches(*power, matchesv, brokenrocks, &hittedwalls);
-                            Match::AddDistinctEntries(matchesv, destroymatches);
+                            destroymatches.Insert(matchesv);
                             nummatches += matchesv.Size();
                         }
                     }
 
-                    activablebonuses.Push(bonuses);
+                    activablebonuses.Insert(bonuses);
                 }
 
-                URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - free HORIZONTAL NumMatches=%u SUCCESS !", entry.ToString().CString(), nummatches);
+                GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - free HORIZONTAL NumMatches=%u SUCCESS !", entry.ToString().CString(), nummatches);
             }
         }
 
@@ -2707,10 +2854,11 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
             {
                 unsigned nummatches = matchesv.Size();
 
-                Match::AddDistinctEntries(matchesv, successmatches);
-                Match::AddDistinctEntries(matchesv, destroymatches);
+                successmatches.Insert(matchesv);
+                destroymatches.Insert(matchesv);
 
-                Vector<Match*> bonuses;
+                Vector<Match*>& bonuses = turnbuffers_.bonuses_;
+                bonuses.Clear();
                 if (GetBonusesInMatches(matchesv, bonuses, DIRECTIONALEXPLOSION))
                 {
                     for (Vector<Match*>::ConstIterator it=bonuses.Begin(); it!=bonuses.End(); ++it)
@@ -2719,21 +2867,21 @@ bool MatchGrid::GetMatches(Match* match, Vector<Match*>& destroymatches, Vector<
                         if (IsPower(*power, DIRECTIONALEXPLOSION, XEXPLOSION))
                         {
                             GetAllHorizontalMatches(*power, matchesh, brokenrocks, &hittedwalls);
-                            Match::AddDistinctEntries(matchesh, destroymatches);
+                            destroymatches.Insert(matchesh);
                             nummatches += matchesh.Size();
                         }
                         if (IsPower(*power, DIRECTIONALEXPLOSION, YEXPLOSION))
                         {
                             GetAllVerticalMatches(*power, matchesv, brokenrocks, &hittedwalls);
-                            Match::AddDistinctEntries(matchesv, destroymatches);
+                            destroymatches.Insert(matchesv);
                             nummatches += matchesv.Size();
                         }
                     }
 
-                    activablebonuses.Push(bonuses);
+                    activablebonuses.Insert(bonuses);
                 }
 
-                URHO3D_LOGINFOF("MatchGrid() - GetMatches : entry=%s - free VERTICAL NumMatches=%u SUCCESS !", entry.ToString().CString(), nummatches);
+                GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - GetMatches : entry=%s - free VERTICAL NumMatches=%u SUCCESS !", entry.ToString().CString(), nummatches);
             }
         }
     }
@@ -2969,11 +3117,6 @@ void MatchGrid::CheckMatches_L(const Match& entry, Vector<Match*>& matches)
 
 void MatchGrid::CheckMatches_NeighborHood(const Match& entry, Vector<Match*>& matches)
 {
-	List<Match* > white;
-	List<Match* > black;
-
-	white.Push(&matches_(entry.x_, entry.y_));
-
 	int range = 2;
 	unsigned char ctype = entry.ctype_;
 
@@ -3001,58 +3144,19 @@ void MatchGrid::CheckMatches_NeighborHood(const Match& entry, Vector<Match*>& ma
     if (entry.y_ + range < height_-1)
         ymax = entry.y_ + range;
 
-    URHO3D_LOGINFOF("MatchGrid() - CheckMatches_NeighborHood : entry=%s ctype=%u ... range=%d (%d %d %d %d)...",
-                    entry.ToString().CString(), ctype, range, xmin, ymin, xmax, ymax);
-
-	while (white.Size())
-	{
-		Match* match = white.Back();
-		white.Pop();
-
-		if (black.Contains(match))
-			continue;
-
-		if (match->ctype_ == ctype)
-		{
-			matches.Push(match);
-		}
-		else if (ctype == ROCKS)
-		{
-			if (white.Size() > 0)
-				continue;
-
-			matches.Push(match);
-		}
-
-		int x = match->x_;
-		int y = match->y_;
-
-		if (y > ymin && HaveSameTypeAndNoWalls(ctype, entry, matches_(x, y - 1)))
-			white.Push(&matches_(x, y - 1));
-		if (y < ymax && HaveSameTypeAndNoWalls(ctype, entry, matches_(x, y + 1)))
-			white.Push(&matches_(x, y + 1));
+    GAMELOG_INFOF(GAMELOG_MATCHES, "MatchGrid() - CheckMatches_NeighborHood : entry=%s ctype=%u ... range=%d (%d %d %d %d)...",
+                  entry.ToString().CString(), ctype, range, xmin, ymin, xmax, ymax);
 
-		if (x > xmin)
-		{
-			if (HaveSameTypeAndNoWalls(ctype, entry, matches_(x - 1, y)))
-				white.Push(&matches_(x - 1, y));
-			if (y > ymin && HaveSameTypeAndNoWalls(ctype, entry, matches_(x - 1, y - 1)))
-				white.Push(&matches_(x - 1, y - 1));
-			if (y < ymax && HaveSameTypeAndNoWalls(ctype, entry, matches_(x - 1, y + 1)))
-				white.Push(&matches_(x - 1, y + 1));
-		}
-		if (x < xmax)
-		{
-			if (HaveSameTypeAndNoWalls(ctype, entry, matches_(x + 1, y)))
-				white.Push(&matches_(x + 1, y));
-			if (y > ymin && HaveSameTypeAndNoWalls(ctype, entry, matches_(x + 1, y - 1)))
-				white.Push(&matches_(x + 1, y - 1));
-			if (y < ymax && HaveSameTypeAndNoWalls(ctype, entry, matches_(x + 1, y + 1)))
-				white.Push(&matches_(x + 1, y + 1));
-		}
+    // the cells of ctype in the range flooded from the entry, without the cells walled from the entry
+    const BitBoard region = powerresolver_.GetNeighborhood(entry.x_, entry.y_, entry.effect_);
 
-		black.Push(match);
-	}
+    matches.Push(&matches_(entry.x_, entry.y_));
+    for (int y=ymin; y <= ymax; y++)
+        for (int x=xmin; x <= xmax; x++)
+        {
+            if (region.Test(x, y) && (x != entry.x_ || y != entry.y_))
+                matches.Push(&matches_(x, y));
+        }
 }
 
 
@@ -3061,894 +3165,640 @@ void MatchGrid::CheckMatches_NeighborHood(const Match& entry, Vector<Match*>& ma
 
 bool MatchGrid::IsPowerActivable(Match& X)
 {
-    Vector<Vector<Match*> > hintstable;
+    PODVector<MatchHint>& hintstable = turnbuffers_.hints_;
+    hintstable.Clear();
 
-    CheckHints_Explosion(X, hintstable);
-    CheckHints_Square(X, hintstable);
-    CheckHints_Horizontal(X, hintstable);
-    CheckHints_Vertical(X, hintstable);
+    CheckHints_Moves(X, hintstable);
 
     return hintstable.Size();
 }
 
 
-void MatchGrid::GetHints(unsigned imatch, Vector<Vector<Match*> >& hintstable)
+void MatchGrid::GetHints(unsigned imatch, PODVector<MatchHint>& hintstable)
 {
     Match& X = matches_[imatch];
 
     if (IsItem(X))
     {
-        Vector<Match*> matches;
+        MatchHint matches;
         matches.Push(&X);
         hintstable.Push(matches);
     }
     else
     {
-        unsigned oldhintsize = hintstable.Size();
-
-        CheckHints_Explosion(X, hintstable);
-        CheckHints_Square(X, hintstable);
-        CheckHints_Horizontal(X, hintstable);
-        CheckHints_Vertical(X, hintstable);
+        CheckHints_Moves(X, hintstable);
         /// TODO
         // CheckHints_L(X, hintstable);
+    }
+}
 
-        // Add Power Tutorial
-        if (GameStatics::playerState_->tutorialEnabled_ && IsPower(X) && hintstable.Size() > oldhintsize)
-        {
-            int powerid = X.otype_+1;
-            if (!powerid)
-            {
-                URHO3D_LOGERRORF("MatchGrid() - GetHints : Check Tutorial => Power Error !");
-                return;
-            }
-
-            if (GameStatics::playerState_->powers_[powerid-1].shown_ > 0)
-                return;
+void MatchGrid::CheckPowerTutorial(unsigned imatch)
+{
+    Match& X = matches_[imatch];
 
-            Node* node = GetObject(X);
-            if (!node)
-                return;
+    if (!GameStatics::playerState_->tutorialEnabled_ || !IsPower(X) || IsItem(X))
+        return;
 
-            URHO3D_LOGINFOF("MatchGrid() - GetHints : send GAME_POWERADDED for Match=%s hintsize=%u !", X.ToString().CString(), hintstable.Size());
-            VariantMap& eventdata = GameStatics::context_->GetEventDataMap();
-            eventdata[Game_PowerAdded::MATCHPROPERTY] = X.property_;
-            eventdata[Game_PowerAdded::NODE] = node;
-            node->SendEvent(GAME_POWERADDED, eventdata);
-        }
+    int powerid = X.otype_+1;
+    if (!powerid)
+    {
+        URHO3D_LOGERRORF("MatchGrid() - CheckPowerTutorial : Power Error !");
+        return;
     }
-}
 
+    if (GameStatics::playerState_->powers_[powerid-1].shown_ > 0)
+        return;
 
-void MatchGrid::CheckHints_Explosion(Match& X, Vector<Vector<Match*> >& hints)
-{
-    if (!IsPower(X))
+    Node* node = GetObject(X);
+    if (!node)
         return;
 
-    // Schema
-    //         W .
-    //         v X
-    //         Z .
-    if (X.x_ > 0)
-    {
-        Match& v = matches_(X.x_-1, X.y_);
+    URHO3D_LOGINFOF("MatchGrid() - CheckPowerTutorial : send GAME_POWERADDED for Match=%s !", X.ToString().CString());
+    PowerAddedEvent event;
+    event.property_.property_ = X.property_;
+    event.node_ = node;
+    EventChannel<PowerAddedEvent>::Send(node, event);
+}
 
-        if (IsSelectableObject(v) && HasNoWalls(X, WO_WALLLEFT) && HasNoWalls(v, WO_WALLRIGHT))
-        {
-            if (X.y_ > 0 && HasNoWalls(v, WO_WALLNORTH))
-            {
-                Match& W = matches_(X.x_-1, X.y_-1);
-                if (HaveSameMatchType(X, W))
-                    if (IsPower(W) && HasNoWalls(W, WO_WALLSOUTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-            }
-            if (X.y_ < height_-1 && HasNoWalls(v, WO_WALLSOUTH))
-            {
-                Match& Z = matches_(X.x_-1, X.y_+1);
-                if (HaveSameMatchType(X, Z))
-                    if (IsPower(Z) && HasNoWalls(Z, WO_WALLNORTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-            }
-        }
-    }
 
-    // Schema
-    //         . W
-    //         X v
-    //         . Z
-    if (X.x_ < width_-1)
+/// MOVE TABLE
+
+// a hint pattern : the swapped cell v and the cells of the hint (X excluded) relative to X,
+// and the walls (relative to X) that must be open.
+struct MatchMovePattern
+{
+    struct Cell
+    {
+        signed char x_, y_;
+    };
+    struct Wall
     {
-        Match& v = matches_(X.x_+1, X.y_);
+        signed char x_, y_;
+        unsigned char orientation_;
+    };
 
-        if (IsSelectableObject(v) && HasNoWalls(X, WO_WALLRIGHT) && HasNoWalls(v, WO_WALLLEFT))
-        {
-            if (X.y_ > 0 && HasNoWalls(v, WO_WALLNORTH))
-            {
-                Match& W = matches_(X.x_+1, X.y_-1);
-                if (HaveSameMatchType(X, W))
-                    if (IsPower(W) && HasNoWalls(W, WO_WALLSOUTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-            }
-            if (X.y_ < height_-1 && HasNoWalls(v, WO_WALLSOUTH))
-            {
-                Match& Z = matches_(X.x_+1, X.y_+1);
-                if (HaveSameMatchType(X, Z))
-                    if (IsPower(Z) && HasNoWalls(Z, WO_WALLNORTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-            }
-        }
-    }
+    unsigned char flags_;
+    Cell swap_;
+    unsigned char numcells_;
+    Cell cells_[MATCHHINT_CAPACITY-1];
+    unsigned char numwalls_;
+    Wall walls_[5];
+};
 
-    // Schema
-    //         W v Z
-    //         . X .
-    if (X.y_ > 0)
-    {
-        Match& v = matches_(X.x_, X.y_-1);
+#define N WO_WALLNORTH
+#define S WO_WALLSOUTH
+#define L WO_WALLLEFT
+#define R WO_WALLRIGHT
+
+static const MatchMovePattern sMovePatterns_[] =
+{
+    // Explosions : the power X swapped with v is beside the power W (or Z) of the same type
+    //         W .     . W     W v Z    . X .
+    //         v X     X v     . X .    W v Z
+    //         Z .     . Z
+    { MOVE_EXPLOSION, { -1, 0 }, 1, { { -1,-1 } }, 3, { { 0, 0, L }, { -1, 0, R|N }, { -1,-1, S } } },
+    { MOVE_EXPLOSION, { -1, 0 }, 1, { { -1, 1 } }, 3, { { 0, 0, L }, { -1, 0, R|S }, { -1, 1, N } } },
+    { MOVE_EXPLOSION, {  1, 0 }, 1, { {  1,-1 } }, 3, { { 0, 0, R }, {  1, 0, L|N }, {  1,-1, S } } },
+    { MOVE_EXPLOSION, {  1, 0 }, 1, { {  1, 1 } }, 3, { { 0, 0, R }, {  1, 0, L|S }, {  1, 1, N } } },
+    { MOVE_EXPLOSION, { 0,-1 }, 1, { { -1,-1 } }, 3, { { 0, 0, N }, { 0,-1, S|L }, { -1,-1, R } } },
+    { MOVE_EXPLOSION, { 0,-1 }, 1, { {  1,-1 } }, 3, { { 0, 0, N }, { 0,-1, S|R }, {  1,-1, L } } },
+    { MOVE_EXPLOSION, { 0, 1 }, 1, { { -1, 1 } }, 3, { { 0, 0, S }, { 0, 1, N|L }, { -1, 1, R } } },
+    { MOVE_EXPLOSION, { 0, 1 }, 1, { {  1, 1 } }, 3, { { 0, 0, S }, { 0, 1, N|R }, {  1, 1, L } } },
+
+    // Squares : hint X Y W Z
+    //         X W v    Y Z .    v W X    . Z Y
+    //         Y Z .    X v W    . Z Y    W v X
+    { 0, {  2, 0 }, 3, { { 0, 1 }, {  1, 0 }, {  1, 1 } }, 5, { { 0, 0, S|R }, { 0, 1, N|R }, {  1, 1, N|L }, {  1, 0, L }, {  2, 0, S|L|R } } },
+    { 0, {  1, 0 }, 3, { { 0,-1 }, {  2, 0 }, {  1,-1 } }, 5, { { 0, 0, N|R }, { 0,-1, S|R }, {  1,-1, S|L }, {  2, 0, L }, {  1, 0, N|L|R } } },
+    { 0, { -1, 0 }, 3, { { 0, 1 }, { -2, 0 }, { -1, 1 } }, 5, { { 0, 0, S|L }, { 0, 1, N|L }, { -1, 1, N|R }, { -2, 0, R }, { -1, 0, S|L|R } } },
+    { 0, { -1, 0 }, 3, { { 0,-1 }, { -2, 0 }, { -1,-1 } }, 5, { { 0, 0, N|L }, { 0,-1, S|L }, { -1,-1, S|R }, { -2, 0, R }, { -1, 0, N|L|R } } },
+    //         . W    W .    Z X    X Z
+    //         Y v    v Y    v Y    Y v
+    //         X Z    Z X    W .    . W
+    { 0, {  1,-1 }, 3, { { 0,-1 }, {  1,-2 }, {  1, 0 } }, 5, { { 0, 0, N|R }, { 0,-1, S|R }, {  1, 0, N|L }, {  1,-2, S }, {  1,-1, N|S|L } } },
+    { 0, { -1,-1 }, 3, { { 0,-1 }, { -1,-2 }, { -1, 0 } }, 5, { { 0, 0, N|L }, { 0,-1, S|L }, { -1, 0, N|R }, { -1,-2, S }, { -1,-1, N|S|R } } },
+    { 0, { -1, 1 }, 3, { { 0, 1 }, { -1, 2 }, { -1, 0 } }, 5, { { 0, 0, S|L }, { 0, 1, N|L }, { -1, 0, S|R }, { -1, 2, N }, { -1, 1, N|S|R } } },
+    { 0, {  1, 1 }, 3, { { 0, 1 }, {  1, 2 }, {  1, 0 } }, 5, { { 0, 0, S|R }, { 0, 1, N|R }, {  1, 0, S|L }, {  1, 2, N }, {  1, 1, N|S|L } } },
+
+    // Horizontals : hint X Y W (or Z)
+    //         W . .    . . W    . . . .    . . . .    . W .
+    //         v X Y    X Y v    X Y v Z    Z v Y X    X v Y
+    //         Z . .    . . Z    . . . .    . . . .    . Z .
+    { 0, { -1, 0 }, 2, { {  1, 0 }, { -1,-1 } }, 4, { { 0, 0, R|L }, {  1, 0, L }, { -1, 0, R|N }, { -1,-1, S } } },
+    { 0, { -1, 0 }, 2, { {  1, 0 }, { -1, 1 } }, 4, { { 0, 0, R|L }, {  1, 0, L }, { -1, 0, R|S }, { -1, 1, N } } },
+    { 0, {  2, 0 }, 2, { {  1, 0 }, {  2,-1 } }, 4, { {  1, 0, R|L }, { 0, 0, R }, {  2, 0, L|N }, {  2,-1, S } } },
+    { 0, {  2, 0 }, 2, { {  1, 0 }, {  2, 1 } }, 4, { {  1, 0, R|L }, { 0, 0, R }, {  2, 0, L|S }, {  2, 1, N } } },
+    { MOVE_NOTSAMESWAP, {  2, 0 }, 2, { {  1, 0 }, {  3, 0 } }, 4, { {  3, 0, L }, {  1, 0, R|L }, {  2, 0, R|L }, { 0, 0, R } } },
+    { MOVE_NOTSAMESWAP, { -2, 0 }, 2, { { -1, 0 }, { -3, 0 } }, 4, { { 0, 0, L }, { -1, 0, R|L }, { -2, 0, R|L }, { -3, 0, R } } },
+    { 0, {  1, 0 }, 2, { {  2, 0 }, {  1,-1 } }, 4, { {  2, 0, L }, { 0, 0, R }, {  1, 0, R|L|N }, {  1,-1, S } } },
+    { 0, {  1, 0 }, 2, { {  2, 0 }, {  1, 1 } }, 4, { {  2, 0, L }, { 0, 0, R }, {  1, 0, R|L|S }, {  1, 1, N } } },
+
+    // Verticals : hint X Y W (or Z)
+    //         W v Z    . X .    . X .    . Z .    . X .
+    //         . X .    . Y .    . Y .    . v .    W v Z
+    //         . Y .    W v Z    . v .    . Y .    . Y .
+    //                           . Z .    . X .
+    { 0, { 0,-1 }, 2, { { 0, 1 }, { -1,-1 } }, 4, { { 0, 0, N|S }, { 0, 1, N }, { 0,-1, S|L }, { -1,-1, R } } },
+    { 0, { 0,-1 }, 2, { { 0, 1 }, {  1,-1 } }, 4, { { 0, 0, N|S }, { 0, 1, N }, { 0,-1, S|R }, {  1,-1, L } } },
+    { 0, { 0, 2 }, 2, { { 0, 1 }, { -1, 2 } }, 4, { { 0, 1, N|S }, { 0, 0, S }, { 0, 2, N|L }, { -1, 2, R } } },
+    { 0, { 0, 2 }, 2, { { 0, 1 }, {  1, 2 } }, 4, { { 0, 1, N|S }, { 0, 0, S }, { 0, 2, N|R }, {  1, 2, L } } },
+    { MOVE_NOTSAMESWAP, { 0, 2 }, 2, { { 0, 1 }, { 0, 3 } }, 4, { { 0, 0, S }, { 0, 1, N|S }, { 0, 2, N|S }, { 0, 3, N } } },
+    { MOVE_NOTSAMESWAP, { 0,-2 }, 2, { { 0,-1 }, { 0,-3 } }, 4, { { 0,-3, S }, { 0,-1, N|S }, { 0,-2, N|S }, { 0, 0, N } } },
+    { 0, { 0, 1 }, 2, { { 0, 2 }, { -1, 1 } }, 4, { { 0, 2, N }, { 0, 0, S }, { 0, 1, N|S|L }, { -1, 1, R } } },
+    { 0, { 0, 1 }, 2, { { 0, 2 }, {  1, 1 } }, 4, { { 0, 2, N }, { 0, 0, S }, { 0, 1, N|S|R }, {  1, 1, L } } },
+};
 
-        if (IsSelectableObject(v) && HasNoWalls(X, WO_WALLNORTH) && HasNoWalls(v, WO_WALLSOUTH))
-        {
-            if (X.x_ > 0 && HasNoWalls(v, WO_WALLLEFT))
-            {
-                Match& W = matches_(X.x_-1, X.y_-1);
-                if (HaveSameMatchType(X, W))
-                    if (IsPower(W) && HasNoWalls(W, WO_WALLRIGHT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-            }
-            if (X.x_ < width_-1 && HasNoWalls(v, WO_WALLRIGHT))
-            {
-                Match& Z = matches_(X.x_+1, X.y_-1);
-                if (HaveSameMatchType(X, Z))
-                    if (IsPower(Z) && HasNoWalls(Z, WO_WALLLEFT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-            }
-        }
-    }
+#undef N
+#undef S
+#undef L
+#undef R
 
-    // Schema
-    //         . X .
-    //         W v Z
-    if (X.y_ < height_-1)
-    {
-        Match& v = matches_(X.x_, X.y_+1);
+static const unsigned sNumMovePatterns_ = sizeof(sMovePatterns_) / sizeof(MatchMovePattern);
 
-        if (IsSelectableObject(v) && HasNoWalls(X, WO_WALLSOUTH) && HasNoWalls(v, WO_WALLNORTH))
-        {
-            if (X.x_ > 0 && HasNoWalls(v, WO_WALLLEFT))
-            {
-                Match& W = matches_(X.x_-1, X.y_+1);
-                if (HaveSameMatchType(X, W))
-                    if (IsPower(W) && HasNoWalls(W, WO_WALLRIGHT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-            }
-            if (X.x_ < width_-1 && HasNoWalls(v, WO_WALLRIGHT))
-            {
-                Match& Z = matches_(X.x_+1, X.y_+1);
-                if (HaveSameMatchType(X, Z))
-                    if (IsPower(Z) && HasNoWalls(Z, WO_WALLLEFT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-            }
-        }
-    }
+static inline bool IsInsideBounds(int x, int y, int width, int height)
+{
+    return x >= 0 && x < width && y >= 0 && y < height;
 }
 
-void MatchGrid::CheckHints_Horizontal(Match& X, Vector<Vector<Match*> >& hints)
+void MatchGrid::UpdateMoveTable()
 {
-    // Schema
-    //         W . .
-    //         v X Y
-    //         Z . .
-    if (X.x_ > 0 && X.x_ < width_-1)
-    {
-        Match& v = matches_(X.x_-1, X.y_);
+    const unsigned numcells = width_ * height_;
+
+    moves_.Clear();
+    moveoffsets_.Resize(numcells+1);
 
-        if (IsSelectableObject(v))
+    for (int y=0; y < height_; y++)
+    {
+        for (int x=0; x < width_; x++)
         {
-            Match& Y = matches_(X.x_+1, X.y_);
+            moveoffsets_[y * width_ + x] = moves_.Size();
 
-            if (HaveSameMatchType(X, Y) && HasNoWalls(X, WO_WALLRIGHT | WO_WALLLEFT) && HasNoWalls(Y, WO_WALLLEFT) && HasNoWalls(v, WO_WALLRIGHT))
+            for (unsigned i=0; i < sNumMovePatterns_; i++)
             {
-                if (X.y_ >= 1 && HasNoWalls(v, WO_WALLNORTH))
-                {
-                    Match& W = matches_(X.x_-1, X.y_-1);
-                    if (HaveSameMatchType(X, W) && HasNoWalls(W, WO_WALLSOUTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-                }
-                if (X.y_ < height_-1 && HasNoWalls(v, WO_WALLSOUTH))
-                {
-                    Match& Z = matches_(X.x_-1, X.y_+1);
-                    if (HaveSameMatchType(X, Z) && HasNoWalls(Z, WO_WALLNORTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-                }
-            }
-        }
-    }
-    // Schema
-    //         . . W
-    //         X Y v
-    //         . . Z
-    if (X.x_ < width_-2)
-    {
-        Match& v = matches_(X.x_+2, X.y_);
+                const MatchMovePattern& pattern = sMovePatterns_[i];
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_+1, X.y_);
+                // bounds
+                bool inside = IsInsideBounds(x + pattern.swap_.x_, y + pattern.swap_.y_, width_, height_);
+                for (unsigned j=0; j < pattern.numcells_ && inside; j++)
+                    inside = IsInsideBounds(x + pattern.cells_[j].x_, y + pattern.cells_[j].y_, width_, height_);
+                if (!inside)
+                    continue;
 
-            if (HaveSameMatchType(X, Y) && HasNoWalls(Y, WO_WALLRIGHT | WO_WALLLEFT) && HasNoWalls(X, WO_WALLRIGHT) && HasNoWalls(v, WO_WALLLEFT))
-            {
-                if (X.y_ >= 1 && HasNoWalls(v, WO_WALLNORTH))
+                // walls
+                bool open = true;
+                for (unsigned j=0; j < pattern.numwalls_ && open; j++)
                 {
-                    Match& W = matches_(X.x_+2, X.y_-1);
-                    if (HaveSameMatchType(X, W) && HasNoWalls(W, WO_WALLSOUTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-                }
-                if (X.y_ < height_-1 && HasNoWalls(v, WO_WALLSOUTH))
-                {
-                    Match& Z = matches_(X.x_+2, X.y_+1);
-                    if (HaveSameMatchType(X, Z) && HasNoWalls(Z, WO_WALLNORTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
+                    const MatchMovePattern::Wall& wall = pattern.walls_[j];
+                    open = (grid_(x + wall.x_, y + wall.y_).wallorientation_ & wall.orientation_) == 0;
                 }
-            }
-        }
-    }
-    // Schema
-    //         . . . .
-    //         X Y v Z
-    //         . . . .
-    if (X.x_ < width_-3)
-    {
-        Match& v = matches_(X.x_+2, X.y_);
+                if (!open)
+                    continue;
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_+1, X.y_);
-            Match& Z = matches_(X.x_+3, X.y_);
+                MatchMove move;
+                move.flags_ = pattern.flags_;
+                move.swapcell_ = (y + pattern.swap_.y_) * width_ + x + pattern.swap_.x_;
+                move.numcells_ = pattern.numcells_+1;
+                move.cells_[0] = y * width_ + x;
+                for (unsigned j=0; j < pattern.numcells_; j++)
+                    move.cells_[j+1] = (y + pattern.cells_[j].y_) * width_ + x + pattern.cells_[j].x_;
 
-            if (HaveSameMatchType(X, Y) && HaveSameMatchType(X, Z) && !HaveSameMatchType(X, v) &&
-                HasNoWalls(Z, WO_WALLLEFT) && HasNoWalls(Y, WO_WALLRIGHT | WO_WALLLEFT) && HasNoWalls(v, WO_WALLRIGHT | WO_WALLLEFT) && HasNoWalls(X, WO_WALLRIGHT))
-            {
-                Vector<Match*> matches;
-                matches.Push(&X);
-                matches.Push(&Y);
-                matches.Push(&Z);
-                hints.Push(matches);
+                moves_.Push(move);
             }
         }
     }
-    // Schema
-    //         . . . .
-    //         Z v Y X
-    //         . . . .
-    if (X.x_ > 2)
+
+    moveoffsets_[numcells] = moves_.Size();
+
+    URHO3D_LOGINFOF("MatchGrid() - UpdateMoveTable : gridid=%d %ux%u moves=%u", gridid_, width_, height_, moves_.Size());
+}
+
+void MatchGrid::CheckHints_Moves(Match& X, PODVector<MatchHint>& hints)
+{
+    // called in the WorkQueue : the table is rebuilt in the main thread (Create, Load, SetHittedWalls)
+    if (moveoffsets_.Size() != width_ * height_ + 1)
+        return;
+
+    const unsigned imatch = X.y_ * width_ + X.x_;
+    const bool xpower = IsPower(X);
+
+    for (unsigned i=moveoffsets_[imatch]; i < moveoffsets_[imatch+1]; i++)
     {
-        Match& v = matches_(X.x_-2, X.y_);
+        const MatchMove& move = moves_[i];
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_-1, X.y_);
-            Match& Z = matches_(X.x_-3, X.y_);
+        const Match& v = matches_[move.swapcell_];
+        if (!IsSelectableObject(v))
+            continue;
 
-            if (HaveSameMatchType(X, Y) && HaveSameMatchType(X, Z) && !HaveSameMatchType(X, v) &&
-                HasNoWalls(X, WO_WALLLEFT) && HasNoWalls(Y, WO_WALLRIGHT | WO_WALLLEFT) && HasNoWalls(v, WO_WALLRIGHT | WO_WALLLEFT) && HasNoWalls(Z, WO_WALLRIGHT))
-            {
-                Vector<Match*> matches;
-                matches.Push(&X);
-                matches.Push(&Y);
-                matches.Push(&Z);
-                hints.Push(matches);
-            }
-        }
+        if ((move.flags_ & MOVE_EXPLOSION) && (!xpower || !IsPower(matches_[move.cells_[1]])))
+            continue;
+
+        if ((move.flags_ & MOVE_NOTSAMESWAP) && HaveSameMatchType(X, v))
+            continue;
+
+        bool sametype = true;
+        for (unsigned j=1; j < move.numcells_ && sametype; j++)
+            sametype = HaveSameMatchType(X, matches_[move.cells_[j]]);
+        if (!sametype)
+            continue;
+
+        MatchHint matches;
+        for (unsigned j=0; j < move.numcells_; j++)
+            matches.Push(&matches_[move.cells_[j]]);
+        hints.Push(matches);
     }
-    // Schema
-    //         . W .
-    //         X v Y
-    //         . Z .
-    if (X.x_ < width_-2)
+}
+
+
+void MatchGrid::GetAllHorizontalMatches(const Match& entry, Vector<Match*>& matches, MatchSet& brokenrocks, Vector<WallInfo>* hittedwalls)
+{
+//    URHO3D_LOGINFOF("MatchGrid() - GetAllHorizontalMatches : entry=%s !", entry.ToString().CString());
+
+    if (hittedwalls)
     {
-        Match& v = matches_(X.x_+1, X.y_);
+        unsigned char y = entry.y_;
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_+2, X.y_);
+        int xmin, xmax;
+        GetHorizontalLine(grid_, entry.x_, y, xmin, xmax, hittedwalls);
 
-            if (HaveSameMatchType(X, Y) && HasNoWalls(Y, WO_WALLLEFT) &&
-                HasNoWalls(X, WO_WALLRIGHT) && HasNoWalls(v, WO_WALLRIGHT | WO_WALLLEFT))
-            {
-                if (X.y_ >= 1 && HasNoWalls(v, WO_WALLNORTH))
-                {
-                    Match& W = matches_(X.x_+1, X.y_-1);
-                    if (HaveSameMatchType(X, W) && HasNoWalls(W, WO_WALLSOUTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-                }
-                if (X.y_ < height_-1 && HasNoWalls(v, WO_WALLSOUTH))
-                {
-                    Match& Z = matches_(X.x_+1, X.y_+1);
-                    if (HaveSameMatchType(X, Z) && HasNoWalls(Z, WO_WALLNORTH))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-                }
-            }
+        // check to left then to right
+        for (int x=entry.x_; x >= xmin; x--)
+        {
+            Match& match = matches_(x, y);
+            if (match.ctype_ == ROCKS)
+                brokenrocks.Insert(&match);
+            else
+                Match::AddDistinctEntry(&match, matches);
+        }
+        for (int x=entry.x_; x <= xmax; x++)
+        {
+            Match& match = matches_(x, y);
+            if (match.ctype_ == ROCKS)
+                brokenrocks.Insert(&match);
+            else
+                Match::AddDistinctEntry(&match, matches);
         }
     }
+    else
+    {
+        for (int x=0; x < width_; x++)
+            matches.Push(&matches_(x, entry.y_));
+    }
 }
 
-void MatchGrid::CheckHints_Vertical(Match& X, Vector<Vector<Match*> >& hints)
+void MatchGrid::GetAllVerticalMatches(const Match& entry, Vector<Match*>& matches, MatchSet& brokenrocks, Vector<WallInfo>* hittedwalls)
 {
-    // Schema
-    //         W v Z
-    //         . X .
-    //         . Y .
-    //         . . .
-    if (X.y_ > 0 && X.y_ < height_-1)
+//    URHO3D_LOGINFOF("MatchGrid() - GetAllVerticalMatches : entry=%s !", entry.ToString().CString());
+
+    if (hittedwalls)
     {
-        Match& v = matches_(X.x_, X.y_-1);
+        unsigned char x = entry.x_;
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_, X.y_+1);
+        int ymin, ymax;
+        GetVerticalLine(grid_, x, entry.y_, ymin, ymax, hittedwalls);
 
-            if (HaveSameMatchType(X, Y) && HasNoWalls(X, WO_WALLNORTH | WO_WALLSOUTH) && HasNoWalls(Y, WO_WALLNORTH) && HasNoWalls(v, WO_WALLSOUTH))
-            {
-                if (X.x_ >= 1 && HasNoWalls(v, WO_WALLLEFT))
-                {
-                    Match& W = matches_(X.x_-1, X.y_-1);
-                    if (HaveSameMatchType(X, W) && HasNoWalls(W, WO_WALLRIGHT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-                }
-                if (X.x_ < width_-1 && HasNoWalls(v, WO_WALLRIGHT))
-                {
-                    Match& Z = matches_(X.x_+1, X.y_-1);
-                    if (HaveSameMatchType(X, Z) && HasNoWalls(Z, WO_WALLLEFT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-                }
-            }
+        // check to top then to bottom
+        for (int y=entry.y_; y >= ymin; y--)
+        {
+            Match& match = matches_(x, y);
+            if (match.ctype_ == ROCKS)
+                brokenrocks.Insert(&match);
+            else
+                Match::AddDistinctEntry(&match, matches);
+        }
+        for (int y=entry.y_; y <= ymax; y++)
+        {
+            Match& match = matches_(x, y);
+            if (match.ctype_ == ROCKS)
+                brokenrocks.Insert(&match);
+            else
+                Match::AddDistinctEntry(&match, matches);
         }
     }
-    // Schema
-    //         . . .
-    //         . X .
-    //         . Y .
-    //         W v Z
-    if (X.y_ < height_-2)
+    else
     {
-        Match& v = matches_(X.x_, X.y_+2);
+        for (int y=0; y < height_; y++)
+            matches.Push(&matches_(entry.x_, y));
+    }
+}
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_, X.y_+1);
+void MatchGrid::GetAllWallsAround(const Match& entry, int range, Vector<WallInfo>& hittedwalls)
+{
+	GetWallsAround(grid_, entry.x_, entry.y_, range, hittedwalls);
 
-            if (HaveSameMatchType(X, Y) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLSOUTH) && HasNoWalls(X, WO_WALLSOUTH) && HasNoWalls(v, WO_WALLNORTH))
-            {
-                if (X.x_ >= 1 && HasNoWalls(v, WO_WALLLEFT))
-                {
-                    Match& W = matches_(X.x_-1, X.y_+2);
-                    if (HaveSameMatchType(X, W) && HasNoWalls(W, WO_WALLRIGHT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-                }
-                if (X.x_ < width_-1 && HasNoWalls(v, WO_WALLRIGHT))
-                {
-                    Match& Z = matches_(X.x_+1, X.y_+2);
-                    if (HaveSameMatchType(X, Z) && HasNoWalls(Z, WO_WALLLEFT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-                }
-            }
-        }
+	URHO3D_LOGINFOF("MatchGrid() - GetAllWallsAround : entry=%s hittedwalls=%u!", entry.ToString().CString(), hittedwalls.Size());
+}
+
+
+/// Rules Core
+
+int MatchGrid::DrawObject(GameRand& random, unsigned numpowers, unsigned numrocks, unsigned numenemies, unsigned& typeindex)
+{
+    const bool addPower = numpowers ? random.Get(100) < Match::BONUSCHANCE : false;
+    const bool addRock = numrocks ? random.Get(100) < Match::ROCKCHANCE : false;
+
+    if (addPower)
+    {
+        typeindex = random.Get(numpowers);
+        return MOC_POWER;
     }
-    // Schema
-    //         . X .
-    //         . Y .
-    //         . v .
-    //         . Z .
-    if (X.y_ < height_-3)
+
+    if (addRock)
     {
-        Match& v = matches_(X.x_, X.y_+2);
+        typeindex = random.Get(numrocks);
+        return MOC_ROCK;
+    }
 
-        if (IsSelectableObject(v))
-        {
-            Match& Y = matches_(X.x_, X.y_+1);
-            Match& Z = matches_(X.x_, X.y_+3);
+    if (!numenemies)
+        return MOC_NONE;
 
-            if (HaveSameMatchType(X, Y) && HaveSameMatchType(X, Z) && !HaveSameMatchType(X, v) &&
-                HasNoWalls(X, WO_WALLSOUTH) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLSOUTH) && HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH) && HasNoWalls(Z, WO_WALLNORTH))
-            {
-                Vector<Match*> matches;
-                matches.Push(&X);
-                matches.Push(&Y);
-                matches.Push(&Z);
-                hints.Push(matches);
-            }
-        }
+    typeindex = random.Get(numenemies);
+    return MOC_ENEMY;
+}
+
+void MatchGrid::GetRefillCells(const Matrix2D<GridTile>& grid, const Matrix2D<Match>& matches, int x, PODVector<IntVector2>& cells)
+{
+    cells.Clear();
+
+    for (int y=grid.Height()-1; y >= 0; y--)
+    {
+        if (grid(x, y).ground_ && !matches(x, y).ctype_)
+            cells.Push(IntVector2(x, y));
     }
-    // Schema
-    //         . Z .
-    //         . v .
-    //         . Y .
-    //         . X .
-    if (X.y_ > 2)
+}
+
+void MatchGrid::Collapse(const Matrix2D<GridTile>& grid, Matrix2D<Match>& matches, int x, PODVector<IntVector2>& transfers)
+{
+    transfers.Clear();
+
+    for (int y=grid.Height()-1; y >= 0; y--)
     {
-        Match& v = matches_(X.x_, X.y_-2);
+        if (grid(x, y).wallorientation_ & WO_WALLNORTH)
+            break;
 
-        if (IsSelectableObject(v))
+        if (!grid(x, y).ground_ || matches(x, y).ctype_)
+            continue;
+
+        for (int y2=y-1; y2 >= 0; y2--)
         {
-            Match& Y = matches_(X.x_, X.y_-1);
-            Match& Z = matches_(X.x_, X.y_-3);
+            Match& m2 = matches(x, y2);
+            if (!m2.ctype_)
+                continue;
 
-            if (HaveSameMatchType(X, Y) && HaveSameMatchType(X, Z) && !HaveSameMatchType(X, v) &&
-                HasNoWalls(Z, WO_WALLSOUTH) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLSOUTH) && HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH) && HasNoWalls(X, WO_WALLNORTH))
-            {
-                Vector<Match*> matches;
-                matches.Push(&X);
-                matches.Push(&Y);
-                matches.Push(&Z);
-                hints.Push(matches);
-            }
+            if (IsDirectional(grid(x, y2).ground_) || (grid(x, y2).wallorientation_ & WO_WALLNORTH))
+                break;
+
+            matches(x, y).property_ = m2.property_;
+            m2.property_ = 0;
+
+            transfers.Push(IntVector2(x, y2));
+            transfers.Push(IntVector2(x, y));
+            break;
         }
     }
-    // Schema
-    //         . X .
-    //         W v Z
-    //         . Y .
-    if (X.y_ < height_-2)
+}
+
+void MatchGrid::MoveOnRamps(const Matrix2D<GridTile>& grid, Matrix2D<Match>& matches, const Vector<Vector<IntVector2> >& ramptiles, Matrix2D<int>& gridupdates, PODVector<IntVector2>& transfers)
+{
+    const int width = grid.Width();
+    const int height = grid.Height();
+
+    transfers.Clear();
+
+    // gridupdates prevents double moves when a tile changes of ramp
+    gridupdates.Resize(width, height);
+    gridupdates.SetBufferValue(-1);
+
+    for (int i=ramptiles.Size()-1; i >= 0; --i)
     {
-        Match& v = matches_(X.x_, X.y_+1);
+        const Vector<IntVector2>& ramptile = ramptiles[i];
+        // ramptile[0] = direction
+        const IntVector2& direction = ramptile.At(0);
 
-        if (IsSelectableObject(v))
+        for (int j=ramptile.Size()-1; j > 0; --j)
         {
-            Match& Y = matches_(X.x_, X.y_+2);
+            const IntVector2& position = ramptile[j];
+            const IntVector2 to = position + direction;
+
+            // check in grid
+            if (to.x_ < 0 || to.x_ >= width || to.y_ < 0 || to.y_ >= height)
+                continue;
+
+            int& updatedfrom = gridupdates(position.x_, position.y_);
+            int& updatedto = gridupdates(to.x_, to.y_);
 
-            if (HaveSameMatchType(X, Y) && HasNoWalls(Y, WO_WALLNORTH) &&
-                HasNoWalls(X, WO_WALLSOUTH) && HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH))
+            if (updatedfrom != -1 && updatedfrom != i)
+                continue;
+
+            Match& mfrom = matches(position.x_, position.y_);
+            Match& mto = matches(to.x_, to.y_);
+
+            if (mfrom.ctype_ && !mto.ctype_ && grid(to.x_, to.y_).ground_ > GT_VOID)
             {
-                if (X.x_ >= 1 && HasNoWalls(v, WO_WALLLEFT))
-                {
-                    Match& W = matches_(X.x_-1, X.y_+1);
-                    if (HaveSameMatchType(X, W) && HasNoWalls(W, WO_WALLRIGHT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&W);
-                        hints.Push(matches);
-                    }
-                }
-                if (X.x_ < width_-1 && HasNoWalls(v, WO_WALLRIGHT))
-                {
-                    Match& Z = matches_(X.x_+1, X.y_+1);
-                    if (HaveSameMatchType(X, Z) && HasNoWalls(Z, WO_WALLLEFT))
-                    {
-                        Vector<Match*> matches;
-                        matches.Push(&X);
-                        matches.Push(&Y);
-                        matches.Push(&Z);
-                        hints.Push(matches);
-                    }
-                }
+                mto.property_ = mfrom.property_;
+                mfrom.property_ = 0;
+
+                transfers.Push(position);
+                transfers.Push(to);
+
+                updatedfrom = i;
+                updatedto = i;
             }
         }
     }
 }
 
-void MatchGrid::CheckHints_Square(Match& X, Vector<Vector<Match*> >& hints)
+void MatchGrid::GetHorizontalLine(const Matrix2D<GridTile>& grid, int x, int y, int& xmin, int& xmax, Vector<WallInfo>* hittedwalls)
 {
-    // X v W
-    // Y Z .
-    if (X.y_ < height_-1 && X.x_ < width_-2)
-    {
-        Match& v = matches_(X.x_+2, X.y_);
-        Match& W = matches_(X.x_+1, X.y_);
-        Match& Y = matches_(X.x_, X.y_+1);
-        Match& Z = matches_(X.x_+1, X.y_+1);
+    const int width = grid.Width();
 
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLSOUTH | WO_WALLRIGHT) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLRIGHT) &&
-            HasNoWalls(Z, WO_WALLNORTH | WO_WALLLEFT) && HasNoWalls(W, WO_WALLLEFT) &&
-            HasNoWalls(v, WO_WALLSOUTH | WO_WALLLEFT | WO_WALLRIGHT))
+    // to left : a right wall stops before the cell, a left wall after the cell
+    for (xmin=x; xmin >= 0; xmin--)
+    {
+        const unsigned char walls = grid(xmin, y).wallorientation_;
+        if (walls & WO_WALLRIGHT)
         {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(xmin, y, WO_WALLRIGHT));
+            xmin++;
+            break;
+        }
+        if (walls & WO_WALLLEFT)
+        {
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(xmin, y, WO_WALLLEFT));
+            break;
         }
     }
-    // Y Z .
-    // X v W
-    if (X.y_ > 0 && X.x_ < width_-2)
+    xmin = Max(xmin, 0);
+
+    // to right : a left wall stops before the cell, a right wall after the cell
+    for (xmax=x; xmax < width; xmax++)
     {
-        Match& v = matches_(X.x_+1, X.y_);
-        Match& W = matches_(X.x_+2, X.y_);
-        Match& Y = matches_(X.x_, X.y_-1);
-        Match& Z = matches_(X.x_+1, X.y_-1);
-
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLNORTH | WO_WALLRIGHT) && HasNoWalls(Y, WO_WALLSOUTH | WO_WALLRIGHT) &&
-            HasNoWalls(Z, WO_WALLSOUTH | WO_WALLLEFT) && HasNoWalls(W, WO_WALLLEFT) &&
-            HasNoWalls(v, WO_WALLNORTH | WO_WALLLEFT | WO_WALLRIGHT))
+        const unsigned char walls = grid(xmax, y).wallorientation_;
+        if (walls & WO_WALLLEFT)
         {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
-        }
-    }
-    // W v X
-    // . Z Y
-    if (X.y_ < height_-1 && X.x_ > 1)
-    {
-        Match& v = matches_(X.x_-1, X.y_);
-        Match& W = matches_(X.x_-2, X.y_);
-        Match& Y = matches_(X.x_, X.y_+1);
-        Match& Z = matches_(X.x_-1, X.y_+1);
-
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLSOUTH | WO_WALLLEFT) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLLEFT) &&
-            HasNoWalls(Z, WO_WALLNORTH | WO_WALLRIGHT) && HasNoWalls(W, WO_WALLRIGHT) &&
-            HasNoWalls(v, WO_WALLSOUTH | WO_WALLLEFT | WO_WALLRIGHT))
-        {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
-        }
-    }
-    // . Z Y
-    // W v X
-    if (X.y_ > 0 && X.x_ > 1)
-    {
-        Match& v = matches_(X.x_-1, X.y_);
-        Match& W = matches_(X.x_-2, X.y_);
-        Match& Y = matches_(X.x_, X.y_-1);
-        Match& Z = matches_(X.x_-1, X.y_-1);
-
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLNORTH | WO_WALLLEFT) && HasNoWalls(Y, WO_WALLSOUTH | WO_WALLLEFT) &&
-            HasNoWalls(Z, WO_WALLSOUTH | WO_WALLRIGHT) && HasNoWalls(W, WO_WALLRIGHT) &&
-            HasNoWalls(v, WO_WALLNORTH | WO_WALLLEFT | WO_WALLRIGHT))
-        {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(xmax, y, WO_WALLLEFT));
+            xmax--;
+            break;
+        }
+        if (walls & WO_WALLRIGHT)
+        {
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(xmax, y, WO_WALLRIGHT));
+            break;
         }
     }
-    // . W
-    // Y v
-    // X Z
-    if (X.y_ > 1 && X.x_ < width_-1)
-    {
-        Match& Y = matches_(X.x_, X.y_-1);
-        Match& v = matches_(X.x_+1, X.y_-1);
-        Match& W = matches_(X.x_+1, X.y_-2);
-        Match& Z = matches_(X.x_+1, X.y_);
-
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLNORTH | WO_WALLRIGHT) && HasNoWalls(Y, WO_WALLSOUTH | WO_WALLRIGHT) &&
-            HasNoWalls(Z, WO_WALLNORTH | WO_WALLLEFT) && HasNoWalls(W, WO_WALLSOUTH) &&
-            HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH | WO_WALLLEFT))
-        {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
-        }
-    }
-    // W .
-    // v Y
-    // Z X
-    if (X.y_ > 1 && X.x_ > 0)
-    {
-        Match& Y = matches_(X.x_, X.y_-1);
-        Match& v = matches_(X.x_-1, X.y_-1);
-        Match& W = matches_(X.x_-1, X.y_-2);
-        Match& Z = matches_(X.x_-1, X.y_);
+    xmax = Min(xmax, width-1);
+}
 
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLNORTH | WO_WALLLEFT) && HasNoWalls(Y, WO_WALLSOUTH | WO_WALLLEFT) &&
-            HasNoWalls(Z, WO_WALLNORTH | WO_WALLRIGHT) && HasNoWalls(W, WO_WALLSOUTH) &&
-            HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH | WO_WALLRIGHT))
-        {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
-        }
-    }
-    // Z X
-    // v Y
-    // W .
-    if (X.y_ < height_-2 && X.x_ > 0)
-    {
-        Match& Y = matches_(X.x_, X.y_+1);
-        Match& v = matches_(X.x_-1, X.y_+1);
-        Match& W = matches_(X.x_-1, X.y_+2);
-        Match& Z = matches_(X.x_-1, X.y_);
+void MatchGrid::GetVerticalLine(const Matrix2D<GridTile>& grid, int x, int y, int& ymin, int& ymax, Vector<WallInfo>* hittedwalls)
+{
+    const int height = grid.Height();
 
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLSOUTH | WO_WALLLEFT) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLLEFT) &&
-            HasNoWalls(Z, WO_WALLSOUTH | WO_WALLRIGHT) && HasNoWalls(W, WO_WALLNORTH) &&
-            HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH | WO_WALLRIGHT))
-        {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
+    // to top : a south wall stops before the cell, a north wall after the cell
+    for (ymin=y; ymin >= 0; ymin--)
+    {
+        const unsigned char walls = grid(x, ymin).wallorientation_;
+        if (walls & WO_WALLSOUTH)
+        {
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(x, ymin, WO_WALLSOUTH));
+            ymin++;
+            break;
+        }
+        if (walls & WO_WALLNORTH)
+        {
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(x, ymin, WO_WALLNORTH));
+            break;
         }
     }
-    // X Z
-    // Y v
-    // . W
-    if (X.y_ < height_-2 && X.x_ < width_-1)
-    {
-        Match& Y = matches_(X.x_, X.y_+1);
-        Match& v = matches_(X.x_+1, X.y_+1);
-        Match& W = matches_(X.x_+1, X.y_+2);
-        Match& Z = matches_(X.x_+1, X.y_);
+    ymin = Max(ymin, 0);
 
-        if (HaveSameMatchType(X, Y, Z, W) && IsSelectableObject(v) &&
-            HasNoWalls(X, WO_WALLSOUTH | WO_WALLRIGHT) && HasNoWalls(Y, WO_WALLNORTH | WO_WALLRIGHT) &&
-            HasNoWalls(Z, WO_WALLSOUTH | WO_WALLLEFT) && HasNoWalls(W, WO_WALLNORTH) &&
-            HasNoWalls(v, WO_WALLNORTH | WO_WALLSOUTH | WO_WALLLEFT))
+    // to bottom : a north wall stops before the cell, a south wall after the cell
+    for (ymax=y; ymax < height; ymax++)
+    {
+        const unsigned char walls = grid(x, ymax).wallorientation_;
+        if (walls & WO_WALLNORTH)
         {
-            Vector<Match*> matches;
-            matches.Push(&X);
-            matches.Push(&Y);
-            matches.Push(&W);
-            matches.Push(&Z);
-            hints.Push(matches);
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(x, ymax, WO_WALLNORTH));
+            ymax--;
+            break;
+        }
+        if (walls & WO_WALLSOUTH)
+        {
+            if (hittedwalls)
+                hittedwalls->Push(WallInfo(x, ymax, WO_WALLSOUTH));
+            break;
         }
     }
+    ymax = Min(ymax, height-1);
 }
 
-
-void MatchGrid::GetAllHorizontalMatches(const Match& entry, Vector<Match*>& matches, Vector<Match*>& brokenrocks, Vector<WallInfo>* hittedwalls)
+void MatchGrid::GetWallsAround(const Matrix2D<GridTile>& grid, int x, int y, int range, Vector<WallInfo>& hittedwalls)
 {
-//    URHO3D_LOGINFOF("MatchGrid() - GetAllHorizontalMatches : entry=%s !", entry.ToString().CString());
+	const int width = grid.Width();
+	const int height = grid.Height();
 
-    if (hittedwalls)
-    {
-        Vector<WallInfo>& hittedw = *hittedwalls;
-
-        unsigned char y = entry.y_;
+	int xmin = 0;
+	int xmax = width - 1;
+	int ymin = 0;
+	int ymax = height - 1;
+
+	if (x > range)
+		xmin = x - range;
+	if (y > range)
+		ymin = y - range;
+    if (x + range < width-1)
+        xmax = x + range;
+    if (y + range < height-1)
+        ymax = y + range;
+
+	for (int j=ymin; j <= ymax; j++)
+		for (int i=xmin; i <= xmax; i++)
+		{
+			if (grid(i, j).wallorientation_ != 0)
+				hittedwalls.Push(WallInfo(i, j, grid(i, j).wallorientation_));
+		}
+}
 
-        // check to left
-        for (int x=entry.x_; x >= 0; x--)
-        {
-            Match& match = matches_(x, y);
+bool MatchGrid::BreakWall(Matrix2D<GridTile>& grid, const WallInfo& wallinfo)
+{
+    GridTile& tile = grid(wallinfo.x_, wallinfo.y_);
+    if ((tile.wallorientation_ & wallinfo.wallorientation_) == 0)
+        return false;
 
-            if (grid_(x, y).wallorientation_ & WO_WALLRIGHT)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLRIGHT));
-                break;
-            }
+    tile.wallorientation_ = tile.wallorientation_ & ~wallinfo.wallorientation_;
+    return true;
+}
 
-            Match::AddDistinctEntry(&match, match.ctype_ == ROCKS ? brokenrocks : matches);
+void MatchGrid::UpdateBitBoard(MatchBitBoard& bitboard, const Matrix2D<GridTile>& grid, const Matrix2D<Match>& matches)
+{
+    const int width = grid.Width();
+    const int height = grid.Height();
 
-            if (grid_(x, y).wallorientation_ & WO_WALLLEFT)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLLEFT));
-                break;
-            }
-        }
+    bitboard.Resize(width, height);
 
-        // check to right
-        for (int x=entry.x_; x < width_; x++)
+    for (int y=0; y < height; y++)
+        for (int x=0; x < width; x++)
         {
-            Match& match = matches_(x, y);
-
-            if (grid_(x, y).wallorientation_ & WO_WALLLEFT)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLLEFT));
-                break;
-            }
+            const GridTile& tile = grid(x, y);
 
-            Match::AddDistinctEntry(&match, match.ctype_ == ROCKS ? brokenrocks : matches);
+            bitboard.SetGround(x, y, tile.ground_ != 0);
+            bitboard.SetLinks(x, y,
+                              x+1 >= width || (tile.wallorientation_ & WO_WALLRIGHT) != 0 || (grid(x+1, y).wallorientation_ & WO_WALLLEFT) != 0,
+                              y+1 >= height || (tile.wallorientation_ & WO_WALLSOUTH) != 0 || (grid(x, y+1).wallorientation_ & WO_WALLNORTH) != 0);
+            bitboard.SetCellWalls(x, y, (tile.wallorientation_ & WO_WALLLEFT) != 0, (tile.wallorientation_ & WO_WALLRIGHT) != 0,
+                                  (tile.wallorientation_ & WO_WALLNORTH) != 0, (tile.wallorientation_ & WO_WALLSOUTH) != 0);
 
-            if (grid_(x, y).wallorientation_ & WO_WALLRIGHT)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLRIGHT));
-                break;
-            }
+            if (matches.Size())
+                bitboard.SetCell(x, y, matches(x, y).ctype_);
         }
-    }
-    else
-    {
-        for (int x=0; x < width_; x++)
-            matches.Push(&matches_(x, entry.y_));
-    }
 }
 
-void MatchGrid::GetAllVerticalMatches(const Match& entry, Vector<Match*>& matches, Vector<Match*>& brokenrocks, Vector<WallInfo>* hittedwalls)
+unsigned MatchGrid::GetAllMatches(Vector<Match*>& matches, MatchBitBoardResult* result)
 {
-//    URHO3D_LOGINFOF("MatchGrid() - GetAllVerticalMatches : entry=%s !", entry.ToString().CString());
+    UpdateBitBoard();
 
-    if (hittedwalls)
-    {
-        Vector<WallInfo>& hittedw = *hittedwalls;
+    MatchBitBoardResult bbresult;
+    if (!result)
+        result = &bbresult;
 
-        unsigned char x = entry.x_;
+    if (!bitboard_.FindMatches(Match::MINIMALMATCHES, BLUE, ROCKS, *result))
+        return 0;
 
-        // check to top
-        for (int y=entry.y_; y >= 0; y--)
+    const BitBoard& all = result->all_;
+    for (int y=0; y < height_; y++)
+        for (int x=0; x < width_; x++)
         {
-            Match& match = matches_(x, y);
-
-            if (grid_(x, y).wallorientation_ & WO_WALLSOUTH)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLSOUTH));
-                break;
-            }
-
-            Match::AddDistinctEntry(&match, match.ctype_ == ROCKS ? brokenrocks : matches);
-
-            if (grid_(x, y).wallorientation_ & WO_WALLNORTH)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLNORTH));
-                break;
-            }
+            if (all.Test(x, y))
+                matches.Push(&matches_(x, y));
         }
 
-        // check to bottom
-        for (int y=entry.y_; y < height_; y++)
-        {
-            Match& match = matches_(x, y);
-
-            if (grid_(x, y).wallorientation_ & WO_WALLNORTH)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLNORTH));
-                break;
-            }
+    return matches.Size();
+}
 
-            Match::AddDistinctEntry(&match, match.ctype_ == ROCKS ? brokenrocks : matches);
+bool MatchGrid::HasAnyMatch()
+{
+    UpdateBitBoard();
 
-            if (grid_(x, y).wallorientation_ & WO_WALLSOUTH)
-            {
-                hittedw.Push(WallInfo(x, y, WO_WALLSOUTH));
-                break;
-            }
-        }
-    }
-    else
-    {
-        for (int y=0; y < height_; y++)
-            matches.Push(&matches_(entry.x_, y));
-    }
+    return bitboard_.HasMatches(Match::MINIMALMATCHES, BLUE, ROCKS);
 }
 
-void MatchGrid::GetAllWallsAround(const Match& entry, int range, Vector<WallInfo>& hittedwalls)
+// Pop the touched cells, dilated to their Manhattan neighborhood of "radius"
+BitBoard MatchGrid::PopTouchedCells(int radius)
 {
-	int xmin = 0;
-	int xmax = width_ - 1;
-	int ymin = 0;
-	int ymax = height_ - 1;
+    BitBoard cells = touchedcells_;
+    for (int i=0; i < radius; i++)
+        cells |= cells.ShiftLeft() | cells.ShiftRight() | cells.ShiftUp() | cells.ShiftDown();
 
-	if (entry.x_ > range)
-		xmin = entry.x_ - range;
-	if (entry.y_ > range)
-		ymin = entry.y_ - range;
-    if (entry.x_ + range < width_-1)
-        xmax = entry.x_ + range;
-    if (entry.y_ + range < height_-1)
-        ymax = entry.y_ + range;
+    BitBoard inside;
+    inside.Fill(width_, height_);
+    cells &= inside;
 
-	for (int y=ymin; y <= ymax; y++)
-		for (int x = xmin; x <= xmax; x++)
-		{
-			if (grid_(x, y).wallorientation_ != 0)
-				hittedwalls.Push(WallInfo(x, y, grid_(x, y).wallorientation_));
-		}
+    touchedcells_.Clear();
 
-	URHO3D_LOGINFOF("MatchGrid() - GetAllWallsAround : entry=%s hittedwalls=%u!", entry.ToString().CString(), hittedwalls.Size());
+    return cells;
 }
@@ -12,6 +12,11 @@ using namespace Urho3D;
 
 #include "MemoryObjects.h"
 #include "GameRand.h"
+#include "GameEvents.h"
+#include "EventChannel.h"
+
+#include "MatchBitBoard.h"
+#include "MatchPowerResolver.h"
 
 class MatchesManager;
 
@@ -178,6 +183,15 @@ struct WallInfo
     unsigned char wallorientation_;
 };
 
+/// the object categories drawn by MatchGrid::DrawObject
+enum MatchObjectCategory
+{
+    MOC_NONE = 0,
+    MOC_POWER,
+    MOC_ROCK,
+    MOC_ENEMY
+};
+
 enum ColorType
 {
     NOTYPE = 0,
@@ -308,6 +322,129 @@ public :
     static int ROCKCHANCE;
 };
 
+#define MATCHSET_CAPACITY (BITBOARD_DIMENSION*BITBOARD_DIMENSION)
+
+/// Set of Matches keyed by grid cell
+/// O(1) distinct insertion with a cell bitboard, iteration in the insertion order, no heap allocation.
+class MatchSet
+{
+public:
+    typedef Match* const* ConstIterator;
+
+    MatchSet() : size_(0) { }
+
+    void Clear() { cells_.Clear(); size_ = 0; }
+
+    bool Insert(Match* match);
+    void Insert(const Vector<Match*>& matches);
+    void Insert(const MatchSet& matches);
+
+    bool Contains(const Match* match) const { return cells_.Test(match->x_, match->y_); }
+    bool Contains(int x, int y) const { return cells_.Test(x, y); }
+    const BitBoard& GetCells() const { return cells_; }
+
+    unsigned Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+    Match* operator [](unsigned index) const { return entries_[index]; }
+    Match* Front() const { return entries_[0]; }
+    ConstIterator Begin() const { return entries_; }
+    ConstIterator End() const { return entries_ + size_; }
+
+private:
+    BitBoard cells_;
+    Match* entries_[MATCHSET_CAPACITY];
+    unsigned size_;
+};
+
+#define MATCHHINT_CAPACITY 4
+
+/// Hint : the matches to show for a possible move (fixed capacity, no heap allocation)
+struct MatchHint
+{
+    MatchHint() : size_(0) { }
+
+    void Push(Match* match) { if (size_ < MATCHHINT_CAPACITY) matches_[size_++] = match; }
+
+    unsigned Size() const { return size_; }
+    Match* operator [](unsigned index) const { return matches_[index]; }
+    Match* const* Begin() const { return matches_; }
+    Match* const* End() const { return matches_ + size_; }
+
+    Match* matches_[MATCHHINT_CAPACITY];
+    unsigned size_;
+};
+
+/// Turn Buffers : the temporary containers of GetMatches, reserved once from the grid dimension
+struct MatchTurnBuffers
+{
+    void Reserve(int dimension);
+    unsigned GetCapacity() const;
+
+    Vector<Match*> matches_;
+    Vector<Match*> matchesh_, matchesv_, matchesq_;
+    Vector<Match*> bonush_, bonusv_, bonus2_;
+    Vector<Match*> bonuses_;
+    PODVector<MatchHint> hints_;
+    /// the cells of the rules core : the refill cells (GetRefillCells) or the moved matches by pairs (from, to)
+    PODVector<IntVector2> transfers_;
+};
+
+/// Hints Cache : the hints index of the boards already evaluated (shakes, cancelled moves), keyed by the zobrist hash
+#define MATCHHINTSCACHE_SIZE 8
+
+struct MatchHintsCache
+{
+    MatchHintsCache() : next_(0), hits_(0), misses_(0) { Clear(); }
+
+    void Clear();
+    bool Restore(unsigned long long hash, Vector<PODVector<MatchHint> >& cellhints);
+    void Store(unsigned long long hash, const Vector<PODVector<MatchHint> >& cellhints);
+
+    struct Entry
+    {
+        unsigned long long hash_;
+        /// hints of the cell i in [offsets_[i], offsets_[i+1][
+        PODVector<MatchHint> hints_;
+        PODVector<unsigned> offsets_;
+    };
+
+    Entry entries_[MATCHHINTSCACHE_SIZE];
+    unsigned next_;
+    unsigned hits_, misses_;
+};
+
+/// Move Table : the hint patterns of each cell with their bounds and walls already resolved.
+/// Built once by layout (rebuilt when walls are broken), the hint search only checks the types of the matches.
+enum MatchMoveFlag
+{
+    MOVE_EXPLOSION   = 1 << 0, // the cells of the hint are powers
+    MOVE_NOTSAMESWAP = 1 << 1, // the swapped cell must not have the type of the hint
+};
+
+struct MatchMove
+{
+    /// cell indexes of the hint (X first) and of the swapped cell
+    unsigned short cells_[MATCHHINT_CAPACITY];
+    unsigned short swapcell_;
+    unsigned char numcells_;
+    unsigned char flags_;
+};
+
+/// GAME_POWERADDED : typed event for EventChannel<PowerAddedEvent>
+struct PowerAddedEvent
+{
+    static StringHash GetEventType() { return GAME_POWERADDED; }
+
+    void FillEventData(VariantMap& eventData) const
+    {
+        eventData[Game_PowerAdded::MATCHPROPERTY] = property_.property_;
+        eventData[Game_PowerAdded::NODE] = node_;
+    }
+
+    MatchProperty property_;
+    Node* node_;
+};
+
 struct TileEntrance
 {
     IntVector2 position_;
@@ -323,6 +460,7 @@ public :
     /// taille des bricks
     static void SetGridUnit(float size) { gridunit_ = size; }
     static void SetAuthorizedTypes(const StringHash& category, const Vector<StringHash>& types);
+    static void ClearAuthorizedTypes();
 
     void SetId(int id) { gridid_ = id; }
     void ClearGrid();
@@ -332,7 +470,8 @@ public :
 
     /// forme de la grille : en "L" .. en carré ..
     /// ajout des blockers
-    void SetLayout(int dimension, GridLayout layout, HorizontalAlignment halign, VerticalAlignment valign, bool randomwalls);
+    /// the random walls use the OBJRAND randomizer if random is null
+    void SetLayout(int dimension, GridLayout layout, HorizontalAlignment halign, VerticalAlignment valign, bool randomwalls, GameRand* random=0);
     void SetGridRect(const Rect& rect) { gridRect_ = rect; }
     void SetGridColor(const Color& color) { gridColor_ = color; }
     void Create(Vector<Match*>& newmatches);
@@ -386,6 +525,7 @@ public :
     bool ContainsItems() const;
     Vector<const Match*> GetAllItems() const;
     Vector<Match*> GetAllPowers();
+    void GetAllPowers(MatchSet& powers);
 
     bool IsInside(const Vector2& position) const;
     bool AreMatched(const Match& m1, const Match& m2) const;
@@ -396,34 +536,91 @@ public :
     bool IsItem(const Match& match) const;
 
     bool IsSelectableObject(const Match& match) const;
-    bool IsDirectional(unsigned char feature) const;
+    static bool IsDirectional(unsigned char feature);
     bool IsDirectionalTile(const Match& match) const;
     bool HasTileEntrances() const;
     bool HasTileExits() const;
 
-    Vector<Match*> GetPermuttedMatches();
+    void GetPermuttedMatches(MatchSet& matches);
 
     void GetActivableBonuses(Vector<Match*>& matches, Vector<Match*>& activablebonuses);
-    bool GetMatches(Match* entry, Vector<Match*>& destroymatches, Vector<Match*>& successmatches, Vector<Match*>& activablebonuses, Vector<Match*>& brokenrocks, Vector<WallInfo>& hittedwalls);
-    void GetHints(unsigned imatch, Vector<Vector<Match*> >& hintstable);
+    bool GetMatches(Match* entry, MatchSet& destroymatches, MatchSet& successmatches, MatchSet& activablebonuses, MatchSet& brokenrocks, Vector<WallInfo>& hittedwalls);
+    /// GetHints has no scene access (WorkQueue safe), CheckPowerTutorial is called in the main thread for the cells with hints
+    void GetHints(unsigned imatch, PODVector<MatchHint>& hintstable);
+    void CheckPowerTutorial(unsigned imatch);
     Match* GetMatch(Node* node);
     Node* GetObject(const Match& m) const;
     Node* GetObject(int x, int y) const;
     Node* GetGridNode() const { return gridNode_; }
 
-    void GetAllHorizontalMatches(const Match& entry, Vector<Match*>& matches, Vector<Match*>& brokenrocks, Vector<WallInfo>* hittedwalls=0);
-    void GetAllVerticalMatches(const Match& entry, Vector<Match*>& matches, Vector<Match*>& brokenrocks, Vector<WallInfo>* hittedwalls=0);
+    void GetAllHorizontalMatches(const Match& entry, Vector<Match*>& matches, MatchSet& brokenrocks, Vector<WallInfo>* hittedwalls=0);
+    void GetAllVerticalMatches(const Match& entry, Vector<Match*>& matches, MatchSet& brokenrocks, Vector<WallInfo>* hittedwalls=0);
 	void GetAllWallsAround(const Match& entry, int range, Vector<WallInfo>& hittedwalls);
 
+    /// Bitboard Match Engine : full board evaluation (simulations, autoplay)
+    static void UpdateBitBoard(MatchBitBoard& bitboard, const Matrix2D<GridTile>& grid, const Matrix2D<Match>& matches);
+    void UpdateBitBoard() { UpdateBitBoard(bitboard_, grid_, matches_); }
+    const MatchBitBoard& GetBitBoard() const { return bitboard_; }
+    /// the power masks of GetMatches (wall bounded segments, neighborhoods) : update before a search
+    void UpdatePowerResolver() { UpdateBitBoard(); powerresolver_.Setup(bitboard_); }
+    unsigned GetAllMatches(Vector<Match*>& matches, MatchBitBoardResult* result=0);
+    bool HasAnyMatch();
+
+    /// Rules Core : the grid rules without Nodes (WorkQueue safe), shared by the MatchGrid methods and the headless BoardSimulator
+    /// the draws of AddObject : the object category and the type index in the category (MOC_NONE if no enemy types)
+    static int DrawObject(GameRand& random, unsigned numpowers, unsigned numrocks, unsigned numenemies, unsigned& typeindex);
+    /// the empty grounds of the column x to refill (AddColumn), from the bottom
+    static void GetRefillCells(const Matrix2D<GridTile>& grid, const Matrix2D<Match>& matches, int x, PODVector<IntVector2>& cells);
+    /// the collapse of the column x (CollapseColumn) : the moved matches are pushed by pairs (from, to) in transfers
+    static void Collapse(const Matrix2D<GridTile>& grid, Matrix2D<Match>& matches, int x, PODVector<IntVector2>& transfers);
+    /// a step of the matches on the ramp tiles (UpdateDirectionalTiles) : the moved matches are pushed by pairs (from, to) in transfers
+    static void MoveOnRamps(const Matrix2D<GridTile>& grid, Matrix2D<Match>& matches, const Vector<Vector<IntVector2> >& ramptiles, Matrix2D<int>& gridupdates, PODVector<IntVector2>& transfers);
+    /// the line of a directional power bounded by the walls : the cells [xmin, x] to the left and [x, xmax] to the right, the hitted walls are added
+    static void GetHorizontalLine(const Matrix2D<GridTile>& grid, int x, int y, int& xmin, int& xmax, Vector<WallInfo>* hittedwalls);
+    static void GetVerticalLine(const Matrix2D<GridTile>& grid, int x, int y, int& ymin, int& ymax, Vector<WallInfo>* hittedwalls);
+    static void GetWallsAround(const Matrix2D<GridTile>& grid, int x, int y, int range, Vector<WallInfo>& hittedwalls);
+    /// remove a hitted wall : false if the wall is already broken
+    static bool BreakWall(Matrix2D<GridTile>& grid, const WallInfo& wallinfo);
+    /// the moves of the cell (Move Table), the patterns are checked in this order : explosions, squares, horizontals, verticals
+    unsigned GetNumMoves(unsigned imatch) const { return moveoffsets_.Size() > imatch+1 ? moveoffsets_[imatch+1] - moveoffsets_[imatch] : 0; }
+    const MatchMove* GetMoves(unsigned imatch) const { return moveoffsets_.Size() > imatch+1 ? moves_.Buffer() + moveoffsets_[imatch] : 0; }
+
+    /// Touched Cells : the cells modified since the last hints update
+    void SetTouched(const Match& m) { touchedcells_.Set(m.x_, m.y_); UpdateHash(m.x_, m.y_); }
+    void SetAllTouched() { touchedcells_.Fill(width_, height_); ResetHash(); }
+    bool HasTouchedCells() const { return !touchedcells_.IsEmpty(); }
+    BitBoard PopTouchedCells(int radius);
+
     Vector3 CalculateMatchPosition(int x, int y) const;
 
+    /// Zobrist Hash : matches and tiles, updated incrementally with SetTouched and SetHittedWalls
+    static unsigned long long GetZobristKey(unsigned cell, unsigned value);
+    void ResetHash();
+    void UpdateHash(int x, int y)
+    {
+        const unsigned cell = y * width_ + x;
+        if (cell >= hashedmatches_.Size() || hashedmatches_[cell] == matches_[cell].property_)
+            return;
+        hash_ ^= GetZobristKey(cell, hashedmatches_[cell]) ^ GetZobristKey(cell, matches_[cell].property_);
+        hashedmatches_[cell] = matches_[cell].property_;
+    }
+    void UpdateTileHash(int x, int y);
+    unsigned long long GetZobristHash() const { return hash_; }
+    /// 32 bits checksum (replay, netplay)
+    unsigned GetHash() const { return (unsigned)(hash_ ^ (hash_ >> 32)); }
+
+    /// Turn Buffers
+    void ReserveTurnBuffers() { turnbuffers_.Reserve(Max(Max((int)width_, (int)height_), Match::MAXDIMENSION)); }
+    unsigned GetTurnBuffersCapacity() const { return turnbuffers_.GetCapacity(); }
+
 private:
     friend class MatchesManager;
     friend class MatchGridInfo;
+    friend class BoardSimulator;
 
     void CleanSavedMatches();
 
-    void RandomizeWalls();
+    void RandomizeWalls(GameRand& random);
 
     void InitializeTypes();
     void InitializeTiles();
@@ -453,10 +650,9 @@ private:
     void CheckMatches_L(const Match& entry, Vector<Match*>& matches);
     void CheckMatches_NeighborHood(const Match& entry, Vector<Match*>& matches);
 
-    void CheckHints_Explosion(Match& X, Vector<Vector<Match*> >& hints);
-    void CheckHints_Horizontal(Match& X, Vector<Vector<Match*> >& hints);
-    void CheckHints_Vertical(Match& X, Vector<Vector<Match*> >& hints);
-    void CheckHints_Square(Match& X, Vector<Vector<Match*> >& hints);
+    /// Move Table : rebuilt in the main thread when the layout or the walls change (Create, Load, SetHittedWalls)
+    void UpdateMoveTable();
+    void CheckHints_Moves(Match& X, PODVector<MatchHint>& hints);
 
     /// Grid Infos
     int gridid_;
@@ -483,6 +679,20 @@ private:
     Matrix2D<WeakPtr<Node> > objects_;
     Matrix2D<Match> previewmatches_;
     Matrix2D<WeakPtr<Node> > previewobjects_;
+    MatchBitBoard bitboard_;
+    MatchPowerResolver powerresolver_;
+    BitBoard touchedcells_;
+    MatchTurnBuffers turnbuffers_;
+
+    /// Zobrist Hash and the hashed values by cell
+    unsigned long long hash_;
+    PODVector<unsigned> hashedmatches_;
+    PODVector<unsigned> hashedtiles_;
+    /// the cached hints point to matches_ : cleared when matches_ is reallocated
+    MatchHintsCache hintscache_;
+    /// Move Table : the moves of the cell i in [moveoffsets_[i], moveoffsets_[i+1][
+    PODVector<MatchMove> moves_;
+    PODVector<unsigned> moveoffsets_;
 
     /// Temporary Saved Matches
     Match savedM1_, savedM2_;
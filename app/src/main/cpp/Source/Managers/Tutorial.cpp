@@ -51,7 +51,8 @@ Tutorial::Tutorial(Context* context) :
 
 Tutorial::~Tutorial()
 {
-
+    EventChannel<PowerAddedEvent>::Unsubscribe(this);
+    EventChannel<NoMatchStateEvent>::Unsubscribe(this);
 }
 
 void Tutorial::RegisterObject(Context* context)
@@ -126,12 +127,12 @@ void Tutorial::SetEnabled(bool enable)
         if (frame_)
             frame_->Stop();
 
-        UnsubscribeFromEvent(GAME_NOMATCHSTATE);
+        EventChannel<NoMatchStateEvent>::Unsubscribe(this);
         UnsubscribeFromEvents();
     }
     else
     {
-        SubscribeToEvent(GAME_NOMATCHSTATE, URHO3D_HANDLER(Tutorial, HandleTutorialStart));
+        EventChannel<NoMatchStateEvent>::Subscribe<Tutorial, &Tutorial::HandleTutorialStart>(this);
         SubscribeToEvents();
     }
 }
@@ -143,14 +144,14 @@ void Tutorial::SubscribeToEvents()
 
     SubscribeToEvent(TUTORIAL_LAUNCH, URHO3D_HANDLER(Tutorial, HandleTutorialLaunch));
     SubscribeToEvent(TUTORIAL_NEXT, URHO3D_HANDLER(Tutorial, HandleTutorialNext));
-    SubscribeToEvent(GAME_POWERADDED, URHO3D_HANDLER(Tutorial, HandleEvents));
+    EventChannel<PowerAddedEvent>::Subscribe<Tutorial, &Tutorial::HandlePowerAdded>(this);
 }
 
 void Tutorial::UnsubscribeFromEvents()
 {
     UnsubscribeFromEvent(TUTORIAL_LAUNCH);
     UnsubscribeFromEvent(TUTORIAL_NEXT);
-    UnsubscribeFromEvent(GAME_POWERADDED);
+    EventChannel<PowerAddedEvent>::Unsubscribe(this);
 }
 
 extern Color MatchColors[NUMCOLORTYPES];
@@ -284,29 +285,20 @@ void Tutorial::HandleTutorialNext(StringHash eventType, VariantMap& eventData)
         DelayInformer::Get(this, 2.f, TUTORIAL_LAUNCH);
 }
 
-void Tutorial::HandleEvents(StringHash eventType, VariantMap& eventData)
+void Tutorial::HandlePowerAdded(const PowerAddedEvent& event)
 {
-    if (eventType == GAME_POWERADDED)
-    {
-        Node* node = static_cast<Node*>(eventData[Game_PowerAdded::NODE].GetPtr());
-        if (!node)
-            return;
-
-        unsigned property = eventData[Game_PowerAdded::MATCHPROPERTY].GetUInt();
-        MatchProperty* mprop = (MatchProperty*)(&property);
-        int powerid = mprop->otype_+1;
+    if (!event.node_)
+        return;
 
-        // Add Tutorial to Show
-        tutorialInfos_.Push(TutorialInfo(node, powerid, mprop->ctype_));
+    int powerid = event.property_.otype_+1;
 
-        URHO3D_LOGINFOF("Tutorial() - HandleEvents : GAME_POWERADDED powerid=%d color=%d", powerid, mprop->ctype_);
+    // Add Tutorial to Show
+    tutorialInfos_.Push(TutorialInfo(event.node_, powerid, event.property_.ctype_));
 
-        if (!enabled_)
-            return;
-    }
+    URHO3D_LOGINFOF("Tutorial() - HandlePowerAdded : GAME_POWERADDED powerid=%d color=%d", powerid, event.property_.ctype_);
 }
 
-void Tutorial::HandleTutorialStart(StringHash eventType, VariantMap& eventData)
+void Tutorial::HandleTutorialStart(const NoMatchStateEvent& event)
 {
     if (GameStatics::numRemainObjectives_ <= 0)
         return;
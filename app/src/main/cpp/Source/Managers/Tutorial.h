@@ -4,6 +4,9 @@
 
 using namespace Urho3D;
 
+struct PowerAddedEvent;
+struct NoMatchStateEvent;
+
 enum TutorialCmd
 {
     TUT_NONE,
@@ -62,8 +65,8 @@ private :
     void SubscribeToEvents();
     void UnsubscribeFromEvents();
 
-    void HandleEvents(StringHash eventType, VariantMap& eventData);
-    void HandleTutorialStart(StringHash eventType, VariantMap& eventData);
+    void HandlePowerAdded(const PowerAddedEvent& event);
+    void HandleTutorialStart(const NoMatchStateEvent& event);
     void HandleTutorialFrameStopped(StringHash eventType, VariantMap& eventData);
     void HandleTutorialLaunch(StringHash eventType, VariantMap& eventData);
     void HandleTutorialNext(StringHash eventType, VariantMap& eventData);
@@ -6,6 +6,8 @@
 
 #include <Urho3D/IO/Log.h>
 
+#include "GameAllocTracker.h"
+
 #include "NetworkConnection.h"
 #include "NetworkTransport.h"
 #include "Network.h"
@@ -154,6 +156,8 @@ void Network::SendBuffer(NetworkConnection* connection, const VectorBuffer& buff
 
 void Network::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
+    GAMEALLOC_SCOPE(GAMEALLOC_NETWORK);
+
     if (state_ == NetworkConnectionState::Disconnecting)
     {
         DisconnectAll();
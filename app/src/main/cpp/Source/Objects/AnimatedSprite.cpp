@@ -11,6 +11,7 @@
 #include <Urho3D/UI/UI.h>
 
 #include "GameStatics.h"
+#include "GameAllocTracker.h"
 
 #include "AnimatedSprite.h"
 
@@ -122,6 +123,8 @@ void AnimatedSprite::SwitchIndependentUpdate()
 
 void AnimatedSprite::Update(float timeStep)
 {
+    GAMEALLOC_SCOPE(GAMEALLOC_ANIMATION);
+
     if (IsVisibleEffective())
     {
         animatedSprite2D_.UpdateAnimation(timeStep);
@@ -32,6 +32,8 @@
 const float IDLE_DELAY = 3.f;
 Vector2 position2D_;
 
+int BlastLogic::updateSystem_ = -1;
+
 const char* BlastSteeringModeNames_[] =
 {
     "NoSteering",
@@ -57,12 +59,13 @@ BlastLogic::BlastLogic(Context* context) :
 BlastLogic::~BlastLogic()
 {
 //    URHO3D_LOGINFOF("~BlastLogic()");
-
+    ComponentUpdater::Remove(updateSystem_, updateSlot_);
 }
 
 void BlastLogic::RegisterObject(Context* context)
 {
     context->RegisterFactory<BlastLogic>();
+    updateSystem_ = ComponentUpdater::RegisterSystem("BlastLogic", &BlastLogic::UpdateComponent);
 
     URHO3D_ENUM_ACCESSOR_ATTRIBUTE("Steering Mode", GetSteeringMode, SetSteeringMode, BlastSteeringMode, BlastSteeringModeNames_, NOSTEERING, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Auto Targeting", GetAutoTargeting, SetAutoTargeting, bool, false, AM_DEFAULT);
@@ -130,7 +133,7 @@ void BlastLogic::Start()
         if (steeringMode_ == NOSTEERING)
             body_->SetLinearVelocity(speed_ * initialDirection_);
         else
-            SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(BlastLogic, OnUpdate));
+            ComponentUpdater::Add(updateSystem_, this, updateSlot_);
 
         if (lifetime_)
             TimerRemover::Get()->Start(node_, lifetime_, FREEMEMORY);
@@ -157,6 +160,7 @@ void BlastLogic::Stop()
 //    node_->SetEnabledRecursive(false);
 
     // stop update
+    ComponentUpdater::Remove(updateSystem_, updateSlot_);
     UnsubscribeFromAllEvents();
 }
 
@@ -211,9 +215,9 @@ void BlastLogic::OnBeginContact(StringHash eventType, VariantMap& eventData)
         node_->Remove();
 }
 
-void BlastLogic::OnUpdate(StringHash eventType, VariantMap& eventData)
+void BlastLogic::UpdateComponent(Component* component, float timestep)
 {
-    Update(eventData[SceneUpdate::P_TIMESTEP].GetFloat());
+    static_cast<BlastLogic*>(component)->Update(timestep);
 }
 
 void BlastLogic::SeekTarget(Node* target)
@@ -270,7 +274,7 @@ void BlastLogic::Update(float timestep)
                 // no target : reset steering mode to default
                 // set velocity to bottom
                 steeringMode_ = NOSTEERING;
-                UnsubscribeFromEvent(GetScene(), E_SCENEPOSTUPDATE);
+                ComponentUpdater::Remove(updateSystem_, updateSlot_);
                 body_->SetLinearVelocity(speed_ * initialDirection_);
             }
             else
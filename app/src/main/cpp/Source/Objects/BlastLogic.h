@@ -2,6 +2,8 @@
 
 #include <Urho3D/Scene/Component.h>
 
+#include "ComponentUpdater.h"
+
 namespace Urho3D
 {
     class AnimatedSprite2D;
@@ -56,7 +58,7 @@ class BlastLogic : public Component
 
     private :
 
-        void OnUpdate(StringHash eventType, VariantMap& eventData);
+        static void UpdateComponent(Component* component, float timestep);
 
         /// Updater
         void SeekTarget(Node* target);
@@ -75,5 +77,8 @@ class BlastLogic : public Component
         IntVector2 effectondie_;
 
         WeakPtr<Node> target_;
+
+        ComponentUpdateSlot updateSlot_;
+        static int updateSystem_;
 };
 
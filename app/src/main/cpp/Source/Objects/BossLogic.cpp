@@ -19,6 +19,7 @@
 #include "GameAttributes.h"
 #include "GameStatics.h"
 #include "GameEvents.h"
+#include "EventChannel.h"
 #include "GameHelpers.h"
 #include "TimerRemover.h"
 
@@ -164,6 +165,8 @@ enum BossState
 };
 
 
+int BossLogic::updateSystem_ = -1;
+
 BossLogic::BossLogic(Context* context) :
     Component(context),
     attackindex_(0),
@@ -179,12 +182,13 @@ BossLogic::BossLogic(Context* context) :
 BossLogic::~BossLogic()
 {
 //    URHO3D_LOGINFOF("~BossLogic()");
-
+    ComponentUpdater::Remove(updateSystem_, updateSlot_);
 }
 
 void BossLogic::RegisterObject(Context* context)
 {
     context->RegisterFactory<BossLogic>();
+    updateSystem_ = ComponentUpdater::RegisterSystem("BossLogic", &BossLogic::UpdateComponent);
 
     URHO3D_ACCESSOR_ATTRIBUTE("Life", GetLife, SetLife, int, 20, AM_DEFAULT);
     URHO3D_ACCESSOR_ATTRIBUTE("Number Of Attacks", GetNumAttacks, SetNumAttacks, int, 1, AM_DEFAULT);
@@ -282,7 +286,7 @@ void BossLogic::Stop()
 
 void BossLogic::SubscribeToEvents()
 {
-    SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(BossLogic, OnUpdate));
+    ComponentUpdater::Add(updateSystem_, this, updateSlot_);
 
     if (animators_.Size())
     {
@@ -293,6 +297,7 @@ void BossLogic::SubscribeToEvents()
 
 void BossLogic::UnsubscribeFromEvents()
 {
+    ComponentUpdater::Remove(updateSystem_, updateSlot_);
     UnsubscribeFromAllEvents();
 }
 
@@ -548,7 +553,7 @@ void BossLogic::ResetHitted()
 
     /// Update Objectives
     MatchesManager::SetObjectiveRemainingQty(0, GetCurrentLife());
-    SendEvent(GAME_OBJECTIVECHANGE);
+    EventChannel<ObjectiveChangeEvent>::Send(this, ObjectiveChangeEvent());
 }
 
 void BossLogic::Hit(int dps, bool updateobjectives, bool forced)
@@ -589,7 +594,7 @@ void BossLogic::Hit(int dps, bool updateobjectives, bool forced)
     if (updateobjectives)
     {
         MatchesManager::SetObjectiveRemainingQty(0, GetCurrentLife());
-        SendEvent(GAME_OBJECTIVECHANGE);
+        EventChannel<ObjectiveChangeEvent>::Send(this, ObjectiveChangeEvent());
     }
 }
 
@@ -648,9 +653,9 @@ void BossLogic::OnSpawnEntity(StringHash eventType, VariantMap& eventData)
 //                    node_->GetName().CString(), node_->GetID(), node->GetName().CString(), node->GetID(), triggerInfo.zindex_);
 }
 
-void BossLogic::OnUpdate(StringHash eventType, VariantMap& eventData)
+void BossLogic::UpdateComponent(Component* component, float timestep)
 {
-    Update(eventData[SceneUpdate::P_TIMESTEP].GetFloat());
+    static_cast<BossLogic*>(component)->Update(timestep);
 }
 
 void BossLogic::Update(float timestep)
@@ -2,6 +2,8 @@
 
 #include <Urho3D/Scene/Component.h>
 
+#include "ComponentUpdater.h"
+
 namespace Urho3D
 {
     class AnimatedSprite2D;
@@ -84,7 +86,7 @@ class BossLogic : public Component
         void AddEffects(Node* root, int index, int num, float x, float y, float delaybetweenspawns, float removedelay);
 
         /// Handler
-        void OnUpdate(StringHash eventType, VariantMap& eventData);
+        static void UpdateComponent(Component* component, float timestep);
         void OnEvent(StringHash eventType, VariantMap& eventData);
         void OnBeginContact(StringHash eventType, VariantMap& eventData);
         void OnSpawnEntity(StringHash eventType, VariantMap& eventData);
@@ -103,5 +105,8 @@ class BossLogic : public Component
         IntVector2 effectonhurt_;
         float actiontimer_;
         bool attackBroken_;
+
+        ComponentUpdateSlot updateSlot_;
+        static int updateSystem_;
 };
 
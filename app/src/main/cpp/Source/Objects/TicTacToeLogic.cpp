@@ -248,6 +248,8 @@ int meilleurCoupBot(char plateau[3][3], int difficulte)
 
 Vector3 tictactoeInitialScale_;
 
+int TicTacToeLogic::gameSystem_ = -1;
+
 TicTacToeLogic::TicTacToeLogic(Context* context) :
     BossLogic(context),
     ticTacToeMode_(false),
@@ -261,17 +263,19 @@ TicTacToeLogic::TicTacToeLogic(Context* context) :
 TicTacToeLogic::~TicTacToeLogic()
 {
 //    URHO3D_LOGINFOF("~TicTacToeLogic()");
-
+    ComponentUpdater::Remove(gameSystem_, gameSlot_);
 }
 
 void TicTacToeLogic::RegisterObject(Context* context)
 {
     context->RegisterFactory<TicTacToeLogic>();
+    gameSystem_ = ComponentUpdater::RegisterSystem("TicTacToeGame", &TicTacToeLogic::UpdateGameComponent);
     URHO3D_COPY_BASE_ATTRIBUTES(BossLogic);
 }
 
 void TicTacToeLogic::SubscribeToEvents()
 {
+    ComponentUpdater::Remove(gameSystem_, gameSlot_);
     BossLogic::SubscribeToEvents();
     SubscribeToEvent(node_, GAME_BOSSSTATECHANGE, URHO3D_HANDLER(TicTacToeLogic, OnBossStateChange));
 }
@@ -279,6 +283,7 @@ void TicTacToeLogic::SubscribeToEvents()
 void TicTacToeLogic::UnsubscribeFromEvents()
 {
     BossLogic::UnsubscribeFromEvents();
+    ComponentUpdater::Remove(gameSystem_, gameSlot_);
     UnsubscribeFromEvent(node_, GAME_BOSSSTATECHANGE);
 }
 
@@ -349,7 +354,7 @@ void TicTacToeLogic::StartGame(char firstplayer)
     elapedTime_ = turnTime_ = 0.f;
     winner_ = CelluleVide;
 
-    SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(TicTacToeLogic, HandleGame));
+    ComponentUpdater::Add(gameSystem_, this, gameSlot_);
     SubscribeToEvent(E_TOUCHBEGIN, URHO3D_HANDLER(TicTacToeLogic, HandleGame));
     SubscribeToEvent(E_MOUSEBUTTONDOWN, URHO3D_HANDLER(TicTacToeLogic, HandleGame));
 }
@@ -390,133 +395,138 @@ void TicTacToeLogic::HandleGame(StringHash eventType, VariantMap& eventData)
             }
         }
     }
-    else if (eventType == E_SCENEPOSTUPDATE)
-    {
-        float timestep = eventData[SceneUpdate::P_TIMESTEP].GetFloat();
-        elapedTime_ += timestep;
+}
+
+void TicTacToeLogic::UpdateGameComponent(Component* component, float timestep)
+{
+    static_cast<TicTacToeLogic*>(component)->UpdateGame(timestep);
+}
+
+void TicTacToeLogic::UpdateGame(float timestep)
+{
+    elapedTime_ += timestep;
 //        URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : elapsedTime=%F ...", elapedTime_);
-        turnTime_ += timestep;
+    turnTime_ += timestep;
 
-        if (turn_ < 8)
+    if (turn_ < 8)
+    {
+        if (winner_ == CelluleVide)
         {
-            if (winner_ == CelluleVide)
-            {
-                bool played = false;
-
-                if (currentplayer_ == JoueurX)
-                {
-                    // the player selected a case (setted by OnBeginContact)
-                    if (case_ != -1)
-                    {
-                        URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : JoueurX case=%d", case_);
-                        board_[case_/3][case_%3] = JoueurX;
+            bool played = false;
 
-                        played = true;
-                    }
-                }
-                else if (turnTime_ > 1.f)
+            if (currentplayer_ == JoueurX)
+            {
+                // the player selected a case (setted by OnBeginContact)
+                if (case_ != -1)
                 {
-                    case_ = meilleurCoupBot(board_, difficulty_);
-
-                    URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : JoueurO case=%d ...", case_);
-                    board_[case_/3][case_%3] = JoueurO;
+                    URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : JoueurX case=%d", case_);
+                    board_[case_/3][case_%3] = JoueurX;
 
                     played = true;
                 }
+            }
+            else if (turnTime_ > 1.f)
+            {
+                case_ = meilleurCoupBot(board_, difficulty_);
 
-                if (played)
-                {
-                    afficherPlateau(board_);
+                URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : JoueurO case=%d ...", case_);
+                board_[case_/3][case_%3] = JoueurO;
 
-                    // add the animation for the played case.
-                    String animation = String("case") + String(case_+1);
-                    String cmap = animation + String("_") + String(currentplayer_ == JoueurO ? "circle":"cross");
-                    if (!animators_.Front()->IsCharacterMapApplied(cmap))
-                    {
-                        animators_.Front()->ApplyCharacterMap(cmap);
-                        animators_.Front()->SetAnimation(animation);
-                    }
+                played = true;
+            }
 
-                    // check for a winner
-                    winner_ = verifierGagnant(board_);
+            if (played)
+            {
+                afficherPlateau(board_);
 
-                    // next turn
-                    turnTime_ = 0.f;
-                    turn_++;
-                    case_ = -1;
-                    currentplayer_ = (currentplayer_ == JoueurX) ? JoueurO : JoueurX;
+                // add the animation for the played case.
+                String animation = String("case") + String(case_+1);
+                String cmap = animation + String("_") + String(currentplayer_ == JoueurO ? "circle":"cross");
+                if (!animators_.Front()->IsCharacterMapApplied(cmap))
+                {
+                    animators_.Front()->ApplyCharacterMap(cmap);
+                    animators_.Front()->SetAnimation(animation);
                 }
+
+                // check for a winner
+                winner_ = verifierGagnant(board_);
+
+                // next turn
+                turnTime_ = 0.f;
+                turn_++;
+                case_ = -1;
+                currentplayer_ = (currentplayer_ == JoueurX) ? JoueurO : JoueurX;
             }
         }
-        else
+    }
+    else
+    {
+        // last turn : auto mode
+        if (winner_ == CelluleVide && turnTime_ > 1.f)
         {
-            // last turn : auto mode
-            if (winner_ == CelluleVide && turnTime_ > 1.f)
-            {
-                case_ = -1;
+            case_ = -1;
 
-                for (int i = 0; i < 3; i++)
-                    for (int j = 0; j < 3; j++)
-                        if (board_[i][j] == CelluleVide)
-                        {
-                            case_ = i * 3 + j;
-                            board_[i][j] = firstplayer_;
-                            break;
-                        }
-
-                if (case_ != -1)
-                {
-                    afficherPlateau(board_);
-
-                    // add the animation for the played case.
-                    String animation = String("case") + String(case_+1);
-                    String cmap = animation + String("_") + String(firstplayer_ == JoueurO ? "circle":"cross");
-                    if (!animators_.Front()->IsCharacterMapApplied(cmap))
+            for (int i = 0; i < 3; i++)
+                for (int j = 0; j < 3; j++)
+                    if (board_[i][j] == CelluleVide)
                     {
-                        animators_.Front()->ApplyCharacterMap(cmap);
-                        animators_.Front()->SetAnimation(animation);
+                        case_ = i * 3 + j;
+                        board_[i][j] = firstplayer_;
+                        break;
                     }
 
-                    turnTime_ = 0.f;
+            if (case_ != -1)
+            {
+                afficherPlateau(board_);
+
+                // add the animation for the played case.
+                String animation = String("case") + String(case_+1);
+                String cmap = animation + String("_") + String(firstplayer_ == JoueurO ? "circle":"cross");
+                if (!animators_.Front()->IsCharacterMapApplied(cmap))
+                {
+                    animators_.Front()->ApplyCharacterMap(cmap);
+                    animators_.Front()->SetAnimation(animation);
                 }
 
-                winner_ = verifierGagnant(board_);
-                if (winner_ == CelluleVide)
-                    winner_ = Draw;
+                turnTime_ = 0.f;
             }
+
+            winner_ = verifierGagnant(board_);
+            if (winner_ == CelluleVide)
+                winner_ = Draw;
         }
+    }
 
-        if (winner_ == CelluleVide && elapedTime_ > TicTacToePlayDelay)
-            winner_ = JoueurO;
+    if (winner_ == CelluleVide && elapedTime_ > TicTacToePlayDelay)
+        winner_ = JoueurO;
 
-        if (winner_ != CelluleVide && turnTime_ > 1.f)
-        {
-            // Stop TicTacToe Game
-            ticTacToeMode_ = false;
+    if (winner_ != CelluleVide && turnTime_ > 1.f)
+    {
+        // Stop TicTacToe Game
+        ticTacToeMode_ = false;
 
-            URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : exit tictactoe mode : Winner=%c !", winner_);
+        URHO3D_LOGINFOF("TicTacToeLogic() - HandleGame : exit tictactoe mode : Winner=%c !", winner_);
 
-            // Restart normal zoom
-            node_->RemoveObjectAnimation();
-            SharedPtr<ObjectAnimation> objectAnimation(new ObjectAnimation(GetContext()));
-            SharedPtr<ValueAnimation> scaleAnimation(new ValueAnimation(GetContext()));
-            scaleAnimation->SetKeyFrame(0.f, node_->GetScale());
-            scaleAnimation->SetKeyFrame(TicTacToeAnimationTime, tictactoeInitialScale_);
-            objectAnimation->AddAttributeAnimation("Scale", scaleAnimation, WM_ONCE);
-            node_->SetObjectAnimation(objectAnimation);
+        // Restart normal zoom
+        node_->RemoveObjectAnimation();
+        SharedPtr<ObjectAnimation> objectAnimation(new ObjectAnimation(GetContext()));
+        SharedPtr<ValueAnimation> scaleAnimation(new ValueAnimation(GetContext()));
+        scaleAnimation->SetKeyFrame(0.f, node_->GetScale());
+        scaleAnimation->SetKeyFrame(TicTacToeAnimationTime, tictactoeInitialScale_);
+        objectAnimation->AddAttributeAnimation("Scale", scaleAnimation, WM_ONCE);
+        node_->SetObjectAnimation(objectAnimation);
 
-            SetState(IDLE);
-            if (winner_ == JoueurX)
-                Hit(10, true, true);
+        SetState(IDLE);
+        if (winner_ == JoueurX)
+            Hit(10, true, true);
 
-            node_->GetDerivedComponent<CollisionShape2D>()->SetEnabled(true);
+        node_->GetDerivedComponent<CollisionShape2D>()->SetEnabled(true);
 
-            SubscribeToEvents();
+        SubscribeToEvents();
 
-            // Reactive MatchesManager
-            MatchesManager::SubscribeToEvents();
-            MatchesManager::SetPhysicsEnable(true);
-        }
+        // Reactive MatchesManager
+        MatchesManager::SubscribeToEvents();
+        MatchesManager::SetPhysicsEnable(true);
     }
 }
 
@@ -21,6 +21,8 @@ class TicTacToeLogic : public BossLogic
 
         void OnBossStateChange(StringHash eventType, VariantMap& eventData);
         void HandleGame(StringHash eventType, VariantMap& eventData);
+        void UpdateGame(float timestep);
+        static void UpdateGameComponent(Component* component, float timestep);
 
         virtual void SubscribeToEvents();
         virtual void UnsubscribeFromEvents();
@@ -32,5 +34,8 @@ class TicTacToeLogic : public BossLogic
         int case_;
         int difficulty_;
         float elapedTime_, turnTime_;
+
+        ComponentUpdateSlot gameSlot_;
+        static int gameSystem_;
 };
 
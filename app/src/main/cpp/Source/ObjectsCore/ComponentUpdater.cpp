@@ -0,0 +1,192 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/IO/Log.h>
+#include <Urho3D/Scene/Component.h>
+#include <Urho3D/Scene/Scene.h>
+#include <Urho3D/Scene/SceneEvents.h>
+
+#include "GameProfiler.h"
+
+#include "ComponentUpdater.h"
+
+
+Vector<ComponentUpdater::UpdateSystem> ComponentUpdater::systems_;
+bool ComponentUpdater::dispatching_ = false;
+ComponentUpdater* ComponentUpdater::updater_ = 0;
+
+
+void ComponentUpdater::Reset(Context* context)
+{
+    // unregister the components, keep the systems
+    for (unsigned i=0; i < systems_.Size(); i++)
+    {
+        UpdateSystem& system = systems_[i];
+        for (unsigned j=0; j < system.entries_.Size(); j++)
+            if (system.entries_[j].component_)
+                system.entries_[j].slot_->index_ = -1;
+
+        system.entries_.Clear();
+        system.numRemoved_ = 0;
+    }
+
+    if (context)
+    {
+        if (!updater_)
+            updater_ = new ComponentUpdater(context);
+    }
+    else if (updater_)
+    {
+        delete updater_;
+        updater_ = 0;
+    }
+}
+
+int ComponentUpdater::RegisterSystem(const char* name, ComponentUpdateFunction function)
+{
+    for (unsigned i=0; i < systems_.Size(); i++)
+        if (systems_[i].name_ == name)
+            return i;
+
+    systems_.Resize(systems_.Size()+1);
+
+    UpdateSystem& system = systems_.Back();
+    system.name_ = name;
+    system.function_ = function;
+    system.numRemoved_ = 0;
+    system.numDispatched_ = 0;
+
+    URHO3D_LOGINFOF("ComponentUpdater() - RegisterSystem : %s id=%u", name, systems_.Size()-1);
+
+    return systems_.Size()-1;
+}
+
+void ComponentUpdater::Add(int systemid, Component* component, ComponentUpdateSlot& slot)
+{
+    if (systemid < 0 || systemid >= (int)systems_.Size())
+        return;
+
+    UpdateSystem& system = systems_[systemid];
+
+    if (slot.IsRegistered())
+    {
+        system.entries_[slot.index_].scene_ = component->GetScene();
+        return;
+    }
+
+    UpdateEntry entry;
+    entry.component_ = component;
+    entry.scene_ = component->GetScene();
+    entry.slot_ = &slot;
+
+    slot.index_ = system.entries_.Size();
+    system.entries_.Push(entry);
+}
+
+void ComponentUpdater::Remove(int systemid, ComponentUpdateSlot& slot)
+{
+    if (!slot.IsRegistered() || systemid < 0 || systemid >= (int)systems_.Size())
+        return;
+
+    UpdateSystem& system = systems_[systemid];
+
+    if (dispatching_)
+    {
+        // keep the order during the dispatch : compacted after
+        system.entries_[slot.index_].component_ = 0;
+        system.numRemoved_++;
+    }
+    else
+    {
+        UpdateEntry& last = system.entries_.Back();
+        if (last.slot_ != &slot)
+        {
+            system.entries_[slot.index_] = last;
+            last.slot_->index_ = slot.index_;
+        }
+        system.entries_.Pop();
+    }
+
+    slot.index_ = -1;
+}
+
+unsigned ComponentUpdater::GetNumComponents(int systemid)
+{
+    if (systemid < 0 || systemid >= (int)systems_.Size())
+        return 0;
+
+    return systems_[systemid].entries_.Size() - systems_[systemid].numRemoved_;
+}
+
+void ComponentUpdater::Dump()
+{
+    for (unsigned i=0; i < systems_.Size(); i++)
+        URHO3D_LOGINFOF("ComponentUpdater() - Dump : system=%s(%u) components=%u capacity=%u",
+                        systems_[i].name_.CString(), i, GetNumComponents(i), systems_[i].entries_.Capacity());
+}
+
+void ComponentUpdater::Compact(UpdateSystem& system)
+{
+    unsigned j = 0;
+    for (unsigned i=0; i < system.entries_.Size(); i++)
+    {
+        UpdateEntry& entry = system.entries_[i];
+        if (!entry.component_)
+            continue;
+
+        if (i != j)
+        {
+            system.entries_[j] = entry;
+            entry.slot_->index_ = j;
+        }
+        j++;
+    }
+
+    system.entries_.Resize(j);
+    system.numRemoved_ = 0;
+}
+
+
+ComponentUpdater::ComponentUpdater(Context* context) :
+    Object(context)
+{
+    SubscribeToEvent(E_SCENEPOSTUPDATE, URHO3D_HANDLER(ComponentUpdater, HandleScenePostUpdate));
+}
+
+ComponentUpdater::~ComponentUpdater()
+{
+    Dump();
+}
+
+void ComponentUpdater::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    Scene* scene = static_cast<Scene*>(eventData[ScenePostUpdate::P_SCENE].GetPtr());
+    const float timestep = eventData[ScenePostUpdate::P_TIMESTEP].GetFloat();
+
+    GAMEPROFILE(ComponentUpdater);
+
+    dispatching_ = true;
+
+    // the components added during the dispatch are updated at the next frame :
+    // a component added by an update of an other system (a Blast spawned by a BossLogic) too
+    for (unsigned i=0; i < systems_.Size(); i++)
+        systems_[i].numDispatched_ = systems_[i].entries_.Size();
+
+    for (unsigned i=0; i < systems_.Size(); i++)
+    {
+        UpdateSystem& system = systems_[i];
+
+        for (unsigned j=0; j < system.numDispatched_; j++)
+        {
+            const UpdateEntry& entry = system.entries_[j];
+            if (entry.component_ && entry.scene_ == scene)
+                system.function_(entry.component_, timestep);
+        }
+    }
+
+    dispatching_ = false;
+
+    for (unsigned i=0; i < systems_.Size(); i++)
+        if (systems_[i].numRemoved_)
+            Compact(systems_[i]);
+}
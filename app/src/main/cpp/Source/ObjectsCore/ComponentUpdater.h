@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Object.h>
+
+namespace Urho3D
+{
+    class Component;
+    class Scene;
+}
+
+using namespace Urho3D;
+
+
+typedef void (*ComponentUpdateFunction)(Component* component, float timestep);
+
+/// Update Slot : the index of a component in the array of its update system
+struct ComponentUpdateSlot
+{
+    ComponentUpdateSlot() : index_(-1) { }
+
+    bool IsRegistered() const { return index_ != -1; }
+
+    int index_;
+};
+
+/// Component Updater
+/// a logic type registers an update function (an update system) and adds its live components in a packed array.
+/// One E_SCENEPOSTUPDATE handler iterates the arrays of the systems, instead of one event handler by component.
+/// The components removed during the dispatch are compacted after it, the components added (in any system) are updated at the next frame.
+class ComponentUpdater : public Object
+{
+    URHO3D_OBJECT(ComponentUpdater, Object);
+
+public :
+    static void Reset(Context* context=0);
+
+    /// Registry : returns the system id
+    static int RegisterSystem(const char* name, ComponentUpdateFunction function);
+
+    static void Add(int system, Component* component, ComponentUpdateSlot& slot);
+    static void Remove(int system, ComponentUpdateSlot& slot);
+
+    static unsigned GetNumComponents(int system);
+    static void Dump();
+
+    ComponentUpdater(Context* context);
+    ~ComponentUpdater();
+
+private :
+    struct UpdateEntry
+    {
+        Component* component_;
+        Scene* scene_;
+        ComponentUpdateSlot* slot_;
+    };
+
+    struct UpdateSystem
+    {
+        String name_;
+        ComponentUpdateFunction function_;
+        PODVector<UpdateEntry> entries_;
+        unsigned numRemoved_;
+        /// size of entries_ when the dispatch starts
+        unsigned numDispatched_;
+    };
+
+    static void Compact(UpdateSystem& system);
+
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+
+    static Vector<UpdateSystem> systems_;
+    static bool dispatching_;
+    static ComponentUpdater* updater_;
+};
@@ -1,7 +1,6 @@
 #include <Urho3D/Urho3D.h>
 
 #include <Urho3D/Core/Context.h>
-#include <Urho3D/Core/CoreEvents.h>
 
 #include "GameStatics.h"
 
@@ -31,68 +30,63 @@ DelayInformer* DelayInformer::Get(Object* object, float delay, StringHash eventT
 }
 
 
-DelayInformer::DelayInformer(Context* context) : Object(context) { }
+DelayInformer::DelayInformer(Context* context) : Object(context), handle_(0) { }
 
-DelayInformer::DelayInformer() : Object(0) { }
+DelayInformer::DelayInformer() : Object(0), handle_(0) { }
 
-DelayInformer::DelayInformer(const DelayInformer& timer) : Object(timer.GetContext()) { }
+DelayInformer::DelayInformer(const DelayInformer& timer) : Object(timer.GetContext()), handle_(0) { }
 
-DelayInformer::~DelayInformer() { }
+DelayInformer::~DelayInformer()
+{
+    TimerWheel::CancelTimer(handle_);
+}
 
 DelayInformer* DelayInformer::Set(Object* object, float delay, StringHash eventType)
 {
     object_ = object;
-    timer_ = 0.0f;
-    expirationTime_ = delay;
     eventType_ = eventType;
     eventData_.Clear();
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(DelayInformer, HandleUpdate));
+    TimerWheel::CancelTimer(handle_);
+    handle_ = TimerWheel::Get()->Add(this, delay);
     return this;
 }
 
 DelayInformer* DelayInformer::Set(Object* object, float delay, StringHash eventType, const VariantMap& eventData)
 {
     object_ = object;
-    timer_ = 0.0f;
-    expirationTime_ = delay;
     eventType_ = eventType;
     eventData_ = eventData;
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(DelayInformer, HandleUpdate));
+    TimerWheel::CancelTimer(handle_);
+    handle_ = TimerWheel::Get()->Add(this, delay);
     return this;
 }
 
 bool DelayInformer::Expired() const
 {
-    return timer_ > expirationTime_;
+    return !TimerWheel::IsActiveTimer(handle_);
 }
 
 void DelayInformer::Free()
 {
     object_.Reset();
-    UnsubscribeFromEvent(E_UPDATE);
+    TimerWheel::CancelTimer(handle_);
 
     pool_.Free(this);
 }
 
-void DelayInformer::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void DelayInformer::OnTimer(unsigned phase)
 {
-    timer_ += eventData[Update::P_TIMESTEP].GetFloat();
+    handle_ = 0;
 
-    if (timer_ > expirationTime_)
+    if (object_)
     {
-        UnsubscribeFromEvent(E_UPDATE);
-
-        if (object_)
-        {
-            if (eventData_.Size())
-                object_->SendEvent(eventType_, eventData_);
-            else
-                object_->SendEvent(eventType_);
-        }
-
-        Free();
+        if (eventData_.Size())
+            object_->SendEvent(eventType_, eventData_);
+        else
+            object_->SendEvent(eventType_);
     }
-}
 
+    Free();
+}
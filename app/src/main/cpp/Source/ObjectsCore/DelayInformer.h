@@ -1,8 +1,9 @@
 #pragma once
 
 #include "Pool.h"
+#include "TimerWheel.h"
 
-class DelayInformer : public Object
+class DelayInformer : public Object, public TimerWheelListener
 {
     URHO3D_OBJECT(DelayInformer, Object);
 
@@ -23,12 +24,11 @@ public :
     bool Expired() const;
     void Free();
 
-private :
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    virtual void OnTimer(unsigned phase);
 
+private :
     WeakPtr<Object> object_;
-    float timer_;
-	float expirationTime_;
+    TimerHandle handle_;
 	StringHash eventType_;
 	VariantMap eventData_;
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Urho3D/Container/HashSet.h>
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/Object.h>
+
+using namespace Urho3D;
+
+
+/// Event Channel
+/// a typed event channel beside Object::SendEvent : an event is a struct passed by reference to the listeners,
+/// the listeners are kept in a static dispatch table by event struct (no VariantMap, no StringHash lookup).
+/// Adapter : Send also sends the string-keyed event to the Urho3D subscribers, only if there are some.
+/// An event struct E defines :
+///     static StringHash GetEventType();
+///     void FillEventData(VariantMap& eventData) const;
+template <class E> class EventChannel
+{
+public:
+    typedef void (*Function)(void* listener, const E& event);
+
+    template <class T, void (T::*F)(const E&)> static void Subscribe(T* listener)
+    {
+        for (unsigned i = 0; i < listeners_.Size(); i++)
+            if (listeners_[i].listener_ == listener)
+            {
+                listeners_[i].function_ = &Call<T, F>;
+                return;
+            }
+
+        Listener entry;
+        entry.listener_ = listener;
+        entry.function_ = &Call<T, F>;
+        listeners_.Push(entry);
+    }
+
+    static void Unsubscribe(void* listener)
+    {
+        for (unsigned i = 0; i < listeners_.Size(); i++)
+            if (listeners_[i].listener_ == listener)
+            {
+                // keep the order during a dispatch : compacted after
+                if (dispatching_)
+                {
+                    listeners_[i].listener_ = 0;
+                    numRemoved_++;
+                }
+                else
+                    listeners_.Erase(i);
+                return;
+            }
+    }
+
+    static bool HasListeners() { return listeners_.Size() > numRemoved_; }
+
+    static void Send(Object* sender, const E& event)
+    {
+        Send(sender, event, E::GetEventType());
+    }
+
+    static void Send(Object* sender, const E& event, StringHash eventType)
+    {
+        // the listeners added during the dispatch don't receive the event
+        const unsigned size = listeners_.Size();
+
+        dispatching_++;
+        for (unsigned i = 0; i < size; i++)
+        {
+            const Listener& entry = listeners_[i];
+            if (entry.listener_)
+                entry.function_(entry.listener_, event);
+        }
+        dispatching_--;
+
+        if (!dispatching_ && numRemoved_)
+            Compact();
+
+        // string-keyed subscribers
+        if (sender && eventType && HasReceivers(sender, eventType))
+        {
+            VariantMap& eventData = sender->GetContext()->GetEventDataMap();
+            event.FillEventData(eventData);
+            sender->SendEvent(eventType, eventData);
+        }
+    }
+
+private:
+    struct Listener
+    {
+        void* listener_;
+        Function function_;
+    };
+
+    template <class T, void (T::*F)(const E&)> static void Call(void* listener, const E& event)
+    {
+        (static_cast<T*>(listener)->*F)(event);
+    }
+
+    static bool HasReceivers(Object* sender, StringHash eventType)
+    {
+        Context* context = sender->GetContext();
+        HashSet<Object*>* receivers = context->GetEventReceivers(sender, eventType);
+        if (receivers && !receivers->Empty())
+            return true;
+        receivers = context->GetEventReceivers(eventType);
+        return receivers && !receivers->Empty();
+    }
+
+    static void Compact()
+    {
+        unsigned j = 0;
+        for (unsigned i = 0; i < listeners_.Size(); i++)
+            if (listeners_[i].listener_)
+                listeners_[j++] = listeners_[i];
+
+        listeners_.Resize(j);
+        numRemoved_ = 0;
+    }
+
+    static PODVector<Listener> listeners_;
+    static unsigned numRemoved_;
+    static int dispatching_;
+};
+
+template <class E> PODVector<typename EventChannel<E>::Listener> EventChannel<E>::listeners_;
+template <class E> unsigned EventChannel<E>::numRemoved_ = 0;
+template <class E> int EventChannel<E>::dispatching_ = 0;
@@ -2,11 +2,19 @@
 
 #include <Urho3D/Container/List.h>
 
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/IO/File.h>
+#include <Urho3D/IO/FileSystem.h>
 #include <Urho3D/IO/Log.h>
 #include <Urho3D/Resource/ResourceCache.h>
 #include <Urho3D/Resource/XMLFile.h>
 #include <Urho3D/Scene/Scene.h>
 #include <Urho3D/Scene/SmoothedTransform.h>
+#include <Urho3D/Graphics/Light.h>
+#include <Urho3D/Graphics/Octree.h>
+#include <Urho3D/Graphics/Terrain.h>
+#include <Urho3D/Graphics/Zone.h>
+#include <Urho3D/Urho2D/Constraint2D.h>
 #include <Urho3D/Urho2D/RigidBody2D.h>
 
 //#include "DefsViews.h"
@@ -14,11 +22,166 @@
 #include "GameAttributes.h"
 #include "GameStatics.h"
 #include "GameHelpers.h"
+#include "GameLog.h"
+#include "GameProfiler.h"
+#include "GameAllocTracker.h"
 
 #include "ObjectPool.h"
 
 #define DEFAULT_NUMOBJECTS 10
 
+/// reserved ids of a local category = size x OBJECTPOOL_GROWTHFACTOR
+#define OBJECTPOOL_GROWTHFACTOR 2
+/// a category grows when its free nodes are under 1/OBJECTPOOL_LOWFREERATIO of its size
+#define OBJECTPOOL_LOWFREERATIO 8
+/// time budget (usec) of the growths by frame
+#define OBJECTPOOL_GROWDELAY 1000
+
+#define OBJECTPOOL_SIZESFILE "poolsizes.bin"
+#define OBJECTPOOL_SIZESFILEID "GMPS"
+
+
+/// Attribute Snapshot
+
+static unsigned GetPlainDataSize(const AttributeInfo& attr)
+{
+    switch (attr.type_)
+    {
+    case VAR_INT:
+        return attr.enumNames_ ? sizeof(unsigned char) : sizeof(int);
+    case VAR_BOOL:
+        return sizeof(bool);
+    case VAR_FLOAT:
+        return sizeof(float);
+    case VAR_VECTOR2:
+        return sizeof(Vector2);
+    case VAR_VECTOR3:
+        return sizeof(Vector3);
+    case VAR_VECTOR4:
+        return sizeof(Vector4);
+    case VAR_QUATERNION:
+        return sizeof(Quaternion);
+    case VAR_COLOR:
+        return sizeof(Color);
+    case VAR_INTRECT:
+        return sizeof(IntRect);
+    case VAR_INTVECTOR2:
+        return sizeof(IntVector2);
+    case VAR_INTVECTOR3:
+        return sizeof(IntVector3);
+    case VAR_DOUBLE:
+        return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+// the classes with an OnSetAttribute override react to their attributes : no plain data copy
+static bool HasSetAttributeOverride(Serializable* serializable)
+{
+    return serializable->IsInstanceOf<Constraint2D>() || serializable->IsInstanceOf<Light>() || serializable->IsInstanceOf<Zone>() ||
+           serializable->IsInstanceOf<Terrain>() || serializable->IsInstanceOf<Octree>();
+}
+
+void ObjectPoolSnapshot::SerializableSnapshot::Take(Serializable* serializable)
+{
+    type_ = serializable->GetType();
+    networkdata_ = false;
+    data_.Clear();
+    dataentries_.Clear();
+    attributes_.Clear();
+    values_.Clear();
+
+    const Vector<AttributeInfo>* attributes = serializable->GetAttributes();
+    if (!attributes)
+        return;
+
+    const bool plaindata = !HasSetAttributeOverride(serializable);
+
+    for (unsigned i = 0; i < attributes->Size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->At(i);
+        if (!(attr.mode_ & AM_FILE))
+            continue;
+
+        const unsigned size = plaindata && !attr.accessor_ && !attr.ptr_ ? GetPlainDataSize(attr) : 0;
+        if (size)
+        {
+            if (attr.mode_ & AM_NET)
+                networkdata_ = true;
+
+            DataEntry entry;
+            entry.offset_ = attr.offset_;
+            entry.size_ = size;
+            entry.dataoffset_ = data_.Size();
+            data_.Resize(data_.Size() + size);
+            memcpy(&data_[entry.dataoffset_], reinterpret_cast<const unsigned char*>(serializable) + attr.offset_, size);
+            dataentries_.Push(entry);
+        }
+        else
+        {
+            attributes_.Push(i);
+            values_.Resize(values_.Size()+1);
+            serializable->OnGetAttribute(attr, values_.Back());
+        }
+    }
+}
+
+void ObjectPoolSnapshot::SerializableSnapshot::Restore(Serializable* serializable) const
+{
+    unsigned char* dest = reinterpret_cast<unsigned char*>(serializable);
+    for (PODVector<DataEntry>::ConstIterator it = dataentries_.Begin(); it != dataentries_.End(); ++it)
+        memcpy(dest + it->offset_, &data_[it->dataoffset_], it->size_);
+
+    // like Serializable::OnSetAttribute for the network attributes
+    if (networkdata_)
+        serializable->MarkNetworkUpdate();
+
+    if (!attributes_.Size())
+        return;
+
+    const Vector<AttributeInfo>& attributes = *serializable->GetAttributes();
+    for (unsigned i = 0; i < attributes_.Size(); ++i)
+        serializable->OnSetAttribute(attributes[attributes_[i]], values_[i]);
+}
+
+void ObjectPoolSnapshot::Take(Node* node)
+{
+    const Vector<SharedPtr<Component> >& components = node->GetComponents();
+
+    serializables_.Resize(components.Size()+1);
+    serializables_[0].Take(node);
+
+    for (unsigned i = 0; i < components.Size(); ++i)
+    {
+        // like GameHelpers::CopyAttributes, the temporary components are not restored
+        if (components[i]->IsTemporary())
+            serializables_[i+1].type_ = StringHash::ZERO;
+        else
+            serializables_[i+1].Take(components[i]);
+    }
+}
+
+void ObjectPoolSnapshot::Restore(Node* node) const
+{
+    if (!serializables_.Size())
+        return;
+
+    serializables_[0].Restore(node);
+
+    const Vector<SharedPtr<Component> >& components = node->GetComponents();
+    const unsigned numcomponents = Min(components.Size(), serializables_.Size()-1);
+
+    for (unsigned i = 0; i < numcomponents; ++i)
+    {
+        const SerializableSnapshot& snapshot = serializables_[i+1];
+        Component* component = components[i];
+
+        if (component && snapshot.type_ == component->GetType())
+            snapshot.Restore(component);
+    }
+}
+
 
 ObjectPoolCategory::ObjectPoolCategory()
 { }
@@ -61,7 +224,28 @@ bool ObjectPoolCategory::HasReplicatedMode() const
 
 bool ObjectPoolCategory::IsNodeInPool(Node* node) const
 {
-    return !node->HasTag("InUse");
+    int index = GetNodeIndex(node);
+    return index == -1 || !IsInUse(index);
+}
+
+int ObjectPoolCategory::GetNodeIndex(Node* node) const
+{
+    unsigned id = node->GetID();
+
+    // ReplicatedID => LocalID
+    if (id && replicatedState_ && id < FIRST_LOCAL_ID)
+    {
+        HashMap<unsigned, NodeComponentID >::ConstIterator it = usedLocalIds_.Find(id);
+        if (it == usedLocalIds_.End())
+            return -1;
+        id = it->second_.nodeID_;
+    }
+
+    if (id < firstNodeID_ || id > lastNodeID_ || !numNodeIdsByObject_)
+        return -1;
+
+    const unsigned index = (id - firstNodeID_) / numNodeIdsByObject_;
+    return index < nodes_.Size() && nodes_[index] == node ? (int)index : -1;
 }
 
 unsigned ObjectPoolCategory::GetNextReplicatedNodeID() const
@@ -122,15 +306,33 @@ void ObjectPoolCategory::ChangeToReplicatedID(Node* node, unsigned newid)
 
 Node* ObjectPoolCategory::GetPoolNode(unsigned id)
 {
-    if (!freenodes_.Empty())
+    GAMEPROFILE_COUNT(ObjectPoolGetNode, 1);
+
+    // dry category : clone the new nodes now
+    if (freeindexes_.Empty() && CanGrow())
     {
-        Scene* scene = nodeCategory_->GetScene();
-        Node* node = freenodes_.Back();
+        GAMELOG_WARNINGF(GAMELOG_POOL, "ObjectPoolCategory() - GetPoolNode : %s(hash=%u) ... No Free Node => Grow now !", GOT::GetType(GOT_).CString(), GOT_.Value());
+        Grow();
+        while (!Update(0, 0)) { }
+    }
+
+    if (!freeindexes_.Empty())
+    {
+        const unsigned index = freeindexes_.Back();
+        Node* node = nodes_[index];
         unsigned localID = node->GetID();
 
-        node->AddTag("InUse");
+        SetInUse(index, true);
+
+        freeindexes_.Pop();
+
+        numUsed_++;
+        if (numUsed_ > highWaterMark_)
+            highWaterMark_ = numUsed_;
 
-        freenodes_.Pop();
+        // grow ahead of demand
+        if (freeindexes_.Size() < Max(2U, nodes_.Size() / OBJECTPOOL_LOWFREERATIO) && CanGrow() && updateState_ < 0)
+            Grow();
 
         if (localID < firstNodeID_ || localID > lastNodeID_)
         {
@@ -148,7 +350,7 @@ Node* ObjectPoolCategory::GetPoolNode(unsigned id)
             else
                 ChangeToReplicatedID(node, id);
 //            URHO3D_LOGINFOF("ObjectPoolCategory() - GetPoolNode : %s(localID=%u replicatedID=%u id=%u) free=%u/%u",
-//                                GOT::GetType(GOT_).CString(), localID, currentReplicatedNodeID_, id, freenodes_.Size(), nodes_.Size());
+//                                GOT::GetType(GOT_).CString(), localID, currentReplicatedNodeID_, id, freeindexes_.Size(), nodes_.Size());
         }
 
 //        if (id != LOCAL)
@@ -159,10 +361,10 @@ Node* ObjectPoolCategory::GetPoolNode(unsigned id)
 //                ChangeToReplicatedID(node, id);
 
 //            URHO3D_LOGINFOF("ObjectPoolCategory() - GetPoolNode : %s(localID=%u replicatedID=%u id=%u) free=%u/%u",
-//                                GOT::GetType(GOT_).CString(), localID, currentReplicatedNodeID_, id, freenodes_.Size(), nodes_.Size());
+//                                GOT::GetType(GOT_).CString(), localID, currentReplicatedNodeID_, id, freeindexes_.Size(), nodes_.Size());
 //        }
 //        else
-//            URHO3D_LOGINFOF("ObjectPoolCategory() - GetPoolNode : %s(localID=%u) free=%u/%u", GOT::GetType(GOT_).CString(), localID, freenodes_.Size(), nodes_.Size());
+//            URHO3D_LOGINFOF("ObjectPoolCategory() - GetPoolNode : %s(localID=%u) free=%u/%u", GOT::GetType(GOT_).CString(), localID, freeindexes_.Size(), nodes_.Size());
 
         return node;
     }
@@ -173,7 +375,11 @@ Node* ObjectPoolCategory::GetPoolNode(unsigned id)
 
 bool ObjectPoolCategory::FreePoolNode(Node* node, bool cleanDependences)
 {
-    if (!freenodes_.Contains(node))
+    GAMEPROFILE_COUNT(ObjectPoolFreeNode, 1);
+
+    int index = GetNodeIndex(node);
+
+    if (index == -1 || IsInUse(index))
     {
         unsigned id = node->GetID();
         unsigned localid = id;
@@ -214,6 +420,13 @@ bool ObjectPoolCategory::FreePoolNode(Node* node, bool cleanDependences)
             return false;
         }
 
+        if (index == -1)
+        {
+            URHO3D_LOGERRORF("ObjectPoolCategory() - FreePoolNode : type=%s localid=%u(%u) ptr=%u ... not a node of the category !",
+                                GOT::GetType(GOT_).CString(), localid, id, node);
+            return false;
+        }
+
         // clean dependences in the components (ex : clear triggers in animatedSprite2D)
         if (cleanDependences)
         {
@@ -222,8 +435,7 @@ bool ObjectPoolCategory::FreePoolNode(Node* node, bool cleanDependences)
                 (*it)->CleanDependences();
         }
 
-        GameHelpers::CopyAttributes(template_, node, false);
-        node->RemoveAllTags();
+        snapshot_.Restore(node);
 
         /// Restore poolnode to Category node
         // Prevent SceneCleaner to Remove ObjectPool Nodes
@@ -236,10 +448,12 @@ bool ObjectPoolCategory::FreePoolNode(Node* node, bool cleanDependences)
 
         node->ApplyAttributes();
 
-        freenodes_.Push(node);
+        SetInUse(index, false);
+        freeindexes_.Push(index);
+        numUsed_--;
 
 //        URHO3D_LOGINFOF("ObjectPoolCategory() - FreePoolNode : type=%s localid=%u(%u) ptr=%u restored to the pool (free=%u/%u) !",
-//                GOT::GetType(GOT_).CString(), localid, id, node, freenodes_.Size(), nodes_.Size());
+//                GOT::GetType(GOT_).CString(), localid, id, node, freeindexes_.Size(), nodes_.Size());
 
         return true;
     }
@@ -251,7 +465,9 @@ bool ObjectPoolCategory::Create(bool replicate, const StringHash& got, Node* nod
 {
     template_.Reset();
     nodes_.Clear();
-    freenodes_.Clear();
+    freeindexes_.Clear();
+    inuse_.Clear();
+    snapshot_.Clear();
 
     if (!templateNode)
     {
@@ -262,7 +478,9 @@ bool ObjectPoolCategory::Create(bool replicate, const StringHash& got, Node* nod
     template_ = templateNode;
     GOT_ = got;
     gotinfo_ = &GOT::GetConstInfo(GOT_);
-    requestedSize_ = 0;
+    requestedSize_ = capacity_ = 0;
+    firstUpdatedNode_ = numUsed_ = highWaterMark_ = 0;
+    updateState_ = -1;
 
     if (nodeCategory_)
     {
@@ -299,30 +517,35 @@ bool ObjectPoolCategory::Create(bool replicate, const StringHash& got, Node* nod
     numNodeIdsByObject_ = 1 + template_->GetChildren().Size();
     numComponentIdsByObject_ = template_->GetNumComponents();
 
-    URHO3D_LOGINFOF("ObjectPoolCategory() - Create : type=%s(%u) ... CreateMode=%s templateID=%u NodeCategoryId=%u LOCAL n=%u c=%u REPLI n=%u c=%u(%u) ... OK !",
-                    GOT::GetType(GOT_).CString(), GOT_.Value(), replicatedState_ ? "REPLICATED":"LOCAL", template_->GetID(), nodeCategory_->GetID(),
-                    firstNodeID_, firstComponentID_, firstReplicatedNodeID_, firstReplicatedComponentID_, ids[3]);
+    GAMELOG_INFOF(GAMELOG_POOL, "ObjectPoolCategory() - Create : type=%s(%u) ... CreateMode=%s templateID=%u NodeCategoryId=%u LOCAL n=%u c=%u REPLI n=%u c=%u(%u) ... OK !",
+                  GOT::GetType(GOT_).CString(), GOT_.Value(), replicatedState_ ? "REPLICATED":"LOCAL", template_->GetID(), nodeCategory_->GetID(),
+                  firstNodeID_, firstComponentID_, firstReplicatedNodeID_, firstReplicatedComponentID_, ids[3]);
 
     GameHelpers::DumpNode(template_, 0, true);
 
+    snapshot_.Take(template_);
+
     return true;
 }
 
-void ObjectPoolCategory::Resize(unsigned size)
+void ObjectPoolCategory::Resize(unsigned size, unsigned capacity)
 {
+    capacity_ = Max(size, capacity);
     requestedSize_ = size;
+    firstUpdatedNode_ = nodes_.Size();
     updateState_ = 0;
 
-    nodes_.Reserve(size);
-    freenodes_.Reserve(size);
+    nodes_.Reserve(capacity_);
+    freeindexes_.Reserve(capacity_);
+    inuse_.Reserve((capacity_ + 31) >> 5);
 
-    // Calculate the last Ids
-    lastNodeID_ = firstNodeID_ + numNodeIdsByObject_ * size - 1;
-    lastComponentID_ = firstComponentID_ + numComponentIdsByObject_ * size - 1;
+    // Calculate the last Ids : the ids are reserved for the capacity
+    lastNodeID_ = firstNodeID_ + numNodeIdsByObject_ * capacity_ - 1;
+    lastComponentID_ = firstComponentID_ + numComponentIdsByObject_ * capacity_ - 1;
     if (replicatedState_)
     {
-        lastReplicatedNodeID_ = firstReplicatedNodeID_ + numNodeIdsByObject_ * size - 1 ;
-        lastReplicatedComponentID_ = firstReplicatedComponentID_ + numComponentIdsByObject_ * size - 1;
+        lastReplicatedNodeID_ = firstReplicatedNodeID_ + numNodeIdsByObject_ * capacity_ - 1 ;
+        lastReplicatedComponentID_ = firstReplicatedComponentID_ + numComponentIdsByObject_ * capacity_ - 1;
     }
     else
     {
@@ -330,20 +553,45 @@ void ObjectPoolCategory::Resize(unsigned size)
         lastReplicatedComponentID_ = 0;
     }
 
-    URHO3D_LOGINFOF("ObjectPoolCategory() - Resize type=%s(%u) CreateMode=%s templateID=%u size=%u LOCAL n=%u->%u c=%u->%u REPLI n=%u->%u c=%u->%u ... OK !",
-                    GOT::GetType(GOT_).CString(), GOT_.Value(), replicatedState_ ? "REPLICATED":"LOCAL", template_->GetID(), size,
-                    firstNodeID_, lastNodeID_, firstComponentID_, lastComponentID_,
-                    firstReplicatedNodeID_, lastReplicatedNodeID_, firstReplicatedComponentID_, lastReplicatedComponentID_);
+    GAMELOG_INFOF(GAMELOG_POOL, "ObjectPoolCategory() - Resize type=%s(%u) CreateMode=%s templateID=%u size=%u capacity=%u LOCAL n=%u->%u c=%u->%u REPLI n=%u->%u c=%u->%u ... OK !",
+                  GOT::GetType(GOT_).CString(), GOT_.Value(), replicatedState_ ? "REPLICATED":"LOCAL", template_->GetID(), size, capacity_,
+                  firstNodeID_, lastNodeID_, firstComponentID_, lastComponentID_,
+                  firstReplicatedNodeID_, lastReplicatedNodeID_, firstReplicatedComponentID_, lastReplicatedComponentID_);
+}
+
+void ObjectPoolCategory::Grow()
+{
+    if (!CanGrow())
+        return;
+
+    const unsigned size = Min(capacity_, requestedSize_ + Max((unsigned)DEFAULT_NUMOBJECTS, requestedSize_ / 2));
+
+    GAMELOG_INFOF(GAMELOG_POOL, "ObjectPoolCategory() - Grow : type=%s(%u) size=%u => %u (used=%u highwatermark=%u capacity=%u)",
+                    GOT::GetType(GOT_).CString(), GOT_.Value(), requestedSize_, size, numUsed_, highWaterMark_, capacity_);
+
+    // the cloning can be already in progress
+    if (updateState_ < 0)
+    {
+        firstUpdatedNode_ = nodes_.Size();
+        updateState_ = 0;
+    }
+    requestedSize_ = size;
+
+    if (ObjectPool::Get())
+        ObjectPool::Get()->AddCategoryToUpdate(this);
 }
 
 bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
 {
+    if (updateState_ < 0)
+        return true;
+
     if (updateState_ == 0)
     {
         unsigned nodeid = firstNodeID_ + numNodeIdsByObject_ * nodes_.Size();
         unsigned componentid = firstComponentID_ + numComponentIdsByObject_ * nodes_.Size();
 
-        URHO3D_LOGINFOF("ObjectPoolCategory() - Update : Resize type=%s(%u) ... Clone Template => PoolSize=%u/%u ... (nodeid=%u, componentid=%u)",
+        GAMELOG_INFOF(GAMELOG_POOL, "ObjectPoolCategory() - Update : Resize type=%s(%u) ... Clone Template => PoolSize=%u/%u ... (nodeid=%u, componentid=%u)",
                         GOT::GetType(GOT_).CString(), GOT_.Value(), nodes_.Size(), requestedSize_, nodeid, componentid);
 
         while (nodes_.Size() < requestedSize_)
@@ -357,8 +605,10 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
                 return true;
             }
 
+            if (inuse_.Size() < ((nodes_.Size() + 32) >> 5))
+                inuse_.Push(0);
+            SetInUse(nodes_.Size(), false);
             nodes_.Push(node);
-            freenodes_.Push(node.Get());
 
             if (nodes_.Size() < requestedSize_ && timer && timer->GetUSec(false) > delay)
                 return false;
@@ -367,7 +617,7 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
             componentid += numComponentIdsByObject_;
         }
 
-        updateState_++;
+        updateState_ = firstUpdatedNode_ + 1;
     }
 
     if (updateState_ > 0)
@@ -375,25 +625,39 @@ bool ObjectPoolCategory::Update(HiresTimer* timer, const long long& delay)
         unsigned inode = updateState_-1;
         Node* node;
 
-        URHO3D_LOGINFOF("ObjectPoolCategory() - Update : Resize type=%s(%u) ... Apply Attributes => PoolSize=%u/%u ...",
+        GAMELOG_INFOF(GAMELOG_POOL, "ObjectPoolCategory() - Update : Resize type=%s(%u) ... Apply Attributes => PoolSize=%u/%u ...",
                         GOT::GetType(GOT_).CString(), GOT_.Value(), inode, requestedSize_);
 
-        while (inode < requestedSize_)
+        while (inode < nodes_.Size())
         {
             node = nodes_[inode];
 
             node->ApplyAttributes();
 
+            // the node is available when its attributes are applied
+            freeindexes_.Push(inode);
+
             inode++;
 
-            if (inode < requestedSize_ && timer && timer->GetUSec(false) > delay)
+            if (inode < nodes_.Size() && timer && timer->GetUSec(false) > delay)
             {
                 updateState_ = inode + 1;
                 return false;
             }
         }
 
-        URHO3D_LOGINFOF("ObjectPoolCategory() - Update : Resize type=%s(%u) ... OK !", GOT::GetType(GOT_).CString(), GOT_.Value());
+        // grown during the update : clone the new requested nodes
+        if (nodes_.Size() < requestedSize_)
+        {
+            firstUpdatedNode_ = nodes_.Size();
+            updateState_ = 0;
+            return false;
+        }
+
+        GAMELOG_INFOF(GAMELOG_POOL, "ObjectPoolCategory() - Update : Resize type=%s(%u) ... OK !", GOT::GetType(GOT_).CString(), GOT_.Value());
+
+        firstUpdatedNode_ = nodes_.Size();
+        updateState_ = -1;
 
 //        Dump();
         return true;
@@ -455,23 +719,23 @@ void ObjectPoolCategory::RestoreObjects(bool allObjects)
 
 void ObjectPoolCategory::Dump(bool logonlyerrors) const
 {
-    URHO3D_LOGINFOF("ObjectPoolCategory() - Dump() : category=%s(%u) - free=%u/%u localids=(%u->%u) replicatedids=(%u->%u)",
-                    GOT::GetType(GOT_).CString(), GOT_.Value(), GetFreeSize(), GetSize(),
+    URHO3D_LOGINFOF("ObjectPoolCategory() - Dump() : category=%s(%u) - free=%u/%u highwatermark=%u capacity=%u localids=(%u->%u) replicatedids=(%u->%u)",
+                    GOT::GetType(GOT_).CString(), GOT_.Value(), GetFreeSize(), GetSize(), highWaterMark_, capacity_,
                     firstNodeID_, lastNodeID_, firstReplicatedNodeID_, lastReplicatedNodeID_);
 
     if (!logonlyerrors)
-        for (unsigned i=0; i <freenodes_.Size(); i++)
+        for (unsigned i=0; i <freeindexes_.Size(); i++)
         {
-            Node* node = freenodes_[i];
+            Node* node = nodes_[freeindexes_[i]];
             if (!node || node->GetID() < firstNodeID_ || node->GetID() > lastNodeID_)
                 URHO3D_LOGERRORF("-> freenode[%d] : ptr=%u id=%u", i, node, node ? node->GetID():0);
             else
                 URHO3D_LOGINFOF("-> freenode[%d] : ptr=%u id=%u", i, node, node ? node->GetID():0);
         }
     else
-        for (unsigned i=0; i <freenodes_.Size(); i++)
+        for (unsigned i=0; i <freeindexes_.Size(); i++)
         {
-            Node* node = freenodes_[i];
+            Node* node = nodes_[freeindexes_[i]];
             if (!node || node->GetID() < firstNodeID_ || node->GetID() > lastNodeID_)
                 URHO3D_LOGERRORF("-> freenode[%d] : ptr=%u id=%u", i, node, node ? node->GetID():0);
         }
@@ -482,6 +746,7 @@ void ObjectPoolCategory::Dump(bool logonlyerrors) const
 ObjectPool* ObjectPool::pool_ = 0;
 CreateMode ObjectPool::createChildMode_ = LOCAL;
 String ObjectPool::debugTxt_;
+HashMap<StringHash, unsigned> ObjectPool::learnedSizes_;
 
 void ObjectPool::Reset(Node* node)
 {
@@ -513,6 +778,8 @@ ObjectPool::ObjectPool(Context* context) :
     createstate_(0)
 {
     SetCreateChildMode(LOCAL);
+
+    SubscribeToEvent(E_ENDFRAME, URHO3D_HANDLER(ObjectPool, HandleEndFrame));
 }
 
 ObjectPool::~ObjectPool()
@@ -546,7 +813,10 @@ void ObjectPool::Stop()
 {
     URHO3D_LOGINFO("ObjectPool() - Stop ...");
 
+    SaveLearnedSizes();
+
     createstate_ = 0;
+    categoriesToUpdate_.Clear();
     categories_.Clear();
 
     GameHelpers::RemoveNodeSafe(nodePool_, false);
@@ -577,16 +847,128 @@ ObjectPoolCategory* ObjectPool::CreateCategory(const GOTInfo& info, Node* templa
         }
     }
 
-    category.Resize(info.poolqty_);
+    unsigned size, capacity;
+    GetCategorySizes(got, info, size, capacity);
+    category.Resize(size, capacity);
 
 	return &category;
 }
 
+void ObjectPool::AddCategoryToUpdate(ObjectPoolCategory* category)
+{
+    if (!categoriesToUpdate_.Contains(category))
+        categoriesToUpdate_.Push(category);
+}
+
+void ObjectPool::GetCategorySizes(const StringHash& got, const GOTInfo& info, unsigned& size, unsigned& capacity)
+{
+    size = info.poolqty_;
+
+    // the replicated categories keep the same ids on all the peers
+    if (info.replicatedMode_)
+    {
+        capacity = size;
+        return;
+    }
+
+    HashMap<StringHash, unsigned>::ConstIterator it = learnedSizes_.Find(got);
+    if (it != learnedSizes_.End())
+        size = Max(size, it->second_ + it->second_ / OBJECTPOOL_LOWFREERATIO + 1);
+
+    capacity = size * OBJECTPOOL_GROWTHFACTOR;
+}
+
+void ObjectPool::LoadLearnedSizes()
+{
+    learnedSizes_.Clear();
+
+    const String filename = GameStatics::gameConfig_.saveDir_ + OBJECTPOOL_SIZESFILE;
+    if (!GameStatics::context_->GetSubsystem<FileSystem>()->FileExists(filename))
+        return;
+
+    File file(GameStatics::context_, filename, FILE_READ);
+    if (!file.IsOpen() || file.ReadFileID() != OBJECTPOOL_SIZESFILEID)
+    {
+        URHO3D_LOGWARNINGF("ObjectPool() - LoadLearnedSizes : %s is not a pool sizes file !", filename.CString());
+        return;
+    }
+
+    unsigned numsizes = file.ReadVLE();
+    while (numsizes--)
+    {
+        StringHash got(file.ReadUInt());
+        learnedSizes_[got] = file.ReadUInt();
+    }
+
+    URHO3D_LOGINFOF("ObjectPool() - LoadLearnedSizes : %s => %u sizes", filename.CString(), learnedSizes_.Size());
+}
+
+void ObjectPool::SaveLearnedSizes()
+{
+    if (!categories_.Size())
+        return;
+
+    for (HashMap<StringHash, ObjectPoolCategory >::ConstIterator it=categories_.Begin();it!=categories_.End();++it)
+    {
+        const ObjectPoolCategory& category = it->second_;
+        if (category.HasReplicatedMode())
+            continue;
+
+        unsigned& size = learnedSizes_[it->first_];
+        size = Max(size, category.GetHighWaterMark());
+    }
+
+    const String filename = GameStatics::gameConfig_.saveDir_ + OBJECTPOOL_SIZESFILE;
+    File file(GameStatics::context_, filename, FILE_WRITE);
+    if (!file.IsOpen())
+    {
+        URHO3D_LOGWARNINGF("ObjectPool() - SaveLearnedSizes : can't open %s !", filename.CString());
+        return;
+    }
+
+    file.WriteFileID(OBJECTPOOL_SIZESFILEID);
+    file.WriteVLE(learnedSizes_.Size());
+    for (HashMap<StringHash, unsigned>::ConstIterator it=learnedSizes_.Begin();it!=learnedSizes_.End();++it)
+    {
+        file.WriteUInt(it->first_.Value());
+        file.WriteUInt(it->second_);
+    }
+
+    URHO3D_LOGINFOF("ObjectPool() - SaveLearnedSizes : %s => %u sizes", filename.CString(), learnedSizes_.Size());
+}
+
+/// the categories grow in the idle time of the frames
+void ObjectPool::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    if (createstate_ < 3 || categoriesToUpdate_.Empty())
+        return;
+
+    GAMEPROFILE(ObjectPoolResize);
+    GAMEALLOC_SCOPE(GAMEALLOC_OBJECTPOOL);
+
+    HiresTimer timer;
+
+    while (categoriesToUpdate_.Size())
+    {
+        ObjectPoolCategory* category = categoriesToUpdate_.Front();
+
+        if (!category->Update(&timer, OBJECTPOOL_GROWDELAY))
+            return;
+
+        categoriesToUpdate_.PopFront();
+
+        if (timer.GetUSec(false) > OBJECTPOOL_GROWDELAY)
+            return;
+    }
+}
+
 bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInfo >& infos, const HashMap<StringHash, WeakPtr<Node> >& templates, HiresTimer* timer, const long long& delay)
 {
     // Reserve Scene Ids
     if (createstate_ == 0)
     {
+        LoadLearnedSizes();
+
         // Get Scene Next Free Ids
         firstReplicatedNodeID_ = lastReplicatedNodeID_ = scene->GetNextFreeReplicatedNodeID();
         firstReplicatedComponentID_ = lastReplicatedComponentID_ = scene->GetNextFreeReplicatedComponentID();
@@ -614,7 +996,8 @@ bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInf
             }
 
             Node* node = itt->second_;
-            unsigned numObjects = info.poolqty_;
+            unsigned numObjects, poolsize;
+            GetCategorySizes(got, info, poolsize, numObjects);
             unsigned numNodes = 1 + node->GetChildren().Size();
             unsigned numComponents = node->GetNumComponents();
             if (info.replicatedMode_)
@@ -687,7 +1070,8 @@ bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInf
                 continue;
 
             Node* node = itt->second_;
-            unsigned numObjects = info.poolqty_;
+            unsigned numObjects, poolsize;
+            GetCategorySizes(got, info, poolsize, numObjects);
             unsigned numNodes = 1 + node->GetChildren().Size();
             unsigned numComponents = node->GetNumComponents();
             if (info.replicatedMode_)
@@ -729,10 +1113,10 @@ bool ObjectPool::CreateCategories(Scene* scene, const HashMap<StringHash, GOTInf
             categoriesToUpdate_.PopFront();
         }
 
-        return true;
+        createstate_++;
     }
 
-    return false;
+    return createstate_ == 3;
 }
 
 ObjectPoolCategory* ObjectPool::GetCategory(const StringHash& got)
@@ -744,6 +1128,8 @@ ObjectPoolCategory* ObjectPool::GetCategory(const StringHash& got)
 
 Node* ObjectPool::CreateChildIn(const StringHash& got, Node* parent, unsigned id, int viewZ, const NodeAttributes* nodeAttr, bool applyAttr, ObjectPoolCategory** retcategory)
 {
+    GAMEALLOC_SCOPE(GAMEALLOC_OBJECTPOOL);
+
     if (got == StringHash::ZERO)
         return 0;
 
@@ -816,6 +1202,8 @@ void ObjectPool::ChangeToReplicatedID(Node* node, unsigned newid)
 
 bool ObjectPool::Free(Node* node)
 {
+    GAMEALLOC_SCOPE(GAMEALLOC_OBJECTPOOL);
+
     if (!node)
         return false;
 
@@ -25,6 +25,42 @@ struct NodeComponentID
     unsigned componentID_;
 };
 
+/// Attribute Snapshot : the file attributes of a template node and of its components, taken once.
+/// The plain data attributes (with an offset) are restored with memcpy, the others with OnSetAttribute.
+/// The classes that override OnSetAttribute (Constraint2D, Light, Zone, Terrain, Octree) are restored with OnSetAttribute only.
+struct ObjectPoolSnapshot
+{
+    void Take(Node* node);
+    void Restore(Node* node) const;
+    void Clear() { serializables_.Clear(); }
+
+    struct DataEntry
+    {
+        unsigned offset_;
+        unsigned size_;
+        unsigned dataoffset_;
+    };
+
+    struct SerializableSnapshot
+    {
+        SerializableSnapshot() : networkdata_(false) { }
+
+        void Take(Serializable* serializable);
+        void Restore(Serializable* serializable) const;
+
+        StringHash type_;
+        /// a plain data attribute is a network attribute : MarkNetworkUpdate after the copy
+        bool networkdata_;
+        PODVector<unsigned char> data_;
+        PODVector<DataEntry> dataentries_;
+        PODVector<unsigned> attributes_;
+        Vector<Variant> values_;
+    };
+
+    /// [0] : the node, [i+1] : the component i
+    Vector<SerializableSnapshot> serializables_;
+};
+
 class ObjectPoolCategory : public RefCounted
 {
 friend class ObjectPool;
@@ -37,7 +73,7 @@ public :
     ObjectPoolCategory& operator = (const ObjectPoolCategory& obj) { return *this; }
 
     bool Create(bool replicate, const StringHash& GOT, Node* nodePool, Node* templateNode, unsigned* ids);
-    void Resize(unsigned size);
+    void Resize(unsigned size, unsigned capacity=0);
     void SetIds(CreateMode mode, unsigned firstNodeID=0, unsigned firstComponentID=0);
     void SynchronizeReplicatedNodes(unsigned startNodeID);
     void SetCurrentReplicatedIDs(unsigned id);
@@ -54,7 +90,11 @@ public :
     unsigned GetFirstComponentID(CreateMode mode) const { return mode == REPLICATED && replicatedState_ ? firstReplicatedComponentID_ : firstComponentID_; }
     unsigned GetLastComponentID(CreateMode mode) const { return mode == REPLICATED && replicatedState_ ? lastReplicatedComponentID_ :  lastComponentID_; }
     unsigned GetSize() const { return nodes_.Size(); }
-    unsigned GetFreeSize() const { return freenodes_.Size(); }
+    unsigned GetFreeSize() const { return freeindexes_.Size(); }
+    unsigned GetCapacity() const { return capacity_; }
+    unsigned GetHighWaterMark() const { return highWaterMark_; }
+    /// the local categories grow in their reserved ids (capacity), the replicated categories keep their size (same ids on all peers)
+    bool CanGrow() const { return !replicatedState_ && requestedSize_ < capacity_; }
 
     Node* GetPoolNode(unsigned id=0);
     Node* GetPoolNode(CreateMode mode=LOCAL);
@@ -70,16 +110,30 @@ public :
 
 private :
     bool Update(HiresTimer* timer, const long long& delay);
+    /// request new nodes, cloned by ObjectPool in the idle frames
+    void Grow();
+
+    /// the index of a pool node in nodes_ (with its local or replicated id), -1 if not a pool node
+    int GetNodeIndex(Node* node) const;
+    bool IsInUse(unsigned index) const { return (inuse_[index >> 5] >> (index & 31)) & 1U; }
+    void SetInUse(unsigned index, bool state) { if (state) inuse_[index >> 5] |= (1U << (index & 31)); else inuse_[index >> 5] &= ~(1U << (index & 31)); }
 
     StringHash GOT_;
     const GOTInfo* gotinfo_;
     unsigned requestedSize_;
+    unsigned capacity_;
+    unsigned firstUpdatedNode_;
+    unsigned numUsed_;
+    unsigned highWaterMark_;
     int updateState_;
 
     WeakPtr<Node> nodeCategory_;
     WeakPtr<Node> template_;
     Vector<SharedPtr<Node> > nodes_;
-    PODVector<Node* > freenodes_;
+    /// free list (indexes in nodes_) and in-use bitmap
+    PODVector<unsigned> freeindexes_;
+    PODVector<unsigned> inuse_;
+    ObjectPoolSnapshot snapshot_;
     bool replicatedState_;
 
     HashMap<unsigned, NodeComponentID > usedLocalIds_;
@@ -98,6 +152,7 @@ public :
     ~ObjectPool();
 
     ObjectPoolCategory* CreateCategory(const GOTInfo& info, Node* templateNode, unsigned* ids);
+    void AddCategoryToUpdate(ObjectPoolCategory* category);
     void ResizeCategory(ObjectPoolCategory& category, unsigned size);
     bool CreateCategories(Scene* scene, const HashMap<StringHash, GOTInfo >& infos, const HashMap<StringHash, WeakPtr<Node> >& templates, HiresTimer* timer, const long long& delay);
 
@@ -124,6 +179,13 @@ public :
 private :
     static void UpdateDebugData();
 
+    /// Learned sizes : the high-water marks of the categories, saved between the sessions
+    static void GetCategorySizes(const StringHash& got, const GOTInfo& info, unsigned& size, unsigned& capacity);
+    static void LoadLearnedSizes();
+    void SaveLearnedSizes();
+
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+
     WeakPtr<Node> nodePool_;
     HashMap<StringHash, ObjectPoolCategory > categories_;
 
@@ -142,4 +204,5 @@ private :
 
     static ObjectPool* pool_;
     static String debugTxt_;
+    static HashMap<StringHash, unsigned> learnedSizes_;
 };
@@ -1,6 +1,9 @@
 #pragma once
 
-#include <Urho3D/Container/List.h>
+#include <new>
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/IO/Log.h>
 
 namespace Urho3D
 {
@@ -11,10 +14,14 @@ namespace Urho3D
 using namespace Urho3D;
 
 
+/// Pool
+/// the instances are constructed in slabs (contiguous arrays of slots) and stay constructed until Delete.
+/// The free slots are linked in an intrusive free list : Get and Free are constant time without allocation.
+/// A slab is added when the free list is empty (miss), with the size of the pool (doubling).
 template <class T> class Pool
 {
 public:
-    Pool()  { }
+    Pool() : context_(0), freelist_(0), capacity_(0), live_(0), peak_(0), misses_(0) { }
     ~Pool() { Delete(); }
 
     void Resize(Context* context, unsigned size)
@@ -28,55 +35,128 @@ public:
 
     T* Get()
     {
-        if (!freeinstances_.Size())
-            Allocate(instances_.Size());
-
-        if (freeinstances_.Size())
+        if (!freelist_ && capacity_)
         {
-            T* instance = freeinstances_.Back();
-            freeinstances_.Pop();
-            return instance;
+            misses_++;
+            Allocate(capacity_);
         }
 
-        return 0;
+        if (!freelist_)
+            return 0;
+
+        Slot* slot = freelist_;
+        freelist_ = slot->nextfree_;
+        slot->nextfree_ = 0;
+        slot->free_ = false;
+
+        live_++;
+        if (live_ > peak_)
+            peak_ = live_;
+
+        return slot->Get();
     }
 
     void Free(T* instance)
     {
-        if (!instances_.Size())
+        if (!instance || !capacity_)
+            return;
+
+        // the object is at the start of its slot
+        Slot* slot = reinterpret_cast<Slot*>(instance);
+        if (slot->free_)
             return;
-        freeinstances_.PushFront(instance);
+
+        slot->free_ = true;
+        slot->nextfree_ = freelist_;
+        freelist_ = slot;
+        live_--;
     }
 
+    /// Free all the used instances with their Free method
     void FreeAll()
     {
-        freeinstances_.Clear();
-        for (unsigned i = 0; i < instances_.Size(); i++)
-            instances_[i]->Free();
+        for (unsigned i = 0; i < slabs_.Size(); i++)
+        {
+            Slot* slots = slabs_[i].slots_;
+            for (unsigned j = 0; j < slabs_[i].size_; j++)
+                if (!slots[j].free_)
+                    slots[j].Get()->Free();
+        }
+    }
+
+    unsigned GetCapacity() const { return capacity_; }
+    unsigned GetNumLive() const { return live_; }
+    unsigned GetPeak() const { return peak_; }
+    unsigned GetNumMisses() const { return misses_; }
+
+    void Dump() const
+    {
+        URHO3D_LOGINFOF("Pool<%s>() - Dump : slabs=%u capacity=%u live=%u peak=%u misses=%u",
+                        T::GetTypeNameStatic().CString(), slabs_.Size(), capacity_, live_, peak_, misses_);
     }
 
 private:
+    struct Slot
+    {
+        T* Get() { return reinterpret_cast<T*>(storage_); }
+
+        alignas(T) unsigned char storage_[sizeof(T)];
+        Slot* nextfree_;
+        bool free_;
+    };
+
+    struct Slab
+    {
+        Slot* slots_;
+        unsigned size_;
+    };
+
     void Allocate(unsigned size)
     {
-        if (!context_)
+        if (!context_ || !size)
             return;
 
-        for (unsigned i = 0; i < size; i++)
+        Slab slab;
+        slab.slots_ = static_cast<Slot*>(::operator new(sizeof(Slot) * size));
+        slab.size_ = size;
+        slabs_.Push(slab);
+
+        // link in order : the first slots of the slab are given first
+        for (int j = (int)size-1; j >= 0; j--)
         {
-            instances_.Push(new T(context_));
-            freeinstances_.Push(instances_.Back());
+            Slot& slot = slab.slots_[j];
+            new (slot.storage_) T(context_);
+            slot.free_ = true;
+            slot.nextfree_ = freelist_;
+            freelist_ = &slot;
         }
+
+        capacity_ += size;
     }
+
     void Delete()
     {
-        for (unsigned i=0; i < instances_.Size(); i++)
-            delete instances_[i];
+        if (!slabs_.Size())
+            return;
+
+        if (context_)
+            Dump();
+
+        for (unsigned i = 0; i < slabs_.Size(); i++)
+        {
+            Slot* slots = slabs_[i].slots_;
+            for (unsigned j = 0; j < slabs_[i].size_; j++)
+                slots[j].Get()->~T();
+            ::operator delete(slots);
+        }
 
-        instances_.Clear();
-        freeinstances_.Clear();
+        slabs_.Clear();
+        freelist_ = 0;
+        capacity_ = live_ = peak_ = misses_ = 0;
     }
 
     Context* context_;
-    Vector<T* > instances_;
-    List<T* > freeinstances_;
+    PODVector<Slab> slabs_;
+    Slot* freelist_;
+    unsigned capacity_, live_, peak_, misses_;
 };
@@ -52,14 +52,26 @@ void TextMessage::FreeAll()
 }
 
 
-TextMessage::TextMessage() : Object(0) { }
-TextMessage::TextMessage(Context* context) : Object(context) { }
-TextMessage::TextMessage(const TextMessage& timer) : Object(timer.GetContext()) { }
-TextMessage::~TextMessage() { }
+enum
+{
+    TEXTMESSAGE_SHOW = 1,
+    TEXTMESSAGE_HIDE,
+    TEXTMESSAGE_REMOVE,
+};
+
+
+TextMessage::TextMessage() : Object(0), handle_(0) { }
+TextMessage::TextMessage(Context* context) : Object(context), handle_(0) { }
+TextMessage::TextMessage(const TextMessage& timer) : Object(timer.GetContext()), handle_(0) { }
+TextMessage::~TextMessage()
+{
+    TimerWheel::CancelTimer(handle_);
+}
 
 void TextMessage::Free()
 {
     UnsubscribeFromEvent(E_UPDATE);
+    TimerWheel::CancelTimer(handle_);
 
     if (type_== 0)
     {
@@ -108,12 +120,12 @@ TextMessage* TextMessage::Set(Node* node, const String& message, const char *fon
     velocityY = GameRand::GetRand(ALLRAND, 2) + 1.f;
 
     autoRemove_ = autoRemove;
-    expirationTime1_ = delayedStart;
+    expirationTime1_ = TimerWheel::GetClockTime(TIMERCLOCK_UPDATE) + delayedStart;
     expirationTime2_ = expirationTime1_ + duration;
     expirationTime3_ = expirationTime2_ + delayedRemove;
-    timer_ = 0.0f;
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate1_3D));
+    TimerWheel::CancelTimer(handle_);
+    handle_ = TimerWheel::Get()->AddAt(this, expirationTime1_, TEXTMESSAGE_SHOW);
 
     return this;
 }
@@ -153,23 +165,24 @@ TextMessage* TextMessage::Set(const String& message, const char *fontName, int f
     text_->SetVisible(false);
 
     autoRemove_ = autoRemove;
-    expirationTime1_ = delayedStart;
+    expirationTime1_ = TimerWheel::GetClockTime(TIMERCLOCK_UPDATE) + delayedStart;
     expirationTime2_ = expirationTime1_ + duration;
     expirationTime3_ = expirationTime2_ + delayedRemove;
-    timer_ = 0.0f;
 
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate1));
+    TimerWheel::CancelTimer(handle_);
+    handle_ = TimerWheel::Get()->AddAt(this, expirationTime1_, TEXTMESSAGE_SHOW);
 
     return this;
 }
 
 void TextMessage::SetDuration(float duration)
 {
-    expirationTime2_ = duration;
+    expirationTime2_ = TimerWheel::GetClockTime(TIMERCLOCK_UPDATE) + duration;
     expirationTime3_ = expirationTime2_;
-    timer_ = 0.0f;
     text_->SetVisible(true);
-    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate2));
+
+    TimerWheel::CancelTimer(handle_);
+    handle_ = TimerWheel::Get()->AddAt(this, expirationTime2_, TEXTMESSAGE_HIDE);
 }
 
 void TextMessage::SetColor(const Color& colorTL, const Color& colorTR, const Color& colorBL, const Color& colorBR)
@@ -190,108 +203,74 @@ void TextMessage::SetColor(const Color& colorTL, const Color& colorTR, const Col
     }
 }
 
-void TextMessage::HandleUpdate1(StringHash eventType, VariantMap& eventData)
+void TextMessage::OnTimer(unsigned phase)
 {
-    timer_ += eventData[Update::P_TIMESTEP].GetFloat();
-    if (timer_ > expirationTime1_)
+    handle_ = 0;
+
+    if (phase == TEXTMESSAGE_SHOW)
     {
-        if (!text_)
+        if ((type_== 0 && !text_) || (type_ == 1 && !node_))
         {
             Free();
-            URHO3D_LOGERRORF("TextMessage() - handleUpdate1 : no text !");
+            URHO3D_LOGERRORF("TextMessage() - OnTimer : no text !");
             return;
         }
 
-        text_->SetVisible(true);
-
-        UnsubscribeFromEvent(E_UPDATE);
-        SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate2));
-    }
-}
-
-void TextMessage::HandleUpdate1_3D(StringHash eventType, VariantMap& eventData)
-{
-    timer_ += eventData[Update::P_TIMESTEP].GetFloat();
-    if (timer_ > expirationTime1_)
-    {
-        if (!node_)
+        if (type_ == 0)
         {
-            Free();
-            URHO3D_LOGERRORF("TextMessage() - handleUpdate1_3D : no text !");
-            return;
+            text_->SetVisible(true);
+        }
+        else
+        {
+            node_->SetEnabled(true);
+            SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate2_3D));
         }
-        node_->SetEnabled(true);
 
-        UnsubscribeFromEvent(E_UPDATE);
-        SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate2_3D));
+        handle_ = TimerWheel::Get()->AddAt(this, expirationTime2_, TEXTMESSAGE_HIDE);
     }
-}
-
-void TextMessage::HandleUpdate2(StringHash eventType, VariantMap& eventData)
-{
-    timer_ += eventData[Update::P_TIMESTEP].GetFloat();
-
-    if (timer_ > expirationTime2_)
+    else if (phase == TEXTMESSAGE_HIDE)
     {
         UnsubscribeFromEvent(E_UPDATE);
 
-        if (!text_)
+        if ((type_== 0 && !text_) || (type_ == 1 && !node_))
         {
             Free();
             return;
         }
-        text_->SetVisible(false);
+
+        if (type_ == 0)
+            text_->SetVisible(false);
+        else
+            node_->SetEnabled(false);
 
         SendEvent(TEXTMESSAGE_EXPIRED);
 
         if (expirationTime3_ > expirationTime2_)
-            SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate3));
+            handle_ = TimerWheel::Get()->AddAt(this, expirationTime3_, TEXTMESSAGE_REMOVE);
         else
             if (autoRemove_)
                 Free();
     }
-}
-
-void TextMessage::HandleUpdate2_3D(StringHash eventType, VariantMap& eventData)
-{
-    float timeStep = eventData[Update::P_TIMESTEP].GetFloat();
-    timer_ += timeStep;
-
-    node_->Translate(Vector3(GameRand::GetRand(ALLRAND, 10) < 5 ? -timeStep : timeStep, velocityY * timeStep, 0.f));
-    node_->SetScale(node_->GetScale()*1.005f);
-    text3D_->SetOpacity(text3D_->GetOpacity()-timeStep);
-
-    if (timer_ > expirationTime2_)
+    else
     {
-        UnsubscribeFromEvent(E_UPDATE);
-
-        if (!node_)
-        {
+        if (autoRemove_)
+            Free();
+        else if ((type_== 0 && !text_) || (type_ == 1 && !node_))
             Free();
-            return;
-        }
-        node_->SetEnabled(false);
-
-        SendEvent(TEXTMESSAGE_EXPIRED);
-
-        if (expirationTime3_ > expirationTime2_)
-            SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TextMessage, HandleUpdate3));
-        else
-            if (autoRemove_)
-                Free();
     }
 }
 
-void TextMessage::HandleUpdate3(StringHash eventType, VariantMap& eventData)
+void TextMessage::HandleUpdate2_3D(StringHash eventType, VariantMap& eventData)
 {
-    timer_ += eventData[Update::P_TIMESTEP].GetFloat();
-
-    if (timer_ > expirationTime3_)
+    if (!node_)
     {
         UnsubscribeFromEvent(E_UPDATE);
-        if (autoRemove_)
-            Free();
-        else if ((type_== 0 && !text_) || (type_ == 1 && !node_))
-            Free();
+        return;
     }
+
+    float timeStep = eventData[Update::P_TIMESTEP].GetFloat();
+
+    node_->Translate(Vector3(GameRand::GetRand(ALLRAND, 10) < 5 ? -timeStep : timeStep, velocityY * timeStep, 0.f));
+    node_->SetScale(node_->GetScale()*1.005f);
+    text3D_->SetOpacity(text3D_->GetOpacity()-timeStep);
 }
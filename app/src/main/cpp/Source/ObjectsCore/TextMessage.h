@@ -8,10 +8,11 @@ namespace Urho3D
 }
 
 #include "Pool.h"
+#include "TimerWheel.h"
 
 URHO3D_EVENT(TEXTMESSAGE_EXPIRED, TextMessage_Expired) { }
 
-class TextMessage : public Object
+class TextMessage : public Object, public TimerWheelListener
 {
     URHO3D_OBJECT(TextMessage, Object);
 
@@ -37,13 +38,13 @@ public :
              bool autoRemove=true, float delayedStart=0.f, float delayedRemove=0.f);
     void SetDuration(float duration);
     void SetColor(const Color& colorTL=Color::WHITE, const Color& colorTR=Color::WHITE, const Color& colorBL=Color::WHITE, const Color& colorBR=Color::WHITE);
-    void HandleUpdate1(StringHash eventType, VariantMap& eventData);
-    void HandleUpdate2(StringHash eventType, VariantMap& eventData);
-    void HandleUpdate1_3D(StringHash eventType, VariantMap& eventData);
+
+    /// the phases (show, hide, remove) are timers in the TimerWheel
+    virtual void OnTimer(unsigned phase);
+    /// the animation of the 3D text while shown
     void HandleUpdate2_3D(StringHash eventType, VariantMap& eventData);
-    void HandleUpdate3(StringHash eventType, VariantMap& eventData);
 
-    bool Expired() { return (timer_ > expirationTime3_); }
+    bool Expired() const { return !TimerWheel::IsActiveTimer(handle_); }
 
     void Free();
 
@@ -56,7 +57,8 @@ private :
 
     int type_;
     bool autoRemove_;
-    float timer_;
+    TimerHandle handle_;
+    /// the deadlines of the phases in the TimerWheel time
 	float expirationTime1_,expirationTime2_,expirationTime3_;
 
 	static Pool<TextMessage> pool_;
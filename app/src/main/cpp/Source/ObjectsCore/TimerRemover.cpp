@@ -1,9 +1,6 @@
 #include <Urho3D/Urho3D.h>
 
 #include <Urho3D/Core/Context.h>
-#include <Urho3D/Core/CoreEvents.h>
-#include <Urho3D/Scene/SceneEvents.h>
-
 #include <Urho3D/Scene/Node.h>
 #include <Urho3D/Scene/Component.h>
 #include <Urho3D/UI/UIElement.h>
@@ -15,8 +12,11 @@
 #include "TimerRemover.h"
 
 
-//StringHash HandleUpdateEvent = E_UPDATE;
-StringHash HandleUpdateEvent = E_SCENEUPDATE;
+enum
+{
+    TIMERREMOVER_START = 0,
+    TIMERREMOVER_EXPIRE,
+};
 
 const char* RemoveStateNames[] =
 {
@@ -44,13 +44,16 @@ TimerRemover* TimerRemover::Get()
 }
 
 
-TimerRemover::TimerRemover(Context* context) : Object(context), startok_(0) { }
+TimerRemover::TimerRemover(Context* context) : Object(context), handle_(0), startok_(0) { }
 
-TimerRemover::TimerRemover() : Object(0) { }
+TimerRemover::TimerRemover() : Object(0), handle_(0) { }
 
-TimerRemover::TimerRemover(const TimerRemover& timer) : Object(timer.GetContext()) { }
+TimerRemover::TimerRemover(const TimerRemover& timer) : Object(timer.GetContext()), handle_(0) { }
 
-TimerRemover::~TimerRemover() { }
+TimerRemover::~TimerRemover()
+{
+    TimerWheel::CancelTimer(handle_);
+}
 
 void TimerRemover::Start(Node* object, float delay, RemoveState state, float delayBeforeStart, unsigned userdata1, unsigned userdata2)
 {
@@ -64,17 +67,9 @@ void TimerRemover::Start(Node* object, float delay, RemoveState state, float del
     startok_ = (delayBeforeStart + delay == 0.f);
 
     if (startok_)
-    {
-        timer_ = 0.1f;
-        Stop(context_->GetEventDataMap());
-    }
+        Stop();
     else
-    {
-        timer_ = 0.0f;
-        startTime_ = delayBeforeStart;
-        expirationTime_ = delay + startTime_;
-        SubscribeToEvent(HandleUpdateEvent, URHO3D_HANDLER(TimerRemover, HandleUpdate));
-    }
+        Start(delay, delayBeforeStart);
 }
 
 void TimerRemover::Start(Component* object, float delay, RemoveState state, float delayBeforeStart, unsigned userdata1, unsigned userdata2)
@@ -83,15 +78,10 @@ void TimerRemover::Start(Component* object, float delay, RemoveState state, floa
     removeState_ = state;
     object_ = WeakPtr<Animatable>(static_cast<Animatable*>(object));
 
-    timer_ = 0.0f;
-    startTime_ = delayBeforeStart;
-    expirationTime_ = delay + startTime_;
     userData_[0] = userdata1;
     userData_[1] = userdata2;
 
-    startok_ = false;
-
-    SubscribeToEvent(HandleUpdateEvent, URHO3D_HANDLER(TimerRemover, HandleUpdate));
+    Start(delay, delayBeforeStart);
 }
 
 void TimerRemover::Start(UIElement* object, float delay, RemoveState state, float delayBeforeStart, unsigned userdata1, unsigned userdata2)
@@ -100,15 +90,10 @@ void TimerRemover::Start(UIElement* object, float delay, RemoveState state, floa
     removeState_ = state;
     object_ = WeakPtr<Animatable>(static_cast<Animatable*>(object));
 
-    timer_ = 0.0f;
-    startTime_ = delayBeforeStart;
-    expirationTime_ = delay + startTime_;
     userData_[0] = userdata1;
     userData_[1] = userdata2;
 
-    startok_ = false;
-
-    SubscribeToEvent(HandleUpdateEvent, URHO3D_HANDLER(TimerRemover, HandleUpdate));
+    Start(delay, delayBeforeStart);
 }
 
 void TimerRemover::SetSendEvents(Object* sender, const StringHash& eventType1, const StringHash& eventType2)
@@ -121,46 +106,73 @@ void TimerRemover::SetSendEvents(Object* sender, const StringHash& eventType1, c
     }
 }
 
-void TimerRemover::HandleUpdate(StringHash eventType, VariantMap& eventData)
+void TimerRemover::Start(float delay, float delayBeforeStart)
+{
+    TimerWheel::CancelTimer(handle_);
+
+    startok_ = false;
+
+    // the deadlines are in the scene time : the timers are paused with the scene
+    expirationTime_ = TimerWheel::GetClockTime(TIMERCLOCK_SCENE) + delayBeforeStart + delay;
+    handle_ = TimerWheel::Get()->Add(this, delayBeforeStart, TIMERREMOVER_START, TIMERCLOCK_SCENE);
+}
+
+void TimerRemover::OnTimer(unsigned phase)
 {
-    timer_ += eventData[Update::P_TIMESTEP].GetFloat();
+    handle_ = 0;
+
+    if (phase == TIMERREMOVER_START)
+    {
+        if (sender_ && eventType_[0])
+        {
+            VariantMap& eventData = context_->GetEventDataMap();
+            eventData[Go_StartTimer::GO_SENDER] = (void*)object_.Get(); // use (void ptr) for variant assignation to skip weakptr creation, we just need a number to keep track
+            eventData[Go_StartTimer::GO_DATA1] = userData_[0];
+            eventData[Go_StartTimer::GO_DATA2] = userData_[1];
+            sender_->SendEvent(eventType_[0], eventData);
+            eventType_[0] = 0;
+        }
+
+        // Set Enable
+        if (object_)
+        {
+            if (objectType_ == NODE)
+                static_cast<Node*>(object_.Get())->SetEnabled(true);
+            else if (objectType_ == COMPONENT)
+                static_cast<Component*>(object_.Get())->SetEnabled(true);
+            else
+                static_cast<UIElement*>(object_.Get())->SetEnabled(true);
+        }
+        startok_ = true;
 
-    if (!startok_)
-        if (timer_ > startTime_)
+        // expired in the same update
+        if (TimerWheel::GetClockTime(TIMERCLOCK_SCENE) > expirationTime_)
         {
-            if (sender_ && eventType_[0])
-            {
-                eventData[Go_StartTimer::GO_SENDER] = (void*)object_.Get(); // use (void ptr) for variant assignation to skip weakptr creation, we just need a number to keep track
-                eventData[Go_StartTimer::GO_DATA1] = userData_[0];
-                eventData[Go_StartTimer::GO_DATA2] = userData_[1];
-//                URHO3D_LOGINFOF("TimerRemover() - HandleUpdate : this=%u SendEvent1=%u ...", this, eventType_[0].Value());
-                sender_->SendEvent(eventType_[0], eventData);
-                eventType_[0] = 0;
-            }
-
-            // Set Enable
-            if (object_)
-            {
-                if (objectType_ == NODE)
-                    static_cast<Node*>(object_.Get())->SetEnabled(true);
-                else if (objectType_ == COMPONENT)
-                    static_cast<Component*>(object_.Get())->SetEnabled(true);
-                else
-                    static_cast<UIElement*>(object_.Get())->SetEnabled(true);
-            }
-            startok_ = true;
+            Stop();
+            return;
         }
 
-    if (timer_ > expirationTime_)
+        handle_ = TimerWheel::Get()->AddAt(this, expirationTime_, TIMERREMOVER_EXPIRE, TIMERCLOCK_SCENE);
+    }
+    else
     {
-//        URHO3D_LOGINFOF("TimerRemover() - HandleUpdate : Stop this=%u ...", this);
-        Stop(eventData);
+//        URHO3D_LOGINFOF("TimerRemover() - OnTimer : Stop this=%u ...", this);
+        Stop();
     }
 }
 
-void TimerRemover::Stop(VariantMap& eventData)
+void TimerRemover::Cancel()
+{
+    TimerWheel::CancelTimer(handle_);
+
+    object_.Reset();
+    sender_.Reset();
+    pool_.Free(this);
+}
+
+void TimerRemover::Stop()
 {
-    UnsubscribeFromEvent(HandleUpdateEvent);
+    TimerWheel::CancelTimer(handle_);
 
     if (!object_)
     {
@@ -170,6 +182,7 @@ void TimerRemover::Stop(VariantMap& eventData)
 
     if (sender_ && eventType_[1])
     {
+        VariantMap& eventData = context_->GetEventDataMap();
         eventData[Go_EndTimer::GO_SENDER] = (void*)sender_.Get(); // use (void ptr) for variant assignation to skip weakptr creation, we just need a number to keep track
         eventData[Go_EndTimer::GO_DATA1] = userData_[0];
         eventData[Go_EndTimer::GO_DATA2] = userData_[1];
@@ -8,6 +8,7 @@ namespace Urho3D
 }
 
 #include "Pool.h"
+#include "TimerWheel.h"
 
 URHO3D_EVENT(GO_STARTTIMER, Go_StartTimer)
 {
@@ -41,7 +42,7 @@ enum RemoveObjectType
     UIELEMENT,
 };
 
-class TimerRemover : public Object
+class TimerRemover : public Object, public TimerWheelListener
 {
     URHO3D_OBJECT(TimerRemover, Object);
 
@@ -60,17 +61,21 @@ public :
     void Start(Component* object, float delay, RemoveState state=FREEMEMORY, float delayBeforeStart = 0.f, unsigned userdata1=0, unsigned userdata2=0);
     void Start(UIElement* object, float delay, RemoveState state=FREEMEMORY, float delayBeforeStart = 0.f, unsigned userdata1=0, unsigned userdata2=0);
 
-    void Stop(VariantMap& eventData);
+    /// Stop : the end event and the remove state are applied now
+    void Stop();
+    /// Cancel : no end event and no remove state
+    void Cancel();
+
+    virtual void OnTimer(unsigned phase);
 
 private :
-    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void Start(float delay, float delayBeforeStart);
 
     RemoveObjectType objectType_;
     RemoveState removeState_;
     WeakPtr<Animatable> object_;
     WeakPtr<Object> sender_;
-    float timer_;
-    float startTime_;
+    TimerHandle handle_;
 	float expirationTime_;
 	unsigned userData_[2];
     StringHash eventType_[2];
@@ -0,0 +1,304 @@
+#include <Urho3D/Urho3D.h>
+
+#include <Urho3D/Core/Context.h>
+#include <Urho3D/Core/CoreEvents.h>
+#include <Urho3D/Scene/SceneEvents.h>
+
+#include <Urho3D/IO/Log.h>
+
+#include "TimerWheel.h"
+
+
+#define TIMERWHEEL_TICKSBYSECOND 64.0
+#define TIMERWHEEL_LEVEL0SIZE 256
+#define TIMERWHEEL_LEVELSIZE 64
+#define TIMERWHEEL_INDEXBITS 20
+#define TIMERWHEEL_INDEXMASK ((1U << TIMERWHEEL_INDEXBITS) - 1U)
+#define TIMERWHEEL_GENERATIONMASK ((1U << (32 - TIMERWHEEL_INDEXBITS)) - 1U)
+
+enum
+{
+    TIMERSLOT_FREE = -1,
+    TIMERSLOT_EXPIRED = -2,
+};
+
+
+TimerWheel* TimerWheel::wheel_ = 0;
+
+void TimerWheel::Reset(Context* context)
+{
+    if (context)
+    {
+        if (!wheel_)
+            wheel_ = new TimerWheel(context);
+        else
+            wheel_->Clear();
+    }
+    else if (wheel_)
+    {
+        delete wheel_;
+        wheel_ = 0;
+    }
+}
+
+TimerWheel::TimerWheel(Context* context) :
+    Object(context),
+    numTimers_(0)
+{
+    for (int i=0; i < NUM_TIMERCLOCKS; i++)
+    {
+        TimerWheelClock& clock = clocks_[i];
+        clock.time_ = 0.0;
+        clock.tick_ = 0;
+        for (int j=0; j < TIMERWHEEL_LEVEL0SIZE + 3*TIMERWHEEL_LEVELSIZE; j++)
+            clock.slots_[j] = -1;
+    }
+
+    SubscribeToEvent(E_UPDATE, URHO3D_HANDLER(TimerWheel, HandleUpdate));
+    SubscribeToEvent(E_SCENEUPDATE, URHO3D_HANDLER(TimerWheel, HandleSceneUpdate));
+}
+
+TimerWheel::~TimerWheel()
+{
+    URHO3D_LOGINFOF("TimerWheel() - ~TimerWheel : entries=%u remaining timers=%u", entries_.Size(), numTimers_);
+}
+
+TimerHandle TimerWheel::Add(TimerWheelListener* listener, float delay, unsigned phase, TimerClock clock)
+{
+    return AddAt(listener, (float)(clocks_[clock].time_ + delay), phase, clock);
+}
+
+TimerHandle TimerWheel::AddAt(TimerWheelListener* listener, float deadline, unsigned phase, TimerClock clock)
+{
+    int index;
+    if (freeentries_.Size())
+    {
+        index = freeentries_.Back();
+        freeentries_.Pop();
+    }
+    else
+    {
+        index = entries_.Size();
+        entries_.Resize(index+1);
+        entries_[index].generation_ = 0;
+    }
+
+    TimerEntry& entry = entries_[index];
+    entry.listener_ = listener;
+    entry.deadline_ = deadline;
+    entry.phase_ = phase;
+    entry.clock_ = clock;
+
+    Link(index);
+    numTimers_++;
+
+    return (entry.generation_ << TIMERWHEEL_INDEXBITS) | (unsigned)(index+1);
+}
+
+bool TimerWheel::Cancel(TimerHandle& handle)
+{
+    const int index = GetEntry(handle);
+    handle = 0;
+
+    if (index == -1)
+        return false;
+
+    if (entries_[index].slot_ >= 0)
+        Unlink(index);
+
+    Release(index);
+    return true;
+}
+
+void TimerWheel::Clear()
+{
+    for (unsigned i=0; i < entries_.Size(); i++)
+    {
+        if (entries_[i].slot_ != TIMERSLOT_FREE)
+            Release(i);
+    }
+
+    for (int i=0; i < NUM_TIMERCLOCKS; i++)
+        for (int j=0; j < TIMERWHEEL_LEVEL0SIZE + 3*TIMERWHEEL_LEVELSIZE; j++)
+            clocks_[i].slots_[j] = -1;
+
+    expired_.Clear();
+}
+
+bool TimerWheel::IsActive(TimerHandle handle) const
+{
+    return GetEntry(handle) != -1;
+}
+
+int TimerWheel::GetEntry(TimerHandle handle) const
+{
+    if (!handle)
+        return -1;
+
+    const unsigned index = (handle & TIMERWHEEL_INDEXMASK) - 1U;
+    if (index >= entries_.Size())
+        return -1;
+
+    const TimerEntry& entry = entries_[index];
+    return entry.slot_ != TIMERSLOT_FREE && entry.generation_ == (handle >> TIMERWHEEL_INDEXBITS) ? (int)index : -1;
+}
+
+void TimerWheel::Link(int index)
+{
+    TimerEntry& entry = entries_[index];
+    TimerWheelClock& clock = clocks_[entry.clock_];
+
+    // a deadline in a processed tick goes in the current tick
+    long long expires = (long long)(entry.deadline_ * TIMERWHEEL_TICKSBYSECOND);
+    if (expires < (long long)clock.tick_)
+        expires = (long long)clock.tick_;
+
+    const unsigned long long delta = (unsigned long long)expires - clock.tick_;
+
+    int slot;
+    if (delta < TIMERWHEEL_LEVEL0SIZE)
+        slot = (int)(expires & (TIMERWHEEL_LEVEL0SIZE-1));
+    else if (delta < (1ULL << 14))
+        slot = TIMERWHEEL_LEVEL0SIZE + (int)((expires >> 8) & (TIMERWHEEL_LEVELSIZE-1));
+    else if (delta < (1ULL << 20))
+        slot = TIMERWHEEL_LEVEL0SIZE + TIMERWHEEL_LEVELSIZE + (int)((expires >> 14) & (TIMERWHEEL_LEVELSIZE-1));
+    else
+    {
+        // beyond the range (~3 days), the timer is relinked at each cascade of the last level
+        if (delta >= (1ULL << 26))
+            expires = (long long)(clock.tick_ + (1ULL << 26) - 1ULL);
+        slot = TIMERWHEEL_LEVEL0SIZE + 2*TIMERWHEEL_LEVELSIZE + (int)((expires >> 20) & (TIMERWHEEL_LEVELSIZE-1));
+    }
+
+    entry.slot_ = slot;
+    entry.prev_ = -1;
+    entry.next_ = clock.slots_[slot];
+    if (entry.next_ != -1)
+        entries_[entry.next_].prev_ = index;
+    clock.slots_[slot] = index;
+}
+
+void TimerWheel::Unlink(int index)
+{
+    TimerEntry& entry = entries_[index];
+    TimerWheelClock& clock = clocks_[entry.clock_];
+
+    if (entry.prev_ != -1)
+        entries_[entry.prev_].next_ = entry.next_;
+    else
+        clock.slots_[entry.slot_] = entry.next_;
+
+    if (entry.next_ != -1)
+        entries_[entry.next_].prev_ = entry.prev_;
+
+    entry.prev_ = entry.next_ = -1;
+}
+
+void TimerWheel::Release(int index)
+{
+    TimerEntry& entry = entries_[index];
+    entry.slot_ = TIMERSLOT_FREE;
+    entry.listener_ = 0;
+    entry.generation_ = (entry.generation_ + 1U) & TIMERWHEEL_GENERATIONMASK;
+
+    freeentries_.Push(index);
+    numTimers_--;
+}
+
+void TimerWheel::Cascade(TimerWheelClock& clock, int level)
+{
+    const int index = (int)((clock.tick_ >> (8 + 6*(level-1))) & (TIMERWHEEL_LEVELSIZE-1));
+    const int slot = TIMERWHEEL_LEVEL0SIZE + (level-1)*TIMERWHEEL_LEVELSIZE + index;
+
+    int i = clock.slots_[slot];
+    clock.slots_[slot] = -1;
+    while (i != -1)
+    {
+        const int next = entries_[i].next_;
+        Link(i);
+        i = next;
+    }
+
+    // the next level is cascaded when this level wraps
+    if (index == 0 && level < 3)
+        Cascade(clock, level+1);
+}
+
+void TimerWheel::CollectSlot(TimerWheelClock& clock, int slot, bool checkdeadline)
+{
+    int i = clock.slots_[slot];
+    while (i != -1)
+    {
+        TimerEntry& entry = entries_[i];
+        const int next = entry.next_;
+
+        if (!checkdeadline || clock.time_ > entry.deadline_)
+        {
+            Unlink(i);
+            entry.slot_ = TIMERSLOT_EXPIRED;
+            expired_.Push(i);
+            expired_.Push(entry.generation_);
+        }
+
+        i = next;
+    }
+}
+
+void TimerWheel::Advance(TimerClock clockid, float timestep)
+{
+    TimerWheelClock& clock = clocks_[clockid];
+    clock.time_ += timestep;
+
+    if (!numTimers_)
+    {
+        clock.tick_ = (unsigned long long)(clock.time_ * TIMERWHEEL_TICKSBYSECOND);
+        return;
+    }
+
+    // the completed ticks
+    const unsigned long long lasttick = (unsigned long long)(clock.time_ * TIMERWHEEL_TICKSBYSECOND);
+    while (clock.tick_ < lasttick)
+    {
+        CollectSlot(clock, (int)(clock.tick_ & (TIMERWHEEL_LEVEL0SIZE-1)), false);
+        clock.tick_++;
+        if ((clock.tick_ & (TIMERWHEEL_LEVEL0SIZE-1)) == 0)
+            Cascade(clock, 1);
+    }
+
+    // the current tick
+    CollectSlot(clock, (int)(clock.tick_ & (TIMERWHEEL_LEVEL0SIZE-1)), true);
+
+    if (!expired_.Size())
+        return;
+
+    // fire the batch : the timers added by the listeners will be fired at the next update
+    PODVector<unsigned> batch;
+    batch.Swap(expired_);
+    for (unsigned i=0; i < batch.Size(); i+=2)
+    {
+        const int index = batch[i];
+        TimerEntry& entry = entries_[index];
+        if (entry.slot_ != TIMERSLOT_EXPIRED || entry.generation_ != batch[i+1])
+            continue;
+
+        TimerWheelListener* listener = entry.listener_;
+        const unsigned phase = entry.phase_;
+        Release(index);
+
+        listener->OnTimer(phase);
+    }
+
+    // keep the capacity
+    batch.Clear();
+    expired_.Swap(batch);
+}
+
+void TimerWheel::HandleUpdate(StringHash eventType, VariantMap& eventData)
+{
+    Advance(TIMERCLOCK_UPDATE, eventData[Update::P_TIMESTEP].GetFloat());
+}
+
+void TimerWheel::HandleSceneUpdate(StringHash eventType, VariantMap& eventData)
+{
+    Advance(TIMERCLOCK_SCENE, eventData[SceneUpdate::P_TIMESTEP].GetFloat());
+}
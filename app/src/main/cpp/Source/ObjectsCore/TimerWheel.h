@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Urho3D/Container/Vector.h>
+#include <Urho3D/Core/Object.h>
+
+using namespace Urho3D;
+
+
+/// Timer Handle : cancellation handle of a timer (index + generation), 0 = no timer
+typedef unsigned TimerHandle;
+
+enum TimerClock
+{
+    /// E_UPDATE time
+    TIMERCLOCK_UPDATE = 0,
+    /// E_SCENEUPDATE time (paused with the scene)
+    TIMERCLOCK_SCENE,
+    NUM_TIMERCLOCKS
+};
+
+class TimerWheelListener
+{
+public:
+    virtual ~TimerWheelListener() { }
+    virtual void OnTimer(unsigned phase) = 0;
+};
+
+/// Timer Wheel
+/// a hierarchical timing wheel by clock (tick=1/64s, 256 slots + 3 levels of 64 slots cascaded in the first level).
+/// The deadlines are absolute in the time of the clock; a timer expires at the first update where time > deadline.
+/// Only the expired timers are visited and they are fired in one batch by update.
+class TimerWheel : public Object
+{
+    URHO3D_OBJECT(TimerWheel, Object);
+
+public :
+    static void Reset(Context* context=0);
+    static TimerWheel* Get() { return wheel_; }
+
+    /// Helpers : safe when the wheel is not created
+    static float GetClockTime(TimerClock clock) { return wheel_ ? wheel_->GetTime(clock) : 0.f; }
+    static bool IsActiveTimer(TimerHandle handle) { return wheel_ && wheel_->IsActive(handle); }
+    static void CancelTimer(TimerHandle& handle) { if (wheel_) wheel_->Cancel(handle); else handle = 0; }
+
+    TimerWheel(Context* context);
+    ~TimerWheel();
+
+    TimerHandle Add(TimerWheelListener* listener, float delay, unsigned phase=0, TimerClock clock=TIMERCLOCK_UPDATE);
+    TimerHandle AddAt(TimerWheelListener* listener, float deadline, unsigned phase=0, TimerClock clock=TIMERCLOCK_UPDATE);
+    /// Cancel : the handle is reset
+    bool Cancel(TimerHandle& handle);
+    void Clear();
+
+    bool IsActive(TimerHandle handle) const;
+    float GetTime(TimerClock clock) const { return (float)clocks_[clock].time_; }
+    unsigned GetNumTimers() const { return numTimers_; }
+
+private :
+    struct TimerEntry
+    {
+        TimerWheelListener* listener_;
+        double deadline_;
+        unsigned phase_;
+        unsigned generation_;
+        int prev_, next_;
+        /// slot in the clock, -1 = free, -2 = expired (waiting in the batch)
+        int slot_;
+        unsigned char clock_;
+    };
+
+    struct TimerWheelClock
+    {
+        double time_;
+        /// next tick to process : all the ticks before are expired
+        unsigned long long tick_;
+        int slots_[256 + 3*64];
+    };
+
+    int GetEntry(TimerHandle handle) const;
+    void Link(int index);
+    void Unlink(int index);
+    void Release(int index);
+    void Cascade(TimerWheelClock& clock, int level);
+    void CollectSlot(TimerWheelClock& clock, int slot, bool checkdeadline);
+    void Advance(TimerClock clock, float timestep);
+
+    void HandleUpdate(StringHash eventType, VariantMap& eventData);
+    void HandleSceneUpdate(StringHash eventType, VariantMap& eventData);
+
+    TimerWheelClock clocks_[NUM_TIMERCLOCKS];
+    PODVector<TimerEntry> entries_;
+    PODVector<int> freeentries_;
+    /// the expired timers of the current batch : index, generation
+    PODVector<unsigned> expired_;
+    unsigned numTimers_;
+
+    static TimerWheel* wheel_;
+};
@@ -71,6 +71,7 @@
 #include "GameAttributes.h"
 #include "GameRand.h"
 #include "GameEvents.h"
+#include "EventChannel.h"
 #include "GameStatics.h"
 #include "GameHelpers.h"
 #include "GameOptions.h"
@@ -135,6 +136,13 @@ PlayState::PlayState(Context* context) :
 PlayState::~PlayState()
 {
     URHO3D_LOGINFO("~PlayState()");
+
+    EventChannel<ScoreChangeEvent>::Unsubscribe(this);
+    EventChannel<MoveRemovedEvent>::Unsubscribe(this);
+    EventChannel<MoveAddedEvent>::Unsubscribe(this);
+    EventChannel<MoveRestoredEvent>::Unsubscribe(this);
+    EventChannel<ObjectiveChangeEvent>::Unsubscribe(this);
+    EventChannel<MatchStateChangeEvent>::Unsubscribe(this);
 }
 
 bool PlayState::Initialize()
@@ -663,7 +671,7 @@ void PlayState::CheckStars(bool loosetry)
         URHO3D_LOGINFOF("PlayState() - CheckStars : No More Star !");
 
         GameStatics::moves_ = 0;
-        SendEvent(GAME_MOVEREMOVED);
+        EventChannel<MoveRemovedEvent>::Send(this, MoveRemovedEvent());
         gameOver_ = true;
         hiScore = 0;
 
@@ -691,7 +699,7 @@ void PlayState::CheckStars(bool loosetry)
 
         SendEvent(GAME_TRYREMOVED);
         GameStatics::moves_ = initialMoves-1;
-        SendEvent(GAME_MOVEADDED);
+        EventChannel<MoveAddedEvent>::Send(this, MoveAddedEvent());
     }
 }
 
@@ -1156,9 +1164,9 @@ void PlayState::SetHiScoreEnable(bool enable)
             if (GameStatics::GetStatus() == PLAYSTATE_RUNNING)
             {
                 if (enable)
-                    SubscribeToEvent(GAME_SCORECHANGE, URHO3D_HANDLER(PlayState, HandleUpdateScores));
+                    EventChannel<ScoreChangeEvent>::Subscribe<PlayState, &PlayState::HandleUpdateScores>(this);
                 else
-                    UnsubscribeFromEvent(GAME_SCORECHANGE);
+                    EventChannel<ScoreChangeEvent>::Unsubscribe(this);
             }
         }
     }
@@ -1218,11 +1226,12 @@ void PlayState::SubscribeToEvents()
     SubscribeToEvent(GAME_SCREENRESIZED, URHO3D_HANDLER(PlayState, HandleScreenResized));
 
     if (showHiScore_)
-        SubscribeToEvent(GAME_SCORECHANGE, URHO3D_HANDLER(PlayState, HandleUpdateScores));
+        EventChannel<ScoreChangeEvent>::Subscribe<PlayState, &PlayState::HandleUpdateScores>(this);
 
-    SubscribeToEvent(GAME_MOVEREMOVED, URHO3D_HANDLER(PlayState, HandleUpdateMoves));
-    SubscribeToEvent(GAME_MOVEADDED, URHO3D_HANDLER(PlayState, HandleUpdateMoves));
-    SubscribeToEvent(GAME_MOVERESTORED, URHO3D_HANDLER(PlayState, HandleUpdateMoves));
+    EventChannel<MoveRemovedEvent>::Subscribe<PlayState, &PlayState::HandleMoveRemoved>(this);
+    EventChannel<MoveAddedEvent>::Subscribe<PlayState, &PlayState::HandleMoveAdded>(this);
+    EventChannel<MoveRestoredEvent>::Subscribe<PlayState, &PlayState::HandleMoveRestored>(this);
+    SubscribeToEvent(GAME_MOVEBONUS, URHO3D_HANDLER(PlayState, HandleMoveBonus));
 
     SubscribeToEvent(GAME_TRYREMOVED, URHO3D_HANDLER(PlayState, HandleUpdateStars));
     SubscribeToEvent(GAME_TRYADDED, URHO3D_HANDLER(PlayState, HandleUpdateStars));
@@ -1230,7 +1239,7 @@ void PlayState::SubscribeToEvents()
 
     SubscribeToEvent(GAME_COINUPDATED, URHO3D_HANDLER(PlayState, HandleUpdateCoins));
 
-    SubscribeToEvent(GAME_OBJECTIVECHANGE, URHO3D_HANDLER(PlayState, HandleUpdateObjectives));
+    EventChannel<ObjectiveChangeEvent>::Subscribe<PlayState, &PlayState::HandleUpdateObjectives>(this);
     SubscribeToEvent(GAME_OVER, URHO3D_HANDLER(PlayState, HandleGameOver));
 
     if (GameStatics::gameState_.storyitems_[1])
@@ -1261,11 +1270,12 @@ void PlayState::UnsubscribeToEvents()
     UnsubscribeFromEvent(GAME_SCREENRESIZED);
 
 	if (showHiScore_)
-        UnsubscribeFromEvent(GAME_SCORECHANGE);
+        EventChannel<ScoreChangeEvent>::Unsubscribe(this);
 
-    UnsubscribeFromEvent(GAME_MOVEREMOVED);
-    UnsubscribeFromEvent(GAME_MOVEADDED);
-    UnsubscribeFromEvent(GAME_MOVERESTORED);
+    EventChannel<MoveRemovedEvent>::Unsubscribe(this);
+    EventChannel<MoveAddedEvent>::Unsubscribe(this);
+    EventChannel<MoveRestoredEvent>::Unsubscribe(this);
+    UnsubscribeFromEvent(GAME_MOVEBONUS);
 
     UnsubscribeFromEvent(GAME_TRYREMOVED);
     UnsubscribeFromEvent(GAME_TRYADDED);
@@ -1273,7 +1283,7 @@ void PlayState::UnsubscribeToEvents()
 
     UnsubscribeFromEvent(GAME_COINUPDATED);
 
-    UnsubscribeFromEvent(GAME_OBJECTIVECHANGE);
+    EventChannel<ObjectiveChangeEvent>::Unsubscribe(this);
     UnsubscribeFromEvent(GAME_OVER);
 
     UnsubscribeFromEvent(GAME_BOSSAPPEARS);
@@ -1292,13 +1302,13 @@ void PlayState::SubscribeToDebugEvents(bool enabled)
             matchStateText->SetVisible(true);
             matchStateText->SetText(String(matchStateNames[MatchesManager::GetState()]));
         }
-        SubscribeToEvent(GAME_MATCHSTATECHANGE, URHO3D_HANDLER(PlayState, HandleUpdateMatchState));
+        EventChannel<MatchStateChangeEvent>::Subscribe<PlayState, &PlayState::HandleUpdateMatchState>(this);
     }
     else
     {
         if (matchStateText)
             matchStateText->SetVisible(false);
-        UnsubscribeFromEvent(GAME_MATCHSTATECHANGE);
+        EventChannel<MatchStateChangeEvent>::Unsubscribe(this);
     }
 
     if (enabled && rootScene_->GetOrCreateComponent<DebugRenderer>())
@@ -1418,7 +1428,7 @@ void PlayState::HandleStart(StringHash eventType, VariantMap& eventData)
         URHO3D_LOGINFOF("PlayState() - HandleStart : ... stars=%d moves=%d ", GameStatics::tries_, GameStatics::moves_);
 
         GameStatics::moves_ = 0;
-        SendEvent(GAME_MOVEREMOVED);
+        EventChannel<MoveRemovedEvent>::Send(this, MoveRemovedEvent());
         activeGameLogic_ = false;
         gameOver_ = true;
 
@@ -1480,60 +1490,62 @@ void PlayState::HandleBossAppears(StringHash eventType, VariantMap& eventData)
     URHO3D_LOGINFOF("PlayState() - HandleBossAppears : ... Add Boss : node=%s(%u) OK !", boss_->GetName().CString(), boss_->GetID());
 }
 
-void PlayState::HandleUpdateScores(StringHash eventType, VariantMap& eventData)
+void PlayState::HandleUpdateScores(const ScoreChangeEvent& event)
 {
-    if (eventType == GAME_SCORECHANGE)
-    {
-        hiScore += MatchesManager::GetTurnScore();
+    hiScore += MatchesManager::GetTurnScore();
 
-        hiscoreText->SetText(String(hiScore));
+    hiscoreText->SetText(String(hiScore));
 
-        // Create "Add Score" Effect
+    // Create "Add Score" Effect
 
-        float fontzoom = Min(1.3f + (float)(MatchesManager::GetTurnScore() / 1000), 5.f);
-//        GameHelpers::AddTextFadeAnim(uiplay_, "+"+String(MatchesManager::GetTurnScore()), hiscoreText, IntVector2(0, floor((float)30 * GameStatics::uiScale_)), 0.7f, fontzoom);
-        GameHelpers::AddText3DFadeAnim(scene_, "+"+String(MatchesManager::GetTurnScore()), hiscoreText, Vector3(0.f, -0.3f, 0.f) * GameStatics::uiScale_, 0.7f, fontzoom);
-    }
+    float fontzoom = Min(1.3f + (float)(MatchesManager::GetTurnScore() / 1000), 5.f);
+//    GameHelpers::AddTextFadeAnim(uiplay_, "+"+String(MatchesManager::GetTurnScore()), hiscoreText, IntVector2(0, floor((float)30 * GameStatics::uiScale_)), 0.7f, fontzoom);
+    GameHelpers::AddText3DFadeAnim(scene_, "+"+String(MatchesManager::GetTurnScore()), hiscoreText, Vector3(0.f, -0.3f, 0.f) * GameStatics::uiScale_, 0.7f, fontzoom);
 }
 
-void PlayState::HandleUpdateMoves(StringHash eventType, VariantMap& eventData)
+void PlayState::HandleMoveRemoved(const MoveRemovedEvent& event)
 {
-    if (eventType == GAME_MOVEREMOVED)
-    {
-        GameStatics::moves_ = Max(0, GameStatics::moves_-1);
+    GameStatics::moves_ = Max(0, GameStatics::moves_-1);
 
-        moveText->SetText(String(GameStatics::moves_));
+    moveText->SetText(String(GameStatics::moves_));
 
-        // Create "Add Move" Effect
-//        GameHelpers::AddTextFadeAnim(uiplay_, String(GameStatics::moves_), moveText, IntVector2(floor((float)30 * GameStatics::uiScale_), floor((float)30 * GameStatics::uiScale_)), 1.f, 5.f);
-        GameHelpers::AddText3DFadeAnim(scene_, String(GameStatics::moves_), moveText, Vector3(0.3f, -0.3f, 0.f) * GameStatics::uiScale_, 1.f, 5.f);
+    // Create "Add Move" Effect
+//    GameHelpers::AddTextFadeAnim(uiplay_, String(GameStatics::moves_), moveText, IntVector2(floor((float)30 * GameStatics::uiScale_), floor((float)30 * GameStatics::uiScale_)), 1.f, 5.f);
+    GameHelpers::AddText3DFadeAnim(scene_, String(GameStatics::moves_), moveText, Vector3(0.3f, -0.3f, 0.f) * GameStatics::uiScale_, 1.f, 5.f);
 
-        URHO3D_LOGINFOF("PlayState() - HandleUpdateMoves : move removed => moves=%d !", GameStatics::moves_);
+    URHO3D_LOGINFOF("PlayState() - HandleMoveRemoved : move removed => moves=%d !", GameStatics::moves_);
 
-        if (!GameStatics::moves_ && GameStatics::tries_)
-            CheckStars(true);
-    }
-    else if (eventType == GAME_MOVEADDED)
-    {
-        GameStatics::moves_++;
+    if (!GameStatics::moves_ && GameStatics::tries_)
+        CheckStars(true);
+}
 
-        URHO3D_LOGINFOF("PlayState() - HandleUpdateMoves : move Added => moves=%d !", GameStatics::moves_);
+void PlayState::HandleMoveAdded(const MoveAddedEvent& event)
+{
+    GameStatics::moves_++;
 
-        moveText->SetText(String(GameStatics::moves_));
+    URHO3D_LOGINFOF("PlayState() - HandleMoveAdded : move Added => moves=%d !", GameStatics::moves_);
 
-        // Create "Add Move" Effect
-//        GameHelpers::AddTextFadeAnim(uiplay_, String(GameStatics::moves_), moveText, IntVector2(floor((float)30 * GameStatics::uiScale_), floor((float)30 * GameStatics::uiScale_)), 1.f, 5.f);
-        GameHelpers::AddText3DFadeAnim(scene_, String(GameStatics::moves_), moveText, Vector3(0.3f, -0.3f, 0.f) * GameStatics::uiScale_, 1.f, 5.f);
+    moveText->SetText(String(GameStatics::moves_));
 
-        if (GameStatics::moves_ > 0 && GameStatics::numRemainObjectives_ > 0)
-            GameStatics::AllowInputs(true);
-    }
-    else if (eventType == GAME_MOVERESTORED)
-    {
-        URHO3D_LOGINFOF("PlayState() - HandleUpdateMoves : move Restored => moves=%d !", GameStatics::moves_);
-        moveText->SetText(String(GameStatics::moves_));
-        GameHelpers::AddText3DFadeAnim(scene_, String(GameStatics::moves_), moveText, Vector3(0.3f, -0.3f, 0.f) * GameStatics::uiScale_, 1.f, 5.f);
-    }
+    // Create "Add Move" Effect
+//    GameHelpers::AddTextFadeAnim(uiplay_, String(GameStatics::moves_), moveText, IntVector2(floor((float)30 * GameStatics::uiScale_), floor((float)30 * GameStatics::uiScale_)), 1.f, 5.f);
+    GameHelpers::AddText3DFadeAnim(scene_, String(GameStatics::moves_), moveText, Vector3(0.3f, -0.3f, 0.f) * GameStatics::uiScale_, 1.f, 5.f);
+
+    if (GameStatics::moves_ > 0 && GameStatics::numRemainObjectives_ > 0)
+        GameStatics::AllowInputs(true);
+}
+
+void PlayState::HandleMoveRestored(const MoveRestoredEvent& event)
+{
+    URHO3D_LOGINFOF("PlayState() - HandleMoveRestored : move Restored => moves=%d !", GameStatics::moves_);
+    moveText->SetText(String(GameStatics::moves_));
+    GameHelpers::AddText3DFadeAnim(scene_, String(GameStatics::moves_), moveText, Vector3(0.3f, -0.3f, 0.f) * GameStatics::uiScale_, 1.f, 5.f);
+}
+
+void PlayState::HandleMoveBonus(StringHash eventType, VariantMap& eventData)
+{
+    // the bonus moves are delayed by a DelayInformer (string-keyed)
+    HandleMoveAdded(MoveAddedEvent());
 }
 
 void PlayState::HandleUpdateStars(StringHash eventType, VariantMap& eventData)
@@ -1583,7 +1595,7 @@ void PlayState::HandleUpdateStars(StringHash eventType, VariantMap& eventData)
 
             GameStatics::moves_ = initialMoves-1;
 
-            SendEvent(GAME_MOVEADDED);
+            EventChannel<MoveAddedEvent>::Send(this, MoveAddedEvent());
 
             if (GameStatics::IsBossLevel() && !boss_)
                 AddRandomBossWarning();
@@ -1667,7 +1679,7 @@ void PlayState::UpdateObjectives(bool init)
     }
 }
 
-void PlayState::HandleUpdateObjectives(StringHash eventType, VariantMap& eventData)
+void PlayState::HandleUpdateObjectives(const ObjectiveChangeEvent& event)
 {
     URHO3D_LOGINFO("PlayState() - HandleUpdateObjectives !");
     UpdateObjectives();
@@ -1702,7 +1714,7 @@ void PlayState::HandleGameOver(StringHash eventType, VariantMap& eventData)
     DelayInformer::Get(this, 0.25f, GAME_UIFRAME_ADD);
 }
 
-void PlayState::HandleUpdateMatchState(StringHash eventType, VariantMap& eventData)
+void PlayState::HandleUpdateMatchState(const MatchStateChangeEvent& event)
 {
 //    URHO3D_LOGINFO("PlayState() - HandleUpdateMatchState !");
 
@@ -2189,7 +2201,7 @@ void PlayState::OnLevelWin(StringHash eventType, VariantMap& eventData)
         completedmission = false;
         GameStatics::tries_ = initialtries_;
         GameStatics::moves_ = initialmoves_;
-        SendEvent(GAME_MOVERESTORED);
+        EventChannel<MoveRestoredEvent>::Send(this, MoveRestoredEvent());
         SendEvent(GAME_TRYRESTORED);
 
         Localization* l10n = context_->GetSubsystem<Localization>();
@@ -2546,7 +2558,7 @@ void PlayState::OnQuitMessageAck(StringHash eventType, VariantMap& eventData)
         gameOver_ = false;
         GameStatics::moves_--;
         SendEvent(GAME_TRYREMOVED);
-        SendEvent(GAME_MOVEADDED);
+        EventChannel<MoveAddedEvent>::Send(this, MoveAddedEvent());
     }
 	else
     {
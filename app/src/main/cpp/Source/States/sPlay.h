@@ -18,6 +18,12 @@ using namespace Urho3D;
 
 
 class InteractiveFrame;
+struct MatchStateChangeEvent;
+struct ScoreChangeEvent;
+struct ObjectiveChangeEvent;
+struct MoveRemovedEvent;
+struct MoveAddedEvent;
+struct MoveRestoredEvent;
 
 
 class PlayState : public GameState
@@ -90,13 +96,16 @@ private:
     void HandleBossAppears(StringHash eventType, VariantMap& eventData);
     void HandleGameOver(StringHash eventType, VariantMap& eventData);
 
-    void HandleUpdateScores(StringHash eventType, VariantMap& eventData);
-    void HandleUpdateMoves(StringHash eventType, VariantMap& eventData);
+    void HandleUpdateScores(const ScoreChangeEvent& event);
+    void HandleMoveRemoved(const MoveRemovedEvent& event);
+    void HandleMoveAdded(const MoveAddedEvent& event);
+    void HandleMoveRestored(const MoveRestoredEvent& event);
+    void HandleMoveBonus(StringHash eventType, VariantMap& eventData);
     void HandleUpdateStars(StringHash eventType, VariantMap& eventData);
     void HandleUpdateCoins(StringHash eventType, VariantMap& eventData);
 
-    void HandleUpdateObjectives(StringHash eventType, VariantMap& eventData);
-    void HandleUpdateMatchState(StringHash eventType, VariantMap& eventData);
+    void HandleUpdateObjectives(const ObjectiveChangeEvent& event);
+    void HandleUpdateMatchState(const MatchStateChangeEvent& event);
 
     void CheckInputForDebug(Input* input);
 	void HandleUpdate(StringHash eventType, VariantMap& eventData);
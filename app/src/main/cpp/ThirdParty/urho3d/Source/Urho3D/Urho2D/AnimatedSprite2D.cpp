@@ -67,6 +67,8 @@ const char* loopModeNames[] =
     0
 };
 
+bool AnimatedSprite2D::parallelUpdate_ = false;
+
 
 AnimatedSprite2D::AnimatedSprite2D(Context* context) :
     StaticSprite2D(context),
@@ -79,7 +81,9 @@ AnimatedSprite2D::AnimatedSprite2D(Context* context) :
     loopMode_(LM_DEFAULT),
     useCharacterMap_(false),
     characterMapDirty_(true),
-    renderEnabled_(true)
+    renderEnabled_(true),
+    parallelTimeStep_(0.f),
+    parallelUpdated_(false)
 {
     sourceBatches_.Reserve(10);
     sourceBatches_.Resize(1);
@@ -93,6 +97,9 @@ AnimatedSprite2D::AnimatedSprite2D(Context* context) :
 
 AnimatedSprite2D::~AnimatedSprite2D()
 {
+    if (renderer_)
+        renderer_->RemoveAnimatedSprite(this);
+
     Dispose();
 }
 
@@ -880,11 +887,11 @@ void AnimatedSprite2D::OnSetEnabled()
         {
             SetTriggers();
             UpdateAnimation(0.f);
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+            SubscribeToAnimationUpdate(scene);
         }
         else
         {
-            UnsubscribeFromEvent(scene, E_SCENEPOSTUPDATE);
+            UnsubscribeFromAnimationUpdate();
             if (spriterInstance_) spriterInstance_->ResetCurrentTime();
             HideTriggers();
         }
@@ -909,12 +916,12 @@ void AnimatedSprite2D::OnSceneSet(Scene* scene)
 
         if (IsEnabledEffective())
         {
-            SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+            SubscribeToAnimationUpdate(scene);
         }
     }
     else
     {
-        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        UnsubscribeFromAnimationUpdate();
         //HideTriggers();
     }
 }
@@ -925,6 +932,38 @@ void AnimatedSprite2D::HandleScenePostUpdate(StringHash eventType, VariantMap& e
         UpdateAnimation(eventData[ScenePostUpdate::P_TIMESTEP].GetFloat());
 }
 
+void AnimatedSprite2D::SetParallelUpdate(bool enable)
+{
+#ifdef USE_KEYPOOLS
+    // the key pools are shared by all the spriter instances : keep the serial update
+    enable = false;
+#endif
+    parallelUpdate_ = enable;
+}
+
+void AnimatedSprite2D::SubscribeToAnimationUpdate(Scene* scene)
+{
+    if (parallelUpdate_ && renderer_)
+    {
+        UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+        renderer_->AddAnimatedSprite(this);
+    }
+    else
+    {
+        if (renderer_)
+            renderer_->RemoveAnimatedSprite(this);
+        SubscribeToEvent(scene, E_SCENEPOSTUPDATE, URHO3D_HANDLER(AnimatedSprite2D, HandleScenePostUpdate));
+    }
+}
+
+void AnimatedSprite2D::UnsubscribeFromAnimationUpdate()
+{
+    UnsubscribeFromEvent(E_SCENEPOSTUPDATE);
+
+    if (renderer_)
+        renderer_->RemoveAnimatedSprite(this);
+}
+
 
 /// UPDATERS
 
@@ -974,6 +1013,67 @@ void AnimatedSprite2D::UpdateAnimation(float timeStep)
     }
 }
 
+/// Parallel update : same steps as UpdateAnimation, only the spriter instance update runs in the worker thread.
+
+bool AnimatedSprite2D::BeginAnimationUpdate(float timeStep)
+{
+    parallelUpdated_ = false;
+
+    if (!speed_)
+        return false;
+
+    if (!timeStep)
+        visibility_ = true;
+
+    if (renderer_ && !renderer_->IsDrawableVisible(this))
+    {
+        if (visibility_)
+        {
+            ClearSourceBatches();
+            visibility_ = false;
+        }
+        return false;
+    }
+
+#ifdef URHO3D_SPINE
+    if (skeleton_ && animationState_)
+        UpdateSpineAnimation(timeStep);
+#endif
+    if (!spriterInstance_ || !spriterInstance_->GetAnimation())
+    {
+        visibility_ = true;
+        return false;
+    }
+
+    parallelTimeStep_ = timeStep;
+    return true;
+}
+
+void AnimatedSprite2D::UpdateAnimationInWorker()
+{
+    float timeStep = parallelTimeStep_;
+
+    if (!visibility_)
+    {
+        spriterInstance_->ResetCurrentTime();
+        timeStep = 0.f;
+    }
+
+    parallelUpdated_ = spriterInstance_->Update(timeStep * speed_);
+
+    visibility_ = true;
+}
+
+void AnimatedSprite2D::EndAnimationUpdate()
+{
+    if (parallelUpdated_)
+    {
+        UpdateTriggers();
+        sourceBatchesDirty_ = true;
+        parallelUpdated_ = false;
+    }
+}
+
 #ifdef URHO3D_SPINE
 void AnimatedSprite2D::SetSpineAnimation()
 {
@@ -1653,6 +1753,13 @@ void AnimatedSprite2D::UpdateSourceBatches()
 	sourceBatchesDirty_ = false;
 }
 
+bool AnimatedSprite2D::CanUpdateSourceBatchesInWorker() const
+{
+    // the multimaterials path uses the material cache of Renderer2D and the render nodes path updates other drawables
+    return spriterInstance_ && spriterInstance_->GetAnimation() && spriterInstance_->GetSpriteKeys().Size() &&
+           !renderNodes_.Size() && !useCharacterMap_ && !animationSet_->IsMultiTextures();
+}
+
 template< typename T > void AnimatedSprite2D::GetVertices(const IntVector2& size, const T& transform, PODVector<float>& verticeData)
 {
     const PODVector<Spriter::SpriteTimelineKey* >& spriteKeys = spriterInstance_->GetSpriteKeys();
@@ -1841,21 +1948,21 @@ void AnimatedSprite2D::UpdateSourceBatchesSpriter_RenderNodesOrthographic()
     UpdateSourceBatchesSpriter_MultiMaterials(GetNode()->GetWorldTransform2D(), sourceBatches_, -1, !hasRendered);
 }
 
-// Rotation 90° Orthographic
-static Matrix2x3 sRotatedMatrixOrtho_(-4.37114e-08f, -1.f, 0.f, 1.f, -4.37114e-08f, 0.f);
+// Rotation 90° Orthographic (copied before setting the translation part, AddSprite can run in the worker threads)
+static const Matrix2x3 sRotatedMatrixOrtho_(-4.37114e-08f, -1.f, 0.f, 1.f, -4.37114e-08f, 0.f);
 // Rotation 90°
-static Matrix3x4 sRotatedMatrix_(5.96046e-08f, -1.f, 0.f, 0.f, 1.f, 5.96046e-08f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f);
+static const Matrix3x4 sRotatedMatrix_(5.96046e-08f, -1.f, 0.f, 0.f, 1.f, 5.96046e-08f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f);
 
 inline void AnimatedSprite2D::AddSprite(Sprite2D* sprite, const Matrix3x4& transform,
                                         float x, float y, float px, float py, float sx, float sy, float angle, float alpha, float* vertices)
 {
-    static Rect textureRect;
+    Rect textureRect;
     if (!sprite->GetTextureRectangle(textureRect, flipX_, flipY_))
         return;
 
-    static Matrix3x4 finaltransform, localTransform;
-    static Rect drawRect;
-    static Vector3 position;
+    Matrix3x4 finaltransform, localTransform;
+    Rect drawRect;
+    Vector3 position;
 
     if (flipX_)
     {
@@ -1875,9 +1982,10 @@ inline void AnimatedSprite2D::AddSprite(Sprite2D* sprite, const Matrix3x4& trans
     if (sprite->GetRotated())
     {
         // set the translation part
-        sRotatedMatrix_.m03_ = -px * (float)sprite->GetSourceSize().x_ * PIXEL_SIZE;
-        sRotatedMatrix_.m13_ = (1.f - py) * (float)sprite->GetSourceSize().y_ * PIXEL_SIZE;
-        localTransform = localTransform * sRotatedMatrix_;
+        Matrix3x4 rotatedMatrix(sRotatedMatrix_);
+        rotatedMatrix.m03_ = -px * (float)sprite->GetSourceSize().x_ * PIXEL_SIZE;
+        rotatedMatrix.m13_ = (1.f - py) * (float)sprite->GetSourceSize().y_ * PIXEL_SIZE;
+        localTransform = localTransform * rotatedMatrix;
     }
 
     finaltransform = transform * localTransform;
@@ -1923,13 +2031,13 @@ inline void AnimatedSprite2D::AddSprite(Sprite2D* sprite, const Matrix3x4& trans
 inline void AnimatedSprite2D::AddSprite(Sprite2D* sprite, const Matrix2x3& transform,
                                         float x, float y, float px, float py, float sx, float sy, float angle, float alpha, float* vertices)
 {
-    static Rect textureRect;
+    Rect textureRect;
     if (!sprite->GetTextureRectangle(textureRect, flipX_, flipY_))
         return;
 
-    static Matrix2x3 finaltransform, localTransform;
-    static Rect drawRect;
-    static Vector3 position;
+    Matrix2x3 finaltransform, localTransform;
+    Rect drawRect;
+    Vector2 position;
 
     if (flipX_)
     {
@@ -1949,9 +2057,10 @@ inline void AnimatedSprite2D::AddSprite(Sprite2D* sprite, const Matrix2x3& trans
     if (sprite->GetRotated())
     {
         // set the translation part
-        sRotatedMatrixOrtho_.m02_ = -px * (float)sprite->GetSourceSize().x_ * PIXEL_SIZE;
-        sRotatedMatrixOrtho_.m12_ = (1.f - py) * (float)sprite->GetSourceSize().y_ * PIXEL_SIZE;
-        localTransform = localTransform * sRotatedMatrixOrtho_;
+        Matrix2x3 rotatedMatrix(sRotatedMatrixOrtho_);
+        rotatedMatrix.m02_ = -px * (float)sprite->GetSourceSize().x_ * PIXEL_SIZE;
+        rotatedMatrix.m12_ = (1.f - py) * (float)sprite->GetSourceSize().y_ * PIXEL_SIZE;
+        localTransform = localTransform * rotatedMatrix;
     }
 
     finaltransform = transform * localTransform;
@@ -223,6 +223,22 @@ public:
     /// Update animation.
     void UpdateAnimation(float timeStep);
 
+    /// Set parallel update for the next enabled instances : the animations are updated by Renderer2D on the worker threads.
+    /// Off by default : the triggers of all the sprites are then published after all the animations have advanced, not interleaved by sprite.
+    static void SetParallelUpdate(bool enable);
+    /// Return whether parallel update is enabled.
+    static bool IsParallelUpdate() { return parallelUpdate_; }
+
+    /// Parallel update, main thread : check visibility. Return true if the animation has to be updated (called by Renderer2D).
+    bool BeginAnimationUpdate(float timeStep);
+    /// Parallel update, worker thread : update the spriter instance only.
+    void UpdateAnimationInWorker();
+    /// Parallel update, main thread : update the triggers and the dirty flags.
+    void EndAnimationUpdate();
+
+    /// Return whether the source batches can be updated in a worker thread : single material, no render nodes.
+    virtual bool CanUpdateSourceBatchesInWorker() const;
+
 /// HELPERS
 
     void DumpSpritesInfos() const;
@@ -240,6 +256,10 @@ protected:
 
     /// Handle scene post update.
     void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Subscribe to the animation update : scene post update event or Renderer2D in parallel update.
+    void SubscribeToAnimationUpdate(Scene* scene);
+    /// Unsubscribe from the animation update.
+    void UnsubscribeFromAnimationUpdate();
 
 #ifdef URHO3D_SPINE
     /// Handle set spine animation.
@@ -337,6 +357,13 @@ protected:
 
     /// Trigger Infos
     EventTriggerInfo triggerInfo_;
+
+    /// Parallel update : time step and spriter instance updated.
+    float parallelTimeStep_;
+    bool parallelUpdated_;
+
+    /// Parallel update for the next enabled instances.
+    static bool parallelUpdate_;
 };
 
 }
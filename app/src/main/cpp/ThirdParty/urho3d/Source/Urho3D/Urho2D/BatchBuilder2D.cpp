@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2008-2016 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "../Precompiled.h"
+
+#include "../Container/Sort.h"
+#include "../Graphics/Material.h"
+#include "../Urho2D/BatchBuilder2D.h"
+
+#include "../DebugNew.h"
+
+namespace Urho3D
+{
+
+BatchBuilder2D::BatchBuilder2D() :
+    lastNumSorted_(0),
+    numSortMoves_(0)
+{
+    for (int i=0; i<2; i++)
+    {
+        indexCount_[i] = 0;
+        vertexCount_[i] = 0;
+        storageDirty_[i] = false;
+    }
+}
+
+void BatchBuilder2D::Clear()
+{
+    sourceBatches_.Clear();
+}
+
+unsigned long long BatchBuilder2D::GetSortKey(const SourceBatch2D* batch)
+{
+    // Flip the sign bit so that the negative draw orders come first
+    unsigned long long key = (unsigned long long)((unsigned)batch->drawOrder_ ^ 0x80000000) << 32;
+    key |= (unsigned long long)batch->material_->GetNameHash().Value();
+    return key;
+}
+
+static inline bool IsBefore(unsigned long long lkey, const SourceBatch2D* lhs, unsigned long long rkey, const SourceBatch2D* rhs)
+{
+    // The whole key is taken by the draw order and the material hash, the primitive type only breaks the ties (triangles after quads)
+    if (lkey != rkey)
+        return lkey < rkey;
+    if (lhs->quadvertices_ != rhs->quadvertices_)
+        return lhs->quadvertices_;
+    return lhs < rhs;
+}
+
+template <class T> static inline bool CompareSortedBatch2Ds(const T& lhs, const T& rhs)
+{
+    return IsBefore(lhs.key_, lhs.batch_, rhs.key_, rhs.batch_);
+}
+
+void BatchBuilder2D::SortSourceBatches()
+{
+    const unsigned numBatches = sourceBatches_.Size();
+
+    // Put back the batches at their rank of the last sort, the new ones (or ranked by an other view) are apart
+    rankedBatches_.Resize(lastNumSorted_);
+    for (unsigned i = 0; i < lastNumSorted_; ++i)
+        rankedBatches_[i].batch_ = 0;
+
+    unrankedBatches_.Clear();
+    for (unsigned i = 0; i < numBatches; ++i)
+    {
+        const SourceBatch2D* batch = sourceBatches_[i];
+        SortedBatch2D entry = { GetSortKey(batch), batch };
+        unsigned rank = batch->sortRank_;
+        if (rank < lastNumSorted_ && !rankedBatches_[rank].batch_)
+            rankedBatches_[rank] = entry;
+        else
+            unrankedBatches_.Push(entry);
+    }
+
+    // The ranked batches keep their last order
+    sortedBatches_.Clear();
+    for (unsigned i = 0; i < lastNumSorted_; ++i)
+    {
+        if (rankedBatches_[i].batch_)
+            sortedBatches_.Push(rankedBatches_[i]);
+    }
+    rankedBatches_.Swap(sortedBatches_);
+
+    const unsigned numRanked = rankedBatches_.Size();
+    numSortMoves_ = 0;
+
+    // Insertion sort of the ranked batches, near linear when only a few keys have changed,
+    // with a move budget before falling back to a full sort
+    const unsigned maxMoves = numRanked * 4 + 64;
+    bool fullSort = false;
+    for (unsigned i = 1; i < numRanked && !fullSort; ++i)
+    {
+        SortedBatch2D entry = rankedBatches_[i];
+        unsigned j = i;
+        while (j > 0 && IsBefore(entry.key_, entry.batch_, rankedBatches_[j-1].key_, rankedBatches_[j-1].batch_))
+        {
+            rankedBatches_[j] = rankedBatches_[j-1];
+            --j;
+            if (++numSortMoves_ > maxMoves)
+            {
+                fullSort = true;
+                break;
+            }
+        }
+        rankedBatches_[j] = entry;
+    }
+    if (fullSort)
+        Sort(rankedBatches_.Begin(), rankedBatches_.End(), CompareSortedBatch2Ds<SortedBatch2D>);
+
+    // The new batches are sorted apart and merged
+    Sort(unrankedBatches_.Begin(), unrankedBatches_.End(), CompareSortedBatch2Ds<SortedBatch2D>);
+    numSortMoves_ += unrankedBatches_.Size();
+
+    sortedBatches_.Resize(numBatches);
+    unsigned r = 0, u = 0;
+    const unsigned numUnranked = unrankedBatches_.Size();
+    for (unsigned i = 0; i < numBatches; ++i)
+    {
+        if (u == numUnranked || (r < numRanked && !CompareSortedBatch2Ds(unrankedBatches_[u], rankedBatches_[r])))
+            sortedBatches_[i] = rankedBatches_[r++];
+        else
+            sortedBatches_[i] = unrankedBatches_[u++];
+    }
+
+    for (unsigned i = 0; i < numBatches; ++i)
+    {
+        sourceBatches_[i] = sortedBatches_[i].batch_;
+        sourceBatches_[i]->sortRank_ = i;
+    }
+
+    lastNumSorted_ = numBatches;
+}
+
+void BatchBuilder2D::Build()
+{
+    SortSourceBatches();
+
+    drawRanges_.Clear();
+
+    unsigned iStart[2] = { 0, 0 };
+    unsigned iCount[2] = { 0, 0 };
+    unsigned vStart[2] = { 0, 0 };
+    unsigned vCount[2] = { 0, 0 };
+    Material* currMaterial = 0;
+    int currType = sourceBatches_.Size() ? sourceBatches_[0]->quadvertices_ : QUAD2D;
+
+    for (unsigned b = 0; b < sourceBatches_.Size(); ++b)
+    {
+        Material* material = sourceBatches_[b]->material_;
+        int primitiveType = sourceBatches_[b]->quadvertices_;
+        unsigned numVertices = sourceBatches_[b]->vertices_.Size();
+
+        // When new material encountered, finish the current range and start new
+        if (currMaterial != material || currType != primitiveType)
+        {
+            if (currMaterial && iCount[currType] && vCount[currType])
+            {
+                DrawRange2D range = { currMaterial, currType, iStart[currType], iCount[currType], vStart[currType], vCount[currType] };
+                drawRanges_.Push(range);
+            }
+
+            iStart[currType] += iCount[currType];
+            iCount[currType] = 0;
+            vStart[currType] += vCount[currType];
+            vCount[currType] = 0;
+
+            currMaterial = material;
+            currType = primitiveType;
+        }
+
+        iCount[currType] += currType == QUAD2D ? numVertices * 6 / 4 : numVertices;
+        vCount[currType] += numVertices;
+    }
+
+    // Add the final range if necessary
+    if (currMaterial && iCount[currType] && vCount[currType])
+    {
+        DrawRange2D range = { currMaterial, currType, iStart[currType], iCount[currType], vStart[currType], vCount[currType] };
+        drawRanges_.Push(range);
+    }
+
+    for (int primitiveType=0; primitiveType<2; primitiveType++)
+    {
+        indexCount_[primitiveType]  = iStart[primitiveType] + iCount[primitiveType];
+        vertexCount_[primitiveType] = vStart[primitiveType] + vCount[primitiveType];
+    }
+}
+
+unsigned BatchBuilder2D::PackVertices(int primitiveType)
+{
+    PODVector<Vertex2D>& storage = vertices_[primitiveType];
+    PODVector<PackedRange2D>& packedRanges = packedRanges_[primitiveType];
+
+    // Grow the storage, the packed vertices are kept
+    if (storage.Size() < vertexCount_[primitiveType])
+        storage.Resize(vertexCount_[primitiveType]);
+
+    newPackedRanges_.Clear();
+
+    unsigned offset = 0;
+    unsigned oldOffset = 0;
+    unsigned numCopied = 0;
+    unsigned p = 0;
+
+    for (unsigned b = 0; b < sourceBatches_.Size(); ++b)
+    {
+        const SourceBatch2D* batch = sourceBatches_[b];
+        if (batch->quadvertices_ != primitiveType)
+            continue;
+
+        const Vector<Vertex2D>& vertices = batch->vertices_;
+        const unsigned count = vertices.Size();
+
+        // Keep the range if the same batch, unchanged, was packed at the same offset
+        bool keep = false;
+        if (p < packedRanges.Size())
+        {
+            const PackedRange2D& range = packedRanges[p++];
+            keep = offset == oldOffset && range.batch_ == batch && range.version_ == batch->version_ && range.count_ == count;
+            oldOffset += range.count_;
+        }
+
+        if (!keep)
+        {
+            memcpy(&storage[offset], vertices.Buffer(), count * sizeof(Vertex2D));
+            numCopied += count;
+        }
+
+        PackedRange2D range = { batch, batch->version_, count };
+        newPackedRanges_.Push(range);
+        offset += count;
+    }
+
+    packedRanges.Swap(newPackedRanges_);
+
+    if (numCopied)
+        storageDirty_[primitiveType] = true;
+
+    return numCopied;
+}
+
+}
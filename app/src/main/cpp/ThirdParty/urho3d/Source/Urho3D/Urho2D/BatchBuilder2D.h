@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2008-2016 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../Container/Ptr.h"
+#include "../Urho2D/Drawable2D.h"
+
+namespace Urho3D
+{
+
+class Material;
+
+/// 2D primitive types.
+static const int TRIANGLE2D = 0;
+static const int QUAD2D = 1;
+
+/// 2D draw range : consecutive source batches with the same material and primitive type.
+struct DrawRange2D
+{
+    /// Material.
+    Material* material_;
+    /// Primitive type.
+    int primitiveType_;
+    /// Index start.
+    unsigned indexStart_;
+    /// Index count.
+    unsigned indexCount_;
+    /// Vertex start.
+    unsigned vertexStart_;
+    /// Vertex count.
+    unsigned vertexCount_;
+};
+
+/// CPU-side 2D batch builder, does not need the Graphics subsystem.
+/// Sorts the source batches of a view, groups them in draw ranges and packs their vertices in a persistent storage per primitive type.
+/// The sort uses a 64-bit key (draw order, material), then the primitive type and the batch address, and starts from the order of the previous sort :
+/// the batches are put back at their last rank, resorted by insertion (only those whose key changed move), and the new batches are merged.
+/// A source batch found at the same place, with the same version and size as in the previous pack, keeps its range and is not copied again.
+class URHO3D_API BatchBuilder2D
+{
+public:
+    /// Construct.
+    BatchBuilder2D();
+
+    /// Clear the source batches before a new build.
+    void Clear();
+    /// Add a source batch.
+    void AddSourceBatch(const SourceBatch2D* batch) { sourceBatches_.Push(batch); }
+    /// Sort the source batches and compute the draw ranges and the index/vertex counts.
+    void Build();
+    /// Pack the vertices of a primitive type in the storage. Return the number of copied vertices.
+    unsigned PackVertices(int primitiveType);
+
+    /// Return the sort key of a source batch : draw order (32 bits), material name hash (32 bits). On equal keys, the triangles come after the quads.
+    static unsigned long long GetSortKey(const SourceBatch2D* batch);
+
+    /// Return the sorted source batches.
+    const PODVector<const SourceBatch2D*>& GetSourceBatches() const { return sourceBatches_; }
+    /// Return the draw ranges.
+    const PODVector<DrawRange2D>& GetDrawRanges() const { return drawRanges_; }
+    /// Return the index count of a primitive type.
+    unsigned GetIndexCount(int primitiveType) const { return indexCount_[primitiveType]; }
+    /// Return the vertex count of a primitive type.
+    unsigned GetVertexCount(int primitiveType) const { return vertexCount_[primitiveType]; }
+    /// Return the packed vertices of a primitive type.
+    const Vertex2D* GetVertices(int primitiveType) const { return vertices_[primitiveType].Buffer(); }
+    /// Return the number of batch moves of the last sort (0 if the order was unchanged).
+    unsigned GetNumSortMoves() const { return numSortMoves_; }
+    /// Return whether the storage of a primitive type has changed since the last call to ClearStorageDirty.
+    bool IsStorageDirty(int primitiveType) const { return storageDirty_[primitiveType]; }
+    /// Clear the storage dirty flag of a primitive type (after the upload).
+    void ClearStorageDirty(int primitiveType) { storageDirty_[primitiveType] = false; }
+
+private:
+    /// Sort the source batches.
+    void SortSourceBatches();
+
+    /// Source batch with its sort key.
+    struct SortedBatch2D
+    {
+        /// Sort key.
+        unsigned long long key_;
+        /// Source batch.
+        const SourceBatch2D* batch_;
+    };
+
+    /// Range of a source batch in the storage.
+    struct PackedRange2D
+    {
+        /// Source batch.
+        const SourceBatch2D* batch_;
+        /// Vertices version of the source batch when packed (unique across batches, so a reused batch address never matches).
+        unsigned version_;
+        /// Vertex count.
+        unsigned count_;
+    };
+
+    /// Sorted source batches.
+    PODVector<const SourceBatch2D*> sourceBatches_;
+    /// Sort entries.
+    PODVector<SortedBatch2D> sortedBatches_;
+    /// Sort entries with their last rank.
+    PODVector<SortedBatch2D> rankedBatches_;
+    /// Sort entries without a valid last rank.
+    PODVector<SortedBatch2D> unrankedBatches_;
+    /// Number of batches of the last sort.
+    unsigned lastNumSorted_;
+    /// Number of batch moves of the last sort.
+    unsigned numSortMoves_;
+    /// Draw ranges.
+    PODVector<DrawRange2D> drawRanges_;
+    /// Index counts.
+    unsigned indexCount_[2];
+    /// Vertex counts.
+    unsigned vertexCount_[2];
+    /// Persistent vertex storages (grown, never shrunk).
+    PODVector<Vertex2D> vertices_[2];
+    /// Packed ranges in storage order.
+    PODVector<PackedRange2D> packedRanges_[2];
+    /// Packed ranges of the current pack.
+    PODVector<PackedRange2D> newPackedRanges_;
+    /// Storage dirty flags.
+    bool storageDirty_[2];
+};
+
+}
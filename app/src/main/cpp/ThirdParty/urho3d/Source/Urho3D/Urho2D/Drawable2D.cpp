@@ -31,6 +31,8 @@
 #include "../Urho2D/Drawable2D.h"
 #include "../Urho2D/Renderer2D.h"
 
+#include <atomic>
+
 #include "../DebugNew.h"
 
 namespace Urho3D
@@ -38,11 +40,22 @@ namespace Urho3D
 
 const float PIXEL_SIZE = 0.01f;
 
+/// Global vertices version counter : a batch address can be reused by another batch, so the versions must not restart from 0 per batch.
+static std::atomic<unsigned> sourceBatchVersion_(0);
+
 SourceBatch2D::SourceBatch2D() :
     distance_(0.0f),
     drawOrder_(0),
-    quadvertices_(true)
+    quadvertices_(true),
+    version_(NextVersion()),
+    sortRank_(M_MAX_UNSIGNED)
+{
+}
+
+unsigned SourceBatch2D::NextVersion()
 {
+    // source batches are updated from the worker threads (CheckDrawableVisibility)
+    return sourceBatchVersion_.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 Drawable2D::Drawable2D(Context* context) :
@@ -153,7 +166,10 @@ void Drawable2D::ClearSourceBatches()
     sourceBatchesToRender_.Clear();
 
     for (unsigned i=0; i < sourceBatches_.Size(); i++)
+    {
         sourceBatches_[i].vertices_.Clear();
+        sourceBatches_[i].version_ = SourceBatch2D::NextVersion();
+    }
 }
 
 void Drawable2D::UpdateSourceBatchesToRender()
@@ -162,7 +178,10 @@ void Drawable2D::UpdateSourceBatchesToRender()
 
     sourceBatchesToRender_.Clear();
     for (unsigned i=0; i < sourceBatches_.Size(); i++)
+    {
+        sourceBatches_[i].version_ = SourceBatch2D::NextVersion();
         sourceBatchesToRender_.Push(&(sourceBatches_[i]));
+    }
 }
 
 //const Vector<SourceBatch2D>& Drawable2D::GetSourceBatches()
@@ -50,6 +50,9 @@ struct SourceBatch2D
     /// Construct.
     SourceBatch2D();
 
+    /// Return a new vertices version, unique across all the source batches.
+    static unsigned NextVersion();
+
     /// Owner.
     WeakPtr<Drawable2D> owner_;
     /// Distance to camera.
@@ -62,6 +65,10 @@ struct SourceBatch2D
     bool quadvertices_;
     /// Vertices.
     Vector<Vertex2D> vertices_;
+    /// Vertices version, renewed from NextVersion() on each update of the source batches (used by Renderer2D to skip the copy of unchanged vertices).
+    unsigned version_;
+    /// Rank in the last sorted batch list of Renderer2D (hint for the next sort).
+    mutable unsigned sortRank_;
 };
 
 /// Pixel size (equal 0.01f).
@@ -106,6 +113,10 @@ public:
 //    const Vector<SourceBatch2D>& GetSourceBatches();
     /// Return all source batches To Renderer (called by Renderer2D).
     const Vector<SourceBatch2D* >& GetSourceBatchesToRender();
+    /// Return whether the source batches need an update.
+    bool IsSourceBatchesDirty() const { return sourceBatchesDirty_; }
+    /// Return whether the source batches can be updated in a worker thread (no shared state written, called by Renderer2D).
+    virtual bool CanUpdateSourceBatchesInWorker() const { return false; }
 //    virtual BoundingBox GetFixedWorldBoundingBox();
 
     void ForceUpdateBatches();
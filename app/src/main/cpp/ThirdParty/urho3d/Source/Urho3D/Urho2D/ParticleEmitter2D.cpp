@@ -41,6 +41,53 @@ namespace Urho3D
 extern const char* URHO2D_CATEGORY;
 extern const char* blendModeNames[];
 
+void Particles2D::Resize(unsigned size)
+{
+    timeToLive_.Resize(size);
+    timeStep_.Resize(size);
+    positionX_.Resize(size);
+    positionY_.Resize(size);
+    size_.Resize(size);
+    sizeDelta_.Resize(size);
+    rotation_.Resize(size);
+    rotationDelta_.Resize(size);
+    color_.Resize(size);
+    colorDelta_.Resize(size);
+    startPosX_.Resize(size);
+    startPosY_.Resize(size);
+    velocityX_.Resize(size);
+    velocityY_.Resize(size);
+    radialAcceleration_.Resize(size);
+    tangentialAcceleration_.Resize(size);
+    emitRadius_.Resize(size);
+    emitRadiusDelta_.Resize(size);
+    emitRotation_.Resize(size);
+    emitRotationDelta_.Resize(size);
+}
+
+void Particles2D::Copy(unsigned dest, unsigned src)
+{
+    timeToLive_[dest] = timeToLive_[src];
+    positionX_[dest] = positionX_[src];
+    positionY_[dest] = positionY_[src];
+    size_[dest] = size_[src];
+    sizeDelta_[dest] = sizeDelta_[src];
+    rotation_[dest] = rotation_[src];
+    rotationDelta_[dest] = rotationDelta_[src];
+    color_[dest] = color_[src];
+    colorDelta_[dest] = colorDelta_[src];
+    startPosX_[dest] = startPosX_[src];
+    startPosY_[dest] = startPosY_[src];
+    velocityX_[dest] = velocityX_[src];
+    velocityY_[dest] = velocityY_[src];
+    radialAcceleration_[dest] = radialAcceleration_[src];
+    tangentialAcceleration_[dest] = tangentialAcceleration_[src];
+    emitRadius_[dest] = emitRadius_[src];
+    emitRadiusDelta_[dest] = emitRadiusDelta_[src];
+    emitRotation_[dest] = emitRotation_[src];
+    emitRotationDelta_[dest] = emitRotationDelta_[src];
+}
+
 ParticleEmitter2D::ParticleEmitter2D(Context* context) :
     Drawable2D(context),
     blendMode_(BLEND_ADDALPHA),
@@ -249,42 +296,44 @@ void ParticleEmitter2D::UpdateSourceBatches()
     | /         |
     V0---------V3
     */
-    Vertex2D vertex0;
-    Vertex2D vertex1;
-    Vertex2D vertex2;
-    Vertex2D vertex3;
+    const Vector2 uv0 = textureRect.min_;
+    const Vector2 uv1 = Vector2(textureRect.min_.x_, textureRect.max_.y_);
+    const Vector2 uv2 = textureRect.max_;
+    const Vector2 uv3 = Vector2(textureRect.max_.x_, textureRect.min_.y_);
 
-    vertex0.uv_ = textureRect.min_;
-    vertex1.uv_ = Vector2(textureRect.min_.x_, textureRect.max_.y_);
-    vertex2.uv_ = textureRect.max_;
-    vertex3.uv_ = Vector2(textureRect.max_.x_, textureRect.min_.y_);
+    // Write the vertices straight into the batch
+    vertices.Resize(numParticles_ * 4);
+    Vertex2D* dest = vertices.Buffer();
+
+    const float* positionX = particles_.positionX_.Buffer();
+    const float* positionY = particles_.positionY_.Buffer();
+    const float* size = particles_.size_.Buffer();
+    const float* rotation = particles_.rotation_.Buffer();
+    const Color* color = particles_.color_.Buffer();
 
     for (unsigned i = 0; i < numParticles_; ++i)
     {
-        Particle2D& p = particles_[i];
-
-        float rotation = -p.rotation_;
-        float c = Cos(rotation);
-        float s = Sin(rotation);
-        float add = (c + s) * p.size_ * 0.5f;
-        float sub = (c - s) * p.size_ * 0.5f;
-
-//        vertex0.position_ = Vector3(p.position_.x_ - sub, p.position_.y_ - add, p.position_.z_);
-//        vertex1.position_ = Vector3(p.position_.x_ - add, p.position_.y_ + sub, p.position_.z_);
-//        vertex2.position_ = Vector3(p.position_.x_ + sub, p.position_.y_ + add, p.position_.z_);
-//        vertex3.position_ = Vector3(p.position_.x_ + add, p.position_.y_ - sub, p.position_.z_);
-
-        vertex0.position_ = Vector2(p.position_.x_ - sub, p.position_.y_ - add);
-        vertex1.position_ = Vector2(p.position_.x_ - add, p.position_.y_ + sub);
-        vertex2.position_ = Vector2(p.position_.x_ + sub, p.position_.y_ + add);
-        vertex3.position_ = Vector2(p.position_.x_ + add, p.position_.y_ - sub);
-
-        vertex0.color_ = vertex1.color_ = vertex2.color_ = vertex3.color_ = p.color_.ToUInt();
-
-        vertices.Push(vertex0);
-        vertices.Push(vertex1);
-        vertices.Push(vertex2);
-        vertices.Push(vertex3);
+        float c = Cos(-rotation[i]);
+        float s = Sin(-rotation[i]);
+        float add = (c + s) * size[i] * 0.5f;
+        float sub = (c - s) * size[i] * 0.5f;
+        float x = positionX[i];
+        float y = positionY[i];
+        unsigned uintColor = color[i].ToUInt();
+
+        dest[0].position_ = Vector3(x - sub, y - add, 0.0f);
+        dest[1].position_ = Vector3(x - add, y + sub, 0.0f);
+        dest[2].position_ = Vector3(x + sub, y + add, 0.0f);
+        dest[3].position_ = Vector3(x + add, y - sub, 0.0f);
+
+        dest[0].color_ = dest[1].color_ = dest[2].color_ = dest[3].color_ = uintColor;
+
+        dest[0].uv_ = uv0;
+        dest[1].uv_ = uv1;
+        dest[2].uv_ = uv2;
+        dest[3].uv_ = uv3;
+
+        dest += 4;
     }
 
     sourceBatchesDirty_ = false;
@@ -317,23 +366,24 @@ void ParticleEmitter2D::Update(float timeStep)
     boundingBoxMinPoint_ = Vector3(M_INFINITY, M_INFINITY, M_INFINITY);
     boundingBoxMaxPoint_ = Vector3(-M_INFINITY, -M_INFINITY, -M_INFINITY);
 
+    // Remove the dead particles, in the same order as before the update
     unsigned particleIndex = 0;
     while (particleIndex < numParticles_)
     {
-        Particle2D& particle = particles_[particleIndex];
-        if (particle.timeToLive_ > 0.0f)
+        if (particles_.timeToLive_[particleIndex] > 0.0f)
         {
-            UpdateParticle(particle, timeStep, worldScale);
             ++particleIndex;
         }
         else
         {
             if (particleIndex != numParticles_ - 1)
-                particles_[particleIndex] = particles_[numParticles_ - 1];
+                particles_.Copy(particleIndex, numParticles_ - 1);
             --numParticles_;
         }
     }
 
+    UpdateParticles(0, numParticles_, timeStep, worldScale);
+
     if (emissionTime_ > 0.0f)
     {
         float worldAngle = GetNode()->GetWorldRotation().RollAngle();
@@ -344,7 +394,7 @@ void ParticleEmitter2D::Update(float timeStep)
         while (emitParticleTime_ > 0.0f)
         {
             if (EmitParticle(worldPosition, worldAngle, worldScale))
-                UpdateParticle(particles_[numParticles_ - 1], emitParticleTime_, worldScale);
+                UpdateParticles(numParticles_ - 1, numParticles_, emitParticleTime_, worldScale);
 
             emitParticleTime_ -= timeBetweenParticles;
         }
@@ -381,104 +431,144 @@ bool ParticleEmitter2D::EmitParticle(const Vector2& worldPosition, float worldAn
 
     float invLifespan = 1.0f / lifespan;
 
-    Particle2D& particle = particles_[numParticles_++];
-    particle.timeToLive_ = lifespan;
+    const unsigned i = numParticles_++;
+    particles_.timeToLive_[i] = lifespan;
 
-    particle.position_.x_ = worldPosition.x_ + worldScale * effect_->GetSourcePositionVariance().x_ * Random(-1.0f, 1.0f);
-    particle.position_.y_ = worldPosition.y_ + worldScale * effect_->GetSourcePositionVariance().y_ * Random(-1.0f, 1.0f);
-//    particle.position_.z_ = worldPosition.z_;
-    particle.startPos_.x_ = worldPosition.x_;
-    particle.startPos_.y_ = worldPosition.y_;
+    particles_.positionX_[i] = worldPosition.x_ + worldScale * effect_->GetSourcePositionVariance().x_ * Random(-1.0f, 1.0f);
+    particles_.positionY_[i] = worldPosition.y_ + worldScale * effect_->GetSourcePositionVariance().y_ * Random(-1.0f, 1.0f);
+    particles_.startPosX_[i] = worldPosition.x_;
+    particles_.startPosY_[i] = worldPosition.y_;
 
     float angle = worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * Random(-1.0f, 1.0f);
     float speed = worldScale * (effect_->GetSpeed() + effect_->GetSpeedVariance() * Random(-1.0f, 1.0f));
-    particle.velocity_.x_ = speed * Cos(angle);
-    particle.velocity_.y_ = speed * Sin(angle);
+    particles_.velocityX_[i] = speed * Cos(angle);
+    particles_.velocityY_[i] = speed * Sin(angle);
 
     float maxRadius = Max(0.0f, worldScale * (effect_->GetMaxRadius() + effect_->GetMaxRadiusVariance() * Random(-1.0f, 1.0f)));
     float minRadius = Max(0.0f, worldScale * (effect_->GetMinRadius() + effect_->GetMinRadiusVariance() * Random(-1.0f, 1.0f)));
-    particle.emitRadius_ = maxRadius;
-    particle.emitRadiusDelta_ = (minRadius - maxRadius) * invLifespan;
-    particle.emitRotation_ = worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * Random(-1.0f, 1.0f);
-    particle.emitRotationDelta_ = effect_->GetRotatePerSecond() + effect_->GetRotatePerSecondVariance() * Random(-1.0f, 1.0f);
-    particle.radialAcceleration_ =
+    particles_.emitRadius_[i] = maxRadius;
+    particles_.emitRadiusDelta_[i] = (minRadius - maxRadius) * invLifespan;
+    particles_.emitRotation_[i] = worldAngle + effect_->GetAngle() + effect_->GetAngleVariance() * Random(-1.0f, 1.0f);
+    particles_.emitRotationDelta_[i] = effect_->GetRotatePerSecond() + effect_->GetRotatePerSecondVariance() * Random(-1.0f, 1.0f);
+    particles_.radialAcceleration_[i] =
         worldScale * (effect_->GetRadialAcceleration() + effect_->GetRadialAccelVariance() * Random(-1.0f, 1.0f));
-    particle.tangentialAcceleration_ =
+    particles_.tangentialAcceleration_[i] =
         worldScale * (effect_->GetTangentialAcceleration() + effect_->GetTangentialAccelVariance() * Random(-1.0f, 1.0f));
 
     float startSize =
         worldScale * Max(0.1f, effect_->GetStartParticleSize() + effect_->GetStartParticleSizeVariance() * Random(-1.0f, 1.0f));
     float finishSize =
         worldScale * Max(0.1f, effect_->GetFinishParticleSize() + effect_->GetFinishParticleSizeVariance() * Random(-1.0f, 1.0f));
-    particle.size_ = startSize;
-    particle.sizeDelta_ = (finishSize - startSize) * invLifespan;
+    particles_.size_[i] = startSize;
+    particles_.sizeDelta_[i] = (finishSize - startSize) * invLifespan;
 
-    particle.color_ = effect_->GetStartColor() * color_.Luma() + effect_->GetStartColorVariance() * Random(-1.0f, 1.0f) ;
+    Color startColor = effect_->GetStartColor() * color_.Luma() + effect_->GetStartColorVariance() * Random(-1.0f, 1.0f) ;
     Color endColor = effect_->GetFinishColor() * color_.Luma() + effect_->GetFinishColorVariance() * Random(-1.0f, 1.0f);
-    particle.colorDelta_ = (endColor - particle.color_) * invLifespan;
+    particles_.color_[i] = startColor;
+    particles_.colorDelta_[i] = (endColor - startColor) * invLifespan;
 
-    particle.rotation_ = worldAngle + effect_->GetRotationStart() + effect_->GetRotationStartVariance() * Random(-1.0f, 1.0f);
+    float startRotation = worldAngle + effect_->GetRotationStart() + effect_->GetRotationStartVariance() * Random(-1.0f, 1.0f);
     float endRotation = worldAngle + effect_->GetRotationEnd() + effect_->GetRotationEndVariance() * Random(-1.0f, 1.0f);
-    particle.rotationDelta_ = (endRotation - particle.rotation_) * invLifespan;
+    particles_.rotation_[i] = startRotation;
+    particles_.rotationDelta_[i] = (endRotation - startRotation) * invLifespan;
 
     return true;
 }
 
-void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, float worldScale)
-//void ParticleEmitter2D::UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale)
+void ParticleEmitter2D::UpdateParticles(unsigned start, unsigned end, float timeStep, float worldScale)
 {
-    if (timeStep > particle.timeToLive_)
-        timeStep = particle.timeToLive_;
+    if (start >= end)
+        return;
 
-    particle.timeToLive_ -= timeStep;
+    // Each attribute is updated in its own loop, without branch, so that the compiler can vectorize them
+    float* timeToLive = particles_.timeToLive_.Buffer();
+    float* timeSteps = particles_.timeStep_.Buffer();
+    for (unsigned i = start; i < end; ++i)
+    {
+        float dt = timeStep > timeToLive[i] ? timeToLive[i] : timeStep;
+        timeToLive[i] -= dt;
+        timeSteps[i] = dt;
+    }
+
+    float* positionX = particles_.positionX_.Buffer();
+    float* positionY = particles_.positionY_.Buffer();
+    const float* startPosX = particles_.startPosX_.Buffer();
+    const float* startPosY = particles_.startPosY_.Buffer();
 
     if (effect_->GetEmitterType() == EMITTER_TYPE_RADIAL)
     {
-        particle.emitRotation_ += particle.emitRotationDelta_ * timeStep;
-        particle.emitRadius_ += particle.emitRadiusDelta_ * timeStep;
+        float* emitRotation = particles_.emitRotation_.Buffer();
+        float* emitRadius = particles_.emitRadius_.Buffer();
+        const float* emitRotationDelta = particles_.emitRotationDelta_.Buffer();
+        const float* emitRadiusDelta = particles_.emitRadiusDelta_.Buffer();
+
+        for (unsigned i = start; i < end; ++i)
+        {
+            emitRotation[i] += emitRotationDelta[i] * timeSteps[i];
+            emitRadius[i] += emitRadiusDelta[i] * timeSteps[i];
 
-        particle.position_.x_ = particle.startPos_.x_ - Cos(particle.emitRotation_) * particle.emitRadius_;
-        particle.position_.y_ = particle.startPos_.y_ + Sin(particle.emitRotation_) * particle.emitRadius_;
+            positionX[i] = startPosX[i] - Cos(emitRotation[i]) * emitRadius[i];
+            positionY[i] = startPosY[i] + Sin(emitRotation[i]) * emitRadius[i];
+        }
     }
     else
     {
-        float distanceX = particle.position_.x_ - particle.startPos_.x_;
-        float distanceY = particle.position_.y_ - particle.startPos_.y_;
+        float* velocityX = particles_.velocityX_.Buffer();
+        float* velocityY = particles_.velocityY_.Buffer();
+        const float* radialAcceleration = particles_.radialAcceleration_.Buffer();
+        const float* tangentialAcceleration = particles_.tangentialAcceleration_.Buffer();
+        const float gravityX = effect_->GetGravity().x_ * worldScale;
+        const float gravityY = effect_->GetGravity().y_ * worldScale;
+
+        for (unsigned i = start; i < end; ++i)
+        {
+            float distanceX = positionX[i] - startPosX[i];
+            float distanceY = positionY[i] - startPosY[i];
 
-        float distanceScalar = Vector2(distanceX, distanceY).Length();
-        if (distanceScalar < 0.0001f)
-            distanceScalar = 0.0001f;
+            float distanceScalar = sqrtf(distanceX * distanceX + distanceY * distanceY);
+            if (distanceScalar < 0.0001f)
+                distanceScalar = 0.0001f;
 
-        float radialX = distanceX / distanceScalar;
-        float radialY = distanceY / distanceScalar;
+            float radialX = distanceX / distanceScalar;
+            float radialY = distanceY / distanceScalar;
 
-        float tangentialX = radialX;
-        float tangentialY = radialY;
+            float tangentialX = -radialY * tangentialAcceleration[i];
+            float tangentialY = radialX * tangentialAcceleration[i];
 
-        radialX *= particle.radialAcceleration_;
-        radialY *= particle.radialAcceleration_;
+            radialX *= radialAcceleration[i];
+            radialY *= radialAcceleration[i];
 
-        float newY = tangentialX;
-        tangentialX = -tangentialY * particle.tangentialAcceleration_;
-        tangentialY = newY * particle.tangentialAcceleration_;
+            velocityX[i] += (gravityX + radialX - tangentialX) * timeSteps[i];
+            velocityY[i] -= (gravityY - radialY + tangentialY) * timeSteps[i];
+            positionX[i] += velocityX[i] * timeSteps[i];
+            positionY[i] += velocityY[i] * timeSteps[i];
+        }
+    }
 
-        particle.velocity_.x_ += (effect_->GetGravity().x_ * worldScale + radialX - tangentialX) * timeStep;
-        particle.velocity_.y_ -= (effect_->GetGravity().y_ * worldScale - radialY + tangentialY) * timeStep;
-        particle.position_.x_ += particle.velocity_.x_ * timeStep;
-        particle.position_.y_ += particle.velocity_.y_ * timeStep;
+    float* size = particles_.size_.Buffer();
+    float* rotation = particles_.rotation_.Buffer();
+    Color* color = particles_.color_.Buffer();
+    const float* sizeDelta = particles_.sizeDelta_.Buffer();
+    const float* rotationDelta = particles_.rotationDelta_.Buffer();
+    const Color* colorDelta = particles_.colorDelta_.Buffer();
+    for (unsigned i = start; i < end; ++i)
+    {
+        size[i] += sizeDelta[i] * timeSteps[i];
+        rotation[i] += rotationDelta[i] * timeSteps[i];
+        color[i].r_ += colorDelta[i].r_ * timeSteps[i];
+        color[i].g_ += colorDelta[i].g_ * timeSteps[i];
+        color[i].b_ += colorDelta[i].b_ * timeSteps[i];
+        color[i].a_ += colorDelta[i].a_ * timeSteps[i];
     }
 
-    particle.size_ += particle.sizeDelta_ * timeStep;
-    particle.rotation_ += particle.rotationDelta_ * timeStep;
-    particle.color_ += particle.colorDelta_ * timeStep;
-
-    float halfSize = particle.size_ * 0.5f;
-    boundingBoxMinPoint_.x_ = Min(boundingBoxMinPoint_.x_, particle.position_.x_ - halfSize);
-    boundingBoxMinPoint_.y_ = Min(boundingBoxMinPoint_.y_, particle.position_.y_ - halfSize);
-//    boundingBoxMinPoint_.z_ = Min(boundingBoxMinPoint_.z_, particle.position_.z_);
-    boundingBoxMaxPoint_.x_ = Max(boundingBoxMaxPoint_.x_, particle.position_.x_ + halfSize);
-    boundingBoxMaxPoint_.y_ = Max(boundingBoxMaxPoint_.y_, particle.position_.y_ + halfSize);
-//    boundingBoxMaxPoint_.z_ = Max(boundingBoxMaxPoint_.z_, particle.position_.z_);
+    for (unsigned i = start; i < end; ++i)
+    {
+        float halfSize = size[i] * 0.5f;
+        boundingBoxMinPoint_.x_ = Min(boundingBoxMinPoint_.x_, positionX[i] - halfSize);
+        boundingBoxMinPoint_.y_ = Min(boundingBoxMinPoint_.y_, positionY[i] - halfSize);
+        boundingBoxMaxPoint_.x_ = Max(boundingBoxMaxPoint_.x_, positionX[i] + halfSize);
+        boundingBoxMaxPoint_.y_ = Max(boundingBoxMaxPoint_.y_, positionY[i] + halfSize);
+    }
 }
 
 }
@@ -30,46 +30,58 @@ namespace Urho3D
 class ParticleEffect2D;
 class Sprite2D;
 
-/// 2D particle.
-struct Particle2D
+/// 2D particles, stored as a structure of arrays : each attribute is contiguous for the update and vertex loops.
+struct URHO3D_API Particles2D
 {
+    /// Resize all the attributes.
+    void Resize(unsigned size);
+    /// Copy a particle.
+    void Copy(unsigned dest, unsigned src);
+    /// Return the number of particles.
+    unsigned Size() const { return timeToLive_.Size(); }
+
     /// Time to live.
-    float timeToLive_;
+    PODVector<float> timeToLive_;
+    /// Time step of the current update.
+    PODVector<float> timeStep_;
 
     /// Position.
-    Vector3 position_;
+    PODVector<float> positionX_;
+    PODVector<float> positionY_;
     /// Size.
-    float size_;
+    PODVector<float> size_;
     /// Size delta.
-    float sizeDelta_;
+    PODVector<float> sizeDelta_;
     /// Rotation.
-    float rotation_;
+    PODVector<float> rotation_;
     /// Rotation delta.
-    float rotationDelta_;
+    PODVector<float> rotationDelta_;
     /// Color.
-    Color color_;
+    PODVector<Color> color_;
     /// Color delta.
-    Color colorDelta_;
+    PODVector<Color> colorDelta_;
 
     // EMITTER_TYPE_GRAVITY parameters
     /// Start position.
-    Vector2 startPos_;
+    PODVector<float> startPosX_;
+    PODVector<float> startPosY_;
     /// Velocity.
-    Vector2 velocity_;
+    PODVector<float> velocityX_;
+    PODVector<float> velocityY_;
     /// Radial acceleration.
-    float radialAcceleration_;
+    PODVector<float> radialAcceleration_;
     /// Tangential acceleration.
-    float tangentialAcceleration_;
+    PODVector<float> tangentialAcceleration_;
 
     // EMITTER_TYPE_RADIAL parameters
     /// Emit radius.
-    float emitRadius_;
+    PODVector<float> emitRadius_;
     /// Emit radius delta.
-    float emitRadiusDelta_;
+    PODVector<float> emitRadiusDelta_;
     /// Emit rotation.
-    float emitRotation_;
+    PODVector<float> emitRotation_;
     /// Emit rotation delta.
-    float emitRotationDelta_;
+    PODVector<float> emitRotationDelta_;
 };
 
 /// 2D particle emitter component.
@@ -111,6 +123,8 @@ public:
 
     /// Return max particles.
     unsigned GetMaxParticles() const { return particles_.Size(); }
+    /// Return the number of alive particles.
+    unsigned GetNumParticles() const { return numParticles_; }
     /// Return color.
     const Color& GetColor() const { return color_; }
     /// Return alpha.
@@ -147,9 +161,8 @@ private:
     /// Emit particle.
     bool EmitParticle(const Vector2& worldPosition, float worldAngle, float worldScale);
 //    bool EmitParticle(const Vector3& worldPosition, float worldAngle, float worldScale);
-    /// Update particle.
-    void UpdateParticle(Particle2D& particle, float timeStep, float worldScale);
-//    void UpdateParticle(Particle2D& particle, float timeStep, const Vector3& worldPosition, float worldScale);
+    /// Update the particles in [start, end[.
+    void UpdateParticles(unsigned start, unsigned end, float timeStep, float worldScale);
 
     /// Particle effect.
     SharedPtr<ParticleEffect2D> effect_;
@@ -164,7 +177,7 @@ private:
     /// Emit particle time
     float emitParticleTime_;
     /// Particles.
-    Vector<Particle2D> particles_;
+    Particles2D particles_;
     /// Bounding box min point.
     Vector3 boundingBoxMinPoint_;
     /// Bounding box max point.
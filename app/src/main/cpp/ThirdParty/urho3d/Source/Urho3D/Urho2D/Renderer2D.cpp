@@ -40,6 +40,8 @@
 #include "../IO/Log.h"
 #include "../Scene/Node.h"
 #include "../Scene/Scene.h"
+#include "../Scene/SceneEvents.h"
+#include "../Urho2D/AnimatedSprite2D.h"
 #include "../Urho2D/Drawable2D.h"
 #include "../Urho2D/Renderer2D.h"
 
@@ -52,20 +54,11 @@ extern const char* blendModeNames[];
 
 static const unsigned MASK_VERTEX2D = MASK_POSITION | MASK_COLOR | MASK_TEXCOORD1;
 
-static const int TRIANGLE2D = 0;
-static const int QUAD2D = 1;
-
 ViewBatchInfo2D::ViewBatchInfo2D() :
     vertexBufferUpdateFrameNumber_(0),
     batchUpdatedFrameNumber_(0),
     batchCount_(0)
-{
-    for (int i=0; i<2; i++)
-    {
-        indexCount_[i] = 0;
-        vertexCount_[i] = 0;
-    }
-}
+{ }
 
 Renderer2D::Renderer2D(Context* context) :
     Drawable(context, DRAWABLE_GEOMETRY),
@@ -151,8 +144,8 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
     {
         if (i->second_.batchUpdatedFrameNumber_ == frame_.frameNumber_)
         {
-            indexCount[TRIANGLE2D] = (unsigned)Max((int)indexCount[TRIANGLE2D], (int)i->second_.indexCount_[TRIANGLE2D]);
-            indexCount[QUAD2D]     = (unsigned)Max((int)indexCount[QUAD2D], (int)i->second_.indexCount_[QUAD2D]);
+            indexCount[TRIANGLE2D] = Max(indexCount[TRIANGLE2D], i->second_.builder_.GetIndexCount(TRIANGLE2D));
+            indexCount[QUAD2D]     = Max(indexCount[QUAD2D], i->second_.builder_.GetIndexCount(QUAD2D));
         }
     }
     // update index buffer triangles
@@ -262,36 +255,45 @@ void Renderer2D::UpdateGeometry(const FrameInfo& frame)
 
     if (viewBatchInfo.vertexBufferUpdateFrameNumber_ != frame_.frameNumber_)
     {
-        // update vertex buffers
-        for (int primitiveType=0; primitiveType<2; primitiveType++)
+        UpdateViewVertexBuffers(viewBatchInfo);
+        viewBatchInfo.vertexBufferUpdateFrameNumber_ = frame_.frameNumber_;
+    }
+}
+
+void Renderer2D::UpdateViewVertexBuffers(ViewBatchInfo2D& viewBatchInfo)
+{
+    BatchBuilder2D& builder = viewBatchInfo.builder_;
+
+    for (int primitiveType=0; primitiveType<2; primitiveType++)
+    {
+        unsigned vertexCount = builder.GetVertexCount(primitiveType);
+        if (!vertexCount)
+            continue;
+
+        // Only the vertices of the changed source batches are copied in the storage
+        builder.PackVertices(primitiveType);
+
+        VertexBuffer* vertexBuffer = viewBatchInfo.vertexBuffer_[primitiveType];
+        bool upload = builder.IsStorageDirty(primitiveType) || vertexBuffer->IsDataLost();
+
+        // Grow with a margin to avoid resizing on each new drawable
+        if (vertexBuffer->GetVertexCount() < vertexCount)
         {
-            VertexBuffer* vertexBuffer = viewBatchInfo.vertexBuffer_[primitiveType];
-            if (vertexBuffer->GetVertexCount() < viewBatchInfo.vertexCount_[primitiveType])
-                vertexBuffer->SetSize(viewBatchInfo.vertexCount_[primitiveType], MASK_VERTEX2D, true);
-            if (viewBatchInfo.vertexCount_[primitiveType])
-            {
-                Vertex2D* dest = reinterpret_cast<Vertex2D*>(vertexBuffer->Lock(0, viewBatchInfo.vertexCount_[primitiveType], true));
-                if (dest)
-                {
-                    const PODVector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
-                    for (unsigned b = 0; b < sourceBatches.Size(); ++b)
-                    {
-                        if (sourceBatches[b]->quadvertices_ != primitiveType)
-                            continue;
+            vertexBuffer->SetSize(vertexCount + vertexCount / 2, MASK_VERTEX2D, true);
+            upload = true;
+        }
 
-                        const Vector<Vertex2D>& vertices = sourceBatches[b]->vertices_;
-                        for (unsigned i = 0; i < vertices.Size(); ++i)
-                            dest[i] = vertices[i];
-                        dest += vertices.Size();
-                    }
+        // Unchanged storage : the vertex buffer already has the vertices
+        if (!upload)
+            continue;
 
-                    vertexBuffer->Unlock();
-                }
-                else
-                    URHO3D_LOGERRORF("Renderer2D : Failed to lock vertex buffer %d", primitiveType);
-            }
+        if (vertexBuffer->SetDataRange(builder.GetVertices(primitiveType), 0, vertexCount, true))
+        {
+            builder.ClearStorageDirty(primitiveType);
+            vertexBuffer->ClearDataLost();
         }
-        viewBatchInfo.vertexBufferUpdateFrameNumber_ = frame_.frameNumber_;
+        else
+            URHO3D_LOGERRORF("Renderer2D : Failed to update vertex buffer %d", primitiveType);
     }
 }
 
@@ -452,9 +454,32 @@ void Renderer2D::RemoveDrawable(Drawable2D* drawable)
     if (!drawable)
         return;
 
+    // The packed ranges of the builders need no invalidation : a source batch reusing the memory of a removed one has a new version
     drawables_.Remove(drawable);
 }
 
+void Renderer2D::AddAnimatedSprite(AnimatedSprite2D* animatedSprite)
+{
+    if (!animatedSprite || animatedSprites_.Contains(animatedSprite))
+        return;
+
+    if (animatedSprites_.Empty())
+        SubscribeToEvent(GetScene(), E_SCENEPOSTUPDATE, URHO3D_HANDLER(Renderer2D, HandleScenePostUpdate));
+
+    animatedSprites_.Push(animatedSprite);
+}
+
+void Renderer2D::RemoveAnimatedSprite(AnimatedSprite2D* animatedSprite)
+{
+    if (!animatedSprite || !animatedSprites_.Remove(animatedSprite))
+        return;
+
+    // Removed by a trigger during the update : skip it in the remaining main thread pass
+    PODVector<AnimatedSprite2D*>::Iterator it = animationUpdates_.Find(animatedSprite);
+    if (it != animationUpdates_.End())
+        *it = 0;
+}
+
 Material* Renderer2D::GetMaterial(Texture2D* texture, BlendMode blendMode)
 {
     if (!texture)
@@ -591,6 +616,111 @@ void CheckDrawableVisibility(const WorkItem* item, unsigned threadIndex)
     }
 }
 
+static void UpdateAnimatedSpritesWork(const WorkItem* item, unsigned threadIndex)
+{
+    AnimatedSprite2D** start = reinterpret_cast<AnimatedSprite2D**>(item->start_);
+    AnimatedSprite2D** end = reinterpret_cast<AnimatedSprite2D**>(item->end_);
+
+    while (start != end)
+        (*start++)->UpdateAnimationInWorker();
+}
+
+static void UpdateSourceBatchesWork(const WorkItem* item, unsigned threadIndex)
+{
+    Drawable2D** start = reinterpret_cast<Drawable2D**>(item->start_);
+    Drawable2D** end = reinterpret_cast<Drawable2D**>(item->end_);
+
+    while (start != end)
+        (*start++)->GetSourceBatchesToRender();
+}
+
+/// Split the objects in one work item by worker thread (or one for the main thread) and wait for the completion.
+template <class T> static void ProcessWorkItems(WorkQueue* queue, PODVector<T*>& objects, void (*workFunction)(const WorkItem*, unsigned))
+{
+    if (objects.Empty())
+        return;
+
+    int numWorkItems = queue->GetNumThreads();
+    if (!numWorkItems)
+        numWorkItems = 1;
+
+    int objectsPerItem = objects.Size() / numWorkItems;
+
+    typename PODVector<T*>::Iterator start = objects.Begin();
+    for (int i = 0; i < numWorkItems && start != objects.End(); ++i)
+    {
+        SharedPtr<WorkItem> item = queue->GetFreeItem();
+        item->priority_ = M_MAX_UNSIGNED;
+        item->workFunction_ = workFunction;
+
+        typename PODVector<T*>::Iterator end = objects.End();
+        if (i < numWorkItems - 1 && end - start > objectsPerItem)
+            end = start + objectsPerItem;
+
+        item->start_ = &(*start);
+        item->end_ = &(*end);
+        queue->AddWorkItem(item);
+
+        start = end;
+    }
+
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
+void Renderer2D::HandleScenePostUpdate(StringHash eventType, VariantMap& eventData)
+{
+    if (animatedSprites_.Empty())
+        return;
+
+    URHO3D_PROFILE(UpdateAnimatedSprites2D);
+
+    float timeStep = eventData[ScenePostUpdate::P_TIMESTEP].GetFloat();
+
+    // Main thread : visibility, spine
+    animationUpdates_.Clear();
+    for (unsigned i = 0; i < animatedSprites_.Size(); ++i)
+    {
+        if (animatedSprites_[i]->BeginAnimationUpdate(timeStep))
+            animationUpdates_.Push(animatedSprites_[i]);
+    }
+
+    // Worker threads : each spriter instance only depends on its own state
+    ProcessWorkItems(GetSubsystem<WorkQueue>(), animationUpdates_, UpdateAnimatedSpritesWork);
+
+    // Main thread : triggers (events, nodes, physics) and dirty flags, in registration order
+    for (unsigned i = 0; i < animationUpdates_.Size(); ++i)
+    {
+        if (animationUpdates_[i])
+            animationUpdates_[i]->EndAnimationUpdate();
+    }
+
+    animationUpdates_.Clear();
+}
+
+void Renderer2D::UpdateSourceBatchesInWorkers(Camera* camera)
+{
+    workerDrawables_.Clear();
+    for (unsigned d = 0; d < drawables_.Size(); ++d)
+    {
+        Drawable2D* drawable = drawables_[d];
+        if (drawable->IsSourceBatchesDirty() && drawable->IsInView(camera) && drawable->CanUpdateSourceBatchesInWorker())
+        {
+            // The world transforms are cached on demand : update them in the main thread
+            Node* node = drawable->GetNode();
+            node->GetWorldTransform();
+            node->GetWorldTransform2D();
+            workerDrawables_.Push(drawable);
+        }
+    }
+
+    if (workerDrawables_.Size() < 2)
+        return;
+
+    URHO3D_PROFILE(UpdateSourceBatches2D);
+
+    ProcessWorkItems(GetSubsystem<WorkQueue>(), workerDrawables_, UpdateSourceBatchesWork);
+}
+
 void Renderer2D::UpdateFrustumBoundingBox(Camera* camera)
 {
     frustum_ = &camera->GetFrustum();
@@ -680,9 +810,12 @@ void Renderer2D::HandleBeginViewUpdate(StringHash eventType, VariantMap& eventDa
 
     ViewBatchInfo2D& viewBatchInfo = viewBatchInfos_[camera];
 
-    // Create vertex buffer
+    // Create vertex buffers once, they are kept for the next frames
     for (int primitiveType=0; primitiveType<2; primitiveType++)
-        viewBatchInfo.vertexBuffer_[primitiveType] = new VertexBuffer(context_);
+    {
+        if (!viewBatchInfo.vertexBuffer_[primitiveType])
+            viewBatchInfo.vertexBuffer_[primitiveType] = new VertexBuffer(context_);
+    }
 
     UpdateViewBatchInfo(viewBatchInfo, camera);
 
@@ -716,28 +849,16 @@ void Renderer2D::GetDrawables(PODVector<Drawable2D*>& dest, Node* node)
         GetDrawables(dest, i->Get());
 }
 
-static inline bool CompareSourceBatch2Ds(const SourceBatch2D* lhs, const SourceBatch2D* rhs)
-{
-    if (lhs->drawOrder_ != rhs->drawOrder_)
-        return lhs->drawOrder_ < rhs->drawOrder_;
-
-    if (lhs->material_ != rhs->material_)
-        return lhs->material_->GetNameHash() < rhs->material_->GetNameHash();
-
-    if (lhs->quadvertices_ != rhs->quadvertices_)
-        return lhs->quadvertices_;
-
-    return lhs < rhs;
-}
-
 void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera)
 {
     // Already update in same frame ?
     if (viewBatchInfo.batchUpdatedFrameNumber_ == frame_.frameNumber_)
         return;
 
-    PODVector<const SourceBatch2D*>& sourceBatches = viewBatchInfo.sourceBatches_;
-    sourceBatches.Clear();
+    UpdateSourceBatchesInWorkers(camera);
+
+    BatchBuilder2D& builder = viewBatchInfo.builder_;
+    builder.Clear();
     for (unsigned d = 0; d < drawables_.Size(); ++d)
     {
         if (!drawables_[d]->IsInView(camera))
@@ -749,74 +870,28 @@ void Renderer2D::UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* cam
         {
             const SourceBatch2D* batch = batches[b];
             if (batch && batch->material_ && !batch->vertices_.Empty())
-//            if (batch->material_ && !batch->vertices_.Empty())
-                sourceBatches.Push(batch);
+                builder.AddSourceBatch(batch);
         }
     }
 
-    Sort(sourceBatches.Begin(), sourceBatches.End(), CompareSourceBatch2Ds);
-
-    viewBatchInfo.batchCount_ = 0;
-    Material* currMaterial = 0;
-
-    unsigned iStart[2] = { 0, 0 };
-    unsigned iCount[2] = { 0, 0 };
-    unsigned vStart[2] = { 0, 0 };
-    unsigned vCount[2] = { 0, 0 };
-    int currType = sourceBatches.Size() ? sourceBatches[0]->quadvertices_ : QUAD2D;
-
-    for (unsigned b = 0; b < sourceBatches.Size(); ++b)
     {
-        Material* material = sourceBatches[b]->material_;
-        int primitiveType = sourceBatches[b]->quadvertices_;
-        const Vector<Vertex2D>& vertices = sourceBatches[b]->vertices_;
-
-        // When new material encountered, finish the current batch and start new
-        if (currMaterial != material || currType != primitiveType)
-        {
-            if (currMaterial)
-            {
-                AddViewBatch(viewBatchInfo, currType, currMaterial, iStart[currType], iCount[currType], vStart[currType], vCount[currType]);
-                iStart[primitiveType] += iCount[primitiveType];
-                iCount[primitiveType] = 0;
-                vStart[primitiveType] += vCount[primitiveType];
-                vCount[primitiveType] = 0;
-            }
-
-            currMaterial = material;
-            currType = primitiveType;
-        }
-
-        if (currType == QUAD2D)
-            iCount[currType] += vertices.Size() * 6 / 4;
-        else
-            iCount[currType] += vertices.Size();
-
-        vCount[currType] += vertices.Size();
+        URHO3D_PROFILE(BuildBatches2D);
+        builder.Build();
     }
 
-    // Add the final batch if necessary
-    if (currMaterial && vCount[currType])
-        AddViewBatch(viewBatchInfo, currType, currMaterial, iStart[currType], iCount[currType], vStart[currType], vCount[currType]);
-
-    for (int primitiveType=0; primitiveType<2; primitiveType++)
-    {
-        viewBatchInfo.indexCount_[primitiveType]  = iStart[primitiveType] + iCount[primitiveType];
-        viewBatchInfo.vertexCount_[primitiveType] = vStart[primitiveType] + vCount[primitiveType];
-    }
+    viewBatchInfo.batchCount_ = 0;
+    const PODVector<DrawRange2D>& ranges = builder.GetDrawRanges();
+    for (unsigned i = 0; i < ranges.Size(); ++i)
+        AddViewBatch(viewBatchInfo, ranges[i]);
 
     viewBatchInfo.batchUpdatedFrameNumber_ = frame_.frameNumber_;
 }
 
-void Renderer2D::AddViewBatch(ViewBatchInfo2D& viewBatchInfo, int primitivetype, Material* material, unsigned indexStart, unsigned indexCount,
-    unsigned vertexStart, unsigned vertexCount)
+void Renderer2D::AddViewBatch(ViewBatchInfo2D& viewBatchInfo, const DrawRange2D& range)
 {
-    if (!material || indexCount == 0 || vertexCount == 0)
-        return;
-
     if (viewBatchInfo.materials_.Size() <= viewBatchInfo.batchCount_)
         viewBatchInfo.materials_.Resize(viewBatchInfo.batchCount_ + 1);
-    viewBatchInfo.materials_[viewBatchInfo.batchCount_] = material;
+    viewBatchInfo.materials_[viewBatchInfo.batchCount_] = range.material_;
 
     // Allocate new geometry if necessary
     if (viewBatchInfo.geometries_.Size() <= viewBatchInfo.batchCount_)
@@ -826,9 +901,9 @@ void Renderer2D::AddViewBatch(ViewBatchInfo2D& viewBatchInfo, int primitivetype,
     }
 
     Geometry* geometry = viewBatchInfo.geometries_[viewBatchInfo.batchCount_];
-    geometry->SetIndexBuffer(indexBuffer_[primitivetype]);
-    geometry->SetVertexBuffer(0, viewBatchInfo.vertexBuffer_[primitivetype]);
-    geometry->SetDrawRange(TRIANGLE_LIST, indexStart, indexCount, vertexStart, vertexCount, false);
+    geometry->SetIndexBuffer(indexBuffer_[range.primitiveType_]);
+    geometry->SetVertexBuffer(0, viewBatchInfo.vertexBuffer_[range.primitiveType_]);
+    geometry->SetDrawRange(TRIANGLE_LIST, range.indexStart_, range.indexCount_, range.vertexStart_, range.vertexCount_, false);
 
     viewBatchInfo.batchCount_++;
 }
@@ -23,10 +23,12 @@
 #pragma once
 
 #include "../Graphics/Drawable.h"
+#include "../Urho2D/BatchBuilder2D.h"
 
 namespace Urho3D
 {
 
+class AnimatedSprite2D;
 class Drawable2D;
 class IndexBuffer;
 class Material;
@@ -44,16 +46,12 @@ struct ViewBatchInfo2D
 
     /// Vertex buffer update frame number.
     unsigned vertexBufferUpdateFrameNumber_;
-    /// Index count.
-    unsigned indexCount_[2];
-    /// Vertex count.
-    unsigned vertexCount_[2];
-    /// Vertex buffer.
+    /// Vertex buffers, persistent for the view.
     SharedPtr<VertexBuffer> vertexBuffer_[2];
     /// Batch updated frame number.
     unsigned batchUpdatedFrameNumber_;
-    /// Source batches.
-    PODVector<const SourceBatch2D*> sourceBatches_;
+    /// Batch builder : sorted source batches, draw ranges and packed vertices.
+    BatchBuilder2D builder_;
     /// Batch count;
     unsigned batchCount_;
     /// Materials.
@@ -90,6 +88,10 @@ public:
     void AddDrawable(Drawable2D* drawable);
     /// Remove Drawable2D.
     void RemoveDrawable(Drawable2D* drawable);
+    /// Add AnimatedSprite2D to the parallel animation update.
+    void AddAnimatedSprite(AnimatedSprite2D* animatedSprite);
+    /// Remove AnimatedSprite2D from the parallel animation update.
+    void RemoveAnimatedSprite(AnimatedSprite2D* animatedSprite);
 
     /// Create material by texture and blend mode.
     SharedPtr<Material> CreateMaterial(Texture2D* texture, BlendMode blendMode);
@@ -124,12 +126,18 @@ private:
     void HandleBeginViewUpdate(StringHash eventType, VariantMap& eventData);
     /// C.VILLE
     void HandleEndViewUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle scene post update event. Update the animated sprites in the worker threads.
+    void HandleScenePostUpdate(StringHash eventType, VariantMap& eventData);
+    /// Update in the worker threads the dirty source batches of the drawables in view that allow it.
+    void UpdateSourceBatchesInWorkers(Camera* camera);
     /// Get all drawables in node.
     void GetDrawables(PODVector<Drawable2D*>& drawables, Node* node);
     /// Update view batch info.
     void UpdateViewBatchInfo(ViewBatchInfo2D& viewBatchInfo, Camera* camera);
     /// Add view batch.
-    void AddViewBatch(ViewBatchInfo2D& viewBatchInfo, int primitivetype, Material* material, unsigned indexStart, unsigned indexCount, unsigned vertexStart, unsigned vertexCount);
+    void AddViewBatch(ViewBatchInfo2D& viewBatchInfo, const DrawRange2D& range);
+    /// Update the vertex buffers of a view from its batch builder.
+    void UpdateViewVertexBuffers(ViewBatchInfo2D& viewBatchInfo);
 
     /// Index buffer.
     SharedPtr<IndexBuffer> indexBuffer_[2];
@@ -137,6 +145,12 @@ private:
     SharedPtr<Material> material_;
     /// Drawables.
     PODVector<Drawable2D*> drawables_;
+    /// Animated sprites in parallel update, in registration order.
+    PODVector<AnimatedSprite2D*> animatedSprites_;
+    /// Animated sprites updated in the current parallel update.
+    PODVector<AnimatedSprite2D*> animationUpdates_;
+    /// Drawables with source batches updated in the worker threads.
+    PODVector<Drawable2D*> workerDrawables_;
     /// View frame info for current frame.
     FrameInfo frame_;
     /// View batch info.
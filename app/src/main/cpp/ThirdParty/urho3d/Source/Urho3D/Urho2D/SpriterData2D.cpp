@@ -396,7 +396,8 @@ bool MapInstruction::Load(const pugi::xml_node& node)
     return true;
 }
 
-Animation::Animation()
+Animation::Animation() :
+    bakedAnimation_(0)
 {
 
 }
@@ -408,6 +409,12 @@ Animation::~Animation()
 
 void Animation::Reset()
 {
+    if (bakedAnimation_)
+    {
+        delete bakedAnimation_;
+        bakedAnimation_ = 0;
+    }
+
     if (!mainlineKeys_.Empty())
     {
         for (unsigned i = 0; i < mainlineKeys_.Size(); ++i)
@@ -1164,6 +1171,30 @@ BoxTimelineKey& BoxTimelineKey::operator=(const BoxTimelineKey& rhs)
     return *this;
 }
 
+
+BakedAnimation::BakedAnimation(Animation* animation) :
+    animation_(animation),
+    endSample_(0)
+{
+}
+
+bool BakedAnimation::CanBake(Animation* animation)
+{
+    if (!animation || animation->mainlineKeys_.Empty())
+        return false;
+
+    for (unsigned i = 0; i < animation->timelines_.Size(); ++i)
+    {
+        Timeline* timeline = animation->timelines_[i];
+        if (timeline->objectType_ == POINT || timeline->objectType_ == BOX)
+            return false;
+        if (timeline->objectType_ == BONE && timeline->name_.StartsWith("TrigNode"))
+            return false;
+    }
+
+    return true;
+}
+
 }
 
 }
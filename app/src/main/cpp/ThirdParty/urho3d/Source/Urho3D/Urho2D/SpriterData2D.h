@@ -59,6 +59,8 @@ struct SpriteTimelineKey;
 struct BoneTimelineKey;
 struct BoxTimelineKey;
 
+struct BakedAnimation;
+
 #define DEFAULT_KEYPOOLSIZE 1000
 
 /// Object type.
@@ -213,6 +215,8 @@ struct Animation
     bool looping_;
     PODVector<MainlineKey*> mainlineKeys_;
     PODVector<Timeline*> timelines_;
+    /// Baked sprite keys, shared by the instances (created on demand by SpriterInstance).
+    BakedAnimation* bakedAnimation_;
 };
 
 /// Ref.
@@ -401,6 +405,49 @@ struct BoxTimelineKey : SpatialTimelineKey
     BoxTimelineKey& operator=(const BoxTimelineKey& rhs);
 };
 
+/// Baked animation : the sprite keys of an animation sampled at a fixed rate, in root space.
+/// The samples are grouped by mainline key : the keys are continuous between two mainline keys and can be interpolated.
+/// Immutable once baked, shared by all the instances playing the animation.
+struct BakedAnimation
+{
+    /// Samples of a mainline key, from the key time to the next key time (excluded).
+    struct Segment
+    {
+        /// Time of the mainline key.
+        float startTime_;
+        /// Samples per second.
+        float sampleRate_;
+        /// Index of the first sample.
+        unsigned firstSample_;
+        /// Number of intervals : numIntervals_ + 1 samples (only one sample if 0).
+        unsigned numIntervals_;
+        /// Instant mainline key : the pose is only applied once.
+        bool instant_;
+    };
+
+    BakedAnimation(Animation* animation);
+
+    /// Return whether an animation can be baked : no trigger timelines (point, box, TrigNode bone).
+    static bool CanBake(Animation* animation);
+
+    /// Return the sprite keys of a sample.
+    const SpriteTimelineKey* GetKeys(unsigned sample) const { return &keys_[sampleStarts_[sample]]; }
+    /// Return the number of sprite keys of a sample.
+    unsigned GetNumKeys(unsigned sample) const { return sampleStarts_[sample+1] - sampleStarts_[sample]; }
+
+    Animation* animation_;
+    /// Segment of each mainline key.
+    PODVector<Segment> segments_;
+    /// Sample at the animation length (end of a clamped animation).
+    unsigned endSample_;
+    /// First key of each sample (number of samples + 1 entries).
+    PODVector<unsigned> sampleStarts_;
+    /// Sample has the same sprites as the next one in its segment : the keys can be interpolated.
+    PODVector<bool> sampleLerps_;
+    /// Sprite keys of all the samples.
+    Vector<SpriteTimelineKey> keys_;
+};
+
 }
 
 }
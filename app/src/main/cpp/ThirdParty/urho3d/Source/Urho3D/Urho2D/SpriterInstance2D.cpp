@@ -36,12 +36,34 @@ namespace Urho3D
 namespace Spriter
 {
 
+bool SpriterInstance::bakingEnabled_ = false;
+float SpriterInstance::bakingSampleRate_ = 60.f;
+
+static inline bool IsIdentity(const SpatialInfo& info)
+{
+    return info.x_ == 0.f && info.y_ == 0.f && info.angle_ == 0.f && info.scaleX_ == 1.f && info.scaleY_ == 1.f && info.alpha_ == 1.f;
+}
+
+static inline bool HaveSameSprites(const SpriteTimelineKey* keysA, const SpriteTimelineKey* keysB, unsigned numKeys)
+{
+    for (unsigned i = 0; i < numKeys; ++i)
+    {
+        if (keysA[i].timeline_ != keysB[i].timeline_ || keysA[i].folderId_ != keysB[i].folderId_ ||
+            keysA[i].fileId_ != keysB[i].fileId_ || keysA[i].zIndex_ != keysB[i].zIndex_)
+            return false;
+    }
+    return true;
+}
+
 SpriterInstance::SpriterInstance(Component* owner, SpriterData* spriteData) :
     owner_(owner),
     spriterData_(spriteData),
     entity_(0),
     animation_(0),
-    loopfinished_(false)
+    loopfinished_(false),
+    bakedAnimation_(0),
+    bakedMainlineKey_(-1),
+    spriteKeysBaked_(false)
 {
 }
 
@@ -137,11 +159,13 @@ Animation* SpriterInstance::GetAnimation(const String& name) const
 void SpriterInstance::SetSpatialInfo(const SpatialInfo& spatialInfo)
 {
     this->spatialInfo_ = spatialInfo;
+    SelectBakedAnimation();
 }
 
 void SpriterInstance::SetSpatialInfo(float x, float y, float angle, float scaleX, float scaleY)
 {
     spatialInfo_ = SpatialInfo(x, y, angle, scaleX, scaleY);
+    SelectBakedAnimation();
 }
 
 bool SpriterInstance::HasFinishedAnimation() const
@@ -185,9 +209,12 @@ void SpriterInstance::OnSetAnimation(Animation* animation, LoopMode loopMode)
 
     currentTime_ = 0.f;
     mainlineKey_ = 0;
+    bakedMainlineKey_ = -1;
     loopfinished_ = false;
 
     Clear();
+
+    SelectBakedAnimation();
 }
 
 bool SpriterInstance::Update(float deltaTime)
@@ -201,6 +228,9 @@ bool SpriterInstance::Update(float deltaTime)
     if (!deltaTime)
         currentTime_ = 0.f;
 
+    if (bakedAnimation_)
+        return UpdateBakedKeys(deltaTime);
+
     if (!UpdateMainlineKeys(deltaTime))
         return false;
 
@@ -218,12 +248,13 @@ void SpriterInstance::ResetCurrentTime()
 
     currentTime_ = 0.f;
     mainlineKey_ = 0;
+    bakedMainlineKey_ = -1;
     loopfinished_ = false;
 
     Clear();
 }
 
-bool SpriterInstance::UpdateMainlineKeys(float deltaTime)
+void SpriterInstance::UpdateTime(float deltaTime)
 {
     currentTime_ += deltaTime;
 
@@ -238,6 +269,11 @@ bool SpriterInstance::UpdateMainlineKeys(float deltaTime)
     }
     else if (looping_ && loopfinished_)
         loopfinished_= false;
+}
+
+bool SpriterInstance::UpdateMainlineKeys(float deltaTime)
+{
+    UpdateTime(deltaTime);
 
     const PODVector<MainlineKey*>& mainlineKeys = animation_->mainlineKeys_;
 
@@ -358,7 +394,12 @@ void SpriterInstance::Clear()
         }
         boneKeys_.Clear();
     }
-    if (!spriteKeys_.Empty())
+    if (spriteKeysBaked_)
+    {
+        spriteKeys_.Clear();
+        spriteKeysBaked_ = false;
+    }
+    else if (!spriteKeys_.Empty())
     {
         for (unsigned i = 0; i < spriteKeys_.Size(); ++i)
         {
@@ -402,6 +443,205 @@ void SpriterInstance::Clear()
 
 }
 
+void SpriterInstance::SelectBakedAnimation()
+{
+    BakedAnimation* bakedAnimation = 0;
+
+    // The baked keys are in root space : only with the default root spatial info
+    if (bakingEnabled_ && animation_ && IsIdentity(spatialInfo_) && BakedAnimation::CanBake(animation_))
+        bakedAnimation = GetBakedAnimation(animation_);
+
+    if (bakedAnimation == bakedAnimation_)
+        return;
+
+    Clear();
+
+    bakedAnimation_ = bakedAnimation;
+    mainlineKey_ = 0;
+    bakedMainlineKey_ = -1;
+}
+
+BakedAnimation* SpriterInstance::GetBakedAnimation(Animation* animation) const
+{
+    if (animation->bakedAnimation_)
+        return animation->bakedAnimation_;
+
+    BakedAnimation* bakedAnimation = new BakedAnimation(animation);
+
+    // Sample the animation with a live instance, clamped
+    SpriterInstance sampler(0, spriterData_);
+    sampler.entity_ = entity_;
+    sampler.animation_ = animation;
+    sampler.looping_ = false;
+    sampler.mainlineKey_ = 0;
+
+    // Time before a mainline key where its previous key is sampled for the last time
+    const float keyTimeEpsilon = 0.0001f;
+
+    const PODVector<MainlineKey*>& mainlineKeys = animation->mainlineKeys_;
+    bakedAnimation->segments_.Resize(mainlineKeys.Size());
+
+    unsigned numSamples = 0;
+    for (unsigned i = 0; i < mainlineKeys.Size(); ++i)
+    {
+        BakedAnimation::Segment& segment = bakedAnimation->segments_[i];
+        const float endTime = i + 1 < mainlineKeys.Size() ? mainlineKeys[i+1]->time_ : animation->length_;
+        const float duration = endTime - keyTimeEpsilon - mainlineKeys[i]->time_;
+
+        segment.startTime_ = mainlineKeys[i]->time_;
+        segment.instant_ = mainlineKeys[i]->curveType_ == INSTANT && mainlineKeys.Size() > 1;
+        segment.numIntervals_ = mainlineKeys[i]->curveType_ != INSTANT && duration > 0.f ? (unsigned)Max(CeilToInt(duration * bakingSampleRate_), 1) : 0;
+        segment.sampleRate_ = segment.numIntervals_ ? (float)segment.numIntervals_ / duration : 0.f;
+        segment.firstSample_ = numSamples;
+
+        numSamples += segment.numIntervals_ + 1;
+    }
+    bakedAnimation->endSample_ = numSamples++;
+
+    bakedAnimation->sampleStarts_.Resize(numSamples + 1);
+    bakedAnimation->sampleLerps_.Resize(numSamples);
+
+    for (unsigned sample = 0; sample < numSamples; ++sample)
+    {
+        float time = animation->length_;
+        unsigned interval = 0;
+        const BakedAnimation::Segment* segment = 0;
+
+        if (sample != bakedAnimation->endSample_)
+        {
+            unsigned i = 0;
+            while (i + 1 < mainlineKeys.Size() && bakedAnimation->segments_[i+1].firstSample_ <= sample)
+                i++;
+
+            segment = &bakedAnimation->segments_[i];
+            interval = sample - segment->firstSample_;
+            time = segment->numIntervals_ ? segment->startTime_ + (float)interval / segment->sampleRate_ : segment->startTime_;
+        }
+
+        sampler.currentTime_ = time;
+        sampler.loopfinished_ = false;
+        sampler.mainlineKey_ = 0;
+
+        if (sampler.UpdateMainlineKeys(0.f))
+        {
+            sampler.Clear();
+            sampler.UpdateTimelineKeys();
+        }
+
+        bakedAnimation->sampleStarts_[sample] = bakedAnimation->keys_.Size();
+        bakedAnimation->sampleLerps_[sample] = segment && interval < segment->numIntervals_;
+
+        for (unsigned i = 0; i < sampler.spriteKeys_.Size(); ++i)
+            bakedAnimation->keys_.Push(*sampler.spriteKeys_[i]);
+    }
+    bakedAnimation->sampleStarts_[numSamples] = bakedAnimation->keys_.Size();
+
+    // The sprites are the same in a segment, check anyway before interpolating
+    for (unsigned sample = 0; sample + 1 < numSamples; ++sample)
+    {
+        if (!bakedAnimation->sampleLerps_[sample])
+            continue;
+
+        const unsigned numKeys = bakedAnimation->GetNumKeys(sample);
+        if (!numKeys || numKeys != bakedAnimation->GetNumKeys(sample + 1) ||
+            !HaveSameSprites(bakedAnimation->GetKeys(sample), bakedAnimation->GetKeys(sample + 1), numKeys))
+            bakedAnimation->sampleLerps_[sample] = false;
+    }
+
+    URHO3D_LOGINFOF("SpriterInstance() - GetBakedAnimation : animation=%s length=%f samples=%u keys=%u",
+                    animation->name_.CString(), animation->length_, numSamples, bakedAnimation->keys_.Size());
+
+    animation->bakedAnimation_ = bakedAnimation;
+    return bakedAnimation;
+}
+
+bool SpriterInstance::UpdateBakedKeys(float deltaTime)
+{
+    UpdateTime(deltaTime);
+
+    const BakedAnimation& bakedAnimation = *bakedAnimation_;
+    const PODVector<MainlineKey*>& mainlineKeys = animation_->mainlineKeys_;
+
+    // Same mainline key as the live update
+    int mainlineKey = -1;
+    for (unsigned i = 0; i < mainlineKeys.Size(); ++i)
+    {
+        if (mainlineKeys[i]->time_ > currentTime_)
+            break;
+
+        mainlineKey = i;
+    }
+    if (mainlineKey == -1)
+        mainlineKey = mainlineKeys.Size() - 1;
+
+    const BakedAnimation::Segment& segment = bakedAnimation.segments_[mainlineKey];
+
+    // An instant mainline key is only applied once
+    if (segment.instant_ && mainlineKey == bakedMainlineKey_)
+        return false;
+
+    bakedMainlineKey_ = mainlineKey;
+    mainlineKey_ = mainlineKeys[mainlineKey];
+
+    unsigned sample = segment.firstSample_;
+    float t = 0.f;
+
+    if (currentTime_ >= animation_->length_)
+        sample = bakedAnimation.endSample_;
+    else if (segment.numIntervals_)
+    {
+        const float position = Max(currentTime_ - segment.startTime_, 0.f) * segment.sampleRate_;
+        const unsigned interval = Min((unsigned)position, segment.numIntervals_ - 1);
+        sample += interval;
+        t = Min(position - (float)interval, 1.f);
+    }
+
+    Clear();
+
+    const unsigned numKeys = bakedAnimation.GetNumKeys(sample);
+    bakedKeys_.Resize(numKeys);
+
+    if (numKeys)
+    {
+        const SpriteTimelineKey* keys = bakedAnimation.GetKeys(sample);
+        const SpriteTimelineKey* nextKeys = bakedAnimation.sampleLerps_[sample] && t > 0.f ? bakedAnimation.GetKeys(sample + 1) : 0;
+
+        for (unsigned i = 0; i < numKeys; ++i)
+        {
+            SpriteTimelineKey& key = bakedKeys_[i];
+            key = keys[i];
+            key.timeline_ = keys[i].timeline_;
+            key.zIndex_ = keys[i].zIndex_;
+
+            if (nextKeys)
+            {
+                const SpatialInfo& next = nextKeys[i].info_;
+                SpatialInfo& info = key.info_;
+                info.x_ = Lerp(info.x_, next.x_, t);
+                info.y_ = Lerp(info.y_, next.y_, t);
+                info.scaleX_ = Lerp(info.scaleX_, next.scaleX_, t);
+                info.scaleY_ = Lerp(info.scaleY_, next.scaleY_, t);
+                info.alpha_ = Lerp(info.alpha_, next.alpha_, t);
+                // shortest way between the two sampled angles
+                float delta = fmod(next.angle_ - info.angle_, 360.f);
+                if (delta > 180.f)
+                    delta -= 360.f;
+                else if (delta < -180.f)
+                    delta += 360.f;
+                info.angle_ += delta * t;
+                key.pivotX_ = Lerp(key.pivotX_, nextKeys[i].pivotX_, t);
+                key.pivotY_ = Lerp(key.pivotY_, nextKeys[i].pivotY_, t);
+            }
+
+            spriteKeys_.Push(&key);
+        }
+    }
+
+    spriteKeysBaked_ = true;
+
+    return true;
+}
+
 }
 
 }
@@ -51,6 +51,9 @@ enum LoopMode
 };
 
 /// Spriter instance.
+/// In baked mode (SetBakingEnabled), an animation without triggers is sampled once at a fixed rate in a table shared by all the instances
+/// (see BakedAnimation) : the update of an instance is a time cursor and an interpolation of the sprite keys between two samples,
+/// without bone keys. The character maps are applied on the sprite keys by AnimatedSprite2D and so are independent of the baking.
 class SpriterInstance
 {
 public:
@@ -101,6 +104,15 @@ public:
     void ResetCurrentTime();
     bool HasFinishedAnimation() const;
     bool GetLooping() const { return looping_; }
+    /// Return whether the current animation is played from its baked animation.
+    bool IsBaked() const { return bakedAnimation_ != 0; }
+
+    /// Set baked mode for the next animations set on the instances.
+    static void SetBakingEnabled(bool enable) { bakingEnabled_ = enable; }
+    /// Set the sample rate of the next baked animations.
+    static void SetBakingSampleRate(float sampleRate) { bakingSampleRate_ = sampleRate; }
+    /// Return whether baked mode is enabled.
+    static bool IsBakingEnabled() { return bakingEnabled_; }
 
 private:
     /// Handle set entity.
@@ -108,6 +120,8 @@ private:
     /// Handle set animation.
     void OnSetAnimation(Animation* animation, LoopMode loopMode = Default);
 
+    /// Update current time.
+    void UpdateTime(float deltaTime);
     /// Update mainline keys.
     bool UpdateMainlineKeys(float deltaTime);
     /// Update timeline keys.
@@ -118,6 +132,13 @@ private:
     /// Clear mainline key and timeline keys.
     void Clear();
 
+    /// Use the baked animation of the current animation if possible.
+    void SelectBakedAnimation();
+    /// Return the baked animation of an animation, bake it if needed.
+    BakedAnimation* GetBakedAnimation(Animation* animation) const;
+    /// Update sprite keys from the baked animation.
+    bool UpdateBakedKeys(float deltaTime);
+
     /// Parent component.
     Component* owner_;
     /// Spriter data.
@@ -148,6 +169,20 @@ private:
     HashMap<String, BoneTimelineKey* > nodeTriggers_;
     HashMap<Timeline*, SpriteTimelineKey* > eventTriggers_;
     HashMap<Timeline*, BoxTimelineKey* > physicTriggers_;
+
+    /// Baked animation of the current animation (null if not baked).
+    BakedAnimation* bakedAnimation_;
+    /// Mainline key index of the last baked sample.
+    int bakedMainlineKey_;
+    /// Sprite keys interpolated from the baked animation (spriteKeys_ points to them).
+    Vector<SpriteTimelineKey> bakedKeys_;
+    /// Sprite keys are baked keys (not owned).
+    bool spriteKeysBaked_;
+
+    /// Baked mode.
+    static bool bakingEnabled_;
+    /// Sample rate of the baked animations.
+    static float bakingSampleRate_;
 };
 
 }